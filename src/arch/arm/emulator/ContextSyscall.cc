@@ -192,6 +192,9 @@ void Context::ExecuteSyscall()
 	if (err < 0 && err >= -SIM_ERRNO_MAX)
 		emulator->syscall_debug << misc::fmt(", errno=%s)", error_code_map.MapValue(-err));
 	emulator->syscall_debug << misc::fmt("\n");
+
+	// Let other contexts run
+	emulator->EndQuantum();
 }
 
 
@@ -38,6 +38,9 @@ std::string Emulator::syscall_debug_file;
 // Maximum number of instructions
 long long Emulator::max_instructions;
 
+// Instructions run by a context in a row
+long long Emulator::quantum = 10000;
+
 
 
 //
@@ -91,11 +94,23 @@ void Emulator::RegisterOptions()
 			"Debug information for system calls performed by a ARM "
 			"program, including system call code, arguments, and "
 			"return value.");
+
+	// Option --arm-quantum <number>
+	command_line->RegisterInt64("--arm-quantum <number> (default = 10000)",
+			quantum,
+			"Number of instructions that each ARM context runs in a "
+			"row before the emulator moves on to the next context "
+			"and checks for simulation events. A context also gives "
+			"up its quantum when it performs a system call.");
 }
 
 
 void Emulator::ProcessOptions()
 {
+	// Quantum
+	if (quantum < 1)
+		throw Error("Invalid value for option --arm-quantum");
+
 	// Debuggers
 	context_debug.setPath(context_debug_file);
 	isa_debug.setPath(isa_debug_file);
@@ -288,9 +303,9 @@ bool Emulator::Run()
 	if (esim->hasFinished())
 		return true;
 
-	// Run an instruction from every running context. During execution, a
-	// context can remove itself from the running list, so we need to save
-	// the iterator to the next element before executing.
+	// Run a quantum of instructions from every running context. During
+	// execution, a context can remove itself from the running list, so we
+	// need to save the iterator to the next element before executing.
 	auto end = context_list[ContextListRunning].end();
 	for (auto it = context_list[ContextListRunning].begin(); it != end; )
 	{
@@ -298,9 +313,14 @@ bool Emulator::Run()
 		auto next = it;
 		++next;
 
-		// Run one iteration
+		// Run until the quantum expires, or the context stops running
+		// or gives up its quantum in a system call.
 		Context *context = *it;
-		context->Execute();
+		quantum_ended = false;
+		for (long long i = 0; i < quantum && !quantum_ended &&
+				context->getState(ContextStateRunning) &&
+				!esim->hasFinished(); i++)
+			context->Execute();
 
 		// Move to saved next context
 		it = next;
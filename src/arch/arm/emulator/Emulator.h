@@ -93,6 +93,14 @@ class Emulator : public comm::Emulator
 	// Maximum number of instructions
 	static long long max_instructions;
 
+	// Number of instructions run by a context in a row before moving on
+	// to the next one
+	static long long quantum;
+
+	// Flag set when the running context must give up the rest of its
+	// quantum
+	bool quantum_ended = false;
+
 public:
 
 	/// Exception for ARM emulator
@@ -156,6 +164,10 @@ public:
 	/// Remove a context from all context lists and free it
 	void freeContext(Context *context);
 
+	/// End the quantum of the running context after its current
+	/// instruction, e.g. after a system call.
+	void EndQuantum() { quantum_ended = true; }
+
 	/// Remove a context from a context list if present
 	void RemoveContextFromList(ContextListType type, Context *context);
 
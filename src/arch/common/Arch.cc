@@ -17,6 +17,8 @@
  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <exception>
+
 #include <lib/cpp/Misc.h>
 #include <lib/cpp/Terminal.h>
 
@@ -179,6 +181,69 @@ void ArchPool::Run(int &num_active_emulators, int &num_active_timing_simulators)
 			throw misc::Panic("Invalid simulation kind");
 		}
 	}
+
+	// In co-simulation, the quanta prepared by the timing simulators in
+	// this iteration run concurrently. All of them must finish before
+	// errors are propagated, so that no host thread is left running.
+	// Their memory accesses start in a fixed order after the quantum, but
+	// instructions are emulated in host thread order (see
+	// StartCoSimulation()).
+	if (cosimulation)
+	{
+		for (auto it = getTimingBegin(), end = getTimingEnd();
+				it != end; it++)
+			(*it)->getTiming()->StartQuantum();
+		std::exception_ptr exception;
+		for (auto it = getTimingBegin(), end = getTimingEnd();
+				it != end; it++)
+		{
+			try
+			{
+				(*it)->getTiming()->FinishQuantum();
+			}
+			catch (...)
+			{
+				if (!exception)
+					exception = std::current_exception();
+			}
+		}
+		if (exception)
+			std::rethrow_exception(exception);
+	}
+}
+
+
+void ArchPool::StartCoSimulation(long long lookahead)
+{
+	// Only once
+	assert(!cosimulation);
+	assert(lookahead > 0);
+
+	// Check the timing simulators
+	if (getNumTiming() < 2)
+	{
+		misc::Warning("co-simulation disabled, since fewer than two "
+				"architectures use detailed simulation");
+		return;
+	}
+	for (auto it = getTimingBegin(), end = getTimingEnd(); it != end; it++)
+	{
+		Arch *arch = *it;
+		if (!arch->getTiming()->canCoSimulate())
+		{
+			misc::Warning("%s: co-simulation disabled, since the "
+					"timing simulator does not support it, "
+					"or is being traced or debugged",
+					arch->getName().c_str());
+			return;
+		}
+	}
+
+	// Start
+	cosimulation = true;
+	for (auto it = getTimingBegin(), end = getTimingEnd(); it != end; it++)
+		(*it)->getTiming()->StartCoSimulation(lookahead,
+				&cosimulation_mutex);
 }
 
 
@@ -23,6 +23,7 @@
 #include <list>
 #include <map>
 #include <memory>
+#include <pthread.h>
 
 #include <lib/cpp/String.h>
 
@@ -154,6 +155,16 @@ class ArchPool
 	// List of architectures with timing simulation
 	std::list<Arch *> timing_arch_list;
 
+	// True if timing simulators run concurrently, as enabled with
+	// StartCoSimulation()
+	bool cosimulation = false;
+
+	// Mutex shared by the functional emulators of co-simulated
+	// architectures. It serializes emulation, but in the order in which
+	// host threads take it, so the interleaving of accesses to memory
+	// shared by the architectures is not deterministic.
+	pthread_mutex_t cosimulation_mutex = PTHREAD_MUTEX_INITIALIZER;
+
 	// Register a new architecture with the given name, and return the new
 	// architecture object created. If an architecture with that name
 	// already existed, the existing object is returned.
@@ -222,6 +233,21 @@ public:
 	///	decide whether the main simulation loop should stop.
 	void Run(int &num_emu_active, int &num_timing_active);
 
+	/// Run the timing simulators concurrently on separate host threads,
+	/// synchronizing them every \a lookahead picoseconds. Each timing
+	/// simulator runs a whole quantum ahead of the memory system without
+	/// observing the others, so the lookahead should not exceed the
+	/// minimum latency of an interaction between them through memory.
+	/// Functional emulation is serialized by a shared mutex, so
+	/// architectures accessing the same memory concurrently observe an
+	/// interleaving that depends on the host threads. The call is ignored
+	/// with a warning if fewer than two architectures use detailed
+	/// simulation, or if any of them does not support it.
+	void StartCoSimulation(long long lookahead);
+
+	/// Return whether timing simulators run concurrently
+	bool isCoSimulation() const { return cosimulation; }
+
 	/// Dump a summary for all architectures in the pool.
 	void DumpSummary(std::ostream &os = std::cerr) const;
 
@@ -0,0 +1,218 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2015  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <cassert>
+
+#include "ParallelSimulation.h"
+
+
+namespace comm
+{
+
+ParallelSimulation::~ParallelSimulation()
+{
+	// Workers must have been stopped by the derived class
+	assert(!workers.isStarted());
+}
+
+
+void ParallelSimulation::StartParallelWorkers(int max_threads, int num_units)
+{
+	// Save arguments for restarts
+	this->max_threads = max_threads;
+	this->num_units = num_units;
+
+	// One host thread per unit at most. In co-simulation, units run on
+	// worker threads even if there is only one.
+	num_threads = std::min(max_threads, num_units);
+	if (num_threads <= 1 && !cosimulation)
+		return;
+
+	// Let the derived class decide
+	if (!PrepareParallelSimulation())
+	{
+		num_threads = 1;
+		return;
+	}
+
+	// Per-unit buffers, created in place, since they cannot be copied
+	pending_accesses = std::vector<std::list<std::unique_ptr<
+			PendingAccess>>>(num_units);
+
+	// The main thread acts as worker 0, except in co-simulation, where it
+	// runs other timing simulators during the quantum
+	workers.Start(num_threads, !cosimulation,
+			[this](int index) { RunQuantum(index); });
+}
+
+
+void ParallelSimulation::StopParallelWorkers()
+{
+	workers.Stop();
+}
+
+
+void ParallelSimulation::StartCoSimulation(long long quantum,
+		pthread_mutex_t *functional_mutex)
+{
+	// Must be called before the simulation starts
+	assert(!cosimulation);
+	assert(quantum > 0);
+	assert(!quantum_end);
+
+	// Restart workers, so that all units run on them
+	StopParallelWorkers();
+	cosimulation = true;
+	cosimulation_quantum = quantum;
+	this->functional_mutex = functional_mutex;
+	StartParallelWorkers(max_threads, num_units);
+}
+
+
+void ParallelSimulation::RunQuantum(int index)
+{
+	// Each unit runs the entire quantum before the next unit assigned to
+	// the worker starts
+	for (int unit = index; unit < num_units; unit += num_threads)
+		for (long long cycle = quantum_start; cycle < quantum_end; cycle++)
+			RunUnit(unit, cycle);
+}
+
+
+void ParallelSimulation::RunParallel(long long cycle, long long quantum)
+{
+	// Start a new quantum
+	if (cycle >= quantum_end)
+	{
+		// Start the accesses of the previous quantum. Those that their
+		// modules cannot accept yet stay buffered, and are retried in
+		// the following cycles.
+		StartPendingAccesses(cycle - 1);
+
+		// Let the derived class update its state
+		BeginQuantum();
+
+		// Prepare the quantum. In co-simulation, quanta end at
+		// multiples of their length, so that they stay aligned with
+		// those of other timing simulators.
+		quantum_start = cycle;
+		quantum_end = cycle + quantum;
+		if (cosimulation)
+			quantum_end = (cycle / cosimulation_quantum + 1) *
+					cosimulation_quantum;
+		quantum_ready = true;
+
+		// In co-simulation, the quantum runs when all timing
+		// simulators have prepared theirs
+		if (cosimulation)
+			return;
+
+		// Run all units for the quantum
+		StartQuantum();
+		FinishQuantum();
+		return;
+	}
+
+	// Start memory accesses issued in this cycle
+	StartPendingAccesses(cycle);
+}
+
+
+void ParallelSimulation::StartQuantum()
+{
+	// Nothing prepared
+	if (!quantum_ready)
+		return;
+
+	// Release workers. Outside of co-simulation, the main thread acts as
+	// worker 0.
+	quantum_ready = false;
+	quantum_running = true;
+	parallel_phase = true;
+	workers.Run();
+}
+
+
+void ParallelSimulation::FinishQuantum()
+{
+	// Nothing running
+	if (!quantum_running)
+		return;
+
+	// Wait for workers
+	workers.Wait();
+	quantum_running = false;
+	parallel_phase = false;
+
+	// Propagate errors found in any worker
+	workers.RethrowException();
+
+	// Let the derived class update its state
+	EndQuantum();
+
+	// Start memory accesses issued in the first cycle of the quantum
+	StartPendingAccesses(quantum_start);
+}
+
+
+void ParallelSimulation::StartPendingAccesses(long long cycle)
+{
+	// Traversing units in order makes the order in which accesses start
+	// independent of the number of host threads and their relative speed.
+	std::vector<mem::Module *> blocked_modules;
+	for (auto &accesses : pending_accesses)
+	{
+		blocked_modules.clear();
+		for (auto it = accesses.begin(); it != accesses.end() &&
+				(*it)->cycle <= cycle;)
+		{
+			// Accesses after one that could not start wait for it
+			PendingAccess *access = it->get();
+			if (std::find(blocked_modules.begin(),
+					blocked_modules.end(),
+					access->module) != blocked_modules.end())
+			{
+				++it;
+				continue;
+			}
+
+			// Start access, or hold back its module
+			if (access->Start())
+			{
+				it = accesses.erase(it);
+			}
+			else
+			{
+				blocked_modules.push_back(access->module);
+				++it;
+			}
+		}
+	}
+}
+
+
+void ParallelSimulation::AddPendingAccess(int unit, long long cycle,
+		std::unique_ptr<PendingAccess> access)
+{
+	access->cycle = cycle;
+	pending_accesses[unit].push_back(std::move(access));
+}
+
+}
@@ -0,0 +1,287 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2015  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef ARCH_COMMON_PARALLEL_SIMULATION_H
+#define ARCH_COMMON_PARALLEL_SIMULATION_H
+
+#include <list>
+#include <memory>
+#include <pthread.h>
+#include <vector>
+
+#include <memory/Memory.h>
+
+#include "WorkerPool.h"
+
+
+namespace mem
+{
+
+class Module;
+
+}
+
+
+namespace comm
+{
+
+/// Quantum-based parallel simulation of the units of a timing simulator
+/// (cores, compute units). In the first cycle of each quantum, every unit
+/// runs ahead for the whole quantum on a host worker thread, buffering the
+/// memory accesses it issues. The accesses are started in the following
+/// cycles by the main thread, in the cycles where they were issued and in
+/// the order of units, so that results do not depend on the number of host
+/// threads or their relative speed.
+///
+/// In co-simulation, all units run on worker threads while the main thread
+/// runs other timing simulators, and quanta are aligned with theirs.
+class ParallelSimulation
+{
+public:
+
+	/// Memory access issued by a unit while running ahead of the timing
+	/// simulator. Derived classes hold what is needed to start it.
+	class PendingAccess
+	{
+		friend class ParallelSimulation;
+
+		// Unit cycle where the access was issued
+		long long cycle = 0;
+
+	protected:
+
+		// Accessed module
+		mem::Module *module;
+
+	public:
+
+		/// Constructor
+		PendingAccess(mem::Module *module) : module(module)
+		{
+		}
+
+		/// Virtual destructor
+		virtual ~PendingAccess()
+		{
+		}
+
+		/// Start the access. Return false if the module cannot accept
+		/// it yet, in which case it is retried in the next cycle.
+		virtual bool Start() = 0;
+	};
+
+private:
+
+	// Number of host threads requested in the last call to
+	// StartParallelWorkers()
+	int max_threads = 1;
+
+	// Number of units
+	int num_units = 0;
+
+	// Number of host threads used in this simulation, including the main
+	// thread. A value of 1 runs all units sequentially.
+	int num_threads = 1;
+
+	// True if the units run concurrently with other timing simulators
+	bool cosimulation = false;
+
+	// Number of cycles in a quantum in co-simulation
+	long long cosimulation_quantum = 0;
+
+	// Host threads running the units. Units are assigned to workers in a
+	// round-robin fashion, with worker 0 being the main thread, except in
+	// co-simulation.
+	WorkerPool workers;
+
+	// True while units run ahead of the timing simulator
+	bool parallel_phase = false;
+
+	// First cycle of the current quantum
+	long long quantum_start = 0;
+
+	// First cycle after the current quantum
+	long long quantum_end = 0;
+
+	// True if a quantum was prepared and not started yet
+	bool quantum_ready = false;
+
+	// True if a quantum was started and not finished yet
+	bool quantum_running = false;
+
+	// Memory accesses issued by each unit and not started yet, in the
+	// order they were issued
+	std::vector<std::list<std::unique_ptr<PendingAccess>>> pending_accesses;
+
+	// Mutex protecting the functional emulator while units run on worker
+	// threads
+	pthread_mutex_t own_functional_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+	// Mutex taken by the functional lock. It is the simulator's own mutex,
+	// or the one shared with other emulators in co-simulation.
+	pthread_mutex_t *functional_mutex = &own_functional_mutex;
+
+	// Run the units assigned to the given worker for the current quantum
+	void RunQuantum(int index);
+
+	// Start the buffered memory accesses issued up to the given cycle. In
+	// each unit, an access that its module cannot accept holds back the
+	// later accesses of the unit to the same module, so that they start in
+	// the order they were issued.
+	void StartPendingAccesses(long long cycle);
+
+protected:
+
+	/// Create the worker threads for a simulator with \a num_units units
+	/// and at most \a max_threads host threads, one per unit at most.
+	/// Nothing is done if the simulation is sequential.
+	void StartParallelWorkers(int max_threads, int num_units);
+
+	/// Tell the worker threads to exit and wait for them
+	void StopParallelWorkers();
+
+	/// Return whether units run in quanta, either on several host threads
+	/// or in co-simulation
+	bool inParallelSimulation() const
+	{
+		return num_threads > 1 || cosimulation;
+	}
+
+	/// Return the first cycle after the current quantum
+	long long getQuantumEnd() const { return quantum_end; }
+
+	/// Return the mutex taken by the functional lock
+	pthread_mutex_t *getFunctionalMutex() const { return functional_mutex; }
+
+	/// Simulate the given cycle in parallel simulation. Units run a whole
+	/// quantum of \a quantum cycles on its first cycle, and the memory
+	/// accesses they buffered are started in the following cycles. In
+	/// co-simulation, the quantum is only prepared, and run later with
+	/// StartQuantum() and FinishQuantum().
+	void RunParallel(long long cycle, long long quantum);
+
+	/// Buffer a memory access issued by a unit in the given cycle while
+	/// running ahead of the timing simulator
+	void AddPendingAccess(int unit, long long cycle,
+			std::unique_ptr<PendingAccess> access);
+
+	/// Called by StartParallelWorkers() before creating the worker
+	/// threads. Return false to keep the simulation sequential.
+	virtual bool PrepareParallelSimulation() { return true; }
+
+	/// Run one cycle of the given unit while running ahead of the timing
+	/// simulator. This function runs on worker threads.
+	virtual void RunUnit(int index, long long cycle) = 0;
+
+	/// Called in the main thread right before a quantum is prepared
+	virtual void BeginQuantum() { }
+
+	/// Called in the main thread after all units finished a quantum, and
+	/// before its first buffered accesses start
+	virtual void EndQuantum() { }
+
+public:
+
+	/// Virtual destructor. Derived classes must call StopParallelWorkers()
+	/// in their own destructor, while units still exist.
+	virtual ~ParallelSimulation();
+
+	/// Return whether units are currently running ahead of the timing
+	/// simulator on worker threads
+	bool inParallelPhase() const { return parallel_phase; }
+
+	/// Run all units on worker threads, concurrently with other timing
+	/// simulators, in quanta of the given number of cycles. The
+	/// functional lock takes \a functional_mutex, shared with the
+	/// emulators of the other timing simulators.
+	void StartCoSimulation(long long quantum,
+			pthread_mutex_t *functional_mutex);
+
+	/// In co-simulation, start running the quantum prepared in the last
+	/// call to RunParallel(), if any, without waiting for it.
+	void StartQuantum();
+
+	/// In co-simulation, wait for the quantum started with StartQuantum()
+	/// and start the memory accesses issued in its first cycle.
+	void FinishQuantum();
+
+	/// Lock on the state of the functional emulator shared by all units,
+	/// such as its context lists. Units must hold it while accessing that
+	/// state, or while emulating instructions if the simulator does not
+	/// use memory locks. The lock is only taken while units run ahead of
+	/// the timing simulator.
+	class FunctionalLock
+	{
+		// Mutex, or null if not locked
+		pthread_mutex_t *mutex = nullptr;
+
+	public:
+
+		/// Take the lock of the given simulation
+		FunctionalLock(ParallelSimulation *simulation)
+		{
+			if (simulation->parallel_phase)
+			{
+				mutex = simulation->functional_mutex;
+				pthread_mutex_lock(mutex);
+			}
+		}
+
+		/// Release the lock
+		~FunctionalLock()
+		{
+			if (mutex)
+				pthread_mutex_unlock(mutex);
+		}
+	};
+
+	/// Lock on a memory image of the functional emulator. Units must hold
+	/// it while emulating instructions or translating addresses of the
+	/// contexts that use the memory image, so that units emulating
+	/// different processes run concurrently. The lock is only taken while
+	/// units run ahead of the timing simulator.
+	class MemoryLock
+	{
+		// Memory image, or null if not locked
+		mem::Memory *memory = nullptr;
+
+	public:
+
+		/// Lock the given memory image in the given simulation
+		MemoryLock(ParallelSimulation *simulation, mem::Memory *memory)
+		{
+			if (simulation->parallel_phase)
+			{
+				this->memory = memory;
+				memory->Lock();
+			}
+		}
+
+		/// Release the lock
+		~MemoryLock()
+		{
+			if (memory)
+				memory->Unlock();
+		}
+	};
+};
+
+}
+
+#endif
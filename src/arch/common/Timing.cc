@@ -77,5 +77,12 @@ mem::Module *Timing::getEntryModule(int index)
 }
 
 
+void Timing::StartCoSimulation(long long lookahead,
+		pthread_mutex_t *functional_mutex)
+{
+	throw misc::Panic("Architecture does not support co-simulation");
+}
+
+
 }
 
@@ -21,6 +21,7 @@
 #define ARCH_COMMON_TIMING_H
 
 #include <fstream>
+#include <pthread.h>
 
 #include <lib/cpp/IniFile.h>
 #include <lib/esim/FrequencyDomain.h>
@@ -107,6 +108,27 @@ public:
 	/// getNumEntryModules() - 1.
 	virtual mem::Module *getEntryModule(int index);
 
+	/// Return whether the timing simulator can run concurrently with
+	/// other timing simulators (see StartCoSimulation()).
+	virtual bool canCoSimulate() const { return false; }
+
+	/// Run the timing simulator concurrently with other timing
+	/// simulators. From now on, Run() only prepares the work of every
+	/// quantum of \a lookahead picoseconds on its first cycle. The
+	/// architecture pool then starts the prepared quanta of all timing
+	/// simulators with StartQuantum(), and waits for them with
+	/// FinishQuantum(). The functional emulators of all co-simulated
+	/// architectures are protected by the shared \a functional_mutex.
+	virtual void StartCoSimulation(long long lookahead,
+			pthread_mutex_t *functional_mutex);
+
+	/// Start running the quantum prepared in the last call to Run() on
+	/// host threads, if any, and return without waiting for it.
+	virtual void StartQuantum() { }
+
+	/// Wait for the quantum started with StartQuantum() to finish.
+	virtual void FinishQuantum() { }
+
 	/// Dump the statistics summary for the timing simulator.
 	virtual void DumpSummary(std::ostream &os) const { }
 
@@ -0,0 +1,143 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2015  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cassert>
+
+#include <lib/cpp/Error.h>
+
+#include "WorkerPool.h"
+
+
+namespace comm
+{
+
+void WorkerPool::Start(int num_threads, bool main_thread_runs, Task task)
+{
+	// Only once
+	assert(!isStarted());
+	assert(num_threads > 0);
+	this->num_threads = num_threads;
+	this->main_thread_runs = main_thread_runs;
+	this->task = task;
+	exceptions.assign(num_threads, nullptr);
+
+	// Barriers include the main thread
+	int first_worker = main_thread_runs ? 1 : 0;
+	int num_workers = num_threads - first_worker;
+	pthread_barrier_init(&start_barrier, nullptr, num_workers + 1);
+	pthread_barrier_init(&end_barrier, nullptr, num_workers + 1);
+
+	// Create workers. The vector is sized first, since workers keep a
+	// pointer to their entry.
+	workers.resize(num_workers);
+	for (int i = 0; i < num_workers; i++)
+	{
+		Worker &worker = workers[i];
+		worker.pool = this;
+		worker.index = i + first_worker;
+		if (pthread_create(&worker.thread, nullptr, WorkerMain, &worker))
+			throw misc::Error("Cannot create host thread for "
+					"parallel simulation");
+	}
+}
+
+
+void WorkerPool::Stop()
+{
+	// Nothing to do if not started
+	if (!isStarted())
+		return;
+
+	// Release workers from the start barrier with the exit flag set
+	exit_workers = true;
+	pthread_barrier_wait(&start_barrier);
+	for (Worker &worker : workers)
+		pthread_join(worker.thread, nullptr);
+	workers.clear();
+	exit_workers = false;
+	num_threads = 0;
+
+	// Free barriers
+	pthread_barrier_destroy(&start_barrier);
+	pthread_barrier_destroy(&end_barrier);
+}
+
+
+void *WorkerPool::WorkerMain(void *arg)
+{
+	Worker *worker = (Worker *) arg;
+	WorkerPool *pool = worker->pool;
+	while (true)
+	{
+		// Wait for the next run
+		pthread_barrier_wait(&pool->start_barrier);
+		if (pool->exit_workers)
+			break;
+
+		// Run part of the task
+		pool->RunPart(worker->index);
+		pthread_barrier_wait(&pool->end_barrier);
+	}
+	return nullptr;
+}
+
+
+void WorkerPool::RunPart(int index)
+{
+	try
+	{
+		task(index);
+	}
+	catch (...)
+	{
+		exceptions[index] = std::current_exception();
+	}
+}
+
+
+void WorkerPool::Run()
+{
+	assert(isStarted());
+	pthread_barrier_wait(&start_barrier);
+	if (main_thread_runs)
+		RunPart(0);
+}
+
+
+void WorkerPool::Wait()
+{
+	assert(isStarted());
+	pthread_barrier_wait(&end_barrier);
+}
+
+
+void WorkerPool::RethrowException()
+{
+	for (std::exception_ptr &exception : exceptions)
+	{
+		if (exception)
+		{
+			std::exception_ptr rethrown = exception;
+			exception = nullptr;
+			std::rethrow_exception(rethrown);
+		}
+	}
+}
+
+}
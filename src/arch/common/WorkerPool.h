@@ -0,0 +1,120 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2015  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef ARCH_COMMON_WORKER_POOL_H
+#define ARCH_COMMON_WORKER_POOL_H
+
+#include <exception>
+#include <functional>
+#include <pthread.h>
+#include <vector>
+
+
+namespace comm
+{
+
+/// Pool of host threads running a task repeatedly, such as a quantum of
+/// parallel simulation or emulation. The task is split into parts with
+/// indexes from 0 to the number of threads minus one, each run by one
+/// thread. The main thread can run part 0 itself.
+class WorkerPool
+{
+public:
+
+	/// Part of the task run by a thread, given its index
+	typedef std::function<void(int index)> Task;
+
+private:
+
+	// Worker thread
+	struct Worker
+	{
+		// Pool that the worker belongs to
+		WorkerPool *pool;
+
+		// Index of the part of the task run by the worker
+		int index;
+
+		// Host thread
+		pthread_t thread;
+	};
+
+	// Task run by the threads
+	Task task;
+
+	// Number of parts of the task
+	int num_threads = 0;
+
+	// True if the main thread runs part 0 of the task
+	bool main_thread_runs = false;
+
+	// Worker threads, excluding the main thread
+	std::vector<Worker> workers;
+
+	// Barrier that workers wait on before running the task
+	pthread_barrier_t start_barrier;
+
+	// Barrier that workers wait on after running the task
+	pthread_barrier_t end_barrier;
+
+	// Flag telling workers to exit when released from the start barrier
+	bool exit_workers = false;
+
+	// Exceptions thrown by each part of the task in the last run,
+	// rethrown in the main thread
+	std::vector<std::exception_ptr> exceptions;
+
+	// Main function of worker threads
+	static void *WorkerMain(void *arg);
+
+	// Run one part of the task, saving its exceptions
+	void RunPart(int index);
+
+public:
+
+	/// Destructor, stopping the worker threads
+	~WorkerPool() { Stop(); }
+
+	/// Create the host threads for a task split into \a num_threads parts.
+	/// If \a main_thread_runs is true, part 0 is run by the main thread in
+	/// Run(), and one thread less is created.
+	void Start(int num_threads, bool main_thread_runs, Task task);
+
+	/// Tell the worker threads to exit and wait for them. Nothing is done
+	/// if they were not started.
+	void Stop();
+
+	/// Return whether the worker threads were started
+	bool isStarted() const { return num_threads > 0; }
+
+	/// Release the worker threads to run their parts of the task once.
+	/// If the main thread runs part 0, it returns after finishing it.
+	void Run();
+
+	/// Wait for the worker threads to finish their parts of the task
+	void Wait();
+
+	/// Rethrow in the calling thread an exception thrown by a part of the
+	/// task in the last run, if any
+	void RethrowException();
+};
+
+}
+
+#endif
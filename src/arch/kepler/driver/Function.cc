@@ -52,6 +52,11 @@ Function::Function(int id, Module *module, const std::string &name) :
 	text_buffer = text_section->getBuffer();
 	text_size = text_section->getSize();
 
+	// Decode instructions. Each one is 8 bytes long.
+	instructions.resize(text_size / 8);
+	for (unsigned i = 0; i < instructions.size(); i++)
+		instructions[i].Decode(text_buffer + i * 8, i * 8);
+
 	// Get section named ".nv.info.<name>" from the ELF file
 	std::string info_section_name = ".nv.info." + name;
 	ELFReader::Section *info_section = elf_file->getSection(
@@ -24,6 +24,7 @@ d *  Multi2Sim
 #include <memory>
 #include <vector>
 
+#include <arch/kepler/disassembler/Instruction.h>
 #include <lib/cpp/Misc.h>
 
 #include "Argument.h"
@@ -53,6 +54,10 @@ class Function
 	// Size of the ISA section in bytes FIXME
 	int text_size;
 
+	// Instructions in the ISA section, decoded once when the function is
+	// loaded and shared by all grids launching it
+	std::vector<Instruction> instructions;
+
 	// Arguments
 	std::vector<std::unique_ptr<Argument>> arguments;
 
@@ -70,6 +75,10 @@ public:
 	/// Get a buffer pointing to the ISA section in the associated ELF file
 	const char *getTextBuffer() const { return text_buffer; }
 
+	/// Return the array of decoded instructions, indexed by their offset
+	/// in the ISA section divided by the instruction size
+	Instruction *getInstructions() { return instructions.data(); }
+
 	/// Get number of arguments
 	int getNumArguments() const { return arguments.size(); }
 
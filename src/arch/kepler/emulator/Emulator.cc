@@ -115,7 +115,7 @@ bool Emulator::Run()
 	// Remove grid and its thread blocks from pending list, and add them to
 	// running list
 	Grid *grid;
-	std::unique_ptr<ThreadBlock> thread_block;
+	ThreadBlock *thread_block;
 	int thread_block_id;
 	unsigned thread_block_3d_id[3];
 	while (pending_grids.size())
@@ -143,21 +143,20 @@ bool Emulator::Run()
 								grid->getThreadBlockCount3(2))  ;
 			grid->WaitingToRunning(thread_block_id, thread_block_3d_id);
 			thread_block_id ++;
-			thread_block.reset(grid->getRunningThreadBlocksBegin()->release());
-			while (thread_block.get()->getNumWarpsCompletedEmu()
-					!= thread_block.get()->getWarpCount())
+			thread_block = grid->getRunningThreadBlocksBegin()->get();
+			while (thread_block->getNumWarpsCompletedEmu()
+					!= thread_block->getWarpCount())
 			{
-				for (auto wp_p = thread_block.get()->WarpsBegin(); wp_p <
-					thread_block.get()->WarpsEnd(); ++wp_p)
+				for (auto wp_p = thread_block->WarpsBegin(); wp_p <
+					thread_block->WarpsEnd(); ++wp_p)
 				{
 					if ((*wp_p)->getFinishedEmu() || (*wp_p)->getAtBarrier())
 						continue;
 					(*wp_p)->Execute();
 				}
 			}
-			thread_block.get()->setFinishedEmu(true);
-			grid->PopRunningThreadBlock();
-			thread_block.reset(); // free the memory of thread block
+			thread_block->setFinishedEmu(true);
+			grid->PopRunningThreadBlock(); // recycled by the next one
 		}
 		finished_grids.push_back(grid);
 	}
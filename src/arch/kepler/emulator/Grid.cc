@@ -32,31 +32,11 @@ Grid::Grid(Function *function)
 	// Initialization
 	this->emulator = emulator->getInstance();
 	id = emulator->getGridSize();
-	const char * temp_buffer;
-	temp_buffer = function->getTextBuffer();
+	this->function = function;
 	instruction_buffer_size = function->getTextSize();
-	instruction_buffer.resize(instruction_buffer_size);
 	kernel_function_name = function->getName();
-
-	// Instruction byte
-	unsigned long long inst_byte;
-	for (int i = 0; i < instruction_buffer_size; i++)
-	{
-		inst_byte = (unsigned char) temp_buffer[i];
-		if(i % 8 < 4) // 0 1 2 3 byte
-		{
-			instruction_buffer[i / 8] |= inst_byte << (i * 8 + 32);
-		}
-		else // 4 5 6 7 byte
-		{
-			instruction_buffer[i / 8] |= inst_byte << (i * 8 - 32);
-		}
-	}
 	state = GridStateInvalid;
 
-	//for(int i = 0; i < inst_buffer_size / 8; i++)
-	//	std::cout<<"in function	"<<__FUNCTION__<<
-	//	"the inst_buffer["<<i <<"] is"<<inst_buffer[i]<<std::endl;
 	// Add to list  (no need? )
 	//emu->addGrid(function);
 }
@@ -111,9 +91,19 @@ void Grid::GridSetupConstantMemory()
 
 void Grid::WaitingToRunning(int thread_block_id, unsigned *id_3d)
 {
-	running_thread_blocks.push_back
-		(std::unique_ptr<ThreadBlock>(new ThreadBlock(this, thread_block_id,
-					id_3d)));
+	// Recycle a thread block released earlier, or create a new one
+	if (free_thread_blocks.empty())
+	{
+		running_thread_blocks.push_back
+			(std::unique_ptr<ThreadBlock>(new ThreadBlock(this,
+					thread_block_id, id_3d)));
+	}
+	else
+	{
+		running_thread_blocks.splice(running_thread_blocks.end(),
+				free_thread_blocks, free_thread_blocks.begin());
+		running_thread_blocks.back()->Reset(thread_block_id, id_3d);
+	}
 	pending_thread_blocks.pop_front();
 }
 
@@ -124,7 +114,8 @@ void Grid::PushFinishedThreadBlock(std::unique_ptr<ThreadBlock> threadblock)
 
 void Grid::PopRunningThreadBlock()
 {
-	running_thread_blocks.pop_front();
+	free_thread_blocks.splice(free_thread_blocks.end(),
+			running_thread_blocks, running_thread_blocks.begin());
 }
 
 }	//namespace
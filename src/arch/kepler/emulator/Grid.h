@@ -79,18 +79,23 @@ class Grid
 	std::list<std::unique_ptr<ThreadBlock>> running_thread_blocks;
 	std::list<std::unique_ptr<ThreadBlock>> finished_thread_blocks;
 
+	// Thread-blocks that finished execution, kept to be recycled by the
+	// next thread-blocks of this grid. All thread-blocks of a grid have
+	// the same shape, so their warps and threads can be reused.
+	std::list<std::unique_ptr<ThreadBlock>> free_thread_blocks;
+
 	// Iterators
 	std::list<Grid *>::iterator grid_list_iter;
 	std::list<Grid *>::iterator pending_grid_list_iter;
 	std::list<Grid *>::iterator running_grid_list_iter;
 	std::list<Grid *>::iterator finished_grid_list_iter;
 
+	// Function launched by the grid
+	Function *function;
+
 	// Instruction buffer size in bytes
 	int instruction_buffer_size;
 
-	// Instruction buffer contains the all the instructions in the kernel binary
-	std::vector<unsigned long long> instruction_buffer;
-
 	// Shared memory top pointer
 	unsigned shared_memory_top;
 
@@ -142,11 +147,9 @@ public:
 		return thread_block_count3[index];
 	}
 
-	/// Get instruction buffer
-	std::vector<unsigned long long>::iterator getInstructionBuffer()
-	{
-		return instruction_buffer.begin();
-	}
+	/// Return the array of decoded instructions of the kernel function,
+	/// indexed by their offset divided by the instruction size
+	Instruction *getInstructions() { return function->getInstructions(); }
 
 	/// Get instruction buffer size
 	unsigned getInstructionBufferSize() const
@@ -188,13 +191,15 @@ public:
 	void GridSetupConstantMemory();
 
 	/// pop an element from pending thread block list,
-	/// and create a new thread block pushing into running thread block list
+	/// and create a new thread block pushing into running thread block list.
+	/// Thread-blocks released earlier are recycled.
 	void WaitingToRunning(int thread_block_id, unsigned *id_3d);
 
 	/// push a thread block into finished thread block list
 	void PushFinishedThreadBlock(std::unique_ptr<ThreadBlock> threadblock);
 
-	/// pop the front thread block out of running thread block list
+	/// pop the front thread block out of running thread block list, and
+	/// keep it to be recycled by the next thread block
 	void PopRunningThreadBlock();
 };
 
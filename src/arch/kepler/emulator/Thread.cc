@@ -34,7 +34,6 @@ Thread::Thread(Warp *warp, int id)
 	this->warp = warp;
 	thread_block = warp->getThreadBlock();
 	grid = thread_block->getGrid();
-	this->id = id + thread_block->getId() * grid->getThreadBlockSize();
 	id_in_warp = id % warp_size;
 	id_in_thread_block = id;
 
@@ -43,6 +42,25 @@ Thread::Thread(Warp *warp, int id)
 	local_memory->setSafe(false);
 	local_memory_size = 1 << 20; // current 1MB for local memory
 	local_memory_top_address = 0;
+
+	// Initialization instruction table
+#define DEFINST(_name, _fmt_str, ...) \
+		inst_func[Instruction::INST_##_name] = &Thread::ExecuteInst_##_name;
+#include "../disassembler/Instruction.def"
+#undef DEFINST
+}
+
+
+void Thread::Reset()
+{
+	// Local identifier
+	int id = id_in_thread_block;
+
+	// Global identifier
+	this->id = id + thread_block->getId() * grid->getThreadBlockSize();
+
+	// Local memory starts empty
+	local_memory->Clear();
 	local_memory_top_generic_address = local_memory_top_address + id *
 			local_memory_size +	emulator->getGlobalMemoryTotalSize() +
 			emulator->getSharedMemoryTotalSize();
@@ -51,12 +69,6 @@ Thread::Thread(Warp *warp, int id)
 	emulator->WriteConstantMemory(0x24, sizeof(unsigned),
 			(const char *) &local_memory_top_generic_address);
 
-	// Initialization instruction table
-#define DEFINST(_name, _fmt_str, ...) \
-		inst_func[Instruction::INST_##_name] = &Thread::ExecuteInst_##_name;
-#include "../disassembler/Instruction.def"
-#undef DEFINST
-
 	// Initialize  general purpose registers
 	for (int i = 0; i < 256; ++i)
 		WriteGPR(i, 0);
@@ -135,6 +135,11 @@ public :
 	/// \id Global 1D identifier of the thread
 	Thread(Warp *warp, int id);
 
+	/// Return the thread to its initial state, taking its global
+	/// identifier from the current identifier of its thread-block. This
+	/// is used when the thread-block is created or recycled.
+	void Reset();
+
 	/// Get global id
 	unsigned getId() const { return id; }
 
@@ -44,8 +44,6 @@ ThreadBlock::ThreadBlock(Grid *grid, int id, unsigned *id_3d)
 	// Initialization
 	this->id = id;
 	this->grid = grid;
-	for(int i = 0; i < 3; i++)
-		this->id_3d[i] = id_3d[i];
 
 	// Create warps
 	warp_count = (grid->getThreadBlockSize() + warp_size - 1) /
@@ -75,6 +73,21 @@ ThreadBlock::ThreadBlock(Grid *grid, int id, unsigned *id_3d)
 	shared_memory = misc::new_unique<mem::Memory>();
 	shared_memory->setSafe(false);
 	shared_memory_size = (1 << 20); // current 1MB for local memory
+
+	// Initial state
+	Reset(id, id_3d);
+}
+
+
+void ThreadBlock::Reset(int id, unsigned *id_3d)
+{
+	// Initialization
+	this->id = id;
+	for(int i = 0; i < 3; i++)
+		this->id_3d[i] = id_3d[i];
+
+	// Shared memory starts empty
+	shared_memory->Clear();
 	shared_memory_top_address = 0;
 	shared_memory_top_generic_address = shared_memory_top_address + id *
 				shared_memory_size + emulator->getGlobalMemoryTotalSize();
@@ -84,6 +97,12 @@ ThreadBlock::ThreadBlock(Grid *grid, int id, unsigned *id_3d)
 	emulator->WriteConstantMemory(0x20, sizeof(unsigned),
 			(char *) &shared_memory_top_generic_address);
 
+	// Reset warps and threads
+	for (auto &warp : warps)
+		warp->Reset();
+	for (auto &thread : threads)
+		thread->Reset();
+
 	/* Flags */
 	finished_emu = false;
 	num_warps_completed_emu = 0;
@@ -109,6 +109,11 @@ public:
 	/// \param id Thread-block global 1D ID
 	ThreadBlock(Grid *grid, int id, unsigned *id_3d);
 
+	/// Return the thread-block to its initial state, as if it was just
+	/// created with identifiers \a id and \a id_3d. This is used when the
+	/// thread-block is recycled for another thread-block of the same grid.
+	void Reset(int id, unsigned *id_3d);
+
 	/// Dump thread-block in human readable format into output stream
 	void Dump(std::ostream &os = std::cout) const;
 
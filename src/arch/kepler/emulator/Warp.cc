@@ -34,15 +34,9 @@
 namespace Kepler
 {
 
-Warp::Warp(ThreadBlock *thread_block, unsigned id):inst(Instruction())
+Warp::Warp(ThreadBlock *thread_block, unsigned id)
 {
-
-	unsigned am = 0;
-
 	// Initialization
-	// Calculate the warp ID in grid
-	this->id = id + thread_block->getId() * thread_block->getWarpCount();
-
 	// Get the ID in thread block
 	id_in_thread_block = id;
 
@@ -63,6 +57,24 @@ Warp::Warp(ThreadBlock *thread_block, unsigned id):inst(Instruction())
 		thread_count = grid->getThreadBlockSize() -
 		(thread_block->getWarpCount() - 1) * warp_size;
 
+	// Function name
+	kernel_function_name = grid->getKernelFunctionName();
+
+	// Instruction
+	inst_size = 8;
+	instructions = grid->getInstructions();
+	instruction_buffer_size = grid->getInstructionBufferSize();
+}
+
+
+void Warp::Reset()
+{
+	unsigned am = 0;
+
+	// Calculate the warp ID in grid
+	id = id_in_thread_block + thread_block->getId() *
+			thread_block->getWarpCount();
+
 	// Return Address Stack
 	return_stack = std::unique_ptr<ReturnAddressStack>(new ReturnAddressStack());
 	// SyncStack
@@ -79,16 +91,9 @@ Warp::Warp(ThreadBlock *thread_block, unsigned id):inst(Instruction())
 
 	this->getSyncStack()->get()->setActiveMask(am);
 
-	// Function name
-	kernel_function_name = grid->getKernelFunctionName();
-
 	// Instruction
 	pc = 0;
 	target_pc = 0;
-	inst_size = 8;
-	instruction_buffer = grid->getInstructionBuffer();
-	instruction_buffer_size = grid->getInstructionBufferSize();
-
 
 	// Reset flags
 	at_barrier_thread_count = 0;
@@ -118,50 +123,50 @@ void Warp::Execute()
 	// Get emu instance
 	Emulator *emulator = Emulator::getInstance();
 
-	// Instruction binary
-	Instruction::Bytes inst_bytes;
-
-	// Instruction opcode
-	Instruction::Opcode inst_op;
+	// Instruction at the current PC, decoded when the function was loaded
+	Instruction *inst = &instructions[pc / inst_size];
 
-	// Read instruction binary
-	inst_bytes.as_uint[0] = instruction_buffer[pc / inst_size] >> 32;
-	inst_bytes.as_uint[1] = instruction_buffer[pc / inst_size];
+	// Index of the last thread in the warp
+	unsigned last_id_in_warp = thread_count - 1;
 
-	// Decode instruction
-	if( pc % 64)
+	// Every 64 bytes, the instruction is replaced by a scheduling word
+	// which only has effect on the first and last threads
+	if (!(pc % 64))
 	{
-			inst.Decode((const char *) &inst_bytes, pc);
-
-			// Execute instruction
-			inst_op = (Instruction::Opcode) inst.getOpcode();
-
-			if (!inst_op)
-			{
-				std::cerr << __FILE__ << ":" << __LINE__ << ": unrecognized instruction "
-					<< std::hex << " pc " << pc << std::endl;
-				misc::Panic("Simulation exits with exception.\n");
-			}
-
-			for (auto thread_id = threads_begin; thread_id < threads_end; ++thread_id)
-			{
-				/*
-				if (thread_id->get()->getId() == 0)
-				std::cerr << inst.getName() << " id " << thread_id->get()->getId()
-						<< " warp_id " << id << " thread count " << this->thread_count
-						<< " block id " << thread_block->getId()
-						<< " warp count " << thread_block->getWarpCount()
-						<< " pc " << pc << std::endl;
-						*/
-				thread_id->get()->Execute(inst_op,&inst);
-			}
+		threads_begin[0]->ExecuteSpecial();
+		if (last_id_in_warp)
+			threads_begin[last_id_in_warp]->ExecuteSpecial();
 	}
 	else
 	{
-			for (auto thread_id = threads_begin; thread_id < threads_end; ++thread_id)
-			{
-				thread_id->get()->ExecuteSpecial();
-			}
+		// Execute instruction
+		Instruction::Opcode inst_op = (Instruction::Opcode)
+				inst->getOpcode();
+
+		if (!inst_op)
+		{
+			std::cerr << __FILE__ << ":" << __LINE__ << ": unrecognized instruction "
+				<< std::hex << " pc " << pc << std::endl;
+			misc::Panic("Simulation exits with exception.\n");
+		}
+
+		// The first thread pops the synchronization stack when the
+		// warp reaches a reconvergence point, and the last thread
+		// updates the state of the warp. Any other thread only updates
+		// its own state and its own bit of the active mask, so it is
+		// skipped when its bit is clear after the first thread runs.
+		threads_begin[0]->Execute(inst_op, inst);
+		if (last_id_in_warp)
+		{
+			unsigned active_mask = getSyncStack()->get()->
+					getActiveMask();
+			for (unsigned id_in_warp = 1; id_in_warp < last_id_in_warp;
+					id_in_warp++)
+				if ((active_mask >> id_in_warp) & 1)
+					threads_begin[id_in_warp]->Execute(inst_op,
+							inst);
+			threads_begin[last_id_in_warp]->Execute(inst_op, inst);
+		}
 	}
 
 	// Finish
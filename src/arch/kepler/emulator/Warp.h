@@ -87,11 +87,8 @@ class Warp
 	// Target PC for next instruction
 	int target_pc;
 
-	// Current instruction
-	Instruction inst;
-
-	// Pointer points to the starting position of instruction buffer
-	std::vector<unsigned long long>::iterator instruction_buffer;
+	// Decoded instructions of the kernel function
+	Instruction *instructions;
 
 	// The whole instruction buffer size in bytes
 	unsigned instruction_buffer_size;
@@ -150,6 +147,11 @@ public:
 	///	Global 1D identifier of the warp
 	Warp(ThreadBlock *thread_block, unsigned id);
 
+	/// Return the warp to its initial state, taking its global identifier
+	/// from the current identifier of its thread-block. This is used when
+	/// the thread-block is created or recycled.
+	void Reset();
+
 	/// Return the global warp 1D ID
 	int getId() const { return id; }
 
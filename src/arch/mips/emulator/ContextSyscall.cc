@@ -82,6 +82,9 @@ void Context::ExecuteSyscall()
 	// context got suspended, the wake up routine will set the return value.
 	if (/*code != SyscallCode_sigreturn &&*/ !getState(ContextSuspended))
 		regs.setGPR(2,ret);
+
+	// Let other contexts run
+	emulator->EndQuantum();
 }
 
 
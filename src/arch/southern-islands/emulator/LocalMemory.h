@@ -0,0 +1,76 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2012  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef ARCH_SOUTHERN_ISLANDS_EMU_LOCAL_MEMORY_H
+#define ARCH_SOUTHERN_ISLANDS_EMU_LOCAL_MEMORY_H
+
+#include <cstring>
+#include <vector>
+
+
+namespace SI
+{
+
+/// Local data share (LDS) of a work-group. The LDS is a small and dense
+/// memory region, so it is stored in a contiguous array instead of the
+/// paged memory used for global memory. Every access is checked against
+/// the size of the array.
+class LocalMemory
+{
+	// Contents of the local memory
+	std::vector<char> data;
+
+	// Throw an error for an access out of bounds
+	[[noreturn]] void AccessError(unsigned address, unsigned size) const;
+
+public:
+
+	/// Maximum size of the local memory of a work-group in bytes
+	static const unsigned MaxSize = 65536;
+
+	/// Discard the contents of the local memory and set its size to
+	/// \a size bytes, all initialized to zero.
+	void Reset(unsigned size);
+
+	/// Return the size of the local memory in bytes
+	unsigned getSize() const { return data.size(); }
+
+	/// Read \a size bytes at \a address into \a buffer. An exception of
+	/// type Emulator::Error is thrown if the access is out of bounds.
+	void Read(unsigned address, unsigned size, char *buffer) const
+	{
+		if (address > data.size() || size > data.size() - address)
+			AccessError(address, size);
+		memcpy(buffer, data.data() + address, size);
+	}
+
+	/// Write \a size bytes from \a buffer into \a address. An exception of
+	/// type Emulator::Error is thrown if the access is out of bounds.
+	void Write(unsigned address, unsigned size, const char *buffer)
+	{
+		if (address > data.size() || size > data.size() - address)
+			AccessError(address, size);
+		memcpy(data.data() + address, buffer, size);
+	}
+};
+
+
+}  // namespace SI
+
+#endif
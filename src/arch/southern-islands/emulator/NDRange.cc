@@ -17,6 +17,8 @@
  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <iterator>
+
 #include <arch/southern-islands/disassembler/Argument.h>
 #include <arch/southern-islands/driver/Driver.h>
 #include <arch/southern-islands/driver/Kernel.h>
@@ -329,13 +331,23 @@ void NDRange::AddWorkgroupIdToWaitingList(long work_group_id)
 
 WorkGroup *NDRange::ScheduleWorkGroup(unsigned id)
 {
-	// Create work-group
-	auto it = work_groups.emplace(work_groups.end(),
-			misc::new_unique<WorkGroup>(this, id));
+	// Recycle a work-group released earlier, or create a new one
+	WorkGroup *work_group;
+	if (free_work_groups.empty())
+	{
+		work_groups.emplace_back(misc::new_unique<WorkGroup>(this, id));
+		work_group = work_groups.back().get();
+	}
+	else
+	{
+		work_groups.splice(work_groups.end(), free_work_groups,
+				free_work_groups.begin());
+		work_group = work_groups.back().get();
+		work_group->Reset(id);
+	}
 	
 	// Save iterator
-	WorkGroup *work_group = work_groups.back().get();
-	work_group->work_groups_iterator = it;
+	work_group->work_groups_iterator = std::prev(work_groups.end());
 
 	// Debug info
 	Emulator::scheduler_debug <<
@@ -356,9 +368,11 @@ void NDRange::RemoveWorkGroup(WorkGroup *work_group)
 			"work group %d removed\n",
 			id, work_group->getId());
 
-	// Erase work group
+	// Move work group to the list of free work-groups
 	assert(work_group->work_groups_iterator != work_groups.end());
-	work_groups.erase(work_group->work_groups_iterator);
+	free_work_groups.splice(free_work_groups.end(), work_groups,
+			work_group->work_groups_iterator);
+	work_group->work_groups_iterator = work_groups.end();
 }
 
 void NDRange::WakeupContext()
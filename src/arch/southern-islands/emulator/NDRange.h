@@ -131,6 +131,12 @@ private:
 	// Work-groups allocated for this ND-Range
 	std::list<std::unique_ptr<WorkGroup>> work_groups;
 
+	// Work-groups that finished execution, kept to be recycled by the
+	// next work-groups scheduled in this ND-Range. All work-groups of an
+	// ND-Range have the same shape, so their wavefronts, work-items, and
+	// register files can be reused.
+	std::list<std::unique_ptr<WorkGroup>> free_work_groups;
+
 	// Work-group list of pending work groups, IDs only
 	std::deque<long> waiting_work_groups;
 
@@ -255,6 +261,9 @@ public:
 
 	/// Get num_vgpr_used
 	unsigned getNumVgprUsed() const { return num_vgpr_used; }
+
+	/// Get num_sgpr_used
+	unsigned getNumSgprUsed() const { return num_sgpr_used; }
 	
 	/// Get pointer to local_mem_top
 	int *getLocalMemTopPtr() { return &local_mem_top; }
@@ -17,6 +17,9 @@
  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <algorithm>
+#include <cstring>
+
 #include <arch/southern-islands/disassembler/Disassembler.h>
 #include <arch/southern-islands/disassembler/Instruction.h>
 #include <lib/cpp/Debug.h>
@@ -109,8 +112,75 @@ void Wavefront::setSregUint(int sreg, unsigned int value)
 Wavefront::Wavefront(WorkGroup *work_group, int id)
 {
 	this->work_group = work_group;
+
+	// Size the vector register file with the number of registers used by
+	// the kernel. Registers V0-V2 are always initialized with the
+	// work-item local IDs. If the kernel metadata is not available, all
+	// 256 registers are allocated.
+	num_vregs = work_group->getNDRange()->getNumVgprUsed();
+	if (num_vregs <= 0 || num_vregs > 256)
+		num_vregs = 256;
+	num_vregs = std::max(num_vregs, 3);
+	vregs.reset(new Instruction::Register[num_vregs *
+			WorkGroup::WavefrontSize]);
+
+	// Get emulator instance
+	Emulator *emulator = Emulator::getInstance();
+
+	// Create scalar work item
+	this->scalar_work_item.reset(new WorkItem(this, 0));
+	scalar_work_item->setWorkGroup(this->work_group);
+	scalar_work_item->setGlobalMemory(emulator->getGlobalMemory());
+
+	// Initial state
+	Reset(id);
+}
+
+
+void Wavefront::Reset(int id)
+{
 	this->id = id;
 
+	// Work-items are assigned by the work-group
+	work_item_id_first = 0;
+	work_item_id_last = 0;
+	work_item_count = 0;
+
+	// Execution state
+	data.reset();
+	pc = 0;
+	instruction.reset();
+	inst_size = 0;
+	wavefront_pool_entry = nullptr;
+	barrier_instruction = false;
+	uop_id_counter = 0;
+	id_in_compute_unit = 0;
+	vector_memory_read = false;
+	vector_memory_write = false;
+	vector_memory_atomic = false;
+	scalar_memory_read = false;
+	lds_read = false;
+	lds_write = false;
+	memory_wait = false;
+	at_barrier = false;
+	finished = false;
+	vector_memory_global_coherency = false;
+
+	// Statistics
+	scalar_memory_instruction_count = 0;
+	scalar_alu_instruction_count = 0;
+	branch_instruction_count = 0;
+	vector_memory_instruction_count = 0;
+	vector_alu_instruction_count = 0;
+	global_mem_instruction_count = 0;
+	lds_instruction_count = 0;
+	export_instruction_count = 0;
+
+	// Clear registers
+	memset(sreg, 0, sizeof sreg);
+	memset(vregs.get(), 0, num_vregs * WorkGroup::WavefrontSize *
+			sizeof(Instruction::Register));
+
 	// Integer inline constants.
 	for(int i = 128; i < 193; i++)
 		sreg[i].as_int = i - 128;
@@ -126,23 +196,6 @@ Wavefront::Wavefront(WorkGroup *work_group, int id)
 	sreg[245].as_float = -2.0;
 	sreg[246].as_float = 4.0;
 	sreg[247].as_float = -4.0;
-
-	// FIXME:: Create work items at here ?
-	// self->work_items = xcalloc(si_emu_wavefront_size, sizeof(void *));
-	// for(auto i = work_items_begin; i != work_items_end; ++i)
-	// {
-	// 	self->work_items[work_item_id] = new(SIWorkItem, work_item_id, self);
-	// 	self->work_items[work_item_id]->work_group = work_group;
-	// 	self->work_items[work_item_id]->id_in_wavefront = work_item_id;
-	// }
-
-	// Get emulator instance
-	Emulator *emulator = Emulator::getInstance();
-
-	// Create scalar work item
-	this->scalar_work_item.reset(new WorkItem(this, 0));
-	scalar_work_item->setWorkGroup(this->work_group);
-	scalar_work_item->setGlobalMemory(emulator->getGlobalMemory());
 }
 
 
@@ -20,6 +20,7 @@
 #ifndef ARCH_SOUTHERN_ISLANDS_EMU_WAVEFRONT_H
 #define ARCH_SOUTHERN_ISLANDS_EMU_WAVEFRONT_H
 
+#include <cassert>
 #include <memory>
 #include <vector>
 
@@ -89,6 +90,15 @@ class Wavefront
 	// Scalar registers
 	Instruction::Register sreg[256];
 
+	// Number of vector registers per work-item, as given by the kernel
+	// metadata
+	int num_vregs = 0;
+
+	// Vector registers of all work-items in the wavefront, allocated in
+	// one contiguous block. The registers of the work-item in lane 'i'
+	// start at position 'i * num_vregs'.
+	std::unique_ptr<Instruction::Register[]> vregs;
+
 	// Associated wavefront pool entry
 	WavefrontPoolEntry *wavefront_pool_entry = nullptr;
 
@@ -138,6 +148,12 @@ public:
 	///
 	Wavefront(WorkGroup *work_group, int id);
 
+	/// Return the wavefront to its initial state, as if it was just
+	/// created with identifier \a id. This is used when the work-group
+	/// that it belongs to is recycled for another work-group of the same
+	/// ND-Range. The vector register file is preserved, but cleared.
+	void Reset(int id);
+
 	// Counter for per-wavefront identifiers assigned to uops in the timing
 	// simulator.
 	long long uop_id_counter = 0;
@@ -230,6 +246,20 @@ public:
 	/// Get work_item_count
 	unsigned getWorkItemCount() const { return work_item_count; }
 
+	/// Return the number of vector registers allocated per work-item
+	int getNumVregs() const { return num_vregs; }
+
+	/// Return vector register \a vreg of the work-item in lane
+	/// \a id_in_wavefront. The register index is not checked in release
+	/// builds. Callers that take it from a kernel use
+	/// WorkItem::ReadVReg() and WorkItem::WriteVReg() instead.
+	Instruction::Register &getVreg(int id_in_wavefront, int vreg)
+	{
+		assert(id_in_wavefront >= 0 && id_in_wavefront < 64);
+		assert(vreg >= 0 && vreg < num_vregs);
+		return vregs[id_in_wavefront * num_vregs + vreg];
+	}
+
 	/// Get the associated instruction
 	Instruction *getInstruction() const { return instruction.get(); }
 
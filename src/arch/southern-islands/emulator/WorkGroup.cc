@@ -34,26 +34,11 @@ const unsigned WorkGroup::WavefrontSize = 64;
 WorkGroup::WorkGroup(NDRange *ndrange, unsigned id)
 {
 	// Initialize
-	this->id = id;
 	this->ndrange = ndrange;
-	
-	// Initially, the work-group's position in the ND-Range's list of
-	// work-groups is invalid.
-	work_groups_iterator = ndrange->getWorkGroupsEnd();
-
-	// Initialize local memory
-	local_memory.setSafe(false);
 
 	// Emulator instance
 	Emulator *emulator = Emulator::getInstance();
 
-	unsigned lid;
-	unsigned lidx, lidy, lidz;
-	unsigned tid;
-	unsigned work_item_gidx_start;
-	unsigned work_item_gidy_start;
-	unsigned work_item_gidz_start;
-
 	// Number of work-items in work-group 
 	unsigned work_items_per_group = ndrange->getLocalSize(0) * 
 		ndrange->getLocalSize(1) * ndrange->getLocalSize(2);
@@ -88,6 +73,61 @@ WorkGroup::WorkGroup(NDRange *ndrange, unsigned id)
 		}
 	}
 
+	// Initial state
+	Reset(id);
+}
+
+
+void WorkGroup::Reset(unsigned id)
+{
+	// Initialize
+	this->id = id;
+	wavefronts_at_barrier = 0;
+	wavefronts_completed_emu = 0;
+	wavefronts_completed_timing = 0;
+	finished = false;
+	data.reset();
+	sreg_read_count = 0;
+	sreg_write_count = 0;
+	vreg_read_count = 0;
+	vreg_write_count = 0;
+	id_in_compute_unit = 0;
+	finished_timing = false;
+	inflight_instructions = 0;
+	wavefront_pool = nullptr;
+	
+	// Initially, the work-group's position in the ND-Range's list of
+	// work-groups is invalid.
+	work_groups_iterator = ndrange->getWorkGroupsEnd();
+
+	// Local memory, sized with the amount used by the kernel, including
+	// local arguments. Pixel shaders use it as a parameter cache, which is
+	// not described by the kernel metadata.
+	unsigned local_memory_size = ndrange->getStage() ==
+			NDRange::StagePixelShader ? LocalMemory::MaxSize :
+			ndrange->getLocalMemTop();
+	if (local_memory_size > LocalMemory::MaxSize)
+		throw Emulator::Error(misc::fmt("%u bytes of local memory "
+				"requested, but the maximum is %u",
+				local_memory_size, LocalMemory::MaxSize));
+	local_memory.Reset(local_memory_size);
+
+	unsigned lid;
+	unsigned lidx, lidy, lidz;
+	unsigned tid;
+	unsigned work_item_gidx_start;
+	unsigned work_item_gidy_start;
+	unsigned work_item_gidz_start;
+
+	// Number of work-items in work-group 
+	unsigned work_items_per_group = ndrange->getLocalSize(0) * 
+		ndrange->getLocalSize(1) * ndrange->getLocalSize(2);
+
+	// Reset wavefronts
+	unsigned wavefronts_per_group = wavefronts.size();
+	for (unsigned i = 0; i < wavefronts_per_group; ++i)
+		wavefronts[i]->Reset(id * wavefronts_per_group + i);
+
 	// Initialize work-group and work-item metadata 
 	id_3d[0] = id % ndrange->getGroupCount(0);
 	id_3d[1] = (id / ndrange->getGroupCount(0)) % 
@@ -26,8 +26,8 @@
 #include <vector>
 
 #include <arch/southern-islands/timing/WavefrontPool.h>
-#include <memory/Memory.h>
 
+#include "LocalMemory.h"
 #include "Wavefront.h"
 #include "WorkItem.h"
 
@@ -86,7 +86,7 @@ class WorkGroup
 	std::vector<std::unique_ptr<Wavefront>> wavefronts;
 
 	// Local memory
-	mem::Memory local_memory;
+	LocalMemory local_memory;
 
 	// Additional work-group data
 	std::unique_ptr<WorkGroupData> data;
@@ -114,6 +114,12 @@ public:
 	///	Work-group global 1D identifier
 	WorkGroup(NDRange *ndrange, unsigned id);
 
+	/// Return the work-group to its initial state, as if it was just
+	/// created with identifier \a id. The wavefronts and work-items
+	/// allocated by the constructor are reused. This is used by the
+	/// ND-Range to recycle work-groups that finished execution.
+	void Reset(unsigned id);
+
 	/// Dump work-group in human readable format into output stream
 	void Dump(std::ostream &os = std::cout) const;
 
@@ -214,7 +220,7 @@ public:
 	bool getFinished() { return finished; }
 
 	/// Get a pointer to the local memory of the work group
-	mem::Memory *getLocalMemory() { return &local_memory; }
+	LocalMemory *getLocalMemory() { return &local_memory; }
 
 
 
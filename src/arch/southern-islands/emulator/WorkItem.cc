@@ -19,6 +19,7 @@
 
 #include <lib/cpp/Misc.h>
 
+#include "Emulator.h"
 #include "Wavefront.h"
 #include "WorkItem.h"
 #include "WorkGroup.h"
@@ -273,24 +274,37 @@ void WorkItem::WriteSReg(int sreg,
 }
 
 
-unsigned WorkItem::ReadVReg(int vreg)
+void WorkItem::CheckVReg(int vreg) const
 {
-	assert(vreg >= 0);
-	assert(vreg < 256);
+	int num_vregs = wavefront->getNumVregs();
+	if (vreg < 0 || vreg >= num_vregs)
+		throw Emulator::Error(misc::fmt("Access to vector register "
+				"v%d, but the kernel only allocates %d vector "
+				"registers", vreg, num_vregs));
+}
 
+
+unsigned WorkItem::ReadVReg(int vreg)
+{
 	// Statistics
 	work_group->incVregReadCount();
 
-	return this->vreg[vreg].as_uint;
+	// Check register index
+	CheckVReg(vreg);
+
+	// Registers are stored in the wavefront
+	return wavefront->getVreg(id_in_wavefront, vreg).as_uint;
 }
 
 
 void WorkItem::WriteVReg(int vreg, 
 	unsigned value)
 {
-	assert(vreg >= 0);
-	assert(vreg < 256);
-	this->vreg[vreg].as_uint = value;
+	// Check register index
+	CheckVReg(vreg);
+
+	// Registers are stored in the wavefront
+	wavefront->getVreg(id_in_wavefront, vreg).as_uint = value;
 
 	// Statistics
 	work_group->incVregWriteCount();
@@ -23,6 +23,8 @@
 #include <arch/southern-islands/disassembler/Instruction.h>
 #include <memory/Memory.h>
 
+#include "LocalMemory.h"
+
 
 namespace SI
 {
@@ -191,10 +193,11 @@ private:
 	mem::Memory *global_mem = nullptr;
 	
 	// Local memory
-	mem::Memory *lds = nullptr;
+	LocalMemory *lds = nullptr;
 
-	// Vector registers
-	Instruction::Register vreg[256];
+	// Throw an error if vector register \a vreg is not allocated by the
+	// kernel
+	void CheckVReg(int vreg) const;
 
 	// Emulation of ISA. This code expands to one function per ISA
 	// instruction. For example: ISA_s_mov_b32_Impl(Instruction *inst)
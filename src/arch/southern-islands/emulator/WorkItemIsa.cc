@@ -6368,13 +6368,15 @@ void WorkItem::ISA_DS_WRITE2_B32_Impl(Instruction *instruction)
 	data0.as_uint = ReadVReg(INST.data0);
 	data1.as_uint = ReadVReg(INST.data1);
 
-	if (addr0.as_uint > std::min(work_group->getNDRange()->getLocalMemTop(),
-		ReadSReg(Instruction::RegisterM0)))
+	// The whole Dword must fit below the limit, the same exclusive bound
+	// that the local memory checks.
+	unsigned limit = std::min(work_group->getNDRange()->getLocalMemTop(),
+		ReadSReg(Instruction::RegisterM0));
+	if (limit < 4 || addr0.as_uint > limit - 4)
 	{
 		throw Emulator::Error("Invalid local memory address");
 	}
-	if (addr1.as_uint > std::min(work_group->getNDRange()->getLocalMemTop(),
-		ReadSReg(Instruction::RegisterM0)))
+	if (addr1.as_uint > limit - 4)
 	{
 		throw Emulator::Error("Invalid local memory address");
 	}
@@ -6444,8 +6446,10 @@ void WorkItem::ISA_DS_WRITE_B32_Impl(Instruction *instruction)
 	addr.as_uint = ReadVReg(INST.addr);
 	data0.as_uint = ReadVReg(INST.data0);
 
-	if (addr.as_uint > std::min(work_group->getNDRange()->getLocalMemTop(), 
-		ReadSReg(Instruction::RegisterM0)))
+	// The whole Dword must fit below the limit
+	unsigned limit = std::min(work_group->getNDRange()->getLocalMemTop(),
+		ReadSReg(Instruction::RegisterM0));
+	if (limit < 4 || addr.as_uint > limit - 4)
 	{
 		throw Emulator::Error("Invalid local memory address");
 	}
@@ -73,9 +73,8 @@ void BranchUnit::Issue(std::unique_ptr<Uop> uop)
 
 void BranchUnit::Complete()
 {
-	// Get compute unit and GPU objects
+	// Get compute unit object
 	ComputeUnit *compute_unit = getComputeUnit();
-	Gpu *gpu = compute_unit->getGpu();
 
 	// Sanity check the write buffer
 	assert((int) write_buffer.size() <= write_latency * width);
@@ -88,7 +87,7 @@ void BranchUnit::Complete()
 		Uop *uop = it->get();
 
 		// Break if uop is not ready
-		if (compute_unit->getTiming()->getCycle() < uop->write_ready)
+		if (compute_unit->getCycle() < uop->write_ready)
 			break;
 	
 		// Record trace
@@ -100,6 +99,7 @@ void BranchUnit::Complete()
 
 		// Allow next instruction to be fetched
 		uop->getWavefrontPoolEntry()->ready = true;
+		uop->getWavefrontPoolEntry()->Wakeup();
 
 		// Access complete, remove the uop from the queue, and get the
 		// iterator for the next element
@@ -111,7 +111,7 @@ void BranchUnit::Complete()
 
 		// Statistics
 		num_instructions++;
-		gpu->last_complete_cycle = compute_unit->getTiming()->getCycle();
+		compute_unit->last_complete_cycle = compute_unit->getCycle();
 	}
 }
 
@@ -137,7 +137,7 @@ void BranchUnit::Write()
 		instructions_processed++;
 
 		// Break if uop is not ready
-		if (compute_unit->getTiming()->getCycle() < uop->execute_ready)
+		if (compute_unit->getCycle() < uop->execute_ready)
 			break;
 	
 		// Stall if width has been reached
@@ -179,8 +179,7 @@ void BranchUnit::Write()
 
 
 		// Update Uop write ready cycle
-		uop->write_ready = compute_unit->getTiming()->
-			getCycle() + write_latency;
+		uop->write_ready = compute_unit->getCycle() + write_latency;
 
 		// Trace
 		Timing::trace << misc::fmt("si.inst "
@@ -223,7 +222,7 @@ void BranchUnit::Execute()
 		instructions_processed++;
 
 		// Break if uop is not ready
-		if (compute_unit->getTiming()->getCycle() < uop->read_ready)
+		if (compute_unit->getCycle() < uop->read_ready)
 			break;
 	
 		// Stall if width has been reached
@@ -265,8 +264,7 @@ void BranchUnit::Execute()
 
 
 		// Update Uop exec ready cycle
-		uop->execute_ready = compute_unit->getTiming()->
-			getCycle() + exec_latency;
+		uop->execute_ready = compute_unit->getCycle() + exec_latency;
 
 		// Trace
 		Timing::trace << misc::fmt("si.inst "
@@ -309,7 +307,7 @@ void BranchUnit::Read()
 		instructions_processed++;
 
 		// Break if uop is not ready
-		if (compute_unit->getTiming()->getCycle() < uop->decode_ready)
+		if (compute_unit->getCycle() < uop->decode_ready)
 			break;
 	
 		// Stall if width has been reached
@@ -351,8 +349,7 @@ void BranchUnit::Read()
 
 
 		// Update Uop read ready cycle
-		uop->read_ready = compute_unit->getTiming()->
-			getCycle() + read_latency;
+		uop->read_ready = compute_unit->getCycle() + read_latency;
 
 		// Trace
 		Timing::trace << misc::fmt("si.inst "
@@ -395,7 +392,7 @@ void BranchUnit::Decode()
 		instructions_processed++;
 
 		// Break if uop is not ready
-		if (compute_unit->getTiming()->getCycle() < uop->issue_ready)
+		if (compute_unit->getCycle() < uop->issue_ready)
 			break;
 	
 		// Stall if width has been reached
@@ -437,8 +434,7 @@ void BranchUnit::Decode()
 
 
 		// Update Uop write ready cycle
-		uop->decode_ready = compute_unit->getTiming()->
-			getCycle() + decode_latency;
+		uop->decode_ready = compute_unit->getCycle() + decode_latency;
 
 		// Trace
 		Timing::trace << misc::fmt("si.inst "
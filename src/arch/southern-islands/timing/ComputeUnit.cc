@@ -103,7 +103,7 @@ void ComputeUnit::IssueToExecutionUnit(FetchBuffer *fetch_buffer,
 				continue;
 
 			// Skip uops that have not completed fetch
-			if (timing->getCycle() < uop->fetch_ready)
+			if (getCycle() < uop->fetch_ready)
 				continue;
 
 			// Save oldest uop
@@ -169,7 +169,7 @@ void ComputeUnit::Issue(FetchBuffer *fetch_buffer)
 		Uop *uop = it->get();
 
 		// Skip uops that have not completed fetch
-		if (timing->getCycle() < uop->fetch_ready)
+		if (getCycle() < uop->fetch_ready)
 			continue;
 
 		// Trace
@@ -198,21 +198,22 @@ void ComputeUnit::Fetch(FetchBuffer *fetch_buffer,
 	// Set up variables
 	int instructions_processed = 0;
 
-	// Fetch the instructions
-	for (auto it = wavefront_pool->begin(),
-			e = wavefront_pool->end();
-			it != e;
-			++it)
+	// Fetch the instructions. Only active entries are considered. Entries
+	// that are found blocked are removed from the list, and put back when
+	// the instruction in flight, memory accesses, or barrier they are
+	// waiting for complete.
+	for (auto it = wavefront_pool->getActiveEntriesBegin(),
+			e = wavefront_pool->getActiveEntriesEnd();
+			it != e;)
 	{
-		// Get wavefront pool entry
-		WavefrontPoolEntry *wavefront_pool_entry = it->get();
+		// Get wavefront pool entry, moving to the next one first, since
+		// the entry can be removed from the list.
+		WavefrontPoolEntry *wavefront_pool_entry = *it;
+		++it;
 
-		// Get wavefront
+		// Get wavefront. Active entries always have one.
 		Wavefront *wavefront = wavefront_pool_entry->getWavefront();
-
-		// No waverfront
-		if (!wavefront)
-			continue;
+		assert(wavefront);
 
 		// Check wavefront
 		assert(wavefront->getWavefrontPoolEntry());
@@ -235,7 +236,11 @@ void ComputeUnit::Fetch(FetchBuffer *fetch_buffer,
 		// Wavefront is not ready (previous instructions is still
 		// in flight
 		if (!wavefront_pool_entry->ready)
+		{
+			wavefront_pool->RemoveFromActiveEntries(
+					wavefront_pool_entry);
 			continue;
+		}
 
 		// If the wavefront finishes, there still may be outstanding
 		// memory operations, so if the entry is marked finished
@@ -243,6 +248,8 @@ void ComputeUnit::Fetch(FetchBuffer *fetch_buffer,
 		if (wavefront_pool_entry->wavefront_finished)
 		{
 			assert(wavefront->getFinished());
+			wavefront_pool->RemoveFromActiveEntries(
+					wavefront_pool_entry);
 			continue;
 		}
 
@@ -252,6 +259,8 @@ void ComputeUnit::Fetch(FetchBuffer *fetch_buffer,
 		// be fetched.
 		if (wavefront->getFinished())
 		{
+			wavefront_pool->RemoveFromActiveEntries(
+					wavefront_pool_entry);
 			continue;
 		}
 
@@ -283,30 +292,44 @@ void ComputeUnit::Fetch(FetchBuffer *fetch_buffer,
 						wavefront->getWorkGroup()->
 						getId(),
 						wavefront->getId());
+				wavefront_pool->RemoveFromActiveEntries(
+						wavefront_pool_entry);
 				continue;
 			}
 		}
 
 		// Wavefront is ready but waiting at barrier
 		if (wavefront_pool_entry->wait_for_barrier)
+		{
+			wavefront_pool->RemoveFromActiveEntries(
+					wavefront_pool_entry);
 			continue;
+		}
 
 		// Stall if fetch buffer is full
 		assert(fetch_buffer->getSize() <= fetch_buffer_size);
 		if (fetch_buffer->getSize() == fetch_buffer_size)
 			continue;
 
-		// Emulate instructions
-		wavefront->Execute();
+		// Emulate instructions. The emulator is shared by all compute
+		// units, and uops take their identifiers from a global counter.
+		// In parallel simulation, compute units emulate instructions in
+		// the order in which host threads take the lock, so work-groups
+		// sharing global memory observe a nondeterministic interleaving.
+		std::unique_ptr<Uop> uop;
+		{
+			Gpu::FunctionalLock lock(gpu);
+			wavefront->Execute();
+			uop = misc::new_unique<Uop>(
+					wavefront,
+					wavefront_pool_entry,
+					getCycle(),
+					wavefront->getWorkGroup(),
+					fetch_buffer->getId());
+		}
 		wavefront_pool_entry->ready = false;
 
-		// Create uop
-		auto uop = misc::new_unique<Uop>(
-				wavefront,
-				wavefront_pool_entry,
-				timing->getCycle(),
-				wavefront->getWorkGroup(),
-				fetch_buffer->getId());
+		// Initialize uop
 		uop->vector_memory_read = wavefront->vector_memory_read;
 		uop->vector_memory_write = wavefront->vector_memory_write;
 		uop->vector_memory_atomic = wavefront->vector_memory_atomic;
@@ -399,7 +422,7 @@ void ComputeUnit::Fetch(FetchBuffer *fetch_buffer,
 		// Access instruction cache. Record the time when the
 		// instruction will have been fetched, as per the latency
 		// of the instruction memory.
-		uop->fetch_ready = timing->getCycle() + fetch_latency;
+		uop->fetch_ready = getCycle() + fetch_latency;
 
 		// Insert uop into fetch buffer
 		uop->getWorkGroup()->inflight_instructions++;
@@ -411,24 +434,61 @@ void ComputeUnit::Fetch(FetchBuffer *fetch_buffer,
 }
 
 
+WavefrontPool *ComputeUnit::FindWavefrontPool(
+		const WavefrontPool::WorkGroupResources &resources) const
+{
+	// Scalar registers are shared by all wavefront pools
+	if (num_scalar_registers + resources.num_scalar_registers >
+			Gpu::num_scalar_registers)
+		return nullptr;
+
+	// Find a wavefront pool
+	WavefrontPool *found = nullptr;
+	int found_first_free_entry = 0;
+	for (auto &wavefront_pool : wavefront_pools)
+	{
+		// Skip pools without room
+		if (!wavefront_pool->canMapWorkGroup(resources))
+			continue;
+
+		// Keep the pool with the lowest free entry
+		int first_free_entry = wavefront_pool->getFirstFreeEntry();
+		if (!found || first_free_entry < found_first_free_entry)
+		{
+			found = wavefront_pool.get();
+			found_first_free_entry = first_free_entry;
+		}
+	}
+	return found;
+}
+
+
+bool ComputeUnit::hasFreeEntries() const
+{
+	for (auto &wavefront_pool : wavefront_pools)
+		if (wavefront_pool->hasFreeEntries())
+			return true;
+	return false;
+}
+
+
 void ComputeUnit::MapWorkGroup(WorkGroup *work_group)
 {
 	// Checks
 	assert(work_group);
-	assert((int) work_groups.size() <= gpu->getWorkGroupsPerComputeUnit());
 	assert(!work_group->id_in_compute_unit);
 
+	// Find a wavefront pool with enough resources
+	WavefrontPool::WorkGroupResources resources =
+			gpu->getWorkGroupResources(work_group->getNDRange());
+	WavefrontPool *wavefront_pool = FindWavefrontPool(resources);
+	assert(wavefront_pool);
+
 	// Find an available slot
-	while (work_group->id_in_compute_unit < gpu->getWorkGroupsPerComputeUnit()
-			&& (work_group->id_in_compute_unit < 
-			(int) work_groups.size()) && 
-			(work_groups[work_group->id_in_compute_unit] != nullptr))
+	while (work_group->id_in_compute_unit < (int) work_groups.size() &&
+			work_groups[work_group->id_in_compute_unit] != nullptr)
 		work_group->id_in_compute_unit++;
 
-	// Checks
-	assert(work_group->id_in_compute_unit <
-			gpu->getWorkGroupsPerComputeUnit());
-
 	// Save timing simulator
 	timing = Timing::getInstance();
 
@@ -442,46 +502,22 @@ void ComputeUnit::MapWorkGroup(WorkGroup *work_group)
 	// Insert work group into the list
 	AddWorkGroup(work_group);
 
-	// Checks
-	assert((int) work_groups.size() <= gpu->getWorkGroupsPerComputeUnit());
-	
-	// If compute unit is not full, add it back to the available list
-	if ((int) work_groups.size() < gpu->getWorkGroupsPerComputeUnit())
-	{
-		if (!in_available_compute_units)
-			gpu->InsertInAvailableComputeUnits(this);
-	}
-
-	// Assign wavefront identifiers in compute unit
-	int wavefront_id = 0;
-	for (auto it = work_group->getWavefrontsBegin();
-			it != work_group->getWavefrontsEnd();
-			++it)
-	{
-		// Get wavefront pointer
-		Wavefront *wavefront = it->get();
+	// The compute unit is simulated while it has work groups
+	num_work_groups++;
+	if (!in_active_compute_units)
+		gpu->InsertInActiveComputeUnits(this);
 
-		// Set wavefront Id
-		wavefront->id_in_compute_unit = work_group->id_in_compute_unit *
-				work_group->getWavefrontsInWorkgroup() +
-				wavefront_id;
-
-		// Update internal counter
-		wavefront_id++;
-	}
+	// Insert wavefronts into an instruction buffer
+	work_group->wavefront_pool = wavefront_pool;
+	wavefront_pool->MapWavefronts(work_group, resources);
+	num_scalar_registers += resources.num_scalar_registers;
 
-	// Set wavefront pool for work group
-	int wavefront_pool_id = work_group->id_in_compute_unit %
-			num_wavefront_pools;
-	work_group->wavefront_pool = wavefront_pools[wavefront_pool_id].get();
+	// If compute unit is not full, add it back to the available list
+	if (hasFreeEntries() && !in_available_compute_units)
+		gpu->InsertInAvailableComputeUnits(this);
 
-	// Check if the wavefronts in the work group can fit into the wavefront
-	// pool
-	assert((int) work_group->getWavefrontsInWorkgroup() <=
-			max_wavefronts_per_wavefront_pool);
-
-	// Insert wavefronts into an instruction buffer
-	work_group->wavefront_pool->MapWavefronts(work_group);
+	// Account for the work group in the statistics of its NDRange
+	gpu->AddResidentWorkGroup(work_group->getNDRange());
 
 	// Increment count of mapped work groups
 	num_mapped_work_groups++;
@@ -515,9 +551,7 @@ void ComputeUnit::AddWorkGroup(WorkGroup *work_group)
 	// Add a work group only if the id in compute unit is the id for a new 
 	// work group in the compute unit's list
 	int index = work_group->id_in_compute_unit;
-	if (index == (int) work_groups.size() &&
-			(int) work_groups.size() < 
-			gpu->getWorkGroupsPerComputeUnit())
+	if (index == (int) work_groups.size())
 	{
 		work_groups.push_back(work_group);
 	}
@@ -525,8 +559,6 @@ void ComputeUnit::AddWorkGroup(WorkGroup *work_group)
 	{
 		// Make sure an entry is emptied up
 		assert(work_groups[index] == nullptr);
-		assert(work_groups.size() <=
-				(unsigned) gpu->getWorkGroupsPerComputeUnit());
 
 		// Set the new work group to the empty entry
 		work_groups[index] = work_group;
@@ -564,29 +596,20 @@ void ComputeUnit::RemoveWorkGroup(WorkGroup *work_group)
 }
 
 
-void ComputeUnit::Reset()
-{
-	// If there are no work groups ever assigned to this compute unit
-	// the size would be zero, so no reset is required. 
-	if (!work_groups.size())
-		return;
-
-	// Debug info
-	Emulator::scheduler_debug << misc::fmt("@%lld compute unit %d "
-			"reset\n",
-			timing->getCycle(),
-			index);
-
-	// Reset the workgroups size to 0
-	work_groups.resize(0);
-}
-
-
 void ComputeUnit::UnmapWorkGroup(WorkGroup *work_group)
 {
 	// Get Gpu object
 	Gpu *gpu = getGpu();
 
+	// The list of available compute units and the NDRange are shared by
+	// all compute units, so they are not updated while running ahead of
+	// the GPU.
+	if (gpu->inParallelPhase())
+	{
+		finished_work_groups.push_back(work_group);
+		return;
+	}
+
 	// Add work group register access statistics to compute unit
 	num_sreg_reads += work_group->getSregReadCount();
 	num_sreg_writes += work_group->getSregWriteCount();
@@ -597,13 +620,24 @@ void ComputeUnit::UnmapWorkGroup(WorkGroup *work_group)
 	assert(work_groups.size() > 0);
 	RemoveWorkGroup(work_group);
 
+	// Stop simulating the compute unit if this was its last work group
+	assert(num_work_groups > 0);
+	num_work_groups--;
+	if (!num_work_groups)
+		gpu->RemoveFromActiveComputeUnits(this);
+
 	// Unmap wavefronts from instruction buffer
-	work_group->wavefront_pool->UnmapWavefronts(work_group);
+	NDRange *ndrange = work_group->getNDRange();
+	WavefrontPool::WorkGroupResources resources =
+			gpu->getWorkGroupResources(ndrange);
+	work_group->wavefront_pool->UnmapWavefronts(work_group, resources);
+	assert(num_scalar_registers >= resources.num_scalar_registers);
+	num_scalar_registers -= resources.num_scalar_registers;
+	gpu->RemoveResidentWorkGroup(ndrange);
 	
 	// If compute unit is not already in the available list, place
 	// it there. The vector list of work groups does not shrink,
 	// when we unmap a workgroup.
-	assert((int) work_groups.size() <= gpu->getWorkGroupsPerComputeUnit());
 	if (!in_available_compute_units)
 		gpu->InsertInAvailableComputeUnits(this);
 
@@ -612,11 +646,18 @@ void ComputeUnit::UnmapWorkGroup(WorkGroup *work_group)
 			work_group->getId());
 
 	// Remove the work group from the running work groups list
-	NDRange *ndrange = work_group->getNDRange();
 	ndrange->RemoveWorkGroup(work_group);
 }
 
 
+void ComputeUnit::UnmapFinishedWorkGroups()
+{
+	for (WorkGroup *work_group : finished_work_groups)
+		UnmapWorkGroup(work_group);
+	finished_work_groups.clear();
+}
+
+
 void ComputeUnit::UpdateFetchVisualization(FetchBuffer *fetch_buffer)
 {
 	for (auto it = fetch_buffer->begin(),
@@ -629,7 +670,7 @@ void ComputeUnit::UpdateFetchVisualization(FetchBuffer *fetch_buffer)
 		assert(uop);
 
 		// Skip all uops that have not yet completed the fetch
-		if (timing->getCycle() < uop->fetch_ready)
+		if (getCycle() < uop->fetch_ready)
 			break;
 
 		// Trace
@@ -647,17 +688,20 @@ void ComputeUnit::UpdateFetchVisualization(FetchBuffer *fetch_buffer)
 }
 
 
-void ComputeUnit::Run()
+void ComputeUnit::Run(long long cycle)
 {
 	// Return if no work groups are mapped to this compute unit
 	if (!work_groups.size())
 		return;
+
+	// Set current cycle
+	this->cycle = cycle;
 	
 	// Save timing simulator
 	timing = Timing::getInstance();
 
 	// Issue buffer chosen to issue this cycle
-	int active_issue_buffer = timing->getCycle() % num_wavefront_pools;
+	int active_issue_buffer = getCycle() % num_wavefront_pools;
 	assert(active_issue_buffer >= 0 && active_issue_buffer < num_wavefront_pools);
 
 	// SIMDs
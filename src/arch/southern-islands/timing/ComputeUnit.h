@@ -74,9 +74,17 @@ class ComputeUnit
 	// List of work-groups currently mapped to the compute unit
 	std::vector<WorkGroup *> work_groups;
 
+	// Number of work-groups currently mapped to the compute unit. Entries
+	// of 'work_groups' are left empty when work-groups are unmapped.
+	int num_work_groups = 0;
+
 	// Variable number of wavefront pools
 	std::vector<std::unique_ptr<WavefrontPool>> wavefront_pools;
 
+	// Scalar registers allocated by the mapped work-groups. They are
+	// shared by all wavefront pools.
+	int num_scalar_registers = 0;
+
 	// Variable number of fetch buffers
 	std::vector<std::unique_ptr<FetchBuffer>> fetch_buffers;
 
@@ -101,6 +109,15 @@ class ComputeUnit
 	// Counter of identifiers assigned to uops in this compute unit
 	long long uop_id_counter = 0;
 
+	// Cycle currently simulated by the compute unit. It matches the GPU
+	// cycle, except in parallel simulation, where compute units run
+	// ahead of the GPU for a quantum of cycles.
+	long long cycle = 0;
+
+	// Work-groups that finished while the compute unit was running ahead
+	// of the GPU, unmapped when the quantum ends
+	std::vector<WorkGroup *> finished_work_groups;
+
 public:
 
 	//
@@ -158,11 +175,11 @@ public:
 	/// Constructor
 	ComputeUnit(int index, Gpu *gpu);
 
-	/// Reset the compute unit for the next NDRange
-	void Reset();
+	/// Advance compute unit state by one cycle, simulating the given cycle
+	void Run(long long cycle);
 
-	/// Advance compute unit state by one cycle
-	void Run();
+	/// Return the cycle currently simulated by the compute unit
+	long long getCycle() const { return cycle; }
 
 	/// Return the index of this compute unit in the GPU
 	int getIndex() const { return index; }
@@ -177,12 +194,40 @@ public:
 	/// Return the associated timing simulator
 	Timing *getTiming() const { return timing; }
 	
-	/// Map a work group to the compute unit
+	/// Return the wavefront pool with the given index
+	WavefrontPool *getWavefrontPool(int index) const
+	{
+		assert(index >= 0 && index < (int) wavefront_pools.size());
+		return wavefront_pools[index].get();
+	}
+
+	/// Return the number of scalar registers allocated by the work-groups
+	/// mapped to the compute unit
+	int getNumScalarRegisters() const { return num_scalar_registers; }
+
+	/// Return the wavefront pool where a work-group allocating the given
+	/// resources would be mapped, or null if the compute unit lacks scalar
+	/// registers for it, or no wavefront pool has room for it. Among the
+	/// pools with room, the one with the lowest free entry is chosen, so
+	/// that work-groups are spread across pools.
+	WavefrontPool *FindWavefrontPool(
+			const WavefrontPool::WorkGroupResources &resources) const;
+
+	/// Return whether any wavefront pool has room for another work-group
+	bool hasFreeEntries() const;
+
+	/// Map a work group to the compute unit. One of the wavefront pools
+	/// must have room for it.
 	void MapWorkGroup(WorkGroup *work_group);
 
-	/// Unmap a work group from the compute unit
+	/// Unmap a work group from the compute unit. In parallel simulation,
+	/// the work group is only unmapped when the current quantum ends.
 	void UnmapWorkGroup(WorkGroup *work_group);
 
+	/// Unmap the work groups that finished during the last parallel
+	/// simulation quantum
+	void UnmapFinishedWorkGroups();
+
 	/// Add a work group pointer to the work_groups list
 	void AddWorkGroup(WorkGroup *work_group);
 
@@ -224,6 +269,16 @@ public:
 	/// Flag to indicate if the compute unit is currently available or not
 	bool in_available_compute_units = false;
 
+	/// Iterator of the compute unit location in the active compute units
+	/// list
+	std::list<ComputeUnit *>::iterator active_compute_units_iterator;
+
+	/// Flag to indicate if the compute unit has work-groups mapped
+	bool in_active_compute_units = false;
+
+	/// Last cycle when a uop completed execution
+	long long last_complete_cycle = 0;
+
 
 
 
@@ -29,9 +29,8 @@ namespace SI
 void ExecutionUnit::Issue(std::unique_ptr<Uop> uop)
 {
 	// Spend issue latency
-	Timing *timing = Timing::getInstance();
 	assert(uop->issue_ready == 0);
-	uop->issue_ready = timing->getCycle() + ComputeUnit::issue_latency;	
+	uop->issue_ready = compute_unit->getCycle() + ComputeUnit::issue_latency;	
 	
 	// Insert into issue buffer
 	assert(canIssue());
@@ -17,8 +17,11 @@
  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <algorithm>
+
 #include <arch/southern-islands/emulator/Emulator.h>
 #include <arch/southern-islands/emulator/NDRange.h>
+#include <lib/esim/Statistics.h>
 
 #include "Gpu.h"
 #include "Timing.h"
@@ -35,6 +38,8 @@ int Gpu::num_vector_registers = 65536;
 int Gpu::lds_allocation_size = 64; 
 int Gpu::lds_size = 65536;
 long long Gpu::max_cycles = 0;
+int Gpu::parallel_threads = 1;
+int Gpu::parallel_quantum = 10;
 
 // String map of the argument's access type                                      
 const misc::StringMap Gpu::register_allocation_granularity_map =                                
@@ -59,15 +64,56 @@ Gpu::Gpu()
 		ComputeUnit *compute_unit = compute_units.back().get();
 		InsertInAvailableComputeUnits(compute_unit);
 	}
+
+	// Interval statistics
+	esim::Statistics *statistics = esim::Statistics::getInstance();
+	for (auto &compute_unit : compute_units)
+	{
+		ComputeUnit *cu = compute_unit.get();
+		std::string prefix = misc::fmt("SI.cu%d.", cu->getIndex());
+		statistics->Register(prefix + "Instructions",
+				[cu] { return cu->num_total_instructions; });
+		statistics->Register(prefix + "SimdInstructions",
+				[cu] { return cu->num_simd_instructions; });
+		statistics->Register(prefix + "VectorMemoryInstructions",
+				[cu] { return cu->num_vector_memory_instructions; });
+		statistics->Register(prefix + "LdsInstructions",
+				[cu] { return cu->num_lds_instructions; });
+		statistics->Register(prefix + "MappedWorkGroups",
+				[cu] { return cu->num_mapped_work_groups; });
+	}
+
+	// Host threads for parallel simulation
+	StartParallelWorkers(parallel_threads, num_compute_units);
 }
 
 
-ComputeUnit *Gpu::getAvailableComputeUnit()
+Gpu::~Gpu()
 {
-	if (available_compute_units.empty())
-		return nullptr;
-	else
-		return available_compute_units.front();
+	StopParallelWorkers();
+}
+
+
+long long Gpu::getLastCompleteCycle() const
+{
+	long long last_complete_cycle = 0;
+	for (auto &compute_unit : compute_units)
+		last_complete_cycle = std::max(last_complete_cycle,
+				compute_unit->last_complete_cycle);
+	return last_complete_cycle;
+}
+
+
+ComputeUnit *Gpu::getAvailableComputeUnit(NDRange *ndrange)
+{
+	// Work-groups of different NDRanges allocate different resources, so
+	// an available compute unit may still lack room for this one.
+	WavefrontPool::WorkGroupResources resources =
+			getWorkGroupResources(ndrange);
+	for (ComputeUnit *compute_unit : available_compute_units)
+		if (compute_unit->FindWavefrontPool(resources))
+			return compute_unit;
+	return nullptr;
 }
 
 
@@ -99,12 +145,46 @@ void Gpu::RemoveFromAvailableComputeUnits(ComputeUnit *compute_unit)
 }
 
 
-void Gpu::MapNDRange(NDRange *ndrange)
+void Gpu::InsertInActiveComputeUnits(ComputeUnit *compute_unit)
+{
+	// Sanity
+	assert(!compute_unit->in_active_compute_units);
+
+	// Find the first active compute unit with a higher index
+	auto it = active_compute_units.begin();
+	while (it != active_compute_units.end() &&
+			(*it)->getIndex() < compute_unit->getIndex())
+		++it;
+
+	// Insert compute unit
+	compute_unit->in_active_compute_units = true;
+	compute_unit->active_compute_units_iterator =
+			active_compute_units.insert(it, compute_unit);
+}
+
+
+void Gpu::RemoveFromActiveComputeUnits(ComputeUnit *compute_unit)
+{
+	// Sanity
+	assert(compute_unit->in_active_compute_units);
+
+	// Remove compute unit
+	active_compute_units.erase(
+			compute_unit->active_compute_units_iterator);
+	compute_unit->in_active_compute_units = false;
+	compute_unit->active_compute_units_iterator =
+			active_compute_units.end();
+}
+
+
+void Gpu::StartNDRange(NDRange *ndrange)
 {
 	// Check that at least one work-group can be allocated per 
 	// wavefront pool
-	Gpu::CalcGetWorkGroupsPerWavefrontPool(ndrange->getLocalSize1D(),
+	int work_groups_per_wavefront_pool = CalcGetWorkGroupsPerWavefrontPool(
+			ndrange->getLocalSize1D(),
 			ndrange->getNumVgprUsed(),
+			ndrange->getNumSgprUsed(),
 			ndrange->getLocalMemTop());
 
 	// Make sure the number of work groups per wavefront pool is non-zero
@@ -118,104 +198,341 @@ void Gpu::MapNDRange(NDRange *ndrange)
 			"be executed.\n"));
 	}
 
-	// Calculate limit of work groups per compute unit
-	work_groups_per_compute_unit = work_groups_per_wavefront_pool *
-			ComputeUnit::num_wavefront_pools;
-	assert(work_groups_per_wavefront_pool <=
-			ComputeUnit::max_work_groups_per_wavefront_pool);
 	// Debug info
 	Emulator::scheduler_debug << misc::fmt("NDRange %d calculations:\n"
 			"\t%d work group per wavefront pool\n"
 			"\t%d work group slot per compute unit\n",
 			ndrange->getId(),
 			work_groups_per_wavefront_pool,
-			work_groups_per_compute_unit);
+			work_groups_per_wavefront_pool *
+			ComputeUnit::num_wavefront_pools);
+
+	// Create address space. Work-groups of other NDRanges may be mapped
+	// to compute units at the same time, so it is kept until the NDRange
+	// is freed.
+	assert(!ndrange->address_space);
+	ndrange->address_space = mmu->newSpace("Southern Islands");
 
-	// Map ndrange
-	mapped_ndrange = ndrange;
+	// Initialize statistics
+	NDRangeStats &stats = ndrange_stats[ndrange->getId()];
+	stats.wavefronts_per_work_group = getWorkGroupResources(ndrange)
+			.num_wavefronts;
+	stats.work_groups_per_wavefront_pool = work_groups_per_wavefront_pool;
 }
 
 
-void Gpu::UnmapNDRange(NDRange *ndrange)
+WavefrontPool::WorkGroupResources Gpu::getWorkGroupResources(
+		NDRange *ndrange) const
 {
-	// Unmap NDRange
-	mapped_ndrange = nullptr;
-
-	//Erase every workgroup in each compute unit, setting the
-	// work_groups size to 0
-	for (auto &compute_unit : compute_units)
-		compute_unit->Reset();
+	return CalcWorkGroupResources(ndrange->getLocalSize1D(),
+			ndrange->getNumVgprUsed(),
+			ndrange->getNumSgprUsed(),
+			ndrange->getLocalMemTop());
 }
 
 
-void Gpu::CalcGetWorkGroupsPerWavefrontPool(int work_items_per_work_group, 
-		int registers_per_work_item, int local_memory_per_work_group)
+WavefrontPool::WorkGroupResources Gpu::CalcWorkGroupResources(
+		int work_items_per_work_group,
+		int registers_per_work_item,
+		int scalar_registers_per_wavefront,
+		int local_memory_per_work_group) const
 {
-	// Get maximum number of work-groups per SIMD as limited by the 
-	// maximum number of wavefronts, given the number of wavefronts per 
-	// work-group in the NDRange
+	WavefrontPool::WorkGroupResources resources;
+
+	// Wavefronts
 	assert(WorkGroup::WavefrontSize > 0);
-	int wavefronts_per_work_group = (work_items_per_work_group + 
+	resources.num_wavefronts = (work_items_per_work_group + 
 			WorkGroup::WavefrontSize - 1) / 
 			WorkGroup::WavefrontSize;
-	int max_work_groups_limited_by_max_wavefronts = 
-			ComputeUnit::max_wavefronts_per_wavefront_pool /
-			wavefronts_per_work_group;
 
-	// Get maximum number of work-groups per SIMD as limited by the number 
-	// of available registers, given the number of registers used per 
-	// work-item.
-	int registers_per_work_group;
+	// Vector registers, given the number of registers used per work-item
 	if (register_allocation_granularity == RegisterAllocationWavefront)
 	{
-		registers_per_work_group = misc::RoundUp(
+		resources.num_vector_registers = misc::RoundUp(
 				registers_per_work_item *
 				WorkGroup::WavefrontSize, 
 				register_allocation_size) * 
-				wavefronts_per_work_group;
+				resources.num_wavefronts;
 	}
 	else
 	{
-		registers_per_work_group = misc::RoundUp(
+		resources.num_vector_registers = misc::RoundUp(
 				registers_per_work_item *
 				work_items_per_work_group, 
 				register_allocation_size);
 	}
-	
-	// FIXME need to account for scalar registers
+
+	// Scalar registers, allocated by each wavefront
+	resources.num_scalar_registers = scalar_registers_per_wavefront *
+			resources.num_wavefronts;
+
+	// Local memory
+	resources.local_memory_size = misc::RoundUp(
+			local_memory_per_work_group, 
+			lds_allocation_size);
+
+	// Done
+	return resources;
+}
+
+
+int Gpu::CalcGetWorkGroupsPerWavefrontPool(int work_items_per_work_group, 
+		int registers_per_work_item, int scalar_registers_per_wavefront,
+		int local_memory_per_work_group) const
+{
+	// Get resources allocated by each work-group
+	WavefrontPool::WorkGroupResources resources = CalcWorkGroupResources(
+			work_items_per_work_group,
+			registers_per_work_item,
+			scalar_registers_per_wavefront,
+			local_memory_per_work_group);
+
+	// Get maximum number of work-groups per SIMD as limited by the 
+	// maximum number of wavefronts, given the number of wavefronts per 
+	// work-group in the NDRange
+	int max_work_groups_limited_by_max_wavefronts = 
+			ComputeUnit::max_wavefronts_per_wavefront_pool /
+			resources.num_wavefronts;
+
+	// Get maximum number of work-groups per SIMD as limited by the number 
+	// of available registers
 	int max_work_groups_limited_by_num_registers = 
-			registers_per_work_group ?
-			num_vector_registers / registers_per_work_group :
+			resources.num_vector_registers ?
+			num_vector_registers / resources.num_vector_registers :
+			ComputeUnit::max_work_groups_per_wavefront_pool;
+
+	// Get maximum number of work-groups per SIMD as limited by the number
+	// of scalar registers. These are shared by all SIMDs of the compute
+	// unit, where work-groups are spread evenly.
+	int max_work_groups_limited_by_num_scalar_registers =
+			resources.num_scalar_registers ?
+			(num_scalar_registers / resources.num_scalar_registers +
+			ComputeUnit::num_wavefront_pools - 1) /
+			ComputeUnit::num_wavefront_pools :
 			ComputeUnit::max_work_groups_per_wavefront_pool;
 
 	// Get maximum number of work-groups per SIMD as limited by the 
-	// amount of available local memory, given the local memory used 
-	// by each work-group in the NDRange
-	local_memory_per_work_group = misc::RoundUp(local_memory_per_work_group, 
-			lds_allocation_size);
+	// amount of available local memory
 	int max_work_groups_limited_by_local_memory = 
-			local_memory_per_work_group ?
-			lds_size / local_memory_per_work_group :
+			resources.local_memory_size ?
+			lds_size / resources.local_memory_size :
 			ComputeUnit::max_work_groups_per_wavefront_pool;
 
 	// Based on the limits above, calculate the actual limit of work-groups 
 	// per SIMD.
-	work_groups_per_wavefront_pool = 
+	int work_groups_per_wavefront_pool = 
 			ComputeUnit::max_work_groups_per_wavefront_pool;
 	work_groups_per_wavefront_pool = std::min(work_groups_per_wavefront_pool,
 			max_work_groups_limited_by_max_wavefronts);
 	work_groups_per_wavefront_pool= std::min(work_groups_per_wavefront_pool, 
 			max_work_groups_limited_by_num_registers);
+	work_groups_per_wavefront_pool = std::min(work_groups_per_wavefront_pool,
+			max_work_groups_limited_by_num_scalar_registers);
 	work_groups_per_wavefront_pool = std::min(work_groups_per_wavefront_pool, 
 			max_work_groups_limited_by_local_memory);
+	return work_groups_per_wavefront_pool;
+}
+
+
+void Gpu::UpdateNDRangeStats()
+{
+	// Accumulate the cycles elapsed since the last change
+	long long cycle = Timing::getInstance()->getCycle();
+	long long elapsed = cycle - ndrange_stats_cycle;
+	for (NDRangeStats *stats : resident_ndrange_stats)
+	{
+		stats->resident_work_group_cycles += elapsed *
+				stats->num_resident_work_groups;
+		if (resident_ndrange_stats.size() > 1)
+			stats->overlap_cycles += elapsed;
+	}
+	ndrange_stats_cycle = cycle;
+}
+
+
+void Gpu::AddResidentWorkGroup(NDRange *ndrange)
+{
+	// Statistics up to this cycle
+	UpdateNDRangeStats();
+
+	// The NDRange becomes resident
+	NDRangeStats &stats = ndrange_stats.at(ndrange->getId());
+	if (!stats.num_resident_work_groups)
+	{
+		if (!stats.num_work_groups)
+			stats.start_cycle = ndrange_stats_cycle;
+		resident_ndrange_stats.push_back(&stats);
+	}
+
+	// Count work-group
+	stats.num_work_groups++;
+	stats.num_resident_work_groups++;
+	stats.max_resident_work_groups = std::max(
+			stats.max_resident_work_groups,
+			stats.num_resident_work_groups);
+}
+
+
+void Gpu::RemoveResidentWorkGroup(NDRange *ndrange)
+{
+	// Statistics up to this cycle
+	UpdateNDRangeStats();
+
+	// Discount work-group
+	NDRangeStats &stats = ndrange_stats.at(ndrange->getId());
+	assert(stats.num_resident_work_groups > 0);
+	stats.num_resident_work_groups--;
+	stats.end_cycle = ndrange_stats_cycle;
+
+	// The NDRange is no longer resident
+	if (!stats.num_resident_work_groups)
+		resident_ndrange_stats.erase(std::find(
+				resident_ndrange_stats.begin(),
+				resident_ndrange_stats.end(),
+				&stats));
+}
+
+
+void Gpu::DumpNDRangeReport(std::ostream &os) const
+{
+	// Total number of wavefront pool entries in the GPU
+	long long cycle = Timing::getInstance()->getCycle();
+	long long num_entries = (long long) num_compute_units *
+			ComputeUnit::num_wavefront_pools *
+			ComputeUnit::max_wavefronts_per_wavefront_pool;
+
+	for (auto &pair : ndrange_stats)
+	{
+		// Skip NDRanges that never ran
+		const NDRangeStats &stats = pair.second;
+		if (!stats.num_work_groups)
+			continue;
+
+		// NDRanges still running are accounted up to the current cycle
+		long long elapsed = cycle - ndrange_stats_cycle;
+		long long end_cycle = stats.end_cycle;
+		long long resident_work_group_cycles =
+				stats.resident_work_group_cycles;
+		long long overlap_cycles = stats.overlap_cycles;
+		if (stats.num_resident_work_groups)
+		{
+			end_cycle = cycle;
+			resident_work_group_cycles += elapsed *
+					stats.num_resident_work_groups;
+			if (resident_ndrange_stats.size() > 1)
+				overlap_cycles += elapsed;
+		}
+
+		// Averages
+		long long cycles = end_cycle - stats.start_cycle;
+		double average_resident_work_groups = cycles ?
+				(double) resident_work_group_cycles / cycles :
+				0.0;
+		double occupancy = average_resident_work_groups *
+				stats.wavefronts_per_work_group / num_entries;
+
+		// Dump
+		os << misc::fmt("[ NDRange %d ]\n\n", pair.first);
+		os << misc::fmt("WorkGroups = %lld\n", stats.num_work_groups);
+		os << misc::fmt("WavefrontsPerWorkGroup = %d\n",
+				stats.wavefronts_per_work_group);
+		os << misc::fmt("WorkGroupsPerWavefrontPool = %d\n",
+				stats.work_groups_per_wavefront_pool);
+		os << misc::fmt("StartCycle = %lld\n", stats.start_cycle);
+		os << misc::fmt("EndCycle = %lld\n", end_cycle);
+		os << misc::fmt("Cycles = %lld\n", cycles);
+		os << misc::fmt("MaxResidentWorkGroups = %d\n",
+				stats.max_resident_work_groups);
+		os << misc::fmt("AverageResidentWorkGroups = %.4g\n",
+				average_resident_work_groups);
+		os << misc::fmt("Occupancy = %.4g\n", occupancy);
+		os << misc::fmt("OverlapCycles = %lld\n", overlap_cycles);
+		os << misc::fmt("\n\n");
+	}
 }
 
 
 void Gpu::Run()
 {
-	// Advance one cycle in each compute unit
-	for (auto &compute_unit : compute_units)
-		compute_unit->Run();
+	// Parallel simulation or co-simulation
+	if (inParallelSimulation())
+	{
+		RunParallel(Timing::getInstance()->getCycle(),
+				parallel_quantum);
+		return;
+	}
+
+	// Advance one cycle in each compute unit with work-groups mapped. A
+	// compute unit can leave the list while it runs, so the iterator is
+	// moved forward first.
+	long long cycle = Timing::getInstance()->getCycle();
+	for (auto it = active_compute_units.begin(),
+			e = active_compute_units.end();
+			it != e;)
+	{
+		ComputeUnit *compute_unit = *it;
+		++it;
+		compute_unit->Run(cycle);
+	}
+}
+
+
+bool Gpu::canDispatch() const
+{
+	return !inParallelSimulation() ||
+			Timing::getInstance()->getCycle() >= getQuantumEnd();
+}
+
+
+void Gpu::MemoryAccess(ComputeUnit *compute_unit,
+		mem::Module *module,
+		mem::Module::AccessType access_type,
+		mem::Mmu::Space *space,
+		unsigned address,
+		int *witness)
+{
+	// Buffer the access while running ahead of the GPU
+	if (inParallelPhase())
+	{
+		BufferAccess(compute_unit, module, access_type, space,
+				address, witness, false);
+		return;
+	}
+
+	// Translate virtual address
+	if (space)
+		address = mmu->TranslateVirtualAddress(space, address);
+
+	// Start access
+	module->Access(access_type, address, witness);
+}
+
+
+bool Gpu::TryMemoryAccess(ComputeUnit *compute_unit,
+		mem::Module *module,
+		mem::Module::AccessType access_type,
+		mem::Mmu::Space *space,
+		unsigned address,
+		int *witness)
+{
+	// Buffer the access while running ahead of the GPU. The state of the
+	// module is only checked when the access starts.
+	if (inParallelPhase())
+	{
+		BufferAccess(compute_unit, module, access_type, space,
+				address, witness, true);
+		return true;
+	}
+
+	// Translate virtual address
+	if (space)
+		address = mmu->TranslateVirtualAddress(space, address);
+
+	// Start access if possible
+	if (!module->canAccess(address))
+		return false;
+	module->Access(access_type, address, witness);
+	return true;
 }
 
 }
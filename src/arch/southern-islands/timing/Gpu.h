@@ -20,10 +20,13 @@
 #ifndef ARCH_SOUTHERN_ISLANDS_TIMING_GPU_H
 #define ARCH_SOUTHERN_ISLANDS_TIMING_GPU_H
 
+#include <map>
 #include <vector>
 
+#include <arch/common/ParallelSimulation.h>
 #include <lib/cpp/Misc.h>
 #include <memory/Mmu.h>
+#include <memory/Module.h>
 
 #include "ComputeUnit.h"
 
@@ -32,7 +35,7 @@ namespace SI
 {
 
 /// Class representing a Southern Islands GPU device.
-class Gpu
+class Gpu : public comm::ParallelSimulation
 {
 
 public:
@@ -63,18 +66,136 @@ private:
 	// List of available compute units
 	std::list<ComputeUnit *> available_compute_units;
 
+	// List of compute units with work-groups mapped, in the order of
+	// their indexes. Only these compute units are simulated every cycle.
+	std::list<ComputeUnit *> active_compute_units;
+
 	// Granularity of the register allocation
 	RegisterAllocationGranularity register_allocation_granularity = 
 			RegisterAllocationInvalid;
 
-	/// Number of work groups allowed in a wavefront pool
-	int work_groups_per_wavefront_pool = 0;
+	// Statistics of an NDRange. They are kept after the NDRange is
+	// freed by the driver, until the report is dumped.
+	struct NDRangeStats
+	{
+		// Number of wavefronts per work-group
+		int wavefronts_per_work_group = 0;
+
+		// Number of work-groups of the NDRange that fit in a
+		// wavefront pool when it runs alone
+		int work_groups_per_wavefront_pool = 0;
+
+		// Number of work-groups mapped to compute units so far
+		long long num_work_groups = 0;
+
+		// Cycle when the first work-group was mapped
+		long long start_cycle = 0;
+
+		// Cycle when the last work-group was unmapped
+		long long end_cycle = 0;
+
+		// Number of work-groups currently mapped to compute units
+		int num_resident_work_groups = 0;
+
+		// Maximum number of work-groups mapped at the same time
+		int max_resident_work_groups = 0;
+
+		// Sum over all cycles of the number of work-groups mapped
+		long long resident_work_group_cycles = 0;
+
+		// Cycles where work-groups of other NDRanges were mapped at the
+		// same time
+		long long overlap_cycles = 0;
+	};
+
+	// Statistics of all NDRanges, indexed by NDRange identifier
+	std::map<int, NDRangeStats> ndrange_stats;
+
+	// Statistics of the NDRanges with work-groups currently mapped
+	std::vector<NDRangeStats *> resident_ndrange_stats;
+
+	// Cycle until which the statistics of resident NDRanges have been
+	// accumulated
+	long long ndrange_stats_cycle = 0;
+
+	// Accumulate the statistics of resident NDRanges up to the current
+	// cycle, before the set of mapped work-groups changes
+	void UpdateNDRangeStats();
+
+
+
+
+	//
+	// Parallel simulation (GpuParallel.cc)
+	//
+
+	// Memory access issued by a compute unit while running ahead of the
+	// GPU
+	class PendingMemoryAccess : public PendingAccess
+	{
+		// GPU, translating the address
+		Gpu *gpu;
+
+		// Access type
+		mem::Module::AccessType access_type;
+
+		// Address space of a virtual address, or null if the address
+		// is already translated
+		mem::Mmu::Space *space;
+
+		// Accessed address
+		unsigned address;
+
+		// Witness incremented when the access completes
+		int *witness;
+
+		// True if the access waits until the module can accept it
+		// (see TryMemoryAccess())
+		bool wait_for_module;
+
+	public:
+
+		// Constructor
+		PendingMemoryAccess(Gpu *gpu,
+				mem::Module *module,
+				mem::Module::AccessType access_type,
+				mem::Mmu::Space *space,
+				unsigned address,
+				int *witness,
+				bool wait_for_module) :
+				PendingAccess(module),
+				gpu(gpu),
+				access_type(access_type),
+				space(space),
+				address(address),
+				witness(witness),
+				wait_for_module(wait_for_module)
+		{
+		}
+
+		// Translate the address, and start the access unless it waits
+		// for its module and the module cannot accept it
+		bool Start() override;
+	};
+
+	// Disable parallel simulation while tracing
+	bool PrepareParallelSimulation() override;
 
-	/// Number of work_groups allowed in a compute unit
-	int work_groups_per_compute_unit = 0;
+	// Run one cycle of a compute unit on a worker thread
+	void RunUnit(int index, long long cycle) override;
 
-	/// Mapped NDRange to the GPU
-	NDRange *mapped_ndrange = nullptr;
+	// Release the work-groups that finished during the quantum
+	void EndQuantum() override;
+
+	// Buffer an access issued by a compute unit while running ahead of
+	// the GPU
+	void BufferAccess(ComputeUnit *compute_unit,
+			mem::Module *module,
+			mem::Module::AccessType access_type,
+			mem::Mmu::Space *space,
+			unsigned address,
+			int *witness,
+			bool wait_for_module);
 
 public:
 
@@ -88,6 +209,13 @@ public:
 
 	// Number of compute units
 	static int num_compute_units;
+
+	// Number of host threads simulating compute units in parallel
+	static int parallel_threads;
+
+	// Number of cycles that compute units run ahead of the GPU in
+	// parallel simulation before synchronizing with the memory system
+	static int parallel_quantum;
 	
 
 
@@ -118,15 +246,20 @@ public:
 	// Class members
 	//
 
-	/// Last cycle when uop completed execution
-	long long last_complete_cycle = 0;
-
 	/// Constructor
 	Gpu();
 
-	/// Return the iterator of an available compute unit. If no compute
-	/// units are available a nullptr is returned.
-	ComputeUnit *getAvailableComputeUnit();
+	/// Destructor
+	~Gpu();
+
+	/// Return the last cycle when a uop completed execution in any
+	/// compute unit
+	long long getLastCompleteCycle() const;
+
+	/// Return the first compute unit in the list of available units that
+	/// has room for a work-group of the given NDRange. If no compute unit
+	/// has room, a nullptr is returned.
+	ComputeUnit *getAvailableComputeUnit(NDRange *ndrange);
 
 	/// Insert the given compute unit in the list of available units. The
 	/// compute unit must not be currently present in the list.
@@ -136,6 +269,15 @@ public:
 	/// compute unit must be present in the list.
 	void RemoveFromAvailableComputeUnits(ComputeUnit *compute_unit); 
 
+	/// Insert the given compute unit in the list of active units, keeping
+	/// the order of compute unit indexes. The compute unit must not be
+	/// currently present in the list.
+	void InsertInActiveComputeUnits(ComputeUnit *compute_unit);
+
+	/// Remove the compute unit from the list of active units. The compute
+	/// unit must be present in the list.
+	void RemoveFromActiveComputeUnits(ComputeUnit *compute_unit);
+
 	/// Return the compute unit with the given index.
 	ComputeUnit *getComputeUnit(int index) const
 	{
@@ -143,26 +285,47 @@ public:
 		return compute_units[index].get();
 	}
 
-	/// Return the number of work groups per compute unit
-	int getWorkGroupsPerComputeUnit() const 
-	{
-		return work_groups_per_compute_unit; 
-	}
-
 	/// Return the associated MMU
 	mem::Mmu *getMmu() const { return mmu.get(); }
 
-	/// Map an NDRange to the GPU object
-	void MapNDRange(NDRange *ndrange);
-
-	// Unmap an NDRange from the GPU
-	void UnmapNDRange(NDRange *ndrange);
-	
-	// Calculate the number of allowed work groups per wavefront pool
-	void CalcGetWorkGroupsPerWavefrontPool(
+	/// Start the timing simulation of an NDRange. An address space is
+	/// created for it, which it keeps until it is freed. An exception is
+	/// thrown if a work-group of the NDRange does not fit in a compute
+	/// unit.
+	void StartNDRange(NDRange *ndrange);
+
+	/// Return the resources that a work-group of the given NDRange
+	/// allocates in the wavefront pool where it is mapped
+	WavefrontPool::WorkGroupResources getWorkGroupResources(
+			NDRange *ndrange) const;
+
+	/// Calculate the resources allocated by a work-group in a wavefront
+	/// pool
+	WavefrontPool::WorkGroupResources CalcWorkGroupResources(
+			int work_items_per_work_group,
+			int registers_per_work_item,
+			int scalar_registers_per_wavefront,
+			int local_memory_per_work_group) const;
+
+	/// Calculate the number of work groups that fit in a wavefront pool
+	/// when all of them belong to the same NDRange
+	int CalcGetWorkGroupsPerWavefrontPool(
 			int work_items_per_work_group, 
 			int registers_per_work_item, 
-			int local_memory_per_work_group);
+			int scalar_registers_per_wavefront,
+			int local_memory_per_work_group) const;
+
+	/// Account for a work-group of the given NDRange mapped to a compute
+	/// unit in the NDRange statistics
+	void AddResidentWorkGroup(NDRange *ndrange);
+
+	/// Account for a work-group of the given NDRange unmapped from a
+	/// compute unit in the NDRange statistics
+	void RemoveResidentWorkGroup(NDRange *ndrange);
+
+	/// Dump the occupancy statistics of each NDRange into an output
+	/// stream
+	void DumpNDRangeReport(std::ostream &os) const;
 
 	/// Return an iterator to the first compute unit
 	std::vector<std::unique_ptr<ComputeUnit>>::iterator getComputeUnitsBegin()
@@ -190,12 +353,42 @@ public:
 
 	/// Advance one cycle in the GPU state
 	void Run();
+
+	/// Return whether work-groups can be dispatched to compute units in
+	/// the current cycle. In parallel simulation, this only happens
+	/// before compute units start running a new quantum.
+	bool canDispatch() const;
+
+	/// Start an access to \a module on behalf of a compute unit. If
+	/// \a space is given, \a address is a virtual address in it, and is
+	/// translated by the GPU MMU before starting the access. The
+	/// \a witness is incremented when the access completes. In parallel
+	/// simulation, the access is buffered and started by the main thread
+	/// in the cycle where it was issued.
+	void MemoryAccess(ComputeUnit *compute_unit,
+			mem::Module *module,
+			mem::Module::AccessType access_type,
+			mem::Mmu::Space *space,
+			unsigned address,
+			int *witness);
+
+	/// Same as MemoryAccess(), but the access is only started if
+	/// \a module can accept it, as given by mem::Module::canAccess() on
+	/// the translated address. Return false if the access was not
+	/// started, in which case the compute unit must retry it later. In
+	/// parallel simulation, the access is always buffered, and starts in
+	/// the first cycle after it was issued where the module can accept
+	/// it.
+	bool TryMemoryAccess(ComputeUnit *compute_unit,
+			mem::Module *module,
+			mem::Module::AccessType access_type,
+			mem::Mmu::Space *space,
+			unsigned address,
+			int *witness);
+
 	
 	/// Add a compute unit to the list of available compute units
 	ComputeUnit *AddComputeUnit(ComputeUnit *compute_unit);
-
-	/// Getter for the mapped NDRange of the GPU
-	NDRange *getNDRange() const { return mapped_ndrange; }
 };
 
 }
@@ -0,0 +1,103 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2015  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <arch/southern-islands/emulator/Emulator.h>
+
+#include "Gpu.h"
+#include "Timing.h"
+
+
+namespace SI
+{
+
+bool Gpu::PrepareParallelSimulation()
+{
+	// Traces and debug output are written by the compute units in the
+	// order in which they are simulated, which is only meaningful
+	// sequentially.
+	if (Timing::trace || Timing::pipeline_debug || Emulator::isa_debug)
+	{
+		misc::Warning("Southern Islands parallel simulation disabled "
+				"while tracing or debugging the pipeline");
+		return false;
+	}
+	return true;
+}
+
+
+void Gpu::RunUnit(int index, long long cycle)
+{
+	// Compute units do not leave the list of active units while running
+	// ahead of the GPU, since work-groups are unmapped at the end of the
+	// quantum.
+	ComputeUnit *compute_unit = compute_units[index].get();
+	if (compute_unit->in_active_compute_units)
+		compute_unit->Run(cycle);
+}
+
+
+void Gpu::EndQuantum()
+{
+	// Release the work-groups that finished during the quantum, in the
+	// order of compute units. They become visible to the dispatcher at
+	// the beginning of the next quantum.
+	for (auto &compute_unit : compute_units)
+		compute_unit->UnmapFinishedWorkGroups();
+}
+
+
+bool Gpu::PendingMemoryAccess::Start()
+{
+	// Translate the address once, the first time the access tries to
+	// start, so that physical pages are allocated in the order of
+	// accesses.
+	if (space)
+	{
+		address = gpu->mmu->TranslateVirtualAddress(space, address);
+		space = nullptr;
+	}
+
+	// Retry in the next cycle if the module cannot accept the access yet
+	if (wait_for_module && !module->canAccess(address))
+		return false;
+
+	// Start access
+	module->Access(access_type, address, witness);
+	return true;
+}
+
+
+void Gpu::BufferAccess(ComputeUnit *compute_unit,
+		mem::Module *module,
+		mem::Module::AccessType access_type,
+		mem::Mmu::Space *space,
+		unsigned address,
+		int *witness,
+		bool wait_for_module)
+{
+	// The address is translated when the access starts, so that physical
+	// pages are allocated in the same order regardless of the host
+	// threads.
+	AddPendingAccess(compute_unit->getIndex(), compute_unit->getCycle(),
+			misc::new_unique<PendingMemoryAccess>(this, module,
+					access_type, space, address, witness,
+					wait_for_module));
+}
+
+}
@@ -94,12 +94,13 @@ void LdsUnit::Complete()
 		Uop *uop = it->get();
 
 		// Uop is not ready yet
-		if (compute_unit->getTiming()->getCycle() < uop->write_ready)
+		if (compute_unit->getCycle() < uop->write_ready)
 			break;
 
 		// Statistics
 		assert(uop->getWavefrontPoolEntry()->lgkm_cnt > 0);
 		uop->getWavefrontPoolEntry()->lgkm_cnt--;
+		uop->getWavefrontPoolEntry()->Wakeup();
 
 		// Trace
 		Timing::trace << misc::fmt("si.end_inst "
@@ -117,8 +118,7 @@ void LdsUnit::Complete()
 
 		// Statistics
 		num_instructions++;
-		compute_unit->getGpu()->last_complete_cycle = compute_unit->
-				getTiming()->getCycle();
+		compute_unit->last_complete_cycle = compute_unit->getCycle();
 	}
 }
 
@@ -187,11 +187,12 @@ void LdsUnit::Write()
 		}
 
 		// Access complete, update write ready
-		uop->write_ready = compute_unit->getTiming()->getCycle() +
+		uop->write_ready = compute_unit->getCycle() +
 				write_latency;
 
 		// Update wavefront pool entry
 		uop->getWavefrontPoolEntry()->ready_next_cycle = true;
+		uop->getWavefrontPoolEntry()->Wakeup();
 
 		// One more instruction processed
 		instructions_processed++;
@@ -240,7 +241,7 @@ void LdsUnit::Mem()
 		instructions_processed++;
 
 		// Break if Uop is not ready yet
-		if (compute_unit->getTiming()->getCycle() < uop->read_ready)
+		if (compute_unit->getCycle() < uop->read_ready)
 			break;
 
 		// Stall if the width has been reached
@@ -323,8 +324,11 @@ void LdsUnit::Mem()
 				}
 
 				// Start access
-				compute_unit->getLdsModule()->Access(
+				compute_unit->getGpu()->MemoryAccess(
+						compute_unit,
+						compute_unit->getLdsModule(),
 						access_type,
+						nullptr,
 						work_item_info->lds_access[i].addr,
 						&uop->lds_witness);
 				uop->lds_witness--;
@@ -408,11 +412,11 @@ void LdsUnit::Read()
 		}
 
 		// Uop is not ready yet
-		if (compute_unit->getTiming()->getCycle() < uop->decode_ready)
+		if (compute_unit->getCycle() < uop->decode_ready)
 			break;
 
 		// Update uop
-		uop->read_ready = compute_unit->getTiming()->getCycle() +
+		uop->read_ready = compute_unit->getCycle() +
 				read_latency;
 
 		// Trace
@@ -458,7 +462,7 @@ void LdsUnit::Decode()
 		instructions_processed++;
 
 		// Uop is not ready yet
-		if (compute_unit->getTiming()->getCycle() < uop->issue_ready)
+		if (compute_unit->getCycle() < uop->issue_ready)
 			break;
 
 		// Stall if the width has been reached
@@ -499,7 +503,7 @@ void LdsUnit::Decode()
 		}
 
 		// Update uop
-		uop->decode_ready = compute_unit->getTiming()->getCycle() +
+		uop->decode_ready = compute_unit->getCycle() +
 				decode_latency;
 
 		// if (si_spatial_report_active)
@@ -83,6 +83,7 @@ void ScalarUnit::Issue(std::unique_ptr<Uop> uop)
 	{
 		// The wavefront will be ready next cycle
 		uop->getWavefrontPoolEntry()->ready_next_cycle = true;
+		uop->getWavefrontPoolEntry()->Wakeup();
 		
 		// Keep track of statistics
 		compute_unit->num_scalar_memory_instructions++;
@@ -103,7 +104,6 @@ void ScalarUnit::Complete()
 {
 	// Get useful objects
 	ComputeUnit *compute_unit = getComputeUnit();
-	Gpu *gpu = compute_unit->getGpu();
 
 	// Initialize iterator
 	auto it = write_buffer.begin();
@@ -118,7 +118,7 @@ void ScalarUnit::Complete()
 		WorkGroup *work_group = uop->getWorkGroup();
 
 		// Break if uop is not ready
-		if (compute_unit->getTiming()->getCycle() < uop->write_ready)
+		if (compute_unit->getCycle() < uop->write_ready)
 			break;
 
 		// If this is the last instruction and there are outstanding
@@ -148,12 +148,14 @@ void ScalarUnit::Complete()
 		{
 			assert(uop->getWavefrontPoolEntry()->lgkm_cnt > 0);
 			uop->getWavefrontPoolEntry()->lgkm_cnt--;
+			uop->getWavefrontPoolEntry()->Wakeup();
 		}
 
 		if (!uop->scalar_memory_read)
 		{
 			// Update wavefront pool entry
 			uop->getWavefrontPoolEntry()->ready = true;
+			uop->getWavefrontPoolEntry()->Wakeup();
 		}
 
 		// Check for "wait" instruction
@@ -200,6 +202,8 @@ void ScalarUnit::Complete()
 							wait_for_barrier);
 					wavefront->getWavefrontPoolEntry()->
 							wait_for_barrier = false;
+					wavefront->getWavefrontPoolEntry()->
+							Wakeup();
 				}
 
 				Timing::pipeline_debug << misc::fmt(
@@ -256,7 +260,7 @@ void ScalarUnit::Complete()
 
 		// Statistics
 		num_instructions++;
-		gpu->last_complete_cycle = compute_unit->getTiming()->getCycle();
+		compute_unit->last_complete_cycle = compute_unit->getCycle();
 	}
 }
 
@@ -330,8 +334,7 @@ void ScalarUnit::Write()
 			}
 
 			// Update Uop write ready cycle
-			uop->write_ready = compute_unit->getTiming()->
-					getCycle() + write_latency;
+			uop->write_ready = compute_unit->getCycle() + write_latency;
 
 			// Trace
 			Timing::trace << misc::fmt("si.inst "
@@ -355,7 +358,7 @@ void ScalarUnit::Write()
 		else
 		{
 			// Uop is not ready yet
-			if (compute_unit->getTiming()->getCycle() < uop->
+			if (compute_unit->getCycle() < uop->
 					execute_ready)
 						break;
 
@@ -418,8 +421,7 @@ void ScalarUnit::Write()
 			}
 
 			// Update uop write ready
-			uop->write_ready = compute_unit->getTiming()->
-					getCycle() + write_latency;
+			uop->write_ready = compute_unit->getCycle() + write_latency;
 
 			// Trace
 			Timing::trace << misc::fmt("si.inst "
@@ -465,7 +467,7 @@ void ScalarUnit::Execute()
 		instructions_processed++;
 
 		// Uop is not ready yet
-		if (compute_unit->getTiming()->getCycle() < uop->read_ready)
+		if (compute_unit->getCycle() < uop->read_ready)
 			break;
 
 		// Stall if width has been reached
@@ -515,18 +517,15 @@ void ScalarUnit::Execute()
 			uop->global_memory_access_address = uop->getWavefront()->
 					getScalarWorkItem()->global_memory_access_address;
 
-			// Translate virtual address to physical address
-			unsigned phys_addr = compute_unit->getGpu()->
-					getMmu()->TranslateVirtualAddress(
-							uop->getWorkGroup()->
-							getNDRange()->
-							address_space,
-						uop->global_memory_access_address);
-
-			// Submit the access
-			compute_unit->scalar_cache->Access(
+			// Submit the access, translating the virtual address
+			compute_unit->getGpu()->MemoryAccess(
+					compute_unit,
+					compute_unit->scalar_cache,
 					mem::Module::AccessType::AccessLoad,
-					phys_addr, &uop->global_memory_witness);
+					uop->getWorkGroup()->getNDRange()->
+							address_space,
+					uop->global_memory_access_address,
+					&uop->global_memory_witness);
 
 			// Trace
 			Timing::trace << misc::fmt("si.inst "
@@ -549,8 +548,7 @@ void ScalarUnit::Execute()
 		// ALU instruction
 		else
 		{
-			uop->execute_ready = compute_unit->getTiming()->
-					getCycle() + exec_latency;
+			uop->execute_ready = compute_unit->getCycle() + exec_latency;
 
 			// Trace
 			Timing::trace << misc::fmt("si.inst "
@@ -596,7 +594,7 @@ void ScalarUnit::Read()
 		instructions_processed++;
 
 		// Uop is not ready yet
-		if (compute_unit->getTiming()->getCycle() < uop->decode_ready)
+		if (compute_unit->getCycle() < uop->decode_ready)
 			break;
 
 		// Stall if the decode width has been reached
@@ -637,7 +635,7 @@ void ScalarUnit::Read()
 		}
 
 		// Update uop read ready
-		uop->read_ready = compute_unit->getTiming()->getCycle() +
+		uop->read_ready = compute_unit->getCycle() +
 				read_latency;
 
 		// Trace
@@ -683,7 +681,7 @@ void ScalarUnit::Decode()
 		instructions_processed++;
 
 		// Uop is not ready yet
-		if (compute_unit->getTiming()->getCycle() < uop->issue_ready)
+		if (compute_unit->getCycle() < uop->issue_ready)
 			break;
 
 		// Stall if the issue width has been reached
@@ -724,7 +722,7 @@ void ScalarUnit::Decode()
 		}
 
 		// Update uop decode ready
-		uop->decode_ready = compute_unit->getTiming()->getCycle() +
+		uop->decode_ready = compute_unit->getCycle() +
 				decode_latency;
 
 		// Trace
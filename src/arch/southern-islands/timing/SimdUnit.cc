@@ -77,7 +77,6 @@ void SimdUnit::Complete()
 {
 	// Get useful objects
 	ComputeUnit *compute_unit = getComputeUnit();
-	Gpu *gpu = compute_unit->getGpu();
 
 	// Sanity check exec buffer
 	assert(int(exec_buffer.size()) <= exec_buffer_size);
@@ -95,7 +94,7 @@ void SimdUnit::Complete()
 		assert(uop);
 
 		// Break if uop is not ready
-		if (compute_unit->getTiming()->getCycle() < uop->execute_ready)
+		if (compute_unit->getCycle() < uop->execute_ready)
 			break;
 
 		// Trace
@@ -107,7 +106,7 @@ void SimdUnit::Complete()
 
 		// Statistics
 		num_instructions++;
-		gpu->last_complete_cycle = compute_unit->getTiming()->getCycle();
+		compute_unit->last_complete_cycle = compute_unit->getCycle();
 
 		// Remove uop from the exec buffer and get the iterator to the
 		// next element
@@ -145,7 +144,7 @@ void SimdUnit::Execute()
 		instructions_processed++;
 
 		// Break if uop is not ready
-		if (compute_unit->getTiming()->getCycle() < uop->decode_ready)
+		if (compute_unit->getCycle() < uop->decode_ready)
 			break;
 
 		// Stall if width has been reached
@@ -187,11 +186,12 @@ void SimdUnit::Execute()
 
 		// Includes time for pipelined read-exec-write of all
 		// subwavefronts
-		uop->execute_ready = compute_unit->getTiming()->getCycle() +
+		uop->execute_ready = compute_unit->getCycle() +
 				read_exec_write_latency;
 
 		// Update wavefront pool entry
 		uop->getWavefrontPoolEntry()->ready_next_cycle = true;
+		uop->getWavefrontPoolEntry()->Wakeup();
 
 		// Trace
 		Timing::trace << misc::fmt("si.inst "
@@ -238,7 +238,7 @@ void SimdUnit::Decode()
 		instructions_processed++;
 
 		// Break if uop is not ready
-		if (compute_unit->getTiming()->getCycle() < uop->issue_ready)
+		if (compute_unit->getCycle() < uop->issue_ready)
 			break;
 
 		// Stall if width has been reached
@@ -279,7 +279,7 @@ void SimdUnit::Decode()
 		}
 
 		// Update uop
-		uop->decode_ready = compute_unit->getTiming()->getCycle() +
+		uop->decode_ready = compute_unit->getCycle() +
 				decode_latency;
 
 		//if (si_spatial_report_active)
@@ -17,6 +17,8 @@
  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <algorithm>
+
 #include <arch/common/Arch.h>
 #include <lib/cpp/CommandLine.h>
 #include <memory/System.h>
@@ -70,6 +72,24 @@ const std::string Timing::help_message =
 	"      Frequency for the Southern Islands GPU in MHz.\n"
 	"  NumComputeUnits = <num> (Default = 32)\n"
 	"      Number of compute units in the GPU.\n"
+	"  ParallelThreads = <num> (Default = 1)\n"
+	"      Number of host threads used to simulate compute units in\n"
+	"      parallel. Compute units run ahead of the GPU for a quantum of\n"
+	"      cycles, while their memory accesses are buffered and started\n"
+	"      in the cycles where they were issued, in the order of compute\n"
+	"      units. Timing differs from a sequential simulation, since\n"
+	"      compute units observe memory accesses completed during the\n"
+	"      quantum up to ParallelQuantum-1 cycles late, and work-groups\n"
+	"      are only dispatched between quanta. Instructions are emulated\n"
+	"      as compute units fetch them, in an order that depends on the\n"
+	"      host threads. Results are deterministic for kernels whose\n"
+	"      work-groups do not share global memory; otherwise, e.g. with\n"
+	"      global atomics, they may vary from run to run. Tracing or\n"
+	"      debugging the pipeline forces a value of 1.\n"
+	"  ParallelQuantum = <cycles> (Default = 10)\n"
+	"      Number of cycles that compute units run in parallel before\n"
+	"      synchronizing with the memory hierarchy and the work-group\n"
+	"      dispatcher.\n"
 	"\n"
 	"Section '[ ComputeUnit ]': parameters for the Compute Units.\n"
 	"\n"
@@ -720,6 +740,18 @@ void Timing::ParseConfiguration(misc::IniFile *ini_file)
 				ini_file->getPath().c_str()));
 	Gpu::num_compute_units = ini_file->ReadInt(section, "NumComputeUnits",
 						   Gpu::num_compute_units);
+	Gpu::parallel_threads = ini_file->ReadInt(section, "ParallelThreads",
+			Gpu::parallel_threads);
+	if (Gpu::parallel_threads < 1)
+		throw Error(misc::fmt("%s: The value for 'ParallelThreads' "
+				"must be equal or greater than 1.\n",
+				ini_file->getPath().c_str()));
+	Gpu::parallel_quantum = ini_file->ReadInt(section, "ParallelQuantum",
+			Gpu::parallel_quantum);
+	if (Gpu::parallel_quantum < 1)
+		throw Error(misc::fmt("%s: The value for 'ParallelQuantum' "
+				"must be equal or greater than 1.\n",
+				ini_file->getPath().c_str()));
 
 	// Section [ComputeUnit]
 	section = "ComputeUnit";
@@ -732,7 +764,12 @@ void Timing::ParseConfiguration(misc::IniFile *ini_file)
 					"MaxWavefrontsPerWavefrontPool",
 					ComputeUnit::max_wavefronts_per_wavefront_pool);
 	//TODO ComputeUnit::num_vector_registers
-	//TODO ComputeUnit::num_scalar_register
+	Gpu::num_scalar_registers = ini_file->ReadInt(section,
+			"NumScalarRegisters", Gpu::num_scalar_registers);
+	if (Gpu::num_scalar_registers < 1)
+		throw Error(misc::fmt("%s: The value for 'NumScalarRegisters' "
+				"must be equal or greater than 1.\n",
+				ini_file->getPath().c_str()));
 
 	// Section [FrontEnd]
 	section = "FrontEnd";
@@ -874,6 +911,8 @@ void Timing::DumpConfiguration(std::ofstream &os) const
 	os << misc::fmt("[ Config.Device ]\n");
 	os << misc::fmt("Frequency = %d\n", frequency);
 	os << misc::fmt("NumComputeUnits = %d\n", Gpu::num_compute_units);
+	os << misc::fmt("ParallelThreads = %d\n", Gpu::parallel_threads);
+	os << misc::fmt("ParallelQuantum = %d\n", Gpu::parallel_quantum);
 	os << misc::fmt("\n");
 
 	// Compute Unit
@@ -995,6 +1034,21 @@ void Timing::DumpConfiguration(std::ofstream &os) const
 }
 
 
+bool Timing::canCoSimulate() const
+{
+	return !trace && !pipeline_debug && !Emulator::isa_debug;
+}
+
+
+void Timing::StartCoSimulation(long long lookahead,
+		pthread_mutex_t *functional_mutex)
+{
+	// Quantum in GPU cycles
+	long long quantum = lookahead / getFrequencyDomain()->getCycleTime();
+	gpu->StartCoSimulation(std::max(1LL, quantum), functional_mutex);
+}
+
+
 void Timing::DumpSummary(std::ostream &os) const
 {
 	// Simulated time in nanoseconds
@@ -1054,6 +1108,9 @@ void Timing::DumpReport() const
 	report << misc::fmt("InstructionsPerCycle = %.4g\n", instructions_per_cycle);             
 	report << misc::fmt("\n\n");                                                      
 
+	// Report for NDRanges
+	gpu->DumpNDRangeReport(report);
+
 	// Report for compute units  
 	for (auto it = gpu->getComputeUnitsBegin(), 
 			e = gpu->getComputeUnitsEnd(); 
@@ -1124,45 +1181,31 @@ bool Timing::Run()
 	if (!emulator->getNumNDRanges())
 		return false;
 
-	// TODO instead of statically allocating the whole GPU to one NDRange
-	// which wastes the resources, dynamically add the workgroups of
-	// different NDRanges to the compute units, if all work groups of
-	// the current NDRange is scheduled, and resources are available
-	// Add any available work groups to the waiting list
-	for (auto it = emulator->getNDRangesBegin();
-			it != emulator->getNDRangesEnd();
-			++it)
+	// In parallel simulation, work-groups are only dispatched before
+	// compute units start running a new quantum.
+	if (gpu->canDispatch())
 	{
-		// Get pointer to NDRange
-		NDRange *ndrange = it->get();
-
-		// Setup WorkGroup pointer
-		WorkGroup *work_group = nullptr;
-
-		if (ndrange->address_space == nullptr)
+		// Work-groups of all NDRanges are dispatched to compute units
+		// with enough free resources, in the order in which NDRanges
+		// were created. Work-groups of a later NDRange fill the
+		// resources left by earlier ones.
+		for (auto it = emulator->getNDRangesBegin();
+				it != emulator->getNDRangesEnd();
+				++it)
 		{
-			// TODO the problem is that the NDRange keeps getting
-			// mapped and unmapped since the waitingworkgroups list
-			// of ndrange only grows with the driver calls.
-			// This solution doesn't work.
-			ndrange->address_space = gpu->getMmu()
-					->newSpace("Southern Islands");
-			gpu->MapNDRange(ndrange);
-		}
+			// Get pointer to NDRange
+			NDRange *ndrange = it->get();
 
-		// If the waiting list is not empty
-		if (!ndrange->isWaitingWorkGroupsEmpty())
-		{
-			// Save the number of waiting work groups
-			unsigned num_waiting_work_groups = ndrange->
-					getNumWaitingWorkgroups();
+			// Start simulating new NDRanges
+			if (ndrange->address_space == nullptr)
+				gpu->StartNDRange(ndrange);
 
-			// Map work groups to compute units
-			for (unsigned i = 0; i < num_waiting_work_groups; i++)
+			// Map waiting work groups to compute units
+			while (!ndrange->isWaitingWorkGroupsEmpty())
 			{
 				// Get an available compute unit
 				ComputeUnit *available_compute_unit =
-						gpu->getAvailableComputeUnit();
+						gpu->getAvailableComputeUnit(ndrange);
 
 				// Exit if no compute unit available
 				if (!available_compute_unit)
@@ -1170,7 +1213,8 @@ bool Timing::Run()
 
 				// Remove work group from list and get its ID
 				long work_group_id = ndrange->GetWaitingWorkGroup();
-				work_group = ndrange->ScheduleWorkGroup(work_group_id);
+				WorkGroup *work_group = ndrange->ScheduleWorkGroup(
+						work_group_id);
 
 				// If the last work group is sent, then set the value
 				// to true
@@ -1178,28 +1222,23 @@ bool Timing::Run()
 					ndrange->setLastWorkgroupSent(true);
 
 				// Remove it from the available compute units list.
-				// It will be re-added later if it still has room for
-				// more work groups.
+				// It will be re-added later at the end of the list if
+				// it still has room for more work groups.
 				gpu->RemoveFromAvailableComputeUnits(
 						available_compute_unit);
 
 				// Map the work group to a compute unit
 				available_compute_unit->MapWorkGroup(work_group);
 			}
-		}
 
-		if (ndrange->isRunningWorkGroupsEmpty() &&
-				ndrange->LastWorkGroupSent())
-		{
-			gpu->UnmapNDRange(ndrange);
-			ndrange->WakeupContext();
+			// If a context has been suspended while waiting for the
+			// ndrange check if it can be woken up.
+			if (ndrange->isRunningWorkGroupsEmpty() &&
+					ndrange->LastWorkGroupSent())
+				ndrange->WakeupContext();
 		}
-
-		// If a context has been suspended while waiting for the ndrange
-		// check if it can be woken up.
 	}
 
-
 	// Stop if maximum number of GPU cycles exceeded
 	esim::Engine *esim_engine = esim::Engine::getInstance();
 	if (Gpu::max_cycles && getCycle() >=
@@ -1212,7 +1251,7 @@ bool Timing::Run()
 		esim_engine->Finish("SIMaxInstructions");
 
 	// Stop if there was a simulation stall
-	if (getCycle() - gpu->last_complete_cycle > 1000000)
+	if (getCycle() - gpu->getLastCompleteCycle() > 1000000)
 	{
 		std::cout<<"\n\n************TOO LONG******************\n\n";
 		//warning("Southern Islands GPU simulation stalled.\n%s",
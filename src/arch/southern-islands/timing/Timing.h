@@ -161,6 +161,22 @@ public:
 	/// Dump the configuration of the GPU and compute units
 	void DumpConfiguration(std::ofstream &os) const;
 
+	/// Return whether the GPU can run concurrently with other timing
+	/// simulators, which is not the case while tracing or debugging the
+	/// pipeline.
+	bool canCoSimulate() const override;
+
+	/// Run the GPU concurrently with other timing simulators.
+	/// See comm::Timing::StartCoSimulation() for details.
+	void StartCoSimulation(long long lookahead,
+			pthread_mutex_t *functional_mutex) override;
+
+	/// See comm::Timing::StartQuantum() for details.
+	void StartQuantum() override { gpu->StartQuantum(); }
+
+	/// See comm::Timing::FinishQuantum() for details.
+	void FinishQuantum() override { gpu->FinishQuantum(); }
+
 	/// Dump the statistics summary for the timing simulator.
 	void DumpSummary(std::ostream &os) const override;
 
@@ -71,6 +71,7 @@ void VectorMemoryUnit::Issue(std::unique_ptr<Uop> uop)
 
 	// The wavefront will be ready next cycle
 	uop->getWavefrontPoolEntry()->ready_next_cycle = true;
+	uop->getWavefrontPoolEntry()->Wakeup();
 
 	// One more instruction of this kind
 	compute_unit->num_vector_memory_instructions++;
@@ -82,9 +83,8 @@ void VectorMemoryUnit::Issue(std::unique_ptr<Uop> uop)
 
 void VectorMemoryUnit::Complete()
 {
-	// Get compute unit and GPU objects
+	// Get compute unit object
 	ComputeUnit *compute_unit = getComputeUnit();
-	Gpu *gpu = compute_unit->getGpu();
 
 	// Sanity check the write buffer
 	assert((int) write_buffer.size() <= width);
@@ -97,12 +97,13 @@ void VectorMemoryUnit::Complete()
 		Uop *uop = it->get();
 
 		// Break if uop is not ready
-		if (compute_unit->getTiming()->getCycle() < uop->write_ready)
+		if (compute_unit->getCycle() < uop->write_ready)
 			break;
 	
 		// Access complete, remove the uop from the queue
 		assert(uop->getWavefrontPoolEntry()->lgkm_cnt > 0);
 		uop->getWavefrontPoolEntry()->lgkm_cnt--;
+		uop->getWavefrontPoolEntry()->Wakeup();
 		
 		// Record trace
 		Timing::trace << misc::fmt("si.end_inst "
@@ -121,7 +122,7 @@ void VectorMemoryUnit::Complete()
 
 		// Statistics
 		num_instructions++;
-		gpu->last_complete_cycle = compute_unit->getTiming()->getCycle();
+		compute_unit->last_complete_cycle = compute_unit->getCycle();
 	}
 }
 
@@ -189,8 +190,7 @@ void VectorMemoryUnit::Write()
 
 
 		// Update Uop write ready cycle
-		uop->write_ready = compute_unit->getTiming()->
-			getCycle() + write_latency;
+		uop->write_ready = compute_unit->getCycle() + write_latency;
 
 		// Trace
 		Timing::trace << misc::fmt("si.inst "
@@ -213,8 +213,9 @@ void VectorMemoryUnit::Write()
 
 void VectorMemoryUnit::Memory()
 {
-	// Get compute unit object
+	// Get compute unit and GPU objects
 	ComputeUnit *compute_unit = getComputeUnit();
+	Gpu *gpu = compute_unit->getGpu();
 	
 	// Internal counter
 	int instructions_processed = 0;
@@ -236,7 +237,7 @@ void VectorMemoryUnit::Memory()
 		instructions_processed++;
 
 		// Break if uop is not ready
-		if (compute_unit->getTiming()->getCycle() < uop->read_ready)
+		if (compute_unit->getCycle() < uop->read_ready)
 			break;
 	
 		// Stall if width has been reached
@@ -309,7 +310,7 @@ void VectorMemoryUnit::Memory()
 		Timing::pipeline_debug << misc::fmt(
 				"\t\t@%lld inst=%lld "
 				"id_in_wf=%lld wg=%d/wf=%d (VecMem)\n",
-				compute_unit->getTiming()->getCycle(),
+				compute_unit->getCycle(),
 				uop->getId(),
 				uop->getIdInWavefront(),
 				uop->getWorkGroup()->getId(),
@@ -337,30 +338,19 @@ void VectorMemoryUnit::Memory()
 				if (work_item_info->accessed_cache)	
 					continue;
 
-				// Translate virtual address to a physical 
-				// address
-				unsigned physical_address = compute_unit->
-						getGpu()->
-						getMmu()->
-						TranslateVirtualAddress(
-						uop->getWorkGroup()->
-						getNDRange()->
-						address_space,
-						work_item_info->
-						global_memory_access_address);
-		
-
-				// Make sure we can access the vector cache. If 
-				// so, submit the access. If we can access the
-				// cache, mark the accessed flag of the work 
+				// Submit the access if the vector cache can
+				// accept it, translating the virtual address.
+				// If so, mark the accessed flag of the work
 				// item info struct.
-				if (compute_unit->vector_cache->
-						canAccess(physical_address))
+				if (gpu->TryMemoryAccess(compute_unit,
+						compute_unit->vector_cache,
+						module_access_type,
+						uop->getWorkGroup()->getNDRange()->
+								address_space,
+						work_item_info->
+						global_memory_access_address,
+						&uop->global_memory_witness))
 				{
-					compute_unit->vector_cache->Access(
-							module_access_type,
-							physical_address, 
-							&uop->global_memory_witness);
 					work_item_info->accessed_cache = true;
 
 					// Access global memory
@@ -423,7 +413,7 @@ void VectorMemoryUnit::Read()
 		instructions_processed++;
 
 		// Break if uop is not ready
-		if (compute_unit->getTiming()->getCycle() < uop->decode_ready)
+		if (compute_unit->getCycle() < uop->decode_ready)
 			break;
 	
 		// Stall if width has been reached
@@ -465,8 +455,7 @@ void VectorMemoryUnit::Read()
 
 
 		// Update Uop read ready cycle
-		uop->read_ready = compute_unit->getTiming()->
-			getCycle() + read_latency;
+		uop->read_ready = compute_unit->getCycle() + read_latency;
 
 		// Trace
 		Timing::trace << misc::fmt("si.inst "
@@ -509,7 +498,7 @@ void VectorMemoryUnit::Decode()
 		instructions_processed++;
 
 		// Break if uop is not ready
-		if (compute_unit->getTiming()->getCycle() < uop->issue_ready)
+		if (compute_unit->getCycle() < uop->issue_ready)
 			break;
 	
 		// Stall if width has been reached
@@ -551,8 +540,7 @@ void VectorMemoryUnit::Decode()
 
 
 		// Update Uop write ready cycle
-		uop->decode_ready = compute_unit->getTiming()->
-			getCycle() + decode_latency;
+		uop->decode_ready = compute_unit->getCycle() + decode_latency;
 
 		// Trace
 		Timing::trace << misc::fmt("si.inst "
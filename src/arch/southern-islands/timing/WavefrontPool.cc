@@ -20,6 +20,7 @@
 #include <arch/southern-islands/emulator/WorkGroup.h>
 
 #include "ComputeUnit.h"
+#include "Gpu.h"
 #include "VectorMemoryUnit.h"
 #include "WavefrontPool.h"
 
@@ -37,6 +38,10 @@ void WavefrontPoolEntry::Clear()
 	assert(!mem_wait);
 	assert(!wait_for_barrier);
 
+	// Remove from active entries
+	if (in_active_entries)
+		wavefront_pool->RemoveFromActiveEntries(this);
+
 	// Reset the wavefront flags
 	wavefront = nullptr;
 	uop = nullptr;
@@ -47,6 +52,13 @@ void WavefrontPoolEntry::Clear()
 }
 
 
+void WavefrontPoolEntry::Wakeup()
+{
+	if (valid && !in_active_entries)
+		wavefront_pool->InsertInActiveEntries(this);
+}
+
+
 WavefrontPool::WavefrontPool(int id, ComputeUnit *compute_unit) :
 		id(id),
 		compute_unit(compute_unit)
@@ -60,12 +72,47 @@ WavefrontPool::WavefrontPool(int id, ComputeUnit *compute_unit) :
 }
 
 
-void WavefrontPool::MapWavefronts(WorkGroup *work_group)
+bool WavefrontPool::canMapWorkGroup(const WorkGroupResources &resources) const
+{
+	return num_work_groups < ComputeUnit::max_work_groups_per_wavefront_pool &&
+			num_wavefronts + resources.num_wavefronts <=
+			ComputeUnit::max_wavefronts_per_wavefront_pool &&
+			num_vector_registers + resources.num_vector_registers <=
+			Gpu::num_vector_registers &&
+			local_memory_size + resources.local_memory_size <=
+			Gpu::lds_size;
+}
+
+
+bool WavefrontPool::hasFreeEntries() const
+{
+	return num_work_groups < ComputeUnit::max_work_groups_per_wavefront_pool &&
+			num_wavefronts < ComputeUnit::max_wavefronts_per_wavefront_pool;
+}
+
+
+int WavefrontPool::getFirstFreeEntry() const
+{
+	int entry_index = 0;
+	while (entry_index < (int) wavefront_pool_entries.size() &&
+			wavefront_pool_entries[entry_index]->valid)
+		entry_index++;
+	return entry_index;
+}
+
+
+void WavefrontPool::MapWavefronts(WorkGroup *work_group,
+		const WorkGroupResources &resources)
 {
-	// Determine starting ID for wavefronts in the instruction buffer
-	int wg_id_in_wfp = work_group->getIdInComputeUnit() /
-			ComputeUnit::num_wavefront_pools;
-	int first_entry = wg_id_in_wfp * work_group->getWavefrontsInWorkgroup();
+	// Check that the work-group fits
+	assert(canMapWorkGroup(resources));
+	assert(resources.num_wavefronts ==
+			(int) work_group->getWavefrontsInWorkgroup());
+
+	// Allocate resources
+	num_work_groups++;
+	num_vector_registers += resources.num_vector_registers;
+	local_memory_size += resources.local_memory_size;
 
 	// Initialize entry index within wavefront pool
 	int entry_index = 0;
@@ -79,9 +126,14 @@ void WavefrontPool::MapWavefronts(WorkGroup *work_group)
 		// Get the wavefront object
 		Wavefront *wavefront = it->get();
 
+		// Find the next free entry. Entries released by work-groups
+		// of other NDRanges may leave gaps between them.
+		while (wavefront_pool_entries[entry_index]->valid)
+			entry_index++;
+
 		// Set entry pointer to an entry in the wavefront pool
 		WavefrontPoolEntry *wavefront_pool_entry = 
-			wavefront_pool_entries[first_entry + entry_index].get();
+			wavefront_pool_entries[entry_index].get();
 
 		// Make sure the entry was set and that it is not yet valid.
 		// Having the valid field set would indicate that it was 
@@ -94,6 +146,10 @@ void WavefrontPool::MapWavefronts(WorkGroup *work_group)
 		wavefront_pool_entry->ready = true;
 		wavefront_pool_entry->setWavefront(wavefront);
 		wavefront->setWavefrontPoolEntry(wavefront_pool_entry);
+		wavefront->id_in_compute_unit = id *
+				ComputeUnit::max_wavefronts_per_wavefront_pool +
+				entry_index;
+		wavefront_pool_entry->Wakeup();
 		
 		// Increment the number of wavefronts associated with the 
 		// wavefront pool
@@ -104,10 +160,14 @@ void WavefrontPool::MapWavefronts(WorkGroup *work_group)
 	}
 }
 
-void WavefrontPool::UnmapWavefronts(WorkGroup *work_group)
+void WavefrontPool::UnmapWavefronts(WorkGroup *work_group,
+		const WorkGroupResources &resources)
 {
 	// Reset mapped wavefronts
 	assert(num_wavefronts >= (int) work_group->getWavefrontsInWorkgroup());
+	assert(num_work_groups > 0);
+	assert(num_vector_registers >= resources.num_vector_registers);
+	assert(local_memory_size >= resources.local_memory_size);
 
 	// Remove wavefronts from the wavefront pool
 	for (auto it = work_group->getWavefrontsBegin(), 
@@ -135,8 +195,47 @@ void WavefrontPool::UnmapWavefronts(WorkGroup *work_group)
 	
 	// Adjust the number of wavefronts mapped to the wavefront pool
 	num_wavefronts -= work_group->getWavefrontsInWorkgroup();
+
+	// Release resources
+	num_work_groups--;
+	num_vector_registers -= resources.num_vector_registers;
+	local_memory_size -= resources.local_memory_size;
 }
 
 
+void WavefrontPool::InsertInActiveEntries(
+		WavefrontPoolEntry *wavefront_pool_entry)
+{
+	// Sanity
+	assert(!wavefront_pool_entry->in_active_entries);
+
+	// Find the first active entry located after this one in the pool.
+	// Lists are short, and entries are only inserted when they are woken
+	// up.
+	auto it = active_entries.begin();
+	while (it != active_entries.end() &&
+			(*it)->getIdInWavefrontPool() <
+			wavefront_pool_entry->getIdInWavefrontPool())
+		++it;
+
+	// Insert entry
+	wavefront_pool_entry->in_active_entries = true;
+	wavefront_pool_entry->active_entries_iterator =
+			active_entries.insert(it, wavefront_pool_entry);
+}
+
+
+void WavefrontPool::RemoveFromActiveEntries(
+		WavefrontPoolEntry *wavefront_pool_entry)
+{
+	// Sanity
+	assert(wavefront_pool_entry->in_active_entries);
+
+	// Remove entry
+	active_entries.erase(wavefront_pool_entry->active_entries_iterator);
+	wavefront_pool_entry->in_active_entries = false;
+	wavefront_pool_entry->active_entries_iterator = active_entries.end();
+}
+
 } // SI namespace
 
@@ -20,6 +20,10 @@
 #ifndef ARCH_SOUTHERN_ISLANDS_TIMING_WAVEFRONT_POOL_H
 #define ARCH_SOUTHERN_ISLANDS_TIMING_WAVEFRONT_POOL_H
 
+#include <list>
+#include <memory>
+#include <vector>
+
 
 namespace SI
 {
@@ -59,6 +63,11 @@ public:
 	/// Clear the internal counters of the wavefront pool entry
 	void Clear();
 
+	/// Make the fetch stage consider the entry again. This function
+	/// must be invoked after any change of the flags or counters below
+	/// that can unblock the wavefront.
+	void Wakeup();
+
 
 	//
 	// Getters
@@ -122,12 +131,48 @@ public:
 
 	/// Indicates whether the wavefront needs to wait for a memory access
 	bool mem_wait = false;
+
+
+
+
+	//
+	// List of active entries
+	//
+
+	/// Flag indicating whether the entry is in the list of active entries
+	/// of its wavefront pool
+	bool in_active_entries = false;
+
+	/// Position of the entry in the list of active entries
+	std::list<WavefrontPoolEntry *>::iterator active_entries_iterator;
 };
 
 
 /// Class representing the wavefront pool in the compute unit front-end
 class WavefrontPool
 {
+public:
+
+	/// Resources allocated by a work-group in the wavefront pool where it
+	/// is mapped
+	struct WorkGroupResources
+	{
+		/// Number of wavefront pool entries
+		int num_wavefronts;
+
+		/// Number of vector registers
+		int num_vector_registers;
+
+		/// Number of scalar registers. These are allocated in the
+		/// compute unit, shared by all its wavefront pools.
+		int num_scalar_registers;
+
+		/// Amount of local memory in bytes
+		int local_memory_size;
+	};
+
+private:
+
 	// Global identifier for the wavefront pool, assigned in constructor
 	int id;
 
@@ -140,9 +185,23 @@ class WavefrontPool
 	// Number of wavefronts associated with the wavefront pool
 	int num_wavefronts = 0;
 
+	// Number of work-groups mapped to the wavefront pool
+	int num_work_groups = 0;
+
+	// Number of vector registers allocated by mapped work-groups
+	int num_vector_registers = 0;
+
+	// Amount of local memory allocated by mapped work-groups
+	int local_memory_size = 0;
+
 	// Wavefront pool entries that belong to this pool
 	std::vector<std::unique_ptr<WavefrontPoolEntry>> wavefront_pool_entries;
 
+	// Entries considered by the fetch stage, in the same order as in the
+	// pool. Entries blocked waiting for an instruction in flight, memory
+	// accesses, or a barrier are left out until woken up.
+	std::list<WavefrontPoolEntry *> active_entries;
+
 public:
 
 	/// Constructor
@@ -151,11 +210,42 @@ public:
 	/// Return the identifier for this wavefront pool
 	int getId() const { return id; }
 
-	/// Map wavefronts to the wavefront pool
-	void MapWavefronts(WorkGroup *work_group);
+	/// Return the number of wavefronts mapped to the wavefront pool
+	int getNumWavefronts() const { return num_wavefronts; }
+
+	/// Return the number of work-groups mapped to the wavefront pool
+	int getNumWorkGroups() const { return num_work_groups; }
+
+	/// Return the number of vector registers allocated by the work-groups
+	/// mapped to the wavefront pool
+	int getNumVectorRegisters() const { return num_vector_registers; }
+
+	/// Return the amount of local memory allocated by the work-groups
+	/// mapped to the wavefront pool
+	int getLocalMemorySize() const { return local_memory_size; }
+
+	/// Return whether a work-group allocating the given resources fits in
+	/// the wavefront pool, in addition to the work-groups already mapped
+	bool canMapWorkGroup(const WorkGroupResources &resources) const;
+
+	/// Return whether the wavefront pool has room for at least one more
+	/// work-group with a single wavefront
+	bool hasFreeEntries() const;
+
+	/// Return the index of the first entry without a wavefront assigned,
+	/// or the number of entries if the pool is full
+	int getFirstFreeEntry() const;
+
+	/// Map wavefronts to the wavefront pool, allocating the given
+	/// resources. Wavefronts take the free entries with the lowest
+	/// indexes.
+	void MapWavefronts(WorkGroup *work_group,
+			const WorkGroupResources &resources);
 	
-	/// Unmap wavefronts from the wavefront pool
-	void UnmapWavefronts(WorkGroup *work_group);
+	/// Unmap wavefronts from the wavefront pool, releasing the given
+	/// resources
+	void UnmapWavefronts(WorkGroup *work_group,
+			const WorkGroupResources &resources);
 
 	/// Return an iterator to the first wavefront pool entry
 	/// in wavefront_pool_entries
@@ -170,6 +260,26 @@ public:
 		return wavefront_pool_entries.end();
 	}
 
+	/// Return an iterator to the first active entry
+	std::list<WavefrontPoolEntry *>::iterator getActiveEntriesBegin()
+	{
+		return active_entries.begin();
+	}
+
+	/// Return a past-the-end iterator to the list of active entries
+	std::list<WavefrontPoolEntry *>::iterator getActiveEntriesEnd()
+	{
+		return active_entries.end();
+	}
+
+	/// Insert an entry in the list of active entries, keeping the order
+	/// of entries in the pool. The entry must not be in the list.
+	void InsertInActiveEntries(WavefrontPoolEntry *wavefront_pool_entry);
+
+	/// Remove an entry from the list of active entries. The entry must
+	/// be in the list.
+	void RemoveFromActiveEntries(WavefrontPoolEntry *wavefront_pool_entry);
+
 	/// Return the associated compute unit
 	ComputeUnit *getComputeUnit() const { return compute_unit; }
 };
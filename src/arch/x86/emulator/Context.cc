@@ -108,6 +108,16 @@ void Context::UpdateState(unsigned state)
 	unsigned diff = this->state ^ state;
 	if (diff & ~StateSpecMode)
 		emulator->schedule_signal = true;
+
+	// Entering or leaving speculative mode does not change the presence
+	// of the context in the emulator lists. This is frequent, and done by
+	// cores emulating contexts concurrently in parallel simulation, so
+	// shared emulator state is left untouched.
+	if (diff == StateSpecMode)
+	{
+		this->state = state;
+		return;
+	}
 	
 	// Update state
 	this->state = state;
@@ -750,8 +760,13 @@ void Context::HostThreadTimerCancel()
 }
 
 
-void Context::Execute()
+long long Context::Execute(long long max_instructions)
 {
+	// Repetitions of a string instruction that can be emulated in bulk,
+	// on top of the one emulated by the regular path
+	max_bulk_repetitions = max_instructions - 1;
+	num_bulk_repetitions = 0;
+
 	// Memory permissions should not be checked if the context is executing in
 	// speculative mode. This will prevent guest segmentation faults to occur.
 	bool spec_mode = getState(StateSpecMode);
@@ -858,8 +873,22 @@ void Context::Execute()
 	if (emulator->call_debug)
 		DebugCallInst();
 
-	// Stats
-	emulator->incNumInstructions();
+	// Stats. While contexts run on worker threads, instructions are
+	// counted by the workers.
+	if (!emulator->inParallelPhase() && !emulator->inTimingParallelPhase())
+		emulator->incNumInstructions(num_bulk_repetitions + 1);
+	return num_bulk_repetitions + 1;
+}
+
+
+void Context::ExecuteDeferredSyscall()
+{
+	// The system call is dropped if the context stopped running in the
+	// meantime, e.g., killed by a system call of another context.
+	assert(syscall_deferred);
+	syscall_deferred = false;
+	if (getState(StateRunning))
+		Execute();
 }
 
 
@@ -223,6 +223,18 @@ private:
 	// Number of iterations in string instructions
 	int str_op_count = 0;
 
+	// Maximum number of repetitions of a string instruction that the
+	// current call to Execute() can emulate in bulk
+	long long max_bulk_repetitions = 0;
+
+	// Number of repetitions emulated in bulk by the current call to
+	// Execute()
+	long long num_bulk_repetitions = 0;
+
+	// True if the context stopped at a system call in parallel functional
+	// emulation, leaving it for the main thread
+	bool syscall_deferred = false;
+
 	// Last emulated instruction
 	Instruction inst;
 	
@@ -552,6 +564,25 @@ private:
 	// 'repXXX' prefixes.
 	void StartRepInst();
 
+	// String operations whose repetitions can be emulated in bulk
+	enum BulkStringOp
+	{
+		BulkStringOpNone = 0,
+		BulkStringOpMovs,
+		BulkStringOpStos,
+		BulkStringOpCmps,
+		BulkStringOpScas
+	};
+
+	// In functional simulation, emulate at once all repetitions of a
+	// string instruction with a 'repXXX' prefix except for the last one,
+	// stopping earlier at the repetition that would end a 'repz' or
+	// 'repnz' loop, or after 'max_bulk_repetitions' repetitions. The
+	// remaining repetition is left for the regular emulation path, which
+	// produces the final flags. Argument \a zf is the value of flag ZF
+	// that continues the loop, or -1 for 'rep'.
+	void ExecuteBulkStringInst(BulkStringOp op, int size, int zf);
+
 	// Load from register/memory
 	unsigned char LoadRm8();
 	unsigned short LoadRm16();
@@ -841,8 +872,19 @@ public:
 	void CheckSignalHandlerIntr();
 
 	/// Run one instruction for the context at the position pointed to by
-	/// register \c eip.
-	void Execute();
+	/// register \c eip. In functional simulation, up to \a max_instructions
+	/// repetitions of a repeated string instruction are emulated at once,
+	/// each counting as one instruction. Return the number of instructions
+	/// emulated.
+	long long Execute(long long max_instructions = 1);
+
+	/// Return whether the context stopped at a system call while running
+	/// on a worker thread in parallel functional emulation.
+	bool hasDeferredSyscall() const { return syscall_deferred; }
+
+	/// Run the system call that the context stopped at in parallel
+	/// functional emulation. This is done by the main thread.
+	void ExecuteDeferredSyscall();
 
 	/// Return a reference of the register file
 	Regs &getRegs() { return regs; }
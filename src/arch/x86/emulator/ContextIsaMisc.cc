@@ -1415,10 +1415,23 @@ void Context::ExecuteInst_int_imm8()
 	if (misc::inRange(code, 0, SyscallCodeCount))
 		emulator->isa_debug << " syscall '" << syscall_name[code] << "'";
 
+	// System calls access state shared with other contexts. In the
+	// parallel phase of functional emulation, the instruction is left to be
+	// run again by the main thread.
+	if (emulator->inParallelPhase())
+	{
+		regs.decEip(inst.getSize());
+		syscall_deferred = true;
+		return;
+	}
+
 	// Do system call if not in speculative mode
 	spec_mode = getState(StateSpecMode);
 	if (!spec_mode)
+	{
+		Emulator::SyscallLock lock(emulator);
 		ExecuteSyscall();
+	}
 
 	newUinst(Uinst::OpcodeSyscall,
 			0,
@@ -17,6 +17,9 @@
  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <algorithm>
+#include <cstring>
+
 #include <lib/cpp/Misc.h>
 
 #include "Context.h"
@@ -51,13 +54,131 @@ void Context::StartRepInst()
 }
 
 
-#define OP_REP_IMPL(X, SIZE) \
+// Return the number of string elements of the given size that can be
+// accessed from 'address' on, in direction 'dir', without leaving the memory
+// page of the first one. An element crossing a page boundary goes alone.
+static unsigned getNumPageElements(unsigned address, int size, int dir)
+{
+	unsigned offset = address & (mem::Memory::PageSize - 1);
+	if (offset + size > mem::Memory::PageSize)
+		return 1;
+	return dir > 0 ? (mem::Memory::PageSize - offset) / size :
+			offset / size + 1;
+}
+
+
+void Context::ExecuteBulkStringInst(BulkStringOp op, int size, int zf)
+{
+	// Repetitions are emulated one by one when micro-instructions are
+	// produced for the timing simulator, or in speculative mode.
+	if (op == BulkStringOpNone || uinst_active || getState(StateSpecMode))
+		return;
+
+	// Operands
+	int dir = regs.getFlag(Instruction::FlagDF) ? -1 : 1;
+	bool uses_esi = op == BulkStringOpMovs || op == BulkStringOpCmps;
+	unsigned eax = regs.getEax();
+	char src[mem::Memory::PageSize];
+	char dst[mem::Memory::PageSize];
+
+	// Value stored by 'stos' or compared by 'scas', repeated all over the
+	// source buffer
+	if (op == BulkStringOpStos || op == BulkStringOpScas)
+		for (unsigned offset = 0; offset < sizeof src; offset += size)
+			memcpy(src + offset, &eax, size);
+
+	// Emulate repetitions in chunks that stay within the same memory pages.
+	// All accesses of a chunk touch the pages of its first repetition, so
+	// a memory fault leaves registers in the same state as emulating
+	// repetitions one by one.
+	while (regs.getEcx() > 1 &&
+			num_bulk_repetitions < max_bulk_repetitions)
+	{
+		// Repetitions in the chunk
+		unsigned esi = regs.getEsi();
+		unsigned edi = regs.getEdi();
+		unsigned count = std::min(regs.getEcx() - 1,
+				getNumPageElements(edi, size, dir));
+		count = (unsigned) std::min((long long) count,
+				max_bulk_repetitions - num_bulk_repetitions);
+		if (uses_esi)
+			count = std::min(count, getNumPageElements(esi, size, dir));
+
+		// A copy must not read any element written in the same chunk
+		if (op == BulkStringOpMovs)
+		{
+			int distance = (int) (edi - esi) * dir;
+			if (distance > 0)
+				count = std::min(count, std::max((unsigned)
+						distance / size, 1u));
+		}
+
+		// Lowest addresses accessed by the chunk
+		unsigned bytes = count * size;
+		unsigned esi_start = dir > 0 ? esi : esi - bytes + size;
+		unsigned edi_start = dir > 0 ? edi : edi - bytes + size;
+
+		// Access memory. Comparisons stop at the first repetition that
+		// ends a 'repz' or 'repnz' loop.
+		unsigned done = count;
+		switch (op)
+		{
+
+		case BulkStringOpMovs:
+
+			MemoryRead(esi_start, bytes, src);
+			MemoryWrite(edi_start, bytes, src);
+			break;
+
+		case BulkStringOpStos:
+
+			MemoryWrite(edi_start, bytes, src);
+			break;
+
+		case BulkStringOpCmps:
+		case BulkStringOpScas:
+
+			if (op == BulkStringOpCmps)
+				MemoryRead(esi_start, bytes, src);
+			MemoryRead(edi_start, bytes, dst);
+			for (done = 0; done < count; done++)
+			{
+				unsigned offset = dir > 0 ? done * size :
+						bytes - (done + 1) * size;
+				bool equal = !memcmp(src + offset, dst + offset,
+						size);
+				if (equal != (bool) zf)
+					break;
+			}
+			break;
+
+		default:
+
+			throw misc::Panic("Invalid string operation");
+		}
+
+		// Advance registers past the emulated repetitions
+		if (uses_esi)
+			regs.incEsi((int) done * size * dir);
+		regs.incEdi((int) done * size * dir);
+		regs.decEcx(done);
+		num_bulk_repetitions += done;
+
+		// Repetition ending the loop is left for the regular path
+		if (done < count)
+			break;
+	}
+}
+
+
+#define OP_REP_IMPL(X, SIZE, OP) \
 	void Context::ExecuteInst_rep_##X() \
 	{ \
 		StartRepInst(); \
 		\
 		if (regs.getEcx()) \
 		{ \
+			ExecuteBulkStringInst(OP, SIZE, -1); \
 			ExecuteStringInst_##X(); \
 			regs.decEcx(); \
 			regs.decEip(inst.getSize()); \
@@ -85,13 +206,14 @@ void Context::StartRepInst()
 	}
 
 
-#define OP_REPZ_IMPL(X, SIZE) \
+#define OP_REPZ_IMPL(X, SIZE, OP) \
 	void Context::ExecuteInst_repz_##X() \
 	{ \
 		StartRepInst(); \
 		\
 		if (regs.getEcx()) \
 		{ \
+			ExecuteBulkStringInst(OP, SIZE, 1); \
 			ExecuteStringInst_##X(); \
 			regs.decEcx(); \
 			if (regs.getFlag(Instruction::FlagZF)) \
@@ -120,13 +242,14 @@ void Context::StartRepInst()
 	}
 
 
-#define OP_REPNZ_IMPL(X, SIZE) \
+#define OP_REPNZ_IMPL(X, SIZE, OP) \
 	void Context::ExecuteInst_repnz_##X() \
 	{ \
 		StartRepInst(); \
 		\
 		if (regs.getEcx()) \
 		{ \
+			ExecuteBulkStringInst(OP, SIZE, 0); \
 			ExecuteStringInst_##X(); \
 			regs.decEcx(); \
 			if (!regs.getFlag(Instruction::FlagZF)) \
@@ -939,32 +1062,32 @@ void Context::ExecuteInst_stosd()
 // Repetition prefixes
 ///
 
-OP_REP_IMPL(insb, 1)
-OP_REP_IMPL(insd, 4)
+OP_REP_IMPL(insb, 1, BulkStringOpNone)
+OP_REP_IMPL(insd, 4, BulkStringOpNone)
 
-OP_REP_IMPL(movsb, 1)
-OP_REP_IMPL(movsd, 4)
+OP_REP_IMPL(movsb, 1, BulkStringOpMovs)
+OP_REP_IMPL(movsd, 4, BulkStringOpMovs)
 
-OP_REP_IMPL(outsb, 1)
-OP_REP_IMPL(outsd, 4)
+OP_REP_IMPL(outsb, 1, BulkStringOpNone)
+OP_REP_IMPL(outsd, 4, BulkStringOpNone)
 
-OP_REP_IMPL(lodsb, 1)
-OP_REP_IMPL(lodsd, 4)
+OP_REP_IMPL(lodsb, 1, BulkStringOpNone)
+OP_REP_IMPL(lodsd, 4, BulkStringOpNone)
 
-OP_REP_IMPL(stosb, 1)
-OP_REP_IMPL(stosd, 4)
+OP_REP_IMPL(stosb, 1, BulkStringOpStos)
+OP_REP_IMPL(stosd, 4, BulkStringOpStos)
 
-OP_REPZ_IMPL(cmpsb, 1)
-OP_REPZ_IMPL(cmpsd, 4)
+OP_REPZ_IMPL(cmpsb, 1, BulkStringOpCmps)
+OP_REPZ_IMPL(cmpsd, 4, BulkStringOpCmps)
 
-OP_REPZ_IMPL(scasb, 1)
-OP_REPZ_IMPL(scasd, 4)
+OP_REPZ_IMPL(scasb, 1, BulkStringOpScas)
+OP_REPZ_IMPL(scasd, 4, BulkStringOpScas)
 
-OP_REPNZ_IMPL(cmpsb, 1)
-OP_REPNZ_IMPL(cmpsd, 4)
+OP_REPNZ_IMPL(cmpsb, 1, BulkStringOpCmps)
+OP_REPNZ_IMPL(cmpsd, 4, BulkStringOpCmps)
 
-OP_REPNZ_IMPL(scasb, 1)
-OP_REPNZ_IMPL(scasd, 4)
+OP_REPNZ_IMPL(scasb, 1, BulkStringOpScas)
+OP_REPNZ_IMPL(scasd, 4, BulkStringOpScas)
 
 
 
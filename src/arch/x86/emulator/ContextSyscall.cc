@@ -287,6 +287,9 @@ void Context::ExecuteSyscall()
 		emulator->syscall_debug << misc::fmt(", errno = %s)",
 				syscall_error_map.MapValue(-ret));
 	emulator->syscall_debug << '\n';
+
+	// Let other contexts run in functional simulation
+	emulator->EndQuantum();
 }
 
 
@@ -17,6 +17,8 @@
  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <algorithm>
+
 #include <arch/x86/disassembler/Disassembler.h>
 #include <lib/esim/Engine.h>
 
@@ -34,6 +36,8 @@ std::string Emulator::loader_debug_file;
 std::string Emulator::syscall_debug_file;
 
 long long Emulator::max_instructions;
+long long Emulator::quantum = 10000;
+int Emulator::parallel_threads = 1;
 
 std::unique_ptr<Emulator> Emulator::instance;
 
@@ -90,12 +94,42 @@ void Emulator::RegisterOptions()
 			"simulation, this limit is given in number of emulated "
 			"instructions. On x86 detailed simulation, it is given as "
 			"the number of committed (non-speculative) instructions. "
-			"A value of 0 means no limit.");
+			"In both cases, each repetition of a repeated string "
+			"instruction ('rep movsb', 'repz cmpsb', ...) counts as "
+			"one instruction. A value of 0 means no limit.");
+
+	// Option --x86-quantum <number>
+	command_line->RegisterInt64("--x86-quantum <number> (default = 10000)",
+			quantum,
+			"Number of instructions that each x86 context runs in a "
+			"row on functional simulation before the emulator moves "
+			"on to the next context and checks for simulation "
+			"events. A context also gives up its quantum when it "
+			"performs a system call. Larger values increase "
+			"emulation speed, while a value of 1 interleaves "
+			"contexts one instruction at a time.");
+
+	// Option --x86-parallel-threads <number>
+	command_line->RegisterInt32("--x86-parallel-threads <number> "
+			"(default = 1)",
+			parallel_threads,
+			"Number of host threads emulating x86 processes in "
+			"parallel on functional simulation. Contexts sharing "
+			"their memory image run on the same thread, and system "
+			"calls are performed by the main thread at the end of "
+			"each quantum (see option --x86-quantum). A value of 1 "
+			"emulates all contexts on the main thread.");
 }
 
 
 void Emulator::ProcessOptions()
 {
+	// Quantum
+	if (quantum < 1)
+		throw Error("Invalid value for option --x86-quantum");
+	if (parallel_threads < 1)
+		throw Error("Invalid value for option --x86-parallel-threads");
+
 	// Debuggers
 	call_debug.setPath(call_debug_file);
 	context_debug.setPath(context_debug_file);
@@ -233,6 +267,13 @@ Emulator *Emulator::getInstance()
 }
 
 
+Emulator::~Emulator()
+{
+	// Parallel emulation
+	StopParallelWorkers();
+}
+
+
 Context *Emulator::newContext()
 {
 	// Create context and add to context list
@@ -421,6 +462,27 @@ void Emulator::ProcessEvents()
 }
 
 
+long long Emulator::RunContextQuantum(Context *context, long long count)
+{
+	// Run until the quantum expires, or the context stops running or gives
+	// up its quantum in a system call. In parallel emulation, the context
+	// also stops at a system call, which is left for the main thread.
+	long long num_emulated = 0;
+	while (num_emulated < count && !quantum_ended &&
+			context->getState(Context::StateRunning) &&
+			!context->hasDeferredSyscall() &&
+			!esim->hasFinished())
+	{
+		num_emulated += context->Execute(count - num_emulated);
+	}
+
+	// The instruction with the deferred system call runs again later
+	if (context->hasDeferredSyscall())
+		num_emulated--;
+	return num_emulated;
+}
+
+
 bool Emulator::Run()
 {
 	// Stop if there is no more contexts
@@ -435,17 +497,39 @@ bool Emulator::Run()
 	if (esim->hasFinished())
 		return true;
 
-	// Run an instruction from every running context. During execution, a
-	// context can remove itself from the running list, so traversing the
-	// running list is not an option.
-	for (auto &context : contexts)
+	// Create worker threads for parallel emulation the first time
+	if (!parallel_started)
+		StartParallelWorkers();
+
+	// Run a quantum of instructions from every running context. The
+	// quantum never goes beyond the maximum number of instructions, so
+	// that the simulation stops exactly there. Parallel emulation is used
+	// only while all contexts can run a whole quantum.
+	if (num_parallel_threads > 1 && (!max_instructions ||
+			max_instructions - num_instructions >=
+			quantum * (long long) running_contexts.size()))
 	{
-		// Skip if not running
-		if (!context->getState(Context::StateRunning))
-			continue;
+		RunParallel();
+	}
+	else
+	{
+		// During execution, a context can remove itself from the
+		// running list, so traversing the running list is not an
+		// option.
+		for (auto &context : contexts)
+		{
+			// Skip if not running
+			if (!context->getState(Context::StateRunning))
+				continue;
 
-		// Run one iteration
-		context->Execute();
+			// Run quantum
+			long long count = quantum;
+			if (max_instructions)
+				count = std::min(count, max_instructions -
+						num_instructions);
+			quantum_ended = false;
+			RunContextQuantum(context.get(), count);
+		}
 	}
 
 	// Free finished contexts
@@ -22,8 +22,11 @@
 
 #include <pthread.h>
 
+#include <vector>
+
 #include <arch/common/Arch.h>
 #include <arch/common/Emulator.h>
+#include <arch/common/WorkerPool.h>
 #include <lib/cpp/CommandLine.h>
 #include <lib/cpp/Debug.h>
 #include <lib/cpp/Error.h>
@@ -68,6 +71,14 @@ class Emulator : public comm::Emulator
 	// Maximum number of instructions
 	static long long max_instructions;
 
+	// Number of instructions run by a context in functional simulation
+	// before moving on to the next one
+	static long long quantum;
+
+	// Number of host threads emulating processes in parallel in
+	// functional simulation
+	static int parallel_threads;
+
 	// Unique instance of singleton
 	static std::unique_ptr<Emulator> instance;
 
@@ -106,10 +117,70 @@ class Emulator : public comm::Emulator
 	// and child host threads.
 	pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
 
+	// Mutex taken by system calls, or null if none is. Set by timing
+	// simulators that emulate contexts on several host threads.
+	pthread_mutex_t *syscall_mutex = nullptr;
+
+	// True while a timing simulator emulates contexts on worker threads
+	bool timing_parallel_phase = false;
+
 	// Counter of times that a context has been suspended in a futex. Used
 	// for FIFO wakeups.
 	long long futex_sleep_count = 0;
 
+	// Flag set when the running context must give up the rest of its
+	// quantum in functional simulation
+	bool quantum_ended = false;
+
+	// Run a quantum of at most 'count' instructions for a context, and
+	// return the number of instructions emulated
+	long long RunContextQuantum(Context *context, long long count);
+
+
+
+
+	//
+	// Parallel emulation (EmulatorParallel.cc)
+	//
+
+	// Number of host threads used in parallel emulation, including the
+	// main thread. A value of 1 runs all contexts sequentially.
+	int num_parallel_threads = 1;
+
+	// True once the worker threads have been created
+	bool parallel_started = false;
+
+	// Host threads emulating contexts. Groups of contexts are assigned to
+	// workers in a round-robin fashion, with worker 0 being the main
+	// thread.
+	comm::WorkerPool parallel_workers;
+
+	// Number of instructions emulated by each worker in the last quantum
+	std::vector<long long> parallel_num_instructions;
+
+	// True while contexts run on worker threads
+	bool parallel_phase = false;
+
+	// Running contexts grouped by memory image. Contexts sharing memory
+	// are threads of the same process, and are emulated one after another
+	// by the same worker.
+	std::vector<std::vector<Context *>> parallel_groups;
+
+	// Create the worker threads, if parallel emulation is enabled
+	void StartParallelWorkers();
+
+	// Tell the worker threads to exit and wait for them
+	void StopParallelWorkers();
+
+	// Run the groups of contexts assigned to the given worker for the
+	// current quantum
+	void RunParallelQuantum(int index);
+
+	// Run a quantum for all running contexts in parallel. System calls
+	// found by the workers are performed afterwards by the main thread, in
+	// the order of the context list.
+	void RunParallel();
+
 
 public:
 
@@ -157,6 +228,9 @@ public:
 	/// Constructor
 	Emulator() : comm::Emulator("x86") { }
 
+	/// Destructor
+	~Emulator();
+
 	/// Create a new context associated with the emulator. The context is
 	/// inserted in the main emulator context list. Its state is set to
 	/// ContextRunning, and it is inserted into the emulator list of running
@@ -170,6 +244,30 @@ public:
 	/// Remove a context from all context lists and free it
 	void FreeContext(Context *context);
 
+	/// End the quantum of the context running in functional simulation
+	/// after its current instruction. This is done after system calls, so
+	/// that other contexts get a chance to run as soon as they are woken
+	/// up or a yield is requested.
+	void EndQuantum() { quantum_ended = true; }
+
+	/// Return whether contexts are running on worker threads in parallel
+	/// functional emulation. System calls and other accesses to state
+	/// shared among contexts must be deferred to the main thread.
+	bool inParallelPhase() const { return parallel_phase; }
+
+	/// Set whether a timing simulator is emulating contexts on worker
+	/// threads. In the meantime, contexts do not count the instructions
+	/// they emulate, and the timing simulator adds them afterwards with
+	/// incNumInstructions().
+	void setTimingParallelPhase(bool timing_parallel_phase)
+	{
+		this->timing_parallel_phase = timing_parallel_phase;
+	}
+
+	/// Return whether a timing simulator is emulating contexts on worker
+	/// threads
+	bool inTimingParallelPhase() const { return timing_parallel_phase; }
+
 	/// Create a context and load a program. See comm::Emu::Load() for
 	/// details on the meaning of each argument.
 	void LoadProgram(const std::vector<std::string> &args,
@@ -188,6 +286,35 @@ public:
 	/// Unlock the emulator mutex
 	void UnlockMutex() { pthread_mutex_unlock(&mutex); }
 
+	/// Make system calls take the given mutex, or none if null. System
+	/// calls access state shared by all contexts. Timing simulators that
+	/// emulate contexts with different memory images on several host
+	/// threads set the mutex of their functional lock here.
+	void setSyscallMutex(pthread_mutex_t *mutex) { syscall_mutex = mutex; }
+
+	/// Lock held by a context while running a system call
+	class SyscallLock
+	{
+		// Mutex, or null if not locked
+		pthread_mutex_t *mutex;
+
+	public:
+
+		/// Take the system call mutex of the given emulator, if any
+		SyscallLock(Emulator *emulator) : mutex(emulator->syscall_mutex)
+		{
+			if (mutex)
+				pthread_mutex_lock(mutex);
+		}
+
+		/// Release the lock
+		~SyscallLock()
+		{
+			if (mutex)
+				pthread_mutex_unlock(mutex);
+		}
+	};
+
 	// Check for events detected in spawned host threads, such as waking up
 	// contexts or sending signals. The list is only effectively processed
 	// if events have been scheduled to get processed with a previous call
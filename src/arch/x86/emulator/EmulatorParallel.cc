@@ -0,0 +1,123 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2012  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <lib/cpp/Misc.h>
+
+#include "Context.h"
+#include "Emulator.h"
+
+
+namespace x86
+{
+
+
+void Emulator::StartParallelWorkers()
+{
+	// Only once
+	assert(!parallel_started);
+	parallel_started = true;
+	num_parallel_threads = parallel_threads;
+	if (num_parallel_threads <= 1)
+		return;
+
+	// Debug output is written by the contexts in the order in which they
+	// are emulated, which is only meaningful sequentially.
+	if (isa_debug || call_debug)
+	{
+		misc::Warning("x86 parallel emulation disabled while debugging "
+				"instructions or function calls");
+		num_parallel_threads = 1;
+		return;
+	}
+
+	// Per-worker instruction counters
+	parallel_num_instructions.resize(num_parallel_threads);
+
+	// The main thread acts as worker 0
+	parallel_workers.Start(num_parallel_threads, true,
+			[this](int index) { RunParallelQuantum(index); });
+}
+
+
+void Emulator::StopParallelWorkers()
+{
+	parallel_workers.Stop();
+}
+
+
+void Emulator::RunParallelQuantum(int index)
+{
+	// Each group runs entirely before the next group assigned to the
+	// worker starts
+	long long &num_emulated = parallel_num_instructions[index];
+	num_emulated = 0;
+	for (int group_id = index; group_id < (int) parallel_groups.size();
+			group_id += num_parallel_threads)
+		for (Context *context : parallel_groups[group_id])
+			num_emulated += RunContextQuantum(context, quantum);
+}
+
+
+void Emulator::RunParallel()
+{
+	// Group running contexts by memory image. Groups and their contexts
+	// follow the order of the context list, so that the assignment of
+	// contexts to workers does not depend on the host.
+	parallel_groups.clear();
+	for (auto &context : contexts)
+	{
+		// Skip if not running
+		if (!context->getState(Context::StateRunning))
+			continue;
+
+		// Find group
+		auto it = parallel_groups.begin();
+		while (it != parallel_groups.end() &&
+				it->front()->getMemory() != context->getMemory())
+			++it;
+		if (it == parallel_groups.end())
+			it = parallel_groups.emplace(parallel_groups.end());
+		it->push_back(context.get());
+	}
+
+	// Run all groups for a quantum, with the main thread acting as
+	// worker 0
+	quantum_ended = false;
+	parallel_phase = true;
+	parallel_workers.Run();
+	parallel_workers.Wait();
+	parallel_phase = false;
+
+	// Count instructions
+	for (long long num_emulated : parallel_num_instructions)
+		num_instructions += num_emulated;
+
+	// Propagate errors found in any worker
+	parallel_workers.RethrowException();
+
+	// Perform the system calls that contexts stopped at, in the order of
+	// the context list. As in sequential emulation, a system call ends the
+	// quantum of the context.
+	for (auto &context : contexts)
+		if (context->hasDeferredSyscall())
+			context->ExecuteDeferredSyscall();
+}
+
+
+}  // namespace x86
@@ -165,9 +165,8 @@ Alu::Alu()
 
 int Alu::Reserve(Uop *uop)
 {
-	// Current cycle
-	Timing *timing = Timing::getInstance();
-	long long cycle = timing->getCycle();
+	// Current cycle in the core running the uop
+	long long cycle = uop->getCore()->getCycle();
 
 	// Record the first attempt of the uop to reserve a functional unit
 	if (!uop->first_alu_cycle)
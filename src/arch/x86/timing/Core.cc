@@ -17,6 +17,8 @@
  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <algorithm>
+
 #include "Core.h"
 #include "Cpu.h"
 #include "Timing.h"
@@ -40,6 +42,69 @@ Core::Core(Cpu *cpu,
 }
 
 
+Core::~Core()
+{
+	// Destroy uops still in flight. Their list nodes remove them from the
+	// pipeline structures they are present in.
+	while (Uop *uop = pool_uops.Front())
+		uop->~Uop();
+}
+
+
+Uop *Core::NewUop(Thread *thread,
+		Context *context,
+		std::shared_ptr<Uinst> uinst)
+{
+	// Allocate a new chunk of slots if there is no free slot
+	if (free_uop_slots.empty())
+	{
+		uop_pool_chunks.emplace_back(new UopSlot[uop_pool_chunk_size]);
+		UopSlot *chunk = uop_pool_chunks.back().get();
+		for (int i = uop_pool_chunk_size - 1; i >= 0; i--)
+			free_uop_slots.push_back(&chunk[i]);
+	}
+
+	// Construct uop in a free slot
+	UopSlot *slot = free_uop_slots.back();
+	free_uop_slots.pop_back();
+	Uop *uop = new (slot->data) Uop(thread, context, uinst);
+	pool_uops.PushBack(uop->pool_node);
+	return uop;
+}
+
+
+void Core::ReleaseUop(Uop *uop)
+{
+	// Uop must belong to this core
+	assert(uop->getCore() == this);
+
+	// Defer release until the end of the cycle
+	if (uop->canRelease() && !uop->in_released_list)
+	{
+		uop->in_released_list = true;
+		released_uops.push_back(uop);
+	}
+}
+
+
+void Core::FreeReleasedUops()
+{
+	for (Uop *uop : released_uops)
+	{
+		// Skip uops that were inserted in a structure again
+		assert(uop->in_released_list);
+		uop->in_released_list = false;
+		if (!uop->canRelease())
+			continue;
+
+		// Destroy uop and return its slot to the pool
+		uop->~Uop();
+		free_uop_slots.push_back(reinterpret_cast<UopSlot *>(uop));
+	}
+	released_uops.clear();
+}
+
+
 void Core::Dump(std::ostream &os) const
 {
 	// Dump all threads
@@ -48,31 +113,58 @@ void Core::Dump(std::ostream &os) const
 }
 
 
-void Core::InsertInEventQueue(std::shared_ptr<Uop> uop, int latency)
+void Core::InsertInEventQueueList(misc::List<Uop> &list, Uop *uop)
 {
-	// Sanity
-	assert(!uop->in_event_queue);
+	// Uops are mostly inserted in order, check the tail first
+	auto it = list.end();
+	Uop *back = list.Back();
+	if (back && uop->Compare(back) < 0)
+	{
+		it = list.begin();
+		while (uop->Compare(*it) > 0)
+			++it;
+	}
+
+	// Insert
+	list.Insert(it, uop->event_queue_node);
+}
 
-	// Set completion time for the instruction
-	assert(!uop->completed);
-	uop->complete_when = cpu->getCycle() + latency;
 
-	// Find position in event queue
-	auto it = event_queue.begin();
-	auto e = event_queue.end();
-	while (it != e)
+void Core::AdvanceEventQueue()
+{
+	// Bucket for the current cycle must have been drained
+	assert(!event_queue_wheel[event_queue_cycle %
+			event_queue_wheel_size].getSize());
+	event_queue_cycle++;
+
+	// Move uops entering the horizon from the overflow list. Their
+	// bucket is the one just released, which is empty.
+	while (Uop *uop = event_queue_overflow.Front())
 	{
-		// Check if position found
-		if (uop->Compare(it->get()) < 0)
+		if (uop->complete_when - event_queue_cycle >=
+				event_queue_wheel_size)
 			break;
-
-		// Next
-		++it;
+		event_queue_overflow.Erase(uop->event_queue_node);
+		getEventQueueList(uop->complete_when).PushBack(
+				uop->event_queue_node);
 	}
+}
 
-	// Insert
-	uop->event_queue_iterator = event_queue.insert(it, uop);
+
+void Core::InsertInEventQueue(Uop *uop, int latency)
+{
+	// Sanity
+	assert(!uop->in_event_queue);
+
+	// Set completion time for the instruction
+	assert(!uop->completed);
+	uop->complete_when = getCycle() + latency;
+	assert(uop->complete_when >= event_queue_cycle);
+
+	// Insert in the wheel bucket or overflow list
+	InsertInEventQueueList(getEventQueueList(uop->complete_when), uop);
 	uop->in_event_queue = true;
+	event_queue_size++;
 }
 
 
@@ -81,15 +173,37 @@ void Core::ExtractFromEventQueue(Uop *uop)
 	// Uop must be in the queue
 	assert(uop->in_event_queue);
 
-	// Save iterator
-	auto it = uop->event_queue_iterator;
-
-	// Indicate that the uop is not in the queue anymore
+	// Remove from queue
+	getEventQueueList(uop->complete_when).Erase(uop->event_queue_node);
 	uop->in_event_queue = false;
-	uop->event_queue_iterator = event_queue.end();
+	event_queue_size--;
+	ReleaseUop(uop);
+}
+
 
-	// Remove it as the last step, as this may free the uop
-	event_queue.erase(it);
+void Core::RecoverEventQueue(Thread *thread)
+{
+	// Function removing speculative uops of the thread from a list
+	auto recover = [this, thread](misc::List<Uop> &list)
+	{
+		auto it = list.begin();
+		auto e = list.end();
+		while (it != e)
+		{
+			// Get uop and forward iterator
+			Uop *uop = *it;
+			++it;
+
+			// Remove if speculative uop in the thread
+			if (uop->getThread() == thread && uop->speculative_mode)
+				ExtractFromEventQueue(uop);
+		}
+	};
+
+	// Traverse wheel buckets and overflow list
+	for (auto &list : event_queue_wheel)
+		recover(list);
+	recover(event_queue_overflow);
 }
 
 
@@ -307,24 +421,31 @@ void Core::Writeback()
 	// Traverse event queue
 	for (;;)
 	{
-		// No more elements in the event queue
-		if (event_queue.empty())
-			break;
-
-		// Pick uop from the head of the event queue
-		std::shared_ptr<Uop> uop = event_queue.front();
+		// Advance the timing wheel up to the current cycle once the
+		// bucket in its first cycle has been drained. An empty queue
+		// jumps straight to the current cycle.
+		if (!event_queue_size && event_queue_cycle < cycle)
+			event_queue_cycle = cycle;
+		misc::List<Uop> &bucket = event_queue_wheel[event_queue_cycle %
+				event_queue_wheel_size];
+		if (!bucket.getSize())
+		{
+			if (event_queue_cycle >= cycle)
+				break;
+			AdvanceEventQueue();
+			continue;
+		}
 
-		// If the uop is set to complete later than the current cycle,
-		// there is nothing else to extract from the event queue.
-		if (uop->complete_when > cpu->getCycle())
-			break;
+		// Pick uop from the head of the bucket
+		Uop *uop = bucket.Front();
+		assert(uop->complete_when == event_queue_cycle);
 
 		// Sanity
 		assert(uop->ready);
 		assert(!uop->completed);
 
 		// Extract element from event queue
-		ExtractFromEventQueue(uop.get());
+		ExtractFromEventQueue(uop);
 
 		// If this instruction is the first in speculative mode
 		// (typically a mispredicted branch), and recovery is configured
@@ -358,7 +479,7 @@ void Core::Writeback()
 		// Write output registers
 		Thread *thread = uop->getThread();
 		RegisterFile *register_file = thread->getRegisterFile();
-		register_file->WriteUop(uop.get());
+		register_file->WriteUop(uop);
 
 		// Increment number of writes to core's register counters
 		num_integer_register_writes += uop->getNumIntegerOutputs();
@@ -450,8 +571,19 @@ void Core::Commit()
 }
 
 
-void Core::Run()
+long long Core::getCycle() const
+{
+	// Memory accesses may complete in a CPU cycle that the core already
+	// simulated, when it runs ahead of the CPU in parallel simulation.
+	return std::max(cycle, cpu->getCycle());
+}
+
+
+void Core::Run(long long cycle)
 {
+	// Cycle being simulated
+	this->cycle = cycle;
+
 	// Run stages in reverse order
 	Commit();
 	Writeback();
@@ -459,6 +591,9 @@ void Core::Run()
 	Dispatch();
 	Decode();
 	Fetch();
+
+	// Return uops that left the pipeline to the pool
+	FreeReleasedUops();
 }
 
 }
@@ -20,14 +20,16 @@
 #ifndef ARCH_X86_TIMING_CORE_H
 #define ARCH_X86_TIMING_CORE_H
 
-#include <vector>
-#include <list>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include <arch/x86/emulator/Uinst.h>
+#include <lib/cpp/List.h>
 
 #include "Alu.h"
 #include "Thread.h"
+#include "Uop.h"
 
 
 namespace x86
@@ -57,8 +59,94 @@ private:
 	// Arithmetic-logic unit
 	Alu alu;
 
+	// Cycle currently simulated by the core. It matches the CPU cycle,
+	// except in parallel simulation, where the core runs ahead of the CPU
+	// for the duration of a quantum.
+	long long cycle = 0;
+
+
+
+
+	//
 	// Event queue
-	std::list<std::shared_ptr<Uop>> event_queue;
+	//
+
+	// Number of buckets in the timing wheel of the event queue, which
+	// is the number of cycles ahead covered by the wheel
+	static const int event_queue_wheel_size = 128;
+
+	// Timing wheel of the event queue. Uops completing in cycle 'c' are
+	// stored in bucket 'c % event_queue_wheel_size', sorted by uop
+	// identifier, if 'c' is less than 'event_queue_cycle' plus the wheel
+	// size.
+	misc::List<Uop> event_queue_wheel[event_queue_wheel_size];
+
+	// Uops completing beyond the wheel horizon, sorted by completion
+	// cycle and uop identifier. They are moved into the wheel as the
+	// wheel advances.
+	misc::List<Uop> event_queue_overflow;
+
+	// First cycle covered by the timing wheel. Buckets for earlier cycles
+	// have already been drained by the writeback stage.
+	long long event_queue_cycle = 0;
+
+	// Number of uops in the event queue
+	int event_queue_size = 0;
+
+	// Return the event queue list that a uop completing in the given cycle
+	// is stored in
+	misc::List<Uop> &getEventQueueList(long long complete_when)
+	{
+		return complete_when - event_queue_cycle < event_queue_wheel_size ?
+				event_queue_wheel[complete_when %
+						event_queue_wheel_size] :
+				event_queue_overflow;
+	}
+
+	// Insert a uop in an event queue list, in increasing order of
+	// completion cycle and uop identifier
+	static void InsertInEventQueueList(misc::List<Uop> &list, Uop *uop);
+
+	// Advance the timing wheel by one cycle, moving uops from the
+	// overflow list into the bucket that enters the wheel horizon.
+	void AdvanceEventQueue();
+
+
+
+
+	//
+	// Uop pool
+	//
+
+	// Storage for one uop, constructed in place when allocated
+	struct UopSlot
+	{
+		alignas(Uop) char data[sizeof(Uop)];
+	};
+
+	// Number of uop slots allocated together when the pool runs out of
+	// free slots
+	static const int uop_pool_chunk_size = 256;
+
+	// Chunks of uop slots
+	std::vector<std::unique_ptr<UopSlot[]>> uop_pool_chunks;
+
+	// Slots not currently used by any uop
+	std::vector<UopSlot *> free_uop_slots;
+
+	// Uops currently allocated in the pool
+	misc::List<Uop> pool_uops;
+
+	// Uops that were extracted from their last pipeline structure in the
+	// current cycle. They are returned to the pool at the end of the
+	// cycle, so that pipeline stages can keep using them after extracting
+	// them from a queue.
+	std::vector<Uop *> released_uops;
+
+	// Destroy the uops in the list of released uops that were not
+	// inserted again in a pipeline structure, and return their slots to
+	// the pool.
+	void FreeReleasedUops();
 
 
 
@@ -156,6 +244,9 @@ private:
 	// Number of committed micro-instructions
 	long long num_committed_uinsts = 0;
 
+	// Number of committed macro-instructions
+	long long num_committed_instructions = 0;
+
 	// Number of squashed micro-instructions
 	long long num_squashed_uinsts = 0;
 
@@ -195,6 +286,9 @@ public:
 	/// Constructor
 	Core(Cpu *cpu, int index);
 
+	/// Destructor
+	~Core();
+
 	/// Return the number of threads
 	int getNumThreads() const { return threads.size(); }
 
@@ -288,23 +382,39 @@ public:
 	/// Insert uop into event queue, making it ready to be extract in
 	/// \a latency cycles from now. The uop's field `complete_when` is
 	/// set to the current cycle plus \a latency in the function.
-	void InsertInEventQueue(std::shared_ptr<Uop> uop, int latency);
+	void InsertInEventQueue(Uop *uop, int latency);
 
-	/// Extract uop from event queue. The given uop must be placed at the
-	/// head of the event queue.
+	/// Extract uop from event queue. The uop must be present in the
+	/// queue.
 	void ExtractFromEventQueue(Uop *uop);
 
-	/// Return an iterator to the first element of the event queue
-	std::list<std::shared_ptr<Uop>>::iterator getEventQueueBegin()
-	{
-		return event_queue.begin();
-	}
+	/// Extract all speculative uops of the given thread from the event
+	/// queue.
+	void RecoverEventQueue(Thread *thread);
+
+	/// Return the number of uops in the event queue
+	int getEventQueueSize() const { return event_queue_size; }
 
-	/// Return a past-the-end iterator to the event queue
-	std::list<std::shared_ptr<Uop>>::iterator getEventQueueEnd()
-	{
-		return event_queue.end();
-	}
+
+
+
+	//
+	// Uop pool
+	//
+
+	/// Create a new uop in the core's uop pool, passing the given
+	/// arguments to the uop constructor.
+	Uop *NewUop(Thread *thread,
+			Context *context,
+			std::shared_ptr<Uinst> uinst);
+
+	/// Notify that a uop was extracted from a pipeline structure. If the
+	/// uop is not present in any other structure, it is returned to the
+	/// pool at the end of the current cycle.
+	void ReleaseUop(Uop *uop);
+
+	/// Return the number of uops currently allocated in the uop pool
+	int getNumPoolUops() const { return pool_uops.getSize(); }
 
 
 
@@ -380,7 +490,14 @@ public:
 	//
 
 	/// Run one simulation cycle for all pipeline stages of the core.
-	void Run();
+	/// Argument \a cycle is the cycle being simulated, returned later by
+	/// getCycle().
+	void Run(long long cycle);
+
+	/// Return the current cycle as seen by the core. This is the CPU
+	/// cycle, or the cycle last simulated by the core if it is running
+	/// ahead of the CPU in parallel simulation.
+	long long getCycle() const;
 
 	/// Fetch stage
 	void Fetch();
@@ -519,6 +636,15 @@ public:
 		return num_committed_uinsts;
 	}
 
+	/// Increment the number of committed macro-instructions
+	void incNumCommittedInstructions() { num_committed_instructions++; }
+
+	/// Return the number of committed macro-instructions
+	long long getNumCommittedInstructions() const
+	{
+		return num_committed_instructions;
+	}
+
 	/// Increment the number of reads to integer registers
 	void incNumIntegerRegisterReads(int count = 1)
 	{
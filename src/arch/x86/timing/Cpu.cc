@@ -17,6 +17,8 @@
  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <lib/esim/Statistics.h>
+
 #include "Cpu.h"
 #include "Timing.h"
 
@@ -79,6 +81,8 @@ int Cpu::thread_quantum;
 int Cpu::thread_switch_penalty;
 long long Cpu::num_fast_forward_instructions;
 long long Cpu::max_cycles = 0;
+int Cpu::parallel_threads = 1;
+int Cpu::parallel_quantum = 10;
 int Cpu::recover_penalty;
 Cpu::RecoverKind Cpu::recover_kind;
 Cpu::FetchKind Cpu::fetch_kind;
@@ -124,6 +128,34 @@ Cpu::Cpu(Timing *timing) : timing(timing)
 	cores.reserve(num_cores);
 	for (int i = 0; i < num_cores; i++)
 		cores.emplace_back(misc::new_unique<Core>(this, i));
+
+	// Interval statistics
+	esim::Statistics *statistics = esim::Statistics::getInstance();
+	for (auto &core : cores)
+	{
+		Core *c = core.get();
+		std::string prefix = misc::fmt("x86.c%d.", c->getId());
+		statistics->Register(prefix + "CommittedInstructions",
+				[c] { return c->getNumCommittedInstructions(); });
+		statistics->Register(prefix + "CommittedUinsts",
+				[c] { return c->getNumCommittedUinsts(); });
+		statistics->Register(prefix + "SquashedUinsts",
+				[c] { return c->getNumSquashedUinsts(); });
+		statistics->Register(prefix + "Branches",
+				[c] { return c->getNumBranches(); });
+		statistics->Register(prefix + "MispredictedBranches",
+				[c] { return c->getNumMispredictedBranches(); });
+	}
+
+	// Host threads for parallel simulation
+	StartParallelWorkers(parallel_threads, num_cores);
+}
+
+
+Cpu::~Cpu()
+{
+	// Parallel simulation
+	StopParallelWorkers();
 }
 
 
@@ -142,6 +174,18 @@ void Cpu::ParseConfiguration(misc::IniFile *ini_file)
 	recover_kind = (RecoverKind)ini_file->ReadEnum(section, "RecoverKind",
 			recover_kind_map, RecoverKindWriteback);
 	recover_penalty = ini_file->ReadInt(section, "RecoverPenalty", 0);
+	parallel_threads = ini_file->ReadInt(section, "ParallelThreads", 1);
+	parallel_quantum = ini_file->ReadInt(section, "ParallelQuantum", 10);
+	if (parallel_threads < 1)
+		throw Timing::Error(misc::fmt("%s: value for "
+				"'ParallelThreads' must be equal or greater "
+				"than 1",
+				ini_file->getPath().c_str()));
+	if (parallel_quantum < 1)
+		throw Timing::Error(misc::fmt("%s: value for "
+				"'ParallelQuantum' must be equal or greater "
+				"than 1",
+				ini_file->getPath().c_str()));
 
 	// Section '[ Pipeline ]'
 	section = "Pipeline";
@@ -178,19 +222,27 @@ void Cpu::ParseConfiguration(misc::IniFile *ini_file)
 
 void Cpu::Run()
 {
+	// Parallel simulation or co-simulation
+	if (inParallelSimulation())
+	{
+		RunParallel(getCycle(), parallel_quantum);
+		return;
+	}
+
 	// Invoke scheduler
 	Schedule();
 
 	// Run all cores
+	long long cycle = getCycle();
 	for (auto &core : cores)
-		core->Run();
+		core->Run(cycle);
 }
 
 
 void Cpu::MemoryAccess(mem::Module *module,
 			mem::Module::AccessType access_type,
 			unsigned address,
-			std::shared_ptr<Uop> uop)
+			Uop *uop)
 {
 	// New frame
 	auto frame = misc::new_shared<MemoryAccessFrame>();
@@ -199,19 +251,74 @@ void Cpu::MemoryAccess(mem::Module *module,
 	frame->address = address;
 	frame->uop = uop;
 
+	// The uop is kept alive while the access is in flight
+	assert(!uop->in_memory_access);
+	uop->in_memory_access = true;
+
+	// Start the access at the end of the quantum if the core is running
+	// ahead of the CPU
+	if (inParallelPhase())
+	{
+		AddPendingAccess(uop->getCore(), frame);
+		return;
+	}
+
 	// Schedule event
 	esim::Engine *esim_engine = esim::Engine::getInstance();
 	esim_engine->Call(event_memory_access_start, frame);
 }
 
 
+long long Cpu::FetchAccess(Thread *thread,
+		mem::Module *module,
+		unsigned address)
+{
+	// Access the module right away if the core is not running ahead of
+	// the CPU
+	if (!inParallelPhase())
+		return module->Access(mem::Module::AccessLoad, address);
+
+	// New frame
+	auto frame = misc::new_shared<MemoryAccessFrame>();
+	frame->module = module;
+	frame->access_type = mem::Module::AccessLoad;
+	frame->address = address;
+	frame->thread = thread;
+
+	// Temporary identifier, unique among the fetches buffered by the
+	// core and not started yet
+	Core *core = thread->getCore();
+	frame->fetch_access = next_fetch_access[core->getId()]--;
+	AddPendingAccess(core, frame);
+	return frame->fetch_access;
+}
+
+
+bool Cpu::canAccess(mem::Module *module, unsigned address) const
+{
+	// Buffered accesses check the module when they start
+	if (inParallelPhase())
+		return true;
+	return module->canAccess(address);
+}
+
+
 void Cpu::MemoryAccessHandler(esim::Event *event, esim::Frame *esim_frame)
 {
 	// Get actual frame
 	MemoryAccessFrame *frame = misc::cast<MemoryAccessFrame *>(esim_frame);
 
 	// Check event
-	if (event == event_memory_access_start)
+	if (event == event_memory_access_start && frame->thread)
+	{
+		// Start instruction fetch and let the thread know its actual
+		// identifier
+		long long id = frame->module->Access(
+				frame->access_type,
+				frame->address);
+		frame->thread->ReplaceFetchAccess(frame->fetch_access, id);
+	}
+	else if (event == event_memory_access_start)
 	{
 		// Start access
 		mem::Module *module = frame->module;
@@ -224,8 +331,11 @@ void Cpu::MemoryAccessHandler(esim::Event *event, esim::Frame *esim_frame)
 	else if (event == event_memory_access_end)
 	{
 		// Insert uop into the core's event queue
-		Core *core = frame->uop->getCore();
-		core->InsertInEventQueue(frame->uop, 0);
+		Uop *uop = frame->uop;
+		Core *core = uop->getCore();
+		core->InsertInEventQueue(uop, 0);
+		assert(uop->in_memory_access);
+		uop->in_memory_access = false;
 	}
 	else
 	{
@@ -241,27 +351,125 @@ long long Cpu::getCycle() const
 }
 
 
-void Cpu::InsertInTraceList(std::shared_ptr<Uop> uop)
+const long long *Cpu::getNumDispatchedUinstArray() const
+{
+	for (int i = 0; i < Uinst::OpcodeCount; i++)
+		num_dispatched_uinst_array[i] = 0;
+	for (auto &core : cores)
+		for (int i = 0; i < Uinst::OpcodeCount; i++)
+			num_dispatched_uinst_array[i] +=
+					core->getNumDispatchedUinstArray()[i];
+	return num_dispatched_uinst_array;
+}
+
+
+long long Cpu::getNumDispatchedUinsts() const
+{
+	long long count = 0;
+	for (auto &core : cores)
+		count += core->getNumDispatchedUinsts();
+	return count;
+}
+
+
+const long long *Cpu::getNumIssuedUinstArray() const
+{
+	for (int i = 0; i < Uinst::OpcodeCount; i++)
+		num_issued_uinst_array[i] = 0;
+	for (auto &core : cores)
+		for (int i = 0; i < Uinst::OpcodeCount; i++)
+			num_issued_uinst_array[i] +=
+					core->getNumIssuedUinstArray()[i];
+	return num_issued_uinst_array;
+}
+
+
+long long Cpu::getNumIssuedUinsts() const
+{
+	long long count = 0;
+	for (auto &core : cores)
+		count += core->getNumIssuedUinsts();
+	return count;
+}
+
+
+const long long *Cpu::getNumCommittedUinstArray() const
+{
+	for (int i = 0; i < Uinst::OpcodeCount; i++)
+		num_committed_uinst_array[i] = 0;
+	for (auto &core : cores)
+		for (int i = 0; i < Uinst::OpcodeCount; i++)
+			num_committed_uinst_array[i] +=
+					core->getNumCommittedUinstArray()[i];
+	return num_committed_uinst_array;
+}
+
+
+long long Cpu::getNumCommittedUinsts() const
+{
+	long long count = 0;
+	for (auto &core : cores)
+		count += core->getNumCommittedUinsts();
+	return count;
+}
+
+
+long long Cpu::getNumSquashedUinsts() const
+{
+	long long count = 0;
+	for (auto &core : cores)
+		count += core->getNumSquashedUinsts();
+	return count;
+}
+
+
+long long Cpu::getNumCommittedInstructions() const
+{
+	long long count = 0;
+	for (auto &core : cores)
+		count += core->getNumCommittedInstructions();
+	return count;
+}
+
+
+long long Cpu::getNumBranches() const
+{
+	long long count = 0;
+	for (auto &core : cores)
+		count += core->getNumBranches();
+	return count;
+}
+
+
+long long Cpu::getNumMispredictedBranches() const
+{
+	long long count = 0;
+	for (auto &core : cores)
+		count += core->getNumMispredictedBranches();
+	return count;
+}
+
+
+void Cpu::InsertInTraceList(Uop *uop)
 {
 	assert(Timing::trace == true);
 	assert(!uop->in_trace_list);
 	uop->in_trace_list = true;
-	uop->trace_list_iterator = trace_list.insert(trace_list.end(), uop);
+	trace_list.PushBack(uop->trace_list_node);
 }
 
 
 void Cpu::EmptyTraceList()
 {
-	while (trace_list.size())
+	while (trace_list.getSize())
 	{
 		// Get instruction at the head
-		std::shared_ptr<Uop> uop = trace_list.front();
+		Uop *uop = trace_list.Front();
 		assert(uop->in_trace_list);
 
 		// Remove from trace list
-		trace_list.pop_front();
+		trace_list.Erase(uop->trace_list_node);
 		uop->in_trace_list = false;
-		uop->trace_list_iterator = trace_list.end();
 
 		// Trace
 		Timing::trace << misc::fmt("x86.end_inst "
@@ -269,6 +477,9 @@ void Cpu::EmptyTraceList()
 				"core=%d\n",
 				uop->getIdInCore(),
 				uop->getCore()->getId());
+
+		// Return uop to the pool if not used anymore
+		uop->getCore()->ReleaseUop(uop);
 	}
 }
 
@@ -26,8 +26,10 @@
 
 #include <memory/Mmu.h>
 #include <memory/Module.h>
+#include <arch/common/ParallelSimulation.h>
 #include <arch/x86/emulator/Emulator.h>
 #include <arch/x86/emulator/Uinst.h>
+#include <lib/cpp/List.h>
 
 #include "Core.h"
 #include "Thread.h"
@@ -41,7 +43,7 @@ namespace x86
 class Timing;
 
 // Class Cpu
-class Cpu
+class Cpu : public comm::ParallelSimulation
 {
 public:
 
@@ -161,6 +163,13 @@ private:
 	// Number of fast forward instructions
 	static long long num_fast_forward_instructions;
 
+	// Number of host threads simulating cores in parallel
+	static int parallel_threads;
+
+	// Number of cycles that cores run ahead of the CPU in parallel
+	// simulation before synchronizing with the memory system
+	static int parallel_quantum;
+
 
 
 	//
@@ -173,6 +182,11 @@ private:
 	// Associated timing simulator, initialized in constructor
 	Timing *timing;
 
+	// List containing uops that need to report an 'end_inst' trace event.
+	// Declared before the cores, since uops still in flight when the cores
+	// are destroyed remove themselves from it.
+	misc::List<Uop> trace_list;
+
 	// Array of cores 
 	std::vector<std::unique_ptr<Core>> cores;
 
@@ -182,8 +196,6 @@ private:
 	// Name of currently simulated stage 
 	std::string stage;
 
-	// List containing uops that need to report an 'end_inst' trace event 
-	std::list<std::shared_ptr<Uop>> trace_list;
 
 
 
@@ -192,39 +204,18 @@ private:
 	// Statistics 
 	//
 
-	// Number of fectched micro-instructions
-	long long num_fetched_uinsts = 0;
+	// Statistics are kept per core, so that cores can update them from
+	// different host threads, and added up when requested. These arrays
+	// hold the sums returned by the array getters.
 
 	// Number of dispatched micro-instructions for every opcode
-	long long num_dispatched_uinst_array[Uinst::OpcodeCount] = { };
+	mutable long long num_dispatched_uinst_array[Uinst::OpcodeCount];
 
 	// Number of issued micro-instructions for every opcode
-	long long num_issued_uinst_array[Uinst::OpcodeCount] = { };
+	mutable long long num_issued_uinst_array[Uinst::OpcodeCount];
 
 	// Number of committed micro-instructions for every opcode
-	long long num_committed_uinst_array[Uinst::OpcodeCount] = { };
-
-	// Number of dispatched micro-instructions
-	long long num_dispatched_uinsts = 0;
-
-	// Number of issued micro-instructions
-	long long num_issued_uinsts = 0;
-
-	// Number of committed micro-instructions
-	long long num_committed_uinsts = 0;
-
-
-	// Committed macro-instructions
-	long long num_committed_instructions = 0;
-
-	// Number of squashed micro-instructions
-	long long num_squashed_uinsts = 0;
-
-	// Number of branch micro-instructions
-	long long num_branches = 0;
-
-	// Number of mis-predicted branch micro-instructions
-	long long num_mispredicted_branches = 0;
+	mutable long long num_committed_uinst_array[Uinst::OpcodeCount];
 
 
 
@@ -259,7 +250,15 @@ private:
 		unsigned address = -1;
 
 		// Uop associated with the memory access
-		std::shared_ptr<Uop> uop;
+		Uop *uop = nullptr;
+
+		// Thread performing an instruction fetch buffered in parallel
+		// simulation, or null for data accesses
+		Thread *thread = nullptr;
+
+		// Temporary identifier returned to the thread for a buffered
+		// instruction fetch, replaced when the access starts
+		long long fetch_access = 0;
 	};
 
 	// Event scheduled to start a memory access
@@ -274,6 +273,59 @@ private:
 
 
 
+	//
+	// Parallel simulation (CpuParallel.cc)
+	//
+
+	// Memory access issued by a core while running ahead of the CPU
+	class PendingMemoryAccess : public PendingAccess
+	{
+		// Frame for the access start event
+		std::shared_ptr<MemoryAccessFrame> frame;
+
+	public:
+
+		// Constructor
+		PendingMemoryAccess(std::shared_ptr<MemoryAccessFrame> frame) :
+				PendingAccess(frame->module),
+				frame(frame)
+		{
+		}
+
+		// Schedule the access start event if the module can accept the
+		// access
+		bool Start() override;
+	};
+
+	// Temporary identifier returned for the next instruction fetch
+	// buffered by each core. Identifiers are negative and decrease, so
+	// that they stay unique while buffered fetches wait for their module
+	// across quanta.
+	std::vector<long long> next_fetch_access;
+
+	// Number of instructions emulated by each core in the current quantum
+	std::vector<long long> parallel_num_instructions;
+
+	// Disable parallel simulation while tracing, and prepare the MMU and
+	// the emulator
+	bool PrepareParallelSimulation() override;
+
+	// Run one cycle of a core on a worker thread
+	void RunUnit(int index, long long cycle) override;
+
+	// Invoke the scheduler before each quantum
+	void BeginQuantum() override;
+
+	// Add the instructions emulated in the quantum to the emulator
+	void EndQuantum() override;
+
+	// Buffer a memory access issued by a core in its current cycle
+	void AddPendingAccess(Core *core,
+			std::shared_ptr<MemoryAccessFrame> frame);
+
+
+
+
 	//
 	// CPU parameters
 	//
@@ -441,6 +493,14 @@ public:
 	/// Return the maximum number of cycles to simulate, as configured by
 	/// the user
 	static long long getMaxCycles() { return max_cycles; }
+
+	/// Return the number of host threads for parallel simulation, as
+	/// configured by the user
+	static int getParallelThreads() { return parallel_threads; }
+
+	/// Return the number of cycles in a parallel simulation quantum, as
+	/// configured by the user
+	static int getParallelQuantum() { return parallel_quantum; }
 	
 	/// Read branch predictor configuration from configuration file
 	static void ParseConfiguration(misc::IniFile *ini_file);
@@ -455,6 +515,9 @@ public:
 	/// Constructor
 	Cpu(Timing *timing);
 
+	/// Destructor
+	~Cpu();
+
 	/// Return the core with the given index
 	Core *getCore(int index) const
 	{
@@ -480,7 +543,7 @@ public:
 	/// Insert an uop into a list of uops that still need to dump an
 	/// 'end_inst' trace event. This will happen when the trace list is
 	/// emptied with a call to EmptyUopTraceList().
-	void InsertInTraceList(std::shared_ptr<Uop> uop);
+	void InsertInTraceList(Uop *uop);
 
 	/// Empty the uop trace list and make every uop contained in it dump
 	/// its last 'end_inst' trace event.
@@ -501,7 +564,28 @@ public:
 	void MemoryAccess(mem::Module *module,
 			mem::Module::AccessType access_type,
 			unsigned address,
-			std::shared_ptr<Uop> uop);
+			Uop *uop);
+
+	/// Fetch the block containing the given physical address from the
+	/// instruction module of \a thread. Return the access identifier, to
+	/// be checked with Module::isInFlightAccess(). In parallel simulation,
+	/// the access is buffered and a negative temporary identifier is
+	/// returned instead, replaced by Thread::ReplaceFetchAccess() when the
+	/// access starts.
+	long long FetchAccess(Thread *thread,
+			mem::Module *module,
+			unsigned address);
+
+	/// Count an instruction emulated by \a core while running ahead of
+	/// the CPU. The emulator does not count it itself in the meantime.
+	void incNumParallelInstructions(Core *core);
+
+	/// Return whether \a module can accept an access to the given
+	/// physical address, as given by mem::Module::canAccess(). While
+	/// cores run ahead of the CPU, the state of the module is not known,
+	/// and true is returned. The buffered access is then held back when
+	/// it starts until the module can accept it.
+	bool canAccess(mem::Module *module, unsigned address) const;
 
 
 
@@ -538,92 +622,38 @@ public:
 	// Stats
 	//
 
-	/// Increment the number of fetched micro-instructions
-	void incNumFetchedUinsts() { num_fetched_uinsts++; }
-
-	/// Increment the number of dispatched micro-instructions of a kind
-	void incNumDispatchedUinsts(Uinst::Opcode opcode)
-	{
-		assert(opcode < Uinst::OpcodeCount);
-		num_dispatched_uinst_array[opcode]++;
-		num_dispatched_uinsts++;
-	}
-
-	/// Return the array of dispatched micro-instructions
-	const long long *getNumDispatchedUinstArray() const
-	{
-		return num_dispatched_uinst_array;
-	}
+	/// Return the array of dispatched micro-instructions for every
+	/// opcode, added up for all cores
+	const long long *getNumDispatchedUinstArray() const;
 
 	/// Return the number of dispatched micro-instructions
-	long long getNumDispatchedUinsts() const
-	{
-		return num_dispatched_uinsts;
-	}
-
-	/// Increment the number of issued micro-instructions of a kind
-	void incNumIssuedUinsts(Uinst::Opcode opcode)
-	{
-		assert(opcode < Uinst::OpcodeCount);
-		num_issued_uinst_array[opcode]++;
-		num_issued_uinsts++;
-	}
+	long long getNumDispatchedUinsts() const;
 
-	/// Return the array of issued micro-instructions
-	const long long *getNumIssuedUinstArray() const
-	{
-		return num_issued_uinst_array;
-	}
+	/// Return the array of issued micro-instructions for every opcode,
+	/// added up for all cores
+	const long long *getNumIssuedUinstArray() const;
 
 	/// Return the number of issued micro-instructions
-	long long getNumIssuedUinsts() const
-	{
-		return num_issued_uinsts;
-	}
-
-	/// Increment the number of committed micro-instructions of a type
-	void incNumCommittedUinsts(Uinst::Opcode opcode)
-	{
-		assert(opcode < Uinst::OpcodeCount);
-		num_committed_uinst_array[opcode]++;
-		num_committed_uinsts++;
-	}
+	long long getNumIssuedUinsts() const;
 
-	/// Return the array of committed micro-instructions
-	const long long *getNumCommittedUinstArray() const
-	{
-		return num_committed_uinst_array;
-	}
+	/// Return the array of committed micro-instructions for every
+	/// opcode, added up for all cores
+	const long long *getNumCommittedUinstArray() const;
 
 	/// Return the number of committed micro-instructions
-	long long getNumCommittedUinsts() const
-	{
-		return num_committed_uinsts;
-	}
-
-	/// Increment the number of squashed micro-instructions
-	void incNumSquashedUinsts() { num_squashed_uinsts++; }
+	long long getNumCommittedUinsts() const;
 
 	/// Return the number of squashed micro-instructions
-	long long getNumSquashedUinsts() const { return num_squashed_uinsts; }
+	long long getNumSquashedUinsts() const;
 
-	/// Increment the number of committed instructions
-	void incNumCommittedInstructions() { num_committed_instructions++; }
-	
 	/// Return the number of committed macro-instructions
-	long long getNumCommittedInstructions() const { return num_committed_instructions; }
-
-	/// Increment the number of branches
-	void incNumBranches() { num_branches++; }
+	long long getNumCommittedInstructions() const;
 
 	/// Return the number of committed branches
-	long long getNumBranches() const { return num_branches; }
-
-	/// Increment the number of mispredicted branches
-	void incNumMispredictedBranches() { num_mispredicted_branches++; }
+	long long getNumBranches() const;
 
 	/// Return the number of mispredicted branches
-	long long getNumMispredictedBranches() const { return num_mispredicted_branches; }
+	long long getNumMispredictedBranches() const;
 };
 
 }
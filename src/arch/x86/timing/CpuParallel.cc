@@ -0,0 +1,121 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2012  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Cpu.h"
+#include "RegisterFile.h"
+#include "Timing.h"
+#include "TraceCache.h"
+
+
+namespace x86
+{
+
+// Number of regions that physical memory is split into in parallel
+// simulation, each one allocating the pages of a different process
+static const int parallel_mmu_regions = 16;
+
+
+bool Cpu::PrepareParallelSimulation()
+{
+	// Traces and debug output are written by the cores in the order in
+	// which they are simulated, which is only meaningful sequentially.
+	if (Timing::trace || RegisterFile::debug || TraceCache::debug ||
+			Emulator::isa_debug || Emulator::call_debug)
+	{
+		misc::Warning("x86 parallel simulation disabled while tracing "
+				"or debugging the pipeline or the emulator");
+		return false;
+	}
+
+	// Cores translate addresses in an order that depends on the relative
+	// speed of host threads. Allocating the physical pages of each
+	// process in a separate region keeps physical addresses independent
+	// of it.
+	emulator->getMmu()->setNumRegions(parallel_mmu_regions);
+
+	// Cores emulating contexts with different memory images run
+	// concurrently. System calls access state shared by all contexts,
+	// and take the functional lock.
+	emulator->setSyscallMutex(getFunctionalMutex());
+
+	// Temporary identifiers of buffered instruction fetches, and
+	// per-core instruction counters
+	next_fetch_access.resize(num_cores, -1);
+	parallel_num_instructions.resize(num_cores);
+	return true;
+}
+
+
+void Cpu::RunUnit(int index, long long cycle)
+{
+	cores[index]->Run(cycle);
+}
+
+
+void Cpu::BeginQuantum()
+{
+	// Invoke scheduler
+	Schedule();
+
+	// Cores count the instructions they emulate
+	emulator->setTimingParallelPhase(true);
+}
+
+
+void Cpu::EndQuantum()
+{
+	// Count instructions
+	emulator->setTimingParallelPhase(false);
+	for (long long &num_emulated : parallel_num_instructions)
+	{
+		emulator->incNumInstructions(num_emulated);
+		num_emulated = 0;
+	}
+}
+
+
+void Cpu::incNumParallelInstructions(Core *core)
+{
+	parallel_num_instructions[core->getId()]++;
+}
+
+
+bool Cpu::PendingMemoryAccess::Start()
+{
+	// Wait until the module can accept the access, as the core would
+	// have done in a sequential simulation
+	if (!frame->module->canAccess(frame->address))
+		return false;
+
+	// Schedule event
+	esim::Engine *esim_engine = esim::Engine::getInstance();
+	esim_engine->Call(event_memory_access_start, frame);
+	return true;
+}
+
+
+void Cpu::AddPendingAccess(Core *core,
+		std::shared_ptr<MemoryAccessFrame> frame)
+{
+	comm::ParallelSimulation::AddPendingAccess(core->getId(),
+			core->getCycle(),
+			misc::new_unique<PendingMemoryAccess>(frame));
+}
+
+}
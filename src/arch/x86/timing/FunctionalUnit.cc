@@ -55,9 +55,8 @@ const misc::StringMap FunctionalUnit::type_map =
 
 int FunctionalUnit::Reserve(Uop *uop)
 {
-	// Current cycle
-	Timing *timing = Timing::getInstance();
-	long long cycle = timing->getCycle();
+	// Current cycle in the core running the uop
+	long long cycle = uop->getCore()->getCycle();
 
 	// Find a free functional unit
 	assert(num_instances <= MaxInstances);
@@ -397,6 +397,7 @@ void RegisterFile::Rename(Uop *uop)
 			// Rename register
 			int physical_register = integer_rat[logical_register - Uinst::DepIntFirst];
 			uop->setInput(dep, physical_register);
+			AddConsumer(integer_registers[physical_register], uop, dep);
 
 			// Debug
 			debug << "  Input " << Uinst::dep_map[logical_register]
@@ -418,6 +419,7 @@ void RegisterFile::Rename(Uop *uop)
 			// Rename register
 			int physical_register = floating_point_rat[stack_register - Uinst::DepFpFirst];
 			uop->setInput(dep, physical_register);
+			AddConsumer(floating_point_registers[physical_register], uop, dep);
 
 			// Debug
 			debug << "  Input " << Uinst::dep_map[logical_register]
@@ -432,6 +434,7 @@ void RegisterFile::Rename(Uop *uop)
 			// Rename register
 			int physical_register = xmm_rat[logical_register - Uinst::DepXmmFirst];
 			uop->setInput(dep, physical_register);
+			AddConsumer(xmm_registers[physical_register], uop, dep);
 
 			// Debug
 			debug << "  Input " << Uinst::dep_map[logical_register]
@@ -447,6 +450,10 @@ void RegisterFile::Rename(Uop *uop)
 		}
 	}
 
+	// The uop is ready to issue if none of its input registers is pending
+	if (!uop->num_pending_inputs)
+		uop->ready = true;
+
 	// Rename output int/FP/XMM registers (not flags)
 	int flag_physical_register = -1;
 	int flag_count = 0;
@@ -573,40 +580,50 @@ void RegisterFile::Rename(Uop *uop)
 
 bool RegisterFile::isUopReady(Uop *uop)
 {
-	// If uop is marked as ready, it means that we verified that it is
-	// ready before. The uop ready state can never change from true to
-	// false.
-	if (uop->ready)
-		return true;
+	// Input dependencies are tracked since the uop was renamed. The uop is
+	// marked as ready when its last pending input register is written.
+	assert(uop->ready == !uop->num_pending_inputs);
+	return uop->ready;
+}
 
-	// Traverse dependencies
-	for (int dep = 0; dep < Uinst::MaxIDeps; dep++)
-	{
-		// Get dependencies
-		int logical_register = uop->getUinst()->getIDep(dep);
-		int physical_register = uop->getInput(dep);
 
-		// Integer dependency
-		if (Uinst::isIntegerDependency(logical_register)
-				&& integer_registers[physical_register].pending)
-			return false;
+void RegisterFile::AddConsumer(PhysicalRegister &physical_register,
+		Uop *uop,
+		int dep)
+{
+	// Nothing to wait for
+	if (!physical_register.pending)
+		return;
 
-		// Floating-point dependency
-		if (Uinst::isFloatingPointDependency(logical_register)
-				&& floating_point_registers[physical_register].pending)
-			return false;
+	// Wait for the register to be written
+	physical_register.consumers.PushBack(uop->consumer_nodes[dep]);
+	uop->num_pending_inputs++;
+}
 
-		// XMM dependency
-		if (Uinst::isXmmDependency(logical_register)
-				&& xmm_registers[physical_register].pending)
-			return false;
-	}
 
-	// At this point, we found that the uop is ready. Save this information
-	// in the 'ready' field of the uop to avoid having to check in the
-	// future.
-	uop->ready = true;
-	return true;
+void RegisterFile::WritePhysicalRegister(PhysicalRegister &physical_register)
+{
+	// Result is available
+	physical_register.pending = false;
+
+	// Wake up consumers
+	while (physical_register.consumers.getSize())
+	{
+		// Remove consumer from list
+		Uop *uop = physical_register.consumers.Front();
+		physical_register.consumers.Erase(
+				physical_register.consumers.begin());
+
+		// Check if this was the last pending input
+		assert(uop->num_pending_inputs > 0);
+		uop->num_pending_inputs--;
+		if (uop->num_pending_inputs)
+			continue;
+
+		// Uop is ready to issue
+		uop->ready = true;
+		uop->getThread()->WakeUp(uop);
+	}
 }
 
 
@@ -618,11 +635,11 @@ void RegisterFile::WriteUop(Uop *uop)
 		int logical_register = uop->getUinst()->getODep(dep);
 		int physical_register = uop->getOutput(dep);
 		if (Uinst::isIntegerDependency(logical_register))
-			integer_registers[physical_register].pending = false;
+			WritePhysicalRegister(integer_registers[physical_register]);
 		else if (Uinst::isFloatingPointDependency(logical_register))
-			floating_point_registers[physical_register].pending = false;
+			WritePhysicalRegister(floating_point_registers[physical_register]);
 		else if (Uinst::isXmmDependency(logical_register))
-			xmm_registers[physical_register].pending = false;
+			WritePhysicalRegister(xmm_registers[physical_register]);
 	}
 }
 
@@ -22,6 +22,7 @@
 
 #include <lib/cpp/Debug.h>
 #include <lib/cpp/IniFile.h>
+#include <lib/cpp/List.h>
 #include <arch/x86/emulator/Uinst.h>
 
 #include "Uop.h"
@@ -80,8 +81,22 @@ private:
 
 		// Number of logical registers mapped to this physical register
 		int busy = 0;
+
+		// Uops that found this register pending when renamed, and are
+		// waiting for it to be written
+		misc::List<Uop> consumers;
 	};
 
+	// Register the given input dependence of a uop as a consumer of a
+	// physical register, if the register is still pending.
+	void AddConsumer(PhysicalRegister &physical_register,
+			Uop *uop,
+			int dep);
+
+	// Mark a physical register as written, and wake up the uops waiting
+	// for it.
+	void WritePhysicalRegister(PhysicalRegister &physical_register);
+
 
 
 
@@ -287,7 +302,9 @@ public:
 	bool isUopReady(Uop *uop);
 
 	/// Update the state of the register file when an uop completes, that
-	/// is, when its results are written back.
+	/// is, when its results are written back. Uops waiting for the written
+	/// physical registers are woken up in their thread when their last
+	/// pending input is written.
 	void WriteUop(Uop *uop);
 
 	/// Update the state of the register file when an uop is recovered from
@@ -103,14 +103,14 @@ void Thread::Dump(std::ostream &os) const
 }
 
 
-void Thread::InsertInFetchQueue(std::shared_ptr<Uop> uop)
+void Thread::InsertInFetchQueue(Uop *uop)
 {
 	// Sanity
 	assert(!uop->in_fetch_queue);
 
 	// Insert in queue
 	uop->in_fetch_queue = true;
-	uop->fetch_queue_iterator = fetch_queue.insert(fetch_queue.end(), uop);
+	fetch_queue.PushBack(uop->fetch_queue_node);
 
 	// Increase occupancy of fetch queue or trace queue
 	if (uop->from_trace_cache)
@@ -135,17 +135,13 @@ void Thread::ExtractFromFetchQueue(Uop *uop)
 	// Sanity: uop must be in the fetch queue, and must be either the first
 	// or the last element in it.
 	assert(uop->in_fetch_queue);
-	assert(uop->fetch_queue_iterator != fetch_queue.end());
-	assert(fetch_queue.size() > 0);
-	assert(uop == fetch_queue.front().get() ||
-			uop == fetch_queue.back().get());
+	assert(fetch_queue.getSize() > 0);
+	assert(uop == fetch_queue.Front() ||
+			uop == fetch_queue.Back());
 	
-	// Save iterator
-	auto it = uop->fetch_queue_iterator;
-
-	// Mark uop as extracted
+	// Extract uop
+	fetch_queue.Erase(uop->fetch_queue_node);
 	uop->in_fetch_queue = false;
-	uop->fetch_queue_iterator = fetch_queue.end();
 
 	// Decrease occupancy of fetch queue or trace queue
 	if (uop->from_trace_cache)
@@ -167,8 +163,8 @@ void Thread::ExtractFromFetchQueue(Uop *uop)
 		}
 	}
 
-	// Extract uop as last step, since uop may be freed here
-	fetch_queue.erase(it);
+	// Return uop to the pool if not used anymore
+	core->ReleaseUop(uop);
 }
 
 
@@ -181,7 +177,7 @@ void Thread::DumpFetchQueue(std::ostream &os) const
 
 	// Dump content
 	int index = 0;
-	for (auto &uop : fetch_queue)
+	for (Uop *uop : fetch_queue)
 	{
 		os << misc::fmt("%3d. ", index);
 		os << *uop << '\n';
@@ -189,7 +185,7 @@ void Thread::DumpFetchQueue(std::ostream &os) const
 	}
 
 	// Empty list
-	if (fetch_queue.empty())
+	if (!fetch_queue.getSize())
 		os << "-Empty-\n";
 
 	// End
@@ -197,11 +193,11 @@ void Thread::DumpFetchQueue(std::ostream &os) const
 }
 
 
-void Thread::InsertInUopQueue(std::shared_ptr<Uop> uop)
+void Thread::InsertInUopQueue(Uop *uop)
 {
 	assert(!uop->in_uop_queue);
 	uop->in_uop_queue = true;
-	uop->uop_queue_iterator = uop_queue.insert(uop_queue.end(), uop);
+	uop_queue.PushBack(uop->uop_queue_node);
 }
 
 
@@ -210,18 +206,15 @@ void Thread::ExtractFromUopQueue(Uop *uop)
 	// Sanity: uop must be in the uop queue, and must be either the first
 	// or the last element in it.
 	assert(uop->in_uop_queue);
-	assert(uop_queue.size() > 0);
-	assert(uop == uop_queue.front().get() || uop_queue.back().get());
-
-	// Save iterator
-	auto it = uop->uop_queue_iterator;
+	assert(uop_queue.getSize() > 0);
+	assert(uop == uop_queue.Front() || uop == uop_queue.Back());
 
-	// Mark uop as extracted
+	// Extract uop
+	uop_queue.Erase(uop->uop_queue_node);
 	uop->in_uop_queue = false;
-	uop->uop_queue_iterator = uop_queue.end();
 
-	// Extract uop as last step, since this may free it
-	uop_queue.erase(it);
+	// Return uop to the pool if not used anymore
+	core->ReleaseUop(uop);
 }
 
 
@@ -234,7 +227,7 @@ void Thread::DumpUopQueue(std::ostream &os) const
 
 	// Dump content
 	int index = 0;
-	for (auto &uop : uop_queue)
+	for (Uop *uop : uop_queue)
 	{
 		os << misc::fmt("%3d. ", index);
 		os << *uop << '\n';
@@ -242,7 +235,7 @@ void Thread::DumpUopQueue(std::ostream &os) const
 	}
 
 	// Empty list
-	if (uop_queue.empty())
+	if (!uop_queue.getSize())
 		os << "-Empty-\n";
 
 	// End
@@ -260,7 +253,7 @@ bool Thread::canInsertInReorderBuffer()
 		// Return whether the number of instructions in this thread's
 		// ROB is smaller than the ROB size configured by the user,
 		// which is specified as a per-thread ROB size.
-		return (int) reorder_buffer.size() <
+		return reorder_buffer.getSize() <
 				Cpu::getReorderBufferSize();
 
 	case Cpu::ReorderBufferKindShared:
@@ -278,14 +271,14 @@ bool Thread::canInsertInReorderBuffer()
 }
 
 
-void Thread::InsertInReorderBuffer(std::shared_ptr<Uop> uop)
+void Thread::InsertInReorderBuffer(Uop *uop)
 {
 	// Sanity
 	assert(!uop->in_reorder_buffer);
 
 	// Insert into reorder buffer
 	uop->in_reorder_buffer = true;
-	uop->reorder_buffer_iterator = reorder_buffer.insert(reorder_buffer.end(), uop);
+	reorder_buffer.PushBack(uop->reorder_buffer_node);
 
 	// Increase per-core counter
 	core->incReorderBufferOccupancy();
@@ -297,21 +290,18 @@ void Thread::ExtractFromReorderBuffer(Uop *uop)
 	// Sanity: uop must be in the reorder buffer, and must be either the
 	// first or the last instruction in that queue.
 	assert(uop->in_reorder_buffer);
-	assert(reorder_buffer.size() > 0);
-	assert(uop == reorder_buffer.front().get() || reorder_buffer.back().get());
+	assert(reorder_buffer.getSize() > 0);
+	assert(uop == reorder_buffer.Front() || uop == reorder_buffer.Back());
 
-	// Save iterator
-	auto it = uop->reorder_buffer_iterator;
-
-	// Mark uop as extracted
+	// Extract uop
+	reorder_buffer.Erase(uop->reorder_buffer_node);
 	uop->in_reorder_buffer = false;
-	uop->reorder_buffer_iterator = reorder_buffer.end();
-
-	// Extract uop as last step, since this may free it
-	reorder_buffer.erase(it);
 
 	// Decrease per-core counter
 	core->decReorderBufferOccupancy();
+
+	// Return uop to the pool if not used anymore
+	core->ReleaseUop(uop);
 }
 
 
@@ -327,7 +317,7 @@ void Thread::DumpReorderBuffer(std::ostream &os) const
 
 	// Dump content
 	int index = 0;
-	for (auto &uop : reorder_buffer)
+	for (Uop *uop : reorder_buffer)
 	{
 		// Instruction
 		os << misc::fmt("%3d. ", index);
@@ -360,7 +350,7 @@ void Thread::DumpReorderBuffer(std::ostream &os) const
 	}
 
 	// Empty list
-	if (reorder_buffer.empty())
+	if (!reorder_buffer.getSize())
 		os << "-Empty-\n";
 
 	// End
@@ -378,7 +368,7 @@ bool Thread::canInsertInInstructionQueue()
 		// Return whether the number of instructions in this thread's IQ
 		// is smaller than the IQ size configured by the user, which is
 		// specified as a per-thread IQ size.
-		return (int) instruction_queue.size() <
+		return instruction_queue.getSize() <
 				Cpu::getInstructionQueueSize();
 
 	case Cpu::InstructionQueueKindShared:
@@ -396,7 +386,7 @@ bool Thread::canInsertInInstructionQueue()
 }
 
 
-void Thread::InsertInInstructionQueue(std::shared_ptr<Uop> uop)
+void Thread::InsertInInstructionQueue(Uop *uop)
 {
 	// Sanity
 	assert(!uop->in_instruction_queue);
@@ -405,8 +395,11 @@ void Thread::InsertInInstructionQueue(std::shared_ptr<Uop> uop)
 
 	// Insert into instruction queue
 	uop->in_instruction_queue = true;
-	uop->instruction_queue_iterator = instruction_queue.insert(
-			instruction_queue.end(), uop);
+	instruction_queue.PushBack(uop->instruction_queue_node);
+
+	// Candidate for issue if operands are available
+	if (uop->ready)
+		InsertInReadyQueue(instruction_ready_queue, uop);
 
 	// Increase per-core counter
 	core->incInstructionQueueOccupancy();
@@ -420,18 +413,16 @@ void Thread::ExtractFromInstructionQueue(Uop *uop)
 	assert(!uop->in_store_queue);
 	assert(uop->in_instruction_queue);
 
-	// Save iterator
-	auto it = uop->instruction_queue_iterator;
-
-	// Mark uop as not present
+	// Remove from queue
+	ExtractFromReadyQueue(instruction_ready_queue, uop);
+	instruction_queue.Erase(uop->instruction_queue_node);
 	uop->in_instruction_queue = false;
-	uop->instruction_queue_iterator = instruction_queue.end();
-	
-	// Remove from queue as the last step, as this may free the uop
-	instruction_queue.erase(it);
 
 	// Decrease per-core counter
 	core->decInstructionQueueOccupancy();
+
+	// Return uop to the pool if not used anymore
+	core->ReleaseUop(uop);
 }
 
 
@@ -444,7 +435,7 @@ void Thread::DumpInstructionQueue(std::ostream &os) const
 
 	// Dump content
 	int index = 0;
-	for (auto &uop : instruction_queue)
+	for (Uop *uop : instruction_queue)
 	{
 		os << misc::fmt("%3d. ", index);
 		os << *uop << '\n';
@@ -452,7 +443,7 @@ void Thread::DumpInstructionQueue(std::ostream &os) const
 	}
 
 	// Empty list
-	if (instruction_queue.empty())
+	if (!instruction_queue.getSize())
 		os << "-Empty-\n";
 
 	// End
@@ -460,6 +451,41 @@ void Thread::DumpInstructionQueue(std::ostream &os) const
 }
 
 
+void Thread::InsertInReadyQueue(misc::List<Uop> &ready_queue, Uop *uop)
+{
+	// Sanity
+	assert(uop->ready);
+	assert(!uop->in_ready_queue);
+
+	// Uops are issued oldest first. Uops usually become ready in program
+	// order, so check the tail of the queue first.
+	auto it = ready_queue.end();
+	Uop *back = ready_queue.Back();
+	if (back && back->getIdInCore() > uop->getIdInCore())
+	{
+		it = ready_queue.begin();
+		while ((*it)->getIdInCore() < uop->getIdInCore())
+			++it;
+	}
+
+	// Insert
+	ready_queue.Insert(it, uop->ready_queue_node);
+	uop->in_ready_queue = true;
+}
+
+
+void Thread::ExtractFromReadyQueue(misc::List<Uop> &ready_queue, Uop *uop)
+{
+	// Uop may still be waiting for its operands
+	if (!uop->in_ready_queue)
+		return;
+
+	// Remove from queue
+	ready_queue.Erase(uop->ready_queue_node);
+	uop->in_ready_queue = false;
+}
+
+
 bool Thread::canInsertInLoadStoreQueue()
 {
 	switch (Cpu::getLoadStoreQueueKind())
@@ -470,7 +496,7 @@ bool Thread::canInsertInLoadStoreQueue()
 		// Return whether the number of instructions in this thread's
 		// LSQ is smaller than the IQ size configured by the user, which
 		// is specified as a per-thread LSQ size
-		return (int) (load_queue.size() + store_queue.size()) <
+		return load_queue.getSize() + store_queue.getSize() <
 				Cpu::getLoadStoreQueueSize();
 
 	case Cpu::LoadStoreQueueKindShared:
@@ -488,7 +514,7 @@ bool Thread::canInsertInLoadStoreQueue()
 }
 
 
-void Thread::InsertInLoadStoreQueue(std::shared_ptr<Uop> uop)
+void Thread::InsertInLoadStoreQueue(Uop *uop)
 {
 	// Sanity
 	assert(!uop->in_load_queue);
@@ -500,13 +526,15 @@ void Thread::InsertInLoadStoreQueue(std::shared_ptr<Uop> uop)
 
 	case Uinst::OpcodeLoad:
 
-		uop->load_queue_iterator = load_queue.insert(load_queue.end(), uop);
+		load_queue.PushBack(uop->load_queue_node);
 		uop->in_load_queue = true;
+		if (uop->ready)
+			InsertInReadyQueue(load_ready_queue, uop);
 		break;
 
 	case Uinst::OpcodeStore:
 
-		uop->store_queue_iterator = store_queue.insert(store_queue.end(), uop);
+		store_queue.PushBack(uop->store_queue_node);
 		uop->in_store_queue = true;
 		break;
 	
@@ -527,18 +555,16 @@ void Thread::ExtractFromLoadQueue(Uop *uop)
 	assert(!uop->in_store_queue);
 	assert(!uop->in_instruction_queue);
 
-	// Save iterator
-	auto it = uop->load_queue_iterator;
-
-	// Mark as not present in the queue
+	// Remove from queue
+	ExtractFromReadyQueue(load_ready_queue, uop);
+	load_queue.Erase(uop->load_queue_node);
 	uop->in_load_queue = false;
-	uop->load_queue_iterator = load_queue.end();
-	
-	// Remove from queue as last step, as this may free uop
-	load_queue.erase(it);
 
 	// Decrease per-core counter
 	core->decLoadStoreQueueOccupancy();
+
+	// Return uop to the pool if not used anymore
+	core->ReleaseUop(uop);
 }
 
 
@@ -549,18 +575,15 @@ void Thread::ExtractFromStoreQueue(Uop *uop)
 	assert(!uop->in_load_queue);
 	assert(uop->in_store_queue);
 
-	// Save iterator
-	auto it = uop->store_queue_iterator;
-
-	// Mark as not present in the queue
+	// Remove from queue
+	store_queue.Erase(uop->store_queue_node);
 	uop->in_store_queue = false;
-	uop->store_queue_iterator = store_queue.end();
-
-	// Remove from queue as last step, as this may free uop
-	store_queue.erase(it);
 
 	// Decrease per-core counter
 	core->decLoadStoreQueueOccupancy();
+
+	// Return uop to the pool if not used anymore
+	core->ReleaseUop(uop);
 }
 
 
@@ -573,7 +596,7 @@ void Thread::DumpLoadStoreQueue(std::ostream &os) const
 
 	// Dump content
 	int index = 0;
-	for (auto &uop : load_queue)
+	for (Uop *uop : load_queue)
 	{
 		os << misc::fmt("%3d. ", index);
 		os << *uop << '\n';
@@ -581,7 +604,7 @@ void Thread::DumpLoadStoreQueue(std::ostream &os) const
 	}
 
 	// Empty list
-	if (load_queue.empty())
+	if (!load_queue.getSize())
 		os << "-Empty-\n";
 
 	// End
@@ -594,7 +617,7 @@ void Thread::DumpLoadStoreQueue(std::ostream &os) const
 
 	// Dump content
 	index = 0;
-	for (auto &uop : store_queue)
+	for (Uop *uop : store_queue)
 	{
 		os << misc::fmt("%3d. ", index);
 		os << *uop << '\n';
@@ -602,7 +625,7 @@ void Thread::DumpLoadStoreQueue(std::ostream &os) const
 	}
 
 	// Empty list
-	if (store_queue.empty())
+	if (!store_queue.getSize())
 		os << "-Empty-\n";
 
 	// End
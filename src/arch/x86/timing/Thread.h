@@ -26,6 +26,7 @@
 #include <memory/Module.h>
 #include <arch/x86/emulator/Uinst.h>
 #include <arch/x86/emulator/Context.h>
+#include <lib/cpp/List.h>
 
 #include "Uop.h"
 #include "BranchPredictor.h"
@@ -82,10 +83,10 @@ private:
 	//
 
 	// Fetch queue
-	std::list<std::shared_ptr<Uop>> fetch_queue;
+	misc::List<Uop> fetch_queue;
 
 	// Insert a uop into the tail of the fetch queue
-	void InsertInFetchQueue(std::shared_ptr<Uop> uop);
+	void InsertInFetchQueue(Uop *uop);
 
 	// Extract a uop from the fetch queue. The uop must be located either
 	// at the head or at the tail of the fetch queue.
@@ -102,10 +103,10 @@ private:
 	//
 
 	// Uop queue
-	std::list<std::shared_ptr<Uop>> uop_queue;
+	misc::List<Uop> uop_queue;
 
 	// Insert a uop into the tail of the uop queue
-	void InsertInUopQueue(std::shared_ptr<Uop> uop);
+	void InsertInUopQueue(Uop *uop);
 
 	// Extract a uop from the uop queue. The uop must be located either at
 	// the head or at the tail of the uop queue.
@@ -122,10 +123,10 @@ private:
 	//
 
 	// Reorder buffer
-	std::list<std::shared_ptr<Uop>> reorder_buffer;
+	misc::List<Uop> reorder_buffer;
 
 	// Insert a uop into the tail of the reorder buffer
-	void InsertInReorderBuffer(std::shared_ptr<Uop> uop);
+	void InsertInReorderBuffer(Uop *uop);
 
 	// Determine whether a new uop can be inserted into this thread's
 	// reorder buffer, based on whether it is private or shared among
@@ -148,10 +149,10 @@ private:
 	//
 
 	// Instruction queue
-	std::list<std::shared_ptr<Uop>> instruction_queue;
+	misc::List<Uop> instruction_queue;
 
 	// Insert a uop into the tail of the instruction queue
-	void InsertInInstructionQueue(std::shared_ptr<Uop> uop);
+	void InsertInInstructionQueue(Uop *uop);
 
 	// Remove a uop from the instruction queue. The uop must be currently
 	// present in said queue.
@@ -168,15 +169,37 @@ private:
 
 
 
+	//
+	// Ready queues
+	//
+
+	// Uops in the instruction queue whose input operands are available,
+	// in program order. The issue stage only traverses this list, instead
+	// of checking every uop in the instruction queue.
+	misc::List<Uop> instruction_ready_queue;
+
+	// Loads in the load queue whose input operands are available, in
+	// program order
+	misc::List<Uop> load_ready_queue;
+
+	// Insert a uop into the given ready queue, keeping program order
+	void InsertInReadyQueue(misc::List<Uop> &ready_queue, Uop *uop);
+
+	// Remove a uop from the given ready queue, if present
+	void ExtractFromReadyQueue(misc::List<Uop> &ready_queue, Uop *uop);
+
+
+
+
 	//
 	// Load-store queue
 	//
 	
 	// Load queue
-	std::list<std::shared_ptr<Uop>> load_queue;
+	misc::List<Uop> load_queue;
 
 	// Store queue
-	std::list<std::shared_ptr<Uop>> store_queue;
+	misc::List<Uop> store_queue;
 
 	// Determine whether a new uop can be inserted into this thread's
 	// load-store queue, based on whether the queue was configured as
@@ -186,7 +209,7 @@ private:
 	// Insert a uop into the tail of the load-store queue (it is in fact
 	// inserted either at the tail of the load queue or the store queue,
 	// depending on the uop kind).
-	void InsertInLoadStoreQueue(std::shared_ptr<Uop> uop);
+	void InsertInLoadStoreQueue(Uop *uop);
 
 	// Remove a uop from the load queue. The uop must be currently present
 	// in said queue.
@@ -348,9 +371,9 @@ public:
 	/// Return true if there is no uop in the pipeline for this thread
 	bool isPipelineEmpty() const
 	{
-		return fetch_queue.empty()
-				&& uop_queue.empty()
-				&& reorder_buffer.empty();
+		return !fetch_queue.getSize()
+				&& !uop_queue.getSize()
+				&& !reorder_buffer.getSize();
 	}
 	
 	/// Dump a plain-text representation of the object into the given output
@@ -449,14 +472,20 @@ public:
 	/// Fetch stage function
 	void Fetch();
 
+	/// Replace the identifier of an instruction cache access in the
+	/// thread's last fetch and in the uops of the fetch queue. This is
+	/// used in parallel simulation, where the access starts after the
+	/// thread was given a temporary identifier.
+	void ReplaceFetchAccess(long long old_id, long long new_id);
+
 	/// Get the fetch queue size in number of uops
-	int getFetchQueueSize() const { return fetch_queue.size(); }
+	int getFetchQueueSize() const { return fetch_queue.getSize(); }
 
 	/// Get the fetch queue occupancy
 	int getFetchQueueOccupency() const { return fetch_queue_occupancy; }
 
 	/// Get the uop queue size in number of uops
-	int getUopQueueSize() const { return uop_queue.size(); }
+	int getUopQueueSize() const { return uop_queue.getSize(); }
 
 
 
@@ -528,6 +557,11 @@ public:
 	/// The function returns the remaining quantum.
 	int IssueInstructionQueue(int quantum);
 
+	/// Notify that all input operands of \a uop became available. If the
+	/// uop is waiting in the instruction queue or the load queue, it
+	/// becomes a candidate for issue.
+	void WakeUp(Uop *uop);
+
 
 
 
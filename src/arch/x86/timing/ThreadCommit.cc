@@ -35,7 +35,7 @@ const char *Thread::commit_stall_error =
 bool Thread::canCommit()
 {
 	// Get current cycle
-	long long cycle = cpu->getCycle();
+	long long cycle = core->getCycle();
 
 	// Sanity check - If the context is running, we assume that something is
 	// going wrong if more than 1M cycles go by without committing a uop.
@@ -43,6 +43,9 @@ bool Thread::canCommit()
 		last_commit_cycle = cycle;
 	if (cycle - last_commit_cycle > 1000000)
 	{
+		// Only one core reports the stall in parallel simulation
+		Cpu::FunctionalLock lock(cpu);
+
 		// Show warning
 		misc::Warning("[x86] %s: simulation ended due to a commit "
 				"stall.\n\t%s",
@@ -58,17 +61,17 @@ bool Thread::canCommit()
 	}
 
 	// If there is no instruction in the reorder buffer, cannot commit
-	if (reorder_buffer.empty())
+	if (!reorder_buffer.getSize())
 		return false;
 
 	// Get instruction from reorder buffer head
-	assert(reorder_buffer.size());
-	std::shared_ptr<Uop> uop = reorder_buffer.front();
+	assert(reorder_buffer.getSize());
+	Uop *uop = reorder_buffer.Front();
 	assert(uop->getThread() == this);
 
 	// Stores must be ready in order to commit
 	if (uop->getOpcode() == Uinst::OpcodeStore)
-		return register_file->isUopReady(uop.get());
+		return register_file->isUopReady(uop);
 	
 	// Instructions other than stores must be completed
 	return uop->completed;
@@ -84,8 +87,8 @@ void Thread::Commit(int quantum)
 	while (quantum && canCommit())
 	{
 		// Get instruction at the head of the reorder buffer
-		assert(reorder_buffer.size());
-		std::shared_ptr<Uop> uop = reorder_buffer.front();
+		assert(reorder_buffer.getSize());
+		Uop *uop = reorder_buffer.Front();
 		assert(uop->getThread() == this);
 
 		// Recover from mispeculation if this is the first uop of a
@@ -108,29 +111,28 @@ void Thread::Commit(int quantum)
 	
 		// Free physical registers
 		assert(!uop->speculative_mode);
-		register_file->CommitUop(uop.get());
+		register_file->CommitUop(uop);
 		
 		// Branches update branch predictor and BTB
 		if (uop->getFlags() & Uinst::FlagCtrl)
 		{
-			branch_predictor->Update(uop.get());
-			branch_predictor->UpdateBtb(uop.get());
+			branch_predictor->Update(uop);
+			branch_predictor->UpdateBtb(uop);
 			num_btb_writes++;
 		}
 
 		// Trace cache
 		if (TraceCache::isPresent())
-			trace_cache->RecordUop(uop.get());
+			trace_cache->RecordUop(uop);
 
 		// Save last commit cycle
-		last_commit_cycle = cpu->getCycle();
+		last_commit_cycle = core->getCycle();
 
 		// Record committed uops of each kind
 		incNumCommittedUinsts(uop->getOpcode());
 		core->incNumCommittedUinsts(uop->getOpcode());
-		cpu->incNumCommittedUinsts(uop->getOpcode());
 		if (!uop->mop_index)
-			cpu->incNumCommittedInstructions();
+			core->incNumCommittedInstructions();
 
 		// Trace cache statistics
 		if (uop->from_trace_cache)
@@ -142,14 +144,12 @@ void Thread::Commit(int quantum)
 			// Number of branches
 			num_branches++;
 			core->incNumBranches();
-			cpu->incNumBranches();
 
 			// Mispredicted branches
 			if (uop->neip != uop->predicted_neip)
 			{
 				num_mispredicted_branches++;
 				core->incNumMispredictedBranches();
-				cpu->incNumMispredictedBranches();
 			}
 		}
 
@@ -169,7 +169,7 @@ void Thread::Commit(int quantum)
 		}
 
 		// Remove uop from reorder buffer
-		ExtractFromReorderBuffer(uop.get());
+		ExtractFromReorderBuffer(uop);
 
 		// Consume quantum
 		quantum--;
@@ -182,7 +182,10 @@ void Thread::Commit(int quantum)
 	// If context eviction signal is activated and pipeline is empty,
 	// deallocate context.
 	if (context->evict_signal && isPipelineEmpty())
+	{
+		Cpu::FunctionalLock lock(cpu);
 		EvictContext();
+	}
 }
 
 }
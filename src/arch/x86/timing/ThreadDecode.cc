@@ -30,16 +30,16 @@ void Thread::Decode()
 	for (int i = 0; i < Cpu::getDecodeWidth(); i++)
 	{
 		// Empty fetch queue
-		if (fetch_queue.size() == 0)
+		if (fetch_queue.getSize() == 0)
 			break;
 
 		// Full uop queue
-		if ((int) uop_queue.size() >= Cpu::getUopQueueSize())
+		if ((int) uop_queue.getSize() >= Cpu::getUopQueueSize())
 			break;
 
 		// Get uop at the head of the fetch queue
-		assert(!fetch_queue.empty());
-		std::shared_ptr<Uop> uop = fetch_queue.front();
+		assert(fetch_queue.getSize());
+		Uop *uop = fetch_queue.Front();
 
 		// If instructions come from the trace cache, i.e., are located
 		// in the trace cache queue, copy all of them into the uop queue
@@ -49,18 +49,18 @@ void Thread::Decode()
 			do
 			{
 				// Extract from fetch queue
-				ExtractFromFetchQueue(uop.get());
+				ExtractFromFetchQueue(uop);
 
 				// Add to uop queue
 				InsertInUopQueue(uop);
 
 				// Done if fetch queue empty
-				if (fetch_queue.empty())
+				if (!fetch_queue.getSize())
 					break;
 
 				// Next instruction from fetch queue
-				assert(fetch_queue.size());
-				uop = fetch_queue.front();
+				assert(fetch_queue.getSize());
+				uop = fetch_queue.Front();
 
 			} while (uop->from_trace_cache);
 
@@ -70,14 +70,16 @@ void Thread::Decode()
 
 		// Decode one macro-instruction coming from a block in the
 		// instruction cache. If the cache access finished, extract it
-		// from the fetch queue.
+		// from the fetch queue. Negative identifiers are accesses that
+		// did not start yet in parallel simulation.
 		assert(!uop->mop_index);
-		if (!instruction_module->isInFlightAccess(uop->fetch_access))
+		if (uop->fetch_access >= 0 && !instruction_module->
+				isInFlightAccess(uop->fetch_access))
 		{
 			do
 			{
 				// Extract from fetch queue
-				ExtractFromFetchQueue(uop.get());
+				ExtractFromFetchQueue(uop);
 
 				// Add to uop queue
 				InsertInUopQueue(uop);
@@ -91,12 +93,12 @@ void Thread::Decode()
 						core->getId());
 
 				// Done if no more instructions in fetch queue
-				if (fetch_queue.empty())
+				if (!fetch_queue.getSize())
 					break;
 
 				// Next instruction in fetch queue
-				assert(fetch_queue.size());
-				uop = fetch_queue.front();
+				assert(fetch_queue.getSize());
+				uop = fetch_queue.Front();
 
 			} while (uop->mop_index);
 		}
@@ -29,7 +29,7 @@ namespace x86
 Thread::DispatchStall Thread::canDispatch()
 {
 	// Uop queue is empty
-	if (uop_queue.empty())
+	if (!uop_queue.getSize())
 		return !context || !context->getState(Context::StateRunning) ?
 				DispatchStallContext :
 				DispatchStallUopQueue;
@@ -39,7 +39,7 @@ Thread::DispatchStall Thread::canDispatch()
 		return DispatchStallReorderBuffer;
 
 	// Instruction queue is full
-	Uop *uop = uop_queue.front().get();
+	Uop *uop = uop_queue.Front();
 	if (!(uop->getFlags() & Uinst::FlagMem) && !canInsertInInstructionQueue())
 		return DispatchStallInstructionQueue;
 
@@ -70,14 +70,14 @@ int Thread::Dispatch(int quantum)
 		}
 
 		// Get uop at the head of the uop queue
-		assert(uop_queue.size());
-		std::shared_ptr<Uop> uop = uop_queue.front();
+		assert(uop_queue.getSize());
+		Uop *uop = uop_queue.Front();
 	
 		// Extract uop from uop queue
-		ExtractFromUopQueue(uop.get());
+		ExtractFromUopQueue(uop);
 		
 		// Register renaming
-		register_file->Rename(uop.get());
+		register_file->Rename(uop);
 		
 		// Insert in reorder buffer
 		InsertInReorderBuffer(uop);
@@ -86,7 +86,7 @@ int Thread::Dispatch(int quantum)
 
 		// Mark instruction as dispatched
 		uop->dispatched = true;
-		uop->dispatch_when = cpu->getCycle();
+		uop->dispatch_when = core->getCycle();
 		
 		// Insert non-memory instruction into instruction queue
 		if (!(uop->getFlags() & Uinst::FlagMem))
@@ -113,7 +113,6 @@ int Thread::Dispatch(int quantum)
 		// kind
 		incNumDispatchedUinsts(uop->getOpcode());
 		core->incNumDispatchedUinsts(uop->getOpcode());
-		cpu->incNumDispatchedUinsts(uop->getOpcode());
 		
 		// Increment number of dispatched micro-instructions coming from
 		// the trace cache
@@ -50,12 +50,13 @@ Thread::FetchStall Thread::canFetch()
 	unsigned block_address = fetch_neip & ~(instruction_module->getBlockSize() - 1);
 	if (block_address != fetch_block_address)
 	{
+		Cpu::MemoryLock lock(cpu, context->getMemory());
 		mem::Mmu *mmu = context->getMmu();
 		mem::Mmu::Space *mmu_space = context->getMmuSpace();
 		unsigned physical_address = mmu->TranslateVirtualAddress(
 				mmu_space,
 				fetch_neip);
-		if (!instruction_module->canAccess(physical_address))
+		if (!cpu->canAccess(instruction_module, physical_address))
 			return FetchStallInstructionMemory;
 	}
 	
@@ -69,6 +70,9 @@ Uop *Thread::FetchInstruction(bool fetch_from_trace_cache)
 	// A context must be mapped
 	assert(context);
 
+	// Contexts sharing the memory image may be emulated by other cores
+	Cpu::MemoryLock lock(cpu, context->getMemory());
+
 	// Advance current fetch instruction pointer
 	fetch_eip = fetch_neip;
 
@@ -81,8 +85,11 @@ Uop *Thread::FetchInstruction(bool fetch_from_trace_cache)
 	// Record new speculative mode
 	bool speculative_mode = context->getState(Context::StateSpecMode);
 
-	// Run emulation
+	// Run emulation. While running ahead of the CPU, the instruction is
+	// counted by the CPU.
 	context->Execute();
+	if (cpu->inParallelPhase())
+		cpu->incNumParallelInstructions(core);
 
 	// Set next fetch instruction pointer to the next instruction
 	fetch_neip = fetch_eip + context->getInstruction()->getSize();
@@ -104,15 +111,15 @@ Uop *Thread::FetchInstruction(bool fetch_from_trace_cache)
 		// Get micro-instruction from head of list
 		std::shared_ptr<Uinst> uinst = context->ExtractUinst();
 
-		// Create uop
-		auto uop = misc::new_shared<Uop>(this,
+		// Create uop in the core's uop pool
+		Uop *uop = core->NewUop(this,
 				context,
 				uinst);
 
 		// Populate macro-instruction information
 		uop->mop_count = num_uinsts;
 		uop->mop_size = context->getInstruction()->getSize();
-		uop->mop_id = uop->getId() - uinst_index;
+		uop->mop_id = uop->getIdInCore() - uinst_index;
 		uop->mop_index = uinst_index;
 
 		// Other fields
@@ -176,13 +183,12 @@ Uop *Thread::FetchInstruction(bool fetch_from_trace_cache)
 
 		// Select as returned uop
 		if (!ret_uop || (uop->getFlags() & Uinst::FlagCtrl))
-			ret_uop = uop.get();
+			ret_uop = uop;
 
 		// Insert into fetch queue
 		InsertInFetchQueue(uop);
 
 		// Stats
-		cpu->incNumFetchedUinsts();
 		num_fetched_uinsts++;
 		if (fetch_from_trace_cache)
 			trace_cache->incNumFetchedUinsts();
@@ -269,18 +275,22 @@ void Thread::Fetch()
 		// Translate address
 		mem::Mmu *mmu = context->getMmu();
 		mem::Mmu::Space *mmu_space = context->getMmuSpace();
-		unsigned physical_address = mmu->TranslateVirtualAddress(
-						mmu_space,
-						fetch_neip);
+		unsigned physical_address;
+		{
+			Cpu::MemoryLock lock(cpu, context->getMemory());
+			physical_address = mmu->TranslateVirtualAddress(
+					mmu_space,
+					fetch_neip);
+		}
 
 		// Save last fetched block
 		fetch_block_address = block_address;
 		fetch_address = physical_address;
 		
 		// Access instruction cache
-		assert(instruction_module->canAccess(physical_address));
-		fetch_access = instruction_module->Access(
-				mem::Module::AccessLoad,
+		assert(cpu->canAccess(instruction_module, physical_address));
+		fetch_access = cpu->FetchAccess(this,
+				instruction_module,
 				physical_address);
 		
 		// Stats
@@ -341,5 +351,18 @@ void Thread::Fetch()
 	}
 }
 
+
+void Thread::ReplaceFetchAccess(long long old_id, long long new_id)
+{
+	// Last fetched block
+	if (fetch_access == old_id)
+		fetch_access = new_id;
+
+	// Uops waiting for the block in the fetch queue
+	for (Uop *uop : fetch_queue)
+		if (uop->fetch_access == old_id)
+			uop->fetch_access = new_id;
+}
+
 }
 
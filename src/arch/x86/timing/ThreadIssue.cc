@@ -29,27 +29,28 @@ namespace x86
 
 int Thread::IssueLoadQueue(int quantum)
 {
-	// List iterators
-	auto it = load_queue.begin();
-	auto e = load_queue.end();
+	// List iterators. Only loads with all input operands available are
+	// considered.
+	auto it = load_ready_queue.begin();
+	auto e = load_ready_queue.end();
 
 	// Traverse list
 	while (it != e && quantum > 0)
 	{
 		// Get the uop and forward iterator
-		std::shared_ptr<Uop> uop = *it;
+		Uop *uop = *it;
 		++it;
 
-		// If the uop is not ready, skip it
-		if (!register_file->isUopReady(uop.get()))
-			continue;
+		// Sanity
+		assert(uop->in_load_queue);
+		assert(uop->ready);
 
 		// Check that memory system is accessible
-		if (!data_module->canAccess(uop->physical_address))
+		if (!cpu->canAccess(data_module, uop->physical_address))
 			continue;
 
 		// Remove uop from load queue
-		ExtractFromLoadQueue(uop.get());
+		ExtractFromLoadQueue(uop);
 
 		// Access memory system
 		cpu->MemoryAccess(data_module,
@@ -59,12 +60,11 @@ int Thread::IssueLoadQueue(int quantum)
 
 		// Mark uop as issued
 		uop->issued = true;
-		uop->issue_when = cpu->getCycle();
+		uop->issue_when = core->getCycle();
 		
 		// Increment the number of issued instructions of this kind
 		incNumIssuedUinsts(uop->getOpcode());
 		core->incNumIssuedUinsts(uop->getOpcode());
-		cpu->incNumIssuedUinsts(uop->getOpcode());
 
 		// Increment number of reads from load-store-queue
 		num_load_store_queue_reads++;
@@ -112,7 +112,7 @@ int Thread::IssueStoreQueue(int quantum)
 	while (it != e && quantum > 0)
 	{
 		// Get the uop and forward iterator
-		std::shared_ptr<Uop> uop = *it;
+		Uop *uop = *it;
 		++it;
 
 		// Sanity
@@ -123,11 +123,11 @@ int Thread::IssueStoreQueue(int quantum)
 			break;
 
 		// Check that memory system is ready
-		if (!data_module->canAccess(uop->physical_address))
+		if (!cpu->canAccess(data_module, uop->physical_address))
 			break;
 
 		// Remove store from store queue
-		ExtractFromStoreQueue(uop.get());
+		ExtractFromStoreQueue(uop);
 
 		// Issue store to memory system
 		cpu->MemoryAccess(data_module,
@@ -137,12 +137,11 @@ int Thread::IssueStoreQueue(int quantum)
 
 		// Mark uop as issued
 		uop->issued = true;
-		uop->issue_when = cpu->getCycle();
+		uop->issue_when = core->getCycle();
 		
 		// Increment the number of issued instructions of this kind
 		incNumIssuedUinsts(uop->getOpcode());
 		core->incNumIssuedUinsts(uop->getOpcode());
-		cpu->incNumIssuedUinsts(uop->getOpcode());
 
 		// Increment number of reads from load-store-queue
 		num_load_store_queue_reads++;
@@ -185,40 +184,39 @@ int Thread::IssueLoadStoreQueue(int quantum)
 
 int Thread::IssueInstructionQueue(int quantum)
 {
-	// List iterators
-	auto it = instruction_queue.begin();
-	auto e = instruction_queue.end();
+	// List iterators. Only uops with all input operands available are
+	// considered.
+	auto it = instruction_ready_queue.begin();
+	auto e = instruction_ready_queue.end();
 
 	// Traverse list
 	while (it != e && quantum > 0)
 	{
 		// Get the uop and forward iterator
-		std::shared_ptr<Uop> uop = *it;
+		Uop *uop = *it;
 		++it;
 
 		// Sanity
 		assert(!(uop->getFlags() & Uinst::FlagMem));
-
-		// If the uop is not ready, skip it
-		if (!register_file->isUopReady(uop.get()))
-			continue;
+		assert(uop->in_instruction_queue);
+		assert(uop->ready);
 
 		// Run the instruction in its corresponding functional unit in
 		// the ALU. If the instruction does not require a functional
 		// unit, a latency of 1 is returned by ALU::Reserve(). If there
 		// is no functional unit available, it returns 0.
 		Alu *alu = core->getAlu();
-		int latency = alu->Reserve(uop.get());
+		int latency = alu->Reserve(uop);
 		if (!latency)
 			continue;
 
 		// Instruction was successfully issued, remove from instruction
 		// queue.
-		ExtractFromInstructionQueue(uop.get());
+		ExtractFromInstructionQueue(uop);
 
 		// Instruction has been issued
 		uop->issued = true;
-		uop->issue_when = cpu->getCycle();
+		uop->issue_when = core->getCycle();
 
 		// Schedule instruction in event queue
 		assert(latency > 0);
@@ -227,7 +225,6 @@ int Thread::IssueInstructionQueue(int quantum)
 		// Increment the number of issued instructions of this kind
 		incNumIssuedUinsts(uop->getOpcode());
 		core->incNumIssuedUinsts(uop->getOpcode());
-		cpu->incNumIssuedUinsts(uop->getOpcode());
 
 		// Increment number of reads from instruction queue
 		num_instruction_queue_reads++;
@@ -264,5 +261,16 @@ int Thread::IssueInstructionQueue(int quantum)
 	return quantum;
 }
 
+
+void Thread::WakeUp(Uop *uop)
+{
+	// Insert in the ready queue matching the queue the uop waits in
+	assert(uop->ready);
+	if (uop->in_instruction_queue)
+		InsertInReadyQueue(instruction_ready_queue, uop);
+	else if (uop->in_load_queue)
+		InsertInReadyQueue(load_ready_queue, uop);
+}
+
 }
 
@@ -27,10 +27,10 @@ namespace x86
 void Thread::RecoverFetchQueue()
 {
 	// Keep squashing instructions from tail
-	while (fetch_queue.size())
+	while (fetch_queue.getSize())
 	{
 		// Get uop from the tail
-		std::shared_ptr<Uop> uop = fetch_queue.back();
+		Uop *uop = fetch_queue.Back();
 		assert(uop->getThread() == this);
 
 		// Stop if this uop is not in speculative mode anymore
@@ -38,7 +38,7 @@ void Thread::RecoverFetchQueue()
 			break;
 
 		// Remove from fetch queue
-		ExtractFromFetchQueue(uop.get());
+		ExtractFromFetchQueue(uop);
 
 		// Trace
 		if (Timing::trace)
@@ -65,10 +65,10 @@ void Thread::RecoverFetchQueue()
 void Thread::RecoverUopQueue()
 {
 	// Keep squashing uops from the queue
-	while (uop_queue.size())
+	while (uop_queue.getSize())
 	{
 		// Get uop from the back
-		std::shared_ptr<Uop> uop = uop_queue.back();
+		Uop *uop = uop_queue.Back();
 		assert(uop->getThread() == this);
 
 		// Stop if uop is not in speculative mode
@@ -76,7 +76,7 @@ void Thread::RecoverUopQueue()
 			break;
 
 		// Remove it from uop queue
-		ExtractFromUopQueue(uop.get());
+		ExtractFromUopQueue(uop);
 
 		// Trace
 		if (Timing::trace)
@@ -104,7 +104,7 @@ void Thread::RecoverInstructionQueue()
 	while (it != e)
 	{
 		// Get instruction
-		Uop *uop = it->get();
+		Uop *uop = *it;
 		++it;
 
 		// Remove if it is a speculative uop
@@ -122,7 +122,7 @@ void Thread::RecoverLoadQueue()
 	while (it != e)
 	{
 		// Get instruction
-		Uop *uop = it->get();
+		Uop *uop = *it;
 		++it;
 
 		// Remove if it is a speculative uop
@@ -140,7 +140,7 @@ void Thread::RecoverStoreQueue()
 	while (it != e)
 	{
 		// Get instruction
-		Uop *uop = it->get();
+		Uop *uop = *it;
 		++it;
 
 		// Remove if it is a speculative uop
@@ -152,19 +152,8 @@ void Thread::RecoverStoreQueue()
 
 void Thread::RecoverEventQueue()
 {
-	// Traverse event queue
-	auto it = core->getEventQueueBegin();
-	auto e = core->getEventQueueEnd();
-	while (it != e)
-	{
-		// Get instruction
-		Uop *uop = it->get();
-		++it;
-
-		// Remove if it is a speculative uop in the current thread
-		if (uop->getThread() == this && uop->speculative_mode)
-			core->ExtractFromEventQueue(uop);
-	}
+	// The event queue is shared by all threads in the core
+	core->RecoverEventQueue(this);
 }
 
 
@@ -181,10 +170,10 @@ void Thread::Recover()
 
 	// Remove instructions from ROB, restoring the state of the physical
 	// register file.
-	while (reorder_buffer.size())
+	while (reorder_buffer.getSize())
 	{
 		// Get instruction at the reorder buffer tail
-		std::shared_ptr<Uop> uop = reorder_buffer.back();
+		Uop *uop = reorder_buffer.Back();
 		assert(uop->getThread() == this);
 
 		// If we already removed all speculative instructions, done
@@ -194,16 +183,15 @@ void Thread::Recover()
 		// Statistics
 		num_squashed_uinsts++;
 		core->incNumSquashedUinsts();
-		cpu->incNumSquashedUinsts();
 		if (uop->from_trace_cache)
 			trace_cache->incNumSquashedUinsts();
 
 		// Finish register renaming if uop didn't complete yet
 		if (!uop->completed)
-			register_file->WriteUop(uop.get());
+			register_file->WriteUop(uop);
 
 		// Undo register renaming
-		register_file->UndoUop(uop.get());
+		register_file->UndoUop(uop);
 
 		// Trace
 		if (Timing::trace)
@@ -221,7 +209,7 @@ void Thread::Recover()
 		}
 
 		// Remove reorder buffer entry
-		ExtractFromReorderBuffer(uop.get());
+		ExtractFromReorderBuffer(uop);
 	}
 
 	// Check state of fetch stage and mapped context, if still any
@@ -229,7 +217,10 @@ void Thread::Recover()
 	{
 		// If we actually fetched wrong instructions, recover emulator
 		if (context->getState(Context::StateSpecMode))
+		{
+			Cpu::MemoryLock lock(cpu, context->getMemory());
 			context->Recover();
+		}
 	
 		// Set next program counter to valid address
 		fetch_neip = context->getRegs().getEip();
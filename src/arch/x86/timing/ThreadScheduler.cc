@@ -187,7 +187,7 @@ void Thread::EvictContext()
 	assert(context->getState(Context::StateAlloc));
 	assert(context->getState(Context::StateMapped));
 	assert(!context->getState(Context::StateSpecMode));
-	assert(reorder_buffer.empty());
+	assert(!reorder_buffer.getSize());
 	assert(context->evict_signal);
 
 	// Update context state
@@ -17,11 +17,15 @@
  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <algorithm>
+
 #include <arch/common/Arch.h>
 #include <memory/System.h>
 
 #include "Alu.h"
+#include "RegisterFile.h"
 #include "Timing.h"
+#include "TraceCache.h"
 
 
 namespace x86
@@ -78,6 +82,23 @@ const std::string Timing::help_message =
 		"  RecoverPenalty = <cycles> (Default = 0)\n"
 		"      Number of cycles that the fetch stage gets stalled after a branch\n"
 		"      misprediction.\n"
+		"  ParallelThreads = <num_threads> (Default = 1)\n"
+		"      Number of host threads simulating cores in parallel. With a value of 1,\n"
+		"      cores are simulated sequentially in a single host thread. Otherwise, cores\n"
+		"      run independently for a quantum of cycles, and the memory accesses they\n"
+		"      issue are started in their original cycle at the end of the quantum, in\n"
+		"      the order of the cores. Results do not depend on the number of threads,\n"
+		"      but accesses may complete up to ParallelQuantum-1 cycles later than in a\n"
+		"      sequential simulation. Cores do not see the state of cache ports and\n"
+		"      MSHRs while running ahead, so an access that its cache cannot accept\n"
+		"      waits in the buffer, delaying later accesses of the core to that cache,\n"
+		"      instead of stalling the pipeline. Intended for multiprogrammed\n"
+		"      workloads; threads sharing memory may observe a nondeterministic\n"
+		"      interleaving. Tracing or debugging the pipeline forces sequential\n"
+		"      simulation.\n"
+		"  ParallelQuantum = <cycles> (Default = 10)\n"
+		"      Number of cycles that cores run ahead of the memory system in parallel\n"
+		"      simulation before synchronizing with it.\n"
 		"  PageSize = <size> (Default = 4kB)\n"
 		"      Memory page size in bytes.\n"
 		"  DataCachePerfect = {t|f} (Default = False)\n"
@@ -682,6 +703,21 @@ void Timing::ParseConfiguration(misc::IniFile *ini_file)
 }
 
 
+bool Timing::canCoSimulate() const
+{
+	return !trace && !RegisterFile::debug && !TraceCache::debug;
+}
+
+
+void Timing::StartCoSimulation(long long lookahead,
+		pthread_mutex_t *functional_mutex)
+{
+	// Quantum in CPU cycles
+	long long quantum = lookahead / getFrequencyDomain()->getCycleTime();
+	cpu->StartCoSimulation(std::max(1LL, quantum), functional_mutex);
+}
+
+
 void Timing::DumpSummary(std::ostream &os) const
 {
 	// Simulated time in nanoseconds
@@ -1082,6 +1118,8 @@ void Timing::DumpConfiguration(std::ofstream &os) const
 	os << misc::fmt("ThreadSwitchPenalty = %d\n", cpu->getThreadSwitchPenalty());
 	os << misc::fmt("RecoverKind = %s\n", cpu->recover_kind_map[cpu->getRecoverKind()]);
 	os << misc::fmt("RecoverPenalty = %d\n", cpu->getRecoverPenalty());
+	os << misc::fmt("ParallelThreads = %d\n", cpu->getParallelThreads());
+	os << misc::fmt("ParallelQuantum = %d\n", cpu->getParallelQuantum());
 	os << std::endl;
 
 	// Pipeline
@@ -166,6 +166,22 @@ public:
 	void ParseMemoryConfigurationEntry(misc::IniFile *ini_file,
 			const std::string &section) override;
 
+	/// Return whether the CPU can run concurrently with other timing
+	/// simulators, which is not the case while tracing or debugging the
+	/// pipeline.
+	bool canCoSimulate() const override;
+
+	/// Run the CPU concurrently with other timing simulators. See
+	/// comm::Timing::StartCoSimulation() for details.
+	void StartCoSimulation(long long lookahead,
+			pthread_mutex_t *functional_mutex) override;
+
+	/// See comm::Timing::StartQuantum() for details.
+	void StartQuantum() override { cpu->StartQuantum(); }
+
+	/// See comm::Timing::FinishQuantum() for details.
+	void FinishQuantum() override { cpu->FinishQuantum(); }
+
 	/// Dump the statistics summary for the timing simulator.
 	void DumpSummary(std::ostream &os) const override;
 
@@ -131,7 +131,7 @@ void TraceCache::RecordUop(Uop *uop)
 	// If there is not enough space for macro-instruction, commit trace.
 	assert(!uop->speculative_mode);
 	assert(uop->eip);
-	assert(uop->getId() == uop->mop_id);
+	assert(uop->getIdInCore() == uop->mop_id);
 	if (temp->uop_count + uop->mop_count > trace_size)
 		Flush();
 
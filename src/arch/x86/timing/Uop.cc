@@ -25,9 +25,6 @@
 namespace x86
 {
 
-long long Uop::id_counter = 0;
-
-
 Uop::Uop(Thread *thread,
 		Context *context,
 		std::shared_ptr<Uinst> uinst) :
@@ -37,7 +34,6 @@ Uop::Uop(Thread *thread,
 {
 	// Initialize
 	core = thread->getCore();
-	id = ++id_counter;
 	id_in_core = core->getUopId();
 
 	// Assign flags from associated micro-instruction
@@ -99,7 +95,7 @@ void Uop::CountDependencies()
 void Uop::Dump(std::ostream &os) const
 {
 	// Fields
-	os << "id = " << id << ", ";
+	os << "id = " << id_in_core << ", ";
 	os << misc::fmt("eip = 0x%x, ", eip);
 	os << misc::fmt("spec = %c, ", speculative_mode ? 't' : 'f');
 	os << misc::fmt("first_spec = %c, ", first_speculative_mode ? 't' : 'f');
@@ -24,6 +24,7 @@
 
 #include <arch/x86/emulator/Uinst.h>
 #include <arch/x86/emulator/Context.h>
+#include <lib/cpp/List.h>
 #include <lib/cpp/Misc.h>
 
 #include "BranchPredictor.h"
@@ -40,16 +41,6 @@ class Thread;
 // Class Uop
 class Uop
 {
-	//
-	// Static fields
-	//
-
-	// Counter used to assign unique global uop identifiers
-	static long long id_counter;
-
-
-
-
 	//
 	// Class members
 	//
@@ -58,10 +49,10 @@ class Uop
 	// associated emulator micro-instruction.
 	void CountDependencies();
 
-	// Globally unique uop identifier, initialized in constructor
-	long long id;
-
-	// Unique identifier of uop in core, initialized in constructor
+	// Unique identifier of uop in core, initialized in constructor. Uops
+	// are only compared with others of the same core, so identifiers do
+	// not depend on the order in which cores simulated on different host
+	// threads create their uops.
 	long long id_in_core;
 
 	// Thread that the uop belongs to, initialized in constructor
@@ -138,6 +129,11 @@ public:
 			Context *context,
 			std::shared_ptr<Uinst> uinst);
 
+	/// Uops are linked into the pipeline structures through their list
+	/// nodes, and cannot be copied.
+	Uop(const Uop &) = delete;
+	Uop &operator=(const Uop &) = delete;
+
 	/// Dump uop information
 	void Dump(std::ostream &os = std::cout) const;
 
@@ -160,9 +156,6 @@ public:
 	/// Return the opcode of the associated micro-instruction
 	Uinst::Opcode getOpcode() const { return uinst->getOpcode(); }
 
-	/// Return a globally unique identifier for the uop
-	long long getId() const { return id; }
-
 	/// Return a unique identifier of the uop in the core
 	long long getIdInCore() const { return id_in_core; }
 
@@ -226,7 +219,7 @@ public:
 	{
 		return complete_when != uop->complete_when ?
 				complete_when - uop->complete_when :
-				id - uop->id;
+				id_in_core - uop->id_in_core;
 	}
 
 
@@ -259,69 +252,112 @@ public:
 
 
 	//
-	// Queues and iterators
+	// Queues
+	//
+	// All pipeline structures are intrusive lists, with one list node
+	// allocated within the uop for each structure it can belong to. This
+	// avoids any memory allocation when moving uops across the pipeline.
 	//
 
 	/// True if the instruction is currently in the fetch queue
 	bool in_fetch_queue = false;
 
-	/// Position of the uop in the thread's fetch queue
-	std::list<std::shared_ptr<Uop>>::iterator fetch_queue_iterator;
+	/// Node in the thread's fetch queue
+	misc::List<Uop>::Node fetch_queue_node{this};
 
 	/// True if the instruction is currently in the uop queue
 	bool in_uop_queue = false;
 
-	/// Position of the uop in the thread's uop queue
-	std::list<std::shared_ptr<Uop>>::iterator uop_queue_iterator;
+	/// Node in the thread's uop queue
+	misc::List<Uop>::Node uop_queue_node{this};
 
 	/// True if the instruction is currently in the core's event queue
 	bool in_event_queue = false;
 
-	/// Position of the uop in the core's event queue, or past-the-end
-	/// iterator to this queue if not present.
-	std::list<std::shared_ptr<Uop>>::iterator event_queue_iterator;
+	/// Node in the core's event queue
+	misc::List<Uop>::Node event_queue_node{this};
 
 	/// True if the instruction is currently present in the thread's
 	/// reorder buffer
 	bool in_reorder_buffer = false;
 
-	/// Position of the uop in the reorder buffer, if present
-	std::list<std::shared_ptr<Uop>>::iterator reorder_buffer_iterator;
+	/// Node in the thread's reorder buffer
+	misc::List<Uop>::Node reorder_buffer_node{this};
 
 	/// True if the instruction is currently present in the thread's
 	/// instruction queue
 	bool in_instruction_queue = false;
 
-	/// Position of the uop in the thread's instruction queue, or past-the-
-	/// end iterator to this queue if not present.
-	std::list<std::shared_ptr<Uop>>::iterator instruction_queue_iterator;
+	/// Node in the thread's instruction queue
+	misc::List<Uop>::Node instruction_queue_node{this};
 
 	/// True if the instruction is currently present in the thread's
 	/// load queue
 	bool in_load_queue = false;
 
-	/// Position of the uop in the thread's load queue, or past-the-end
-	/// iterator to this queue if not present.
-	std::list<std::shared_ptr<Uop>>::iterator load_queue_iterator;
+	/// Node in the thread's load queue
+	misc::List<Uop>::Node load_queue_node{this};
 
 	/// True if the instruction is currently present in the thread's
 	/// store queue
 	bool in_store_queue = false;
 
-	/// Position of the uop in the thread's store queue, or past-the-end
-	/// iterator to this queue if not present.
-	std::list<std::shared_ptr<Uop>>::iterator store_queue_iterator;
+	/// Node in the thread's store queue
+	misc::List<Uop>::Node store_queue_node{this};
+
+	/// True if the uop is in one of the ready queues of its thread, which
+	/// contain the uops of the instruction queue and the load queue whose
+	/// input operands are available.
+	bool in_ready_queue = false;
+
+	/// Node in the thread's ready queue
+	misc::List<Uop>::Node ready_queue_node{this};
+
+	/// Number of input physical registers that were still pending when
+	/// the uop was renamed, and have not been written yet
+	int num_pending_inputs = 0;
+
+	/// Nodes in the lists of consumers of the input physical registers,
+	/// one per input dependence
+	misc::List<Uop>::Node consumer_nodes[Uinst::MaxIDeps]{
+			{this}, {this}, {this}};
 
 	/// True if the instruction is currently present in the uop trace list
 	/// of the CPU
 	bool in_trace_list = false;
 
-	/// Position of the uop in the CPU's trace list, if present
-	std::list<std::shared_ptr<Uop>>::iterator trace_list_iterator;
+	/// Node in the CPU's trace list
+	misc::List<Uop>::Node trace_list_node{this};
+
+	/// True if the uop has a memory access in flight, started with
+	/// Cpu::MemoryAccess()
+	bool in_memory_access = false;
+
+	/// True if the uop is waiting in the core's list of released uops
+	bool in_released_list = false;
+
+	/// Node in the core's list of uops allocated in its uop pool
+	misc::List<Uop>::Node pool_node{this};
+
+	/// Return true if the uop is not present in any pipeline structure and
+	/// has no memory access in flight, which means that it can be returned
+	/// to the uop pool of its core.
+	bool canRelease() const
+	{
+		return !in_fetch_queue &&
+				!in_uop_queue &&
+				!in_event_queue &&
+				!in_reorder_buffer &&
+				!in_instruction_queue &&
+				!in_load_queue &&
+				!in_store_queue &&
+				!in_trace_list &&
+				!in_memory_access;
+	}
+
 
 
 
-	
 	//
 	// Macro-instruction info
 	//
@@ -37,6 +37,21 @@ Address::Address(long long encoded)
 }
 
 
+Address::Address(int physical, int logical, int rank, int bank, int row,
+		int column)
+		:
+		physical(physical),
+		logical(logical),
+		rank(rank),
+		bank(bank),
+		row(row),
+		column(column)
+{
+	// Encode the address.
+	EncodeAddress();
+}
+
+
 void Address::DecodeAddress()
 {
 	// Get the DRAM system.
@@ -83,6 +98,22 @@ void Address::DecodeAddress()
 }
 
 
+void Address::EncodeAddress()
+{
+	// Get the DRAM system.
+	System *dram = System::getInstance();
+
+	// Assemble the components from MSB to LSB in the order
+	// physical:logical:rank:bank:row:column.
+	encoded = physical;
+	encoded = (encoded << dram->getLogicalSize()) | logical;
+	encoded = (encoded << dram->getRankSize()) | rank;
+	encoded = (encoded << dram->getBankSize()) | bank;
+	encoded = (encoded << dram->getRowSize()) | row;
+	encoded = (encoded << dram->getColumnSize()) | column;
+}
+
+
 void Address::dump(std::ostream &os) const
 {
 	// Print the encoded address and its component locations
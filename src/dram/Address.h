@@ -48,6 +48,10 @@ class Address
 	/// This will eventually be configurable.
 	void DecodeAddress();
 
+	/// Encodes the address components stored in the class into the
+	/// encoded address, following the same order as DecodeAddress().
+	void EncodeAddress();
+
 public:
 
 	/// Creates an address object with all location information derived
@@ -57,6 +61,11 @@ public:
 	/// The encoded memory address.
 	Address(long long encoded);
 
+	/// Creates an address object from its location information, deriving
+	/// the encoded address from it.
+	Address(int physical, int logical, int rank, int bank, int row,
+			int column);
+
 	/// Returns the encoded address.
 	long long getEncoded() const { return encoded; }
 
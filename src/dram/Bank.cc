@@ -104,6 +104,12 @@ void Bank::ProcessRequest(std::shared_ptr<Request> request)
 		future_active_row = address->getRow();
 	}
 
+	// The desired row will already be open. (Row hit)
+	else
+	{
+		getRank()->getChannel()->getController()->incNumRowHits();
+	}
+
 	// Check that the desired row will actually be open.
 	if (future_active_row != address->getRow())
 		throw misc::Panic("Desired row will not be opened.");
@@ -112,6 +112,12 @@ public:
 		return command_queue[position]->getTypeString();
 	}
 
+	/// Returns the type of the command at the front of the queue.
+	CommandType getFrontCommandType() const
+	{
+		return command_queue.front()->getType();
+	}
+
 	/// Returns the cycle when the command at the front of the queue was
 	/// created.
 	long long getFrontCommandCycleCreated()
@@ -65,6 +65,12 @@ Channel::Channel(int id,
 		scheduler = std::unique_ptr<Scheduler>(
 				new OldestFirst(this));
 		break;
+
+	// Create a First-Ready First-Come First-Served scheduler.
+	case SchedulerFrFcfs:
+		scheduler = std::unique_ptr<Scheduler>(
+				new FrFcfs(this));
+		break;
 	}
 }
 
@@ -219,6 +219,44 @@ void Controller::AddRequest(std::shared_ptr<Request> request)
 }
 
 
+std::unique_ptr<Address> Controller::getBlockAddress(long long block,
+		int block_size) const
+{
+	// Number of columns taken by one block, and number of blocks in a row
+	int columns_per_block = std::max(1, block_size * 8 / num_bits);
+	int blocks_per_row = std::max(1, num_columns / columns_per_block);
+
+	// Channel
+	int channel = block % num_channels;
+	block /= num_channels;
+
+	// Column
+	int column = (block % blocks_per_row) * columns_per_block;
+	block /= blocks_per_row;
+
+	// Bank, rank, and row
+	int bank = block % num_banks;
+	block /= num_banks;
+	int rank = block % num_ranks;
+	block /= num_ranks;
+	int row = block % num_rows;
+
+	// Create address
+	return std::unique_ptr<Address>(new Address(id, channel, rank, bank,
+			row, column));
+}
+
+
+void Controller::RecordRequest(RequestType type, long long latency)
+{
+	if (type == RequestRead)
+		num_reads++;
+	else
+		num_writes++;
+	total_latency += latency;
+}
+
+
 void Controller::CreateRequestProcessor(int controller)
 {
 	esim::Engine *esim = esim::Engine::getInstance();
@@ -330,6 +368,20 @@ void Controller::CommandReturnHandler(esim::Event *type, esim::Frame *frame)
 }
 
 
+void Controller::DumpReport(std::ostream &os) const
+{
+	long long num_requests = num_reads + num_writes;
+	os << misc::fmt("DramController = %s\n", name.c_str());
+	os << misc::fmt("DramReads = %lld\n", num_reads);
+	os << misc::fmt("DramWrites = %lld\n", num_writes);
+	os << misc::fmt("DramRowHits = %lld\n", num_row_hits);
+	os << misc::fmt("DramRowHitRatio = %.4g\n", num_requests ?
+			(double) num_row_hits / num_requests : 0.0);
+	os << misc::fmt("DramAverageLatency = %.4g\n", num_requests ?
+			(double) total_latency / num_requests : 0.0);
+}
+
+
 void Controller::dump(std::ostream &os) const
 {
 	// Print header
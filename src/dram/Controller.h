@@ -37,6 +37,7 @@ namespace dram
 {
 
 // Forward declarations
+class Address;
 class Channel;
 class Command;
 class Request;
@@ -109,6 +110,12 @@ class Controller
 	// controller
 	std::map<int, esim::Event *> SCHEDULERS;
 
+	// Statistics
+	long long num_reads = 0;
+	long long num_writes = 0;
+	long long num_row_hits = 0;
+	long long total_latency = 0;
+
 public:
 
 	Controller(int id);
@@ -118,6 +125,10 @@ public:
 	/// controllers.
 	int getId() const { return id; }
 
+	/// Returns the name of this controller, as given in its section of
+	/// the configuration file.
+	const std::string &getName() const { return name; }
+
 	/// Returns a channel that belongs to this controller with the
 	/// specified id.
 	Channel *getChannel(int id) { return channels[id].get(); }
@@ -155,6 +166,40 @@ public:
 	/// Add a request to the controller's incoming request queue.
 	void AddRequest(std::shared_ptr<Request> request);
 
+	/// Returns the address of a memory block served by this controller.
+	/// Consecutive blocks are interleaved across channels first, and then
+	/// placed in consecutive columns of the same row, so that sequential
+	/// accesses spread over channels and hit in open rows.
+	///
+	/// \param block
+	///	Block number local to this controller.
+	///
+	/// \param block_size
+	///	Block size in bytes.
+	std::unique_ptr<Address> getBlockAddress(long long block,
+			int block_size) const;
+
+	/// Record the completion of a request of the given type, which took
+	/// \a latency cycles since it was created.
+	void RecordRequest(RequestType type, long long latency);
+
+	/// Record a request that found its row open in the bank.
+	void incNumRowHits() { num_row_hits++; }
+
+	/// Return the number of completed read requests.
+	long long getNumReads() const { return num_reads; }
+
+	/// Return the number of completed write requests.
+	long long getNumWrites() const { return num_writes; }
+
+	/// Return the total latency of all completed requests, in cycles of
+	/// the DRAM frequency domain.
+	long long getTotalLatency() const { return total_latency; }
+
+	/// Dump the controller statistics in the format used in the memory
+	/// system report.
+	void DumpReport(std::ostream &os = std::cout) const;
+
 	/// Obtain the Event for the controller's request processor.
 	static esim::Event *getRequestProcessor(int controller)
 	{
@@ -20,6 +20,7 @@
 #include <lib/cpp/String.h>
 
 #include "Address.h"
+#include "Controller.h"
 #include "Request.h"
 #include "System.h"
 
@@ -30,16 +31,24 @@ namespace dram
 Request::Request()
 {
 	type = RequestInvalid;
+	cycle_created = System::frequency_domain->getCycle();
 }
 
 
 void Request::setFinished()
 {
-	// FIXME: If not in stand alone DRAM sim, return request back up
-	// through cache hierarchy.
+	// Statistics
+	long long cycle = System::frequency_domain->getCycle();
+	Controller *controller = System::getInstance()->getController(
+			address->getPhysical());
+	controller->RecordRequest(type, cycle - cycle_created);
+
+	// Return to the event chains waiting for the request, if the request
+	// comes from the memory hierarchy.
+	if (!queue.isEmpty())
+		queue.WakeupAll();
 
 	// Debug
-	long long cycle = System::frequency_domain->getCycle();
 	System::activity << misc::fmt("[%lld] Request complete for 0x%llx\n",
 		cycle, address->getEncoded());
 }
@@ -50,4 +59,10 @@ void Request::setEncodedAddress(long long addr)
 	address.reset(new Address(addr));
 }
 
+
+void Request::setAddress(std::unique_ptr<Address> &&new_address)
+{
+	address = std::move(new_address);
+}
+
 }  // namespace dram
@@ -22,6 +22,8 @@
 
 #include <memory>
 
+#include <lib/esim/Queue.h>
+
 
 namespace dram
 {
@@ -43,6 +45,12 @@ class Request
 	RequestType type;
 	std::unique_ptr<Address> address;
 
+	// Cycle when the request was created
+	long long cycle_created;
+
+	// Event chains suspended until the request completes
+	esim::Queue queue;
+
 public:
 
 	Request();
@@ -63,6 +71,17 @@ public:
 	/// Sets the encoded address of the request, which will also decode
 	/// the address into its components.
 	void setEncodedAddress(long long addr);
+
+	/// Sets the address of the request.
+	void setAddress(std::unique_ptr<Address> &&new_address);
+
+	/// Returns the cycle when the request was created.
+	long long getCycleCreated() const { return cycle_created; }
+
+	/// Suspend the current event chain until the request completes. When
+	/// it does, the chain continues with the given event. This function
+	/// must be invoked in the body of an event handler.
+	void Wait(esim::Event *event) { queue.Wait(event); }
 };
 
 }  // namespace dram
@@ -17,12 +17,14 @@
  * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
  */
 
+#include <algorithm>
 #include <climits>
 
 #include <lib/cpp/String.h>
 
 #include "Bank.h"
 #include "Channel.h"
+#include "Rank.h"
 #include "System.h"
 #include "Scheduler.h"
 
@@ -33,7 +35,8 @@ namespace dram
 misc::StringMap SchedulerTypeMap
 {
 	{ "RankBankRoundRobin", SchedulerRankBankRoundRobin},
-	{ "OldestFirst", SchedulerOldestFirst }
+	{ "OldestFirst", SchedulerOldestFirst },
+	{ "FRFCFS", SchedulerFrFcfs }
 };
 
 
@@ -128,4 +131,65 @@ Bank *RankBankRoundRobin::FindNext()
 	return nullptr;
 }
 
+Bank *FrFcfs::FindNext()
+{
+	// Get the current cycle
+	long long cycle = System::frequency_domain->getCycle();
+
+	// Keep track of the best bank found so far. Banks are ranked first by
+	// the cycle when their front command can run, with all cycles up to
+	// the current one being equal, then by whether the command is a
+	// column access, and finally by the age of the command.
+	Bank *best_bank = nullptr;
+	long long best_ready = LLONG_MAX;
+	bool best_column = false;
+	long long best_created = LLONG_MAX;
+
+	// Iterate through all the ranks and banks.
+	int num_banks = channel->getNumBanks();
+	for (int i = 0; i < channel->getNumBanksTotal(); i++)
+	{
+		// Get the current bank
+		Bank *bank = channel->getRank(i / num_banks)
+				->getBank(i % num_banks);
+
+		// Move to the next bank if this one has no commands in queue.
+		if (bank->getNumCommandsInQueue() == 0)
+			continue;
+
+		// Rank the front command of the bank
+		long long ready = std::max(bank->getFrontCommandTiming(), cycle);
+		CommandType type = bank->getFrontCommandType();
+		bool column = type == CommandRead || type == CommandWrite;
+		long long created = bank->getFrontCommandCycleCreated();
+
+		// Compare with the best bank so far
+		if (ready > best_ready)
+			continue;
+		if (ready == best_ready)
+		{
+			if (best_column && !column)
+				continue;
+			if (best_column == column && created >= best_created)
+				continue;
+		}
+
+		// New best bank
+		best_bank = bank;
+		best_ready = ready;
+		best_column = column;
+		best_created = created;
+	}
+
+	// Debug
+	if (best_bank)
+		System::debug << misc::fmt("[%lld] Scheduler returns %d : %d "
+				"for next command scheduling\n", cycle,
+				best_bank->getRank()->getId(),
+				best_bank->getId());
+
+	// Return the selected bank, or nullptr if no bank has commands
+	return best_bank;
+}
+
 }  // namespace dram
@@ -39,7 +39,8 @@ class Channel;
 enum SchedulerType
 {
 	SchedulerRankBankRoundRobin,
-	SchedulerOldestFirst
+	SchedulerOldestFirst,
+	SchedulerFrFcfs
 };
 
 // String map for SchedulerType
@@ -111,6 +112,27 @@ public:
 	Bank *FindNext();
 };
 
+class FrFcfs : public Scheduler
+{
+
+public:
+
+	FrFcfs(Channel *owner)
+			:
+			Scheduler(owner)
+	{
+	}
+
+	/// Returns the pointer to the next bank that should have its command
+	/// scheduled next based on the First-Ready First-Come First-Served
+	/// algorithm. Among the banks whose front command can run in the
+	/// current cycle, column accesses (reads and writes to an open row)
+	/// are preferred over row commands (precharge and activate), and the
+	/// oldest command is chosen among equals. If no command can run in
+	/// the current cycle, the one that will be ready first is chosen.
+	Bank *FindNext();
+};
+
 }  // namespace dram
 
 #endif
@@ -17,6 +17,7 @@
  * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
  */
 
+#include <cstring>
 #include <vector>
 #include <algorithm>
 #include <iostream>
@@ -93,8 +94,10 @@ const std::string System::help_message =
 		"\n"
 		"  PagePolicy = {Open|Closed} (Default = Open) \n"
 		"      Policy that dictates whether the row of a bank remains open or closed.\n"
-		"  SchedulingPolicy = {OldestFirst|BankRoundRobin} (Default = OldestFirst)\n"
+		"  SchedulingPolicy = {OldestFirst|RankBankRoundRobin|FRFCFS} (Default = OldestFirst)\n"
 		"      Policy that determines which bank is allowed to execute a command.\n"
+		"      FRFCFS prioritizes commands that can run right away, then reads and\n"
+		"      writes to open rows, then older commands.\n"
 		"  NumChannels = <num> (Default =  1)\n"
 		"      Number of channels in the DRAM system.\n"
 		"  NumRanks = <num> (Default = 2)\n"
@@ -121,7 +124,11 @@ const std::string System::help_message =
 		"  tRAS = <num> (Default = 28)\n"
 		"  tWR = <num> (Default = 12)\n"
 		"  tRTP = <num> (Default = 6)\n"
-		"  tBURST = <num> (Default = 4)\n";
+		"  tBURST = <num> (Default = 4)\n"
+		"\n"
+		"Main memory modules in the memory configuration file (option\n"
+		"'--mem-config') use a memory controller as their timing model when their\n"
+		"variable 'DramController' gives the name of the controller.\n";
 
 
 System *System::getInstance()
@@ -181,20 +188,17 @@ int System::getCapacity()
 
 void System::RegisterOptions()
 {
-/*
-	//
-	// FIXME: These options are removed, in order to be excluded from
-	// the m2s --help. However, later when we hook up the DRAM model to
-	// the memory system, it will come back.
-	// 
-	// FIXME 2: A whole --dram-trace option should be added as an 
-	// input to the stand-alone DRAM. Otherwise, the stand-alone
-	// does not make any sense. It cannot be actions, as part of the
-	// configuration file.
+	// FIXME: A whole --dram-trace option should be added as an input to
+	// the stand-alone DRAM simulation, which runs with '--dram-sim'.
+	// Otherwise, the stand-alone does not make any sense. It cannot be
+	// actions, as part of the configuration file. Until then, option
+	// '--dram-sim' is not registered, and the DRAM system is only used
+	// as the timing backend of main memory modules.
 	//
-	// FIXME 3: The debug and debug_activity files should be combined
+	// FIXME 2: The debug and debug_activity files should be combined
 	// into one. It does not make sense to have both of them as two
 	// separate file.  
+
 	// Get command line object
 	misc::CommandLine *command_line = misc::CommandLine::getInstance();
 
@@ -217,27 +221,21 @@ void System::RegisterOptions()
 	command_line->RegisterString("--dram-config <file>",
 			config_file,
 			"DRAM configuration file. Memory controllers and "
-			"their components can be defined here.");
+			"their components can be defined here, and then used "
+			"by main memory modules in the memory configuration "
+			"file with variable 'DramController'.");
 
 	// Help message for dram configuration
 	command_line->RegisterBool("--dram-help",
 			help,
-			"Print help message describing the network configuration"
+			"Print help message describing the DRAM configuration"
 			" file, passed in option '--dram-config <file>'.");
-
-	// Stand-alone simulator
-	command_line->RegisterBool("--dram-sim",
-			stand_alone,
-			"Runs a DRAM simulation using the actions provided "
-			"in the DRAM configuration file (option "
-			"'--dram-config').");
-*/
+	command_line->setIncompatible("--dram-help");
 }
 
 
 void System::ProcessOptions()
 {
-/*
 	// DRAM help
 	if (help)
 	{
@@ -257,7 +255,6 @@ void System::ProcessOptions()
 	if (stand_alone && config_file.empty())
 		throw Error(misc::fmt("Option --dram-sim requires "
 				" --dram-config option "));
-*/
 }
 
 
@@ -319,6 +316,15 @@ void System::ParseConfiguration(misc::IniFile *ini_file)
 }
 
 
+Controller *System::getController(const std::string &name) const
+{
+	for (auto &controller : controllers)
+		if (!strcasecmp(controller->getName().c_str(), name.c_str()))
+			return controller.get();
+	return nullptr;
+}
+
+
 void System::Run()
 {
 	// Get the simulation engine.
@@ -123,6 +123,10 @@ public:
 	/// specified id.
 	Controller *getController(int id) { return controllers[id].get(); }
 
+	/// Returns the controller with the given name, or nullptr if no
+	/// controller with that name exists.
+	Controller *getController(const std::string &name) const;
+
 	/// Returns whether or not DRAM is running as a stand alone simulator.
 	static bool isStandAlone() { return stand_alone; }
 
@@ -369,6 +369,9 @@ public:
 	/// Get instance of singleton
 	static CommandLine *getInstance();
 
+	/// Destroy the singleton, so that a new command line can be processed
+	static void Destroy() { instance = nullptr; }
+
 	/// Constructor
 	CommandLine();
 
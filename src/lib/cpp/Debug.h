@@ -95,7 +95,7 @@ public:
 	/// debug object. If the debugger has not been initialized with a call
 	/// to setPath(), this call is ignored. The argument can be of any
 	/// type accepted by an \c std::ostream object.
-	template<typename T> Debug& operator<<(T val)
+	template<typename T> Debug& operator<<(const T &val)
 	{
 		if (os && active)
 			*os << prefix << val;
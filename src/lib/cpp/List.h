@@ -140,27 +140,27 @@ public:
 	int getSize() const { return size; }
 
 	/// Return an iterator to the first element in the list
-	Iterator begin()
+	Iterator begin() const
 	{
 		return Iterator(head);
 	}
 
 	/// Return a past-the-end iterator
-	Iterator end()
+	Iterator end() const
 	{
 		return Iterator(nullptr);
 	}
 
 	/// Return the first element in the list, or `nullptr` if the list is
 	/// empty.
-	T *Front()
+	T *Front() const
 	{
 		return head ? head->data : nullptr;
 	}
 
 	/// Return the last element in the list, or `nullptr` if the list is
 	/// empty.
-	T *Back()
+	T *Back() const
 	{
 		return tail ? tail->data : nullptr;
 	}
@@ -171,6 +171,8 @@ public:
 	Iterator Insert(Iterator position, Node &node)
 	{
 		assert(node.list == nullptr);
+		node.prev = nullptr;
+		node.next = nullptr;
 		if (size == 0)
 		{
 			// List is empty
@@ -254,11 +256,14 @@ public:
 		}
 
 		// Mark as removed
+		Node *next = position.node->next;
 		position.node->list = nullptr;
+		position.node->prev = nullptr;
+		position.node->next = nullptr;
 		size--;
 
 		// Return iterator to next element
-		return Iterator(position.node->next);
+		return Iterator(next);
 	}
 
 	
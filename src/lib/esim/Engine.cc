@@ -109,10 +109,11 @@ bool Engine::Drain(int max_events)
 		// Debug
 		Event *event = current_frame->event;
 		FrequencyDomain *frequency_domain = event->getFrequencyDomain();
-		debug << misc::fmt("[%.2fns] Event '%s/%s' drained\n",
-				(double) current_time / 1000,
-				frequency_domain->getName().c_str(),
-				event->getName().c_str());
+		if (debug)
+			debug << misc::fmt("[%.2fns] Event '%s/%s' drained\n",
+					(double) current_time / 1000,
+					frequency_domain->getName().c_str(),
+					event->getName().c_str());
 
 		// Set current time to the time of the event
 		current_time = current_frame->time;
@@ -151,9 +152,10 @@ void Engine::ProcessEndEvents()
 
 		// Debug
 		Event *event = current_frame->event;
-		debug << misc::fmt("[%.2fns] End event '%s' triggered\n",
-				(double) current_time / 1000,
-				event->getName().c_str());
+		if (debug)
+			debug << misc::fmt("[%.2fns] End event '%s' triggered\n",
+					(double) current_time / 1000,
+					event->getName().c_str());
 
 		// Run event handler with null frame
 		EventHandler event_handler = event->getEventHandler();
@@ -228,10 +230,11 @@ void Engine::ProcessEvents()
 		// Debug
 		Event *event = current_frame->event;
 		FrequencyDomain *frequency_domain = event->getFrequencyDomain();
-		debug << misc::fmt("[%.2fns] Event '%s/%s' triggered\n",
-				(double) current_time / 1000,
-				frequency_domain->getName().c_str(),
-				event->getName().c_str());
+		if (debug)
+			debug << misc::fmt("[%.2fns] Event '%s/%s' triggered\n",
+					(double) current_time / 1000,
+					frequency_domain->getName().c_str(),
+					event->getName().c_str());
 
 		// The event is being run, so decrement the number of in-flight
 		// events of its type.
@@ -325,8 +328,9 @@ void Engine::Schedule(Event *event,
 	// Null event
 	if (event == nullptr || event == null_event)
 	{
-		debug << misc::fmt("[%.2fns] Null event discarded\n",
-				(double) current_time / 1000);
+		if (debug)
+			debug << misc::fmt("[%.2fns] Null event discarded\n",
+					(double) current_time / 1000);
 		return;
 	}
 
@@ -362,11 +366,12 @@ void Engine::Schedule(Event *event,
 	event->incInFlight();
 
 	// Debug
-	debug << misc::fmt("[%.2fns] Event '%s/%s' scheduled for [%.2fns]\n",
-			(double) current_time / 1000,
-			frequency_domain->getName().c_str(),
-			event->getName().c_str(),
-			(double) frame->time / 1000);
+	if (debug)
+		debug << misc::fmt("[%.2fns] Event '%s/%s' scheduled for [%.2fns]\n",
+				(double) current_time / 1000,
+				frequency_domain->getName().c_str(),
+				event->getName().c_str(),
+				(double) frame->time / 1000);
 
 	// Warn when heap is overloaded
 	if (!max_inflight_events_warning && (int) heap.size() >=
@@ -0,0 +1,140 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2012  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cassert>
+
+#include <lib/cpp/Error.h>
+#include <lib/cpp/Misc.h>
+#include <lib/cpp/String.h>
+
+#include "Statistics.h"
+
+
+namespace esim
+{
+
+std::unique_ptr<Statistics> Statistics::instance;
+
+
+Statistics *Statistics::getInstance()
+{
+	// Instance already exists
+	if (instance.get())
+		return instance.get();
+
+	// Create instance
+	instance.reset(new Statistics());
+	return instance.get();
+}
+
+
+void Statistics::setPath(const std::string &path, long long interval)
+{
+	// Statistics must not have been activated yet
+	if (active)
+		throw misc::Panic("Statistics already active");
+	assert(interval > 0);
+
+	// Open file
+	f.open(path, std::ios::trunc);
+	if (!f)
+		throw misc::Error(misc::fmt("%s: cannot open statistics file",
+				path.c_str()));
+
+	// Activate
+	this->path = path;
+	this->interval = interval;
+	next_cycle = interval;
+	active = true;
+}
+
+
+void Statistics::Register(const std::string &name,
+		std::function<long long()> getter)
+{
+	// Ignore if not active
+	if (!active)
+		return;
+
+	// Columns are fixed once the header is written
+	if (header_written)
+		throw misc::Panic(misc::fmt("%s: counter registered after "
+				"sampling started", name.c_str()));
+
+	// Add counter
+	counters.emplace_back();
+	Counter &counter = counters.back();
+	counter.name = name;
+	counter.getter = getter;
+}
+
+
+void Statistics::WriteHeader()
+{
+	assert(!header_written);
+	header_written = true;
+	f << "Cycle";
+	for (Counter &counter : counters)
+		f << ',' << counter.name;
+	f << '\n';
+}
+
+
+void Statistics::WriteRow(long long cycle)
+{
+	// Column names first
+	if (!header_written)
+		WriteHeader();
+
+	// Increments since last sample
+	f << cycle;
+	for (Counter &counter : counters)
+	{
+		long long value = counter.getter();
+		f << ',' << value - counter.last_value;
+		counter.last_value = value;
+	}
+	f << '\n';
+
+	// Check errors
+	if (!f)
+		throw misc::Error(misc::fmt("%s: error writing statistics",
+				path.c_str()));
+
+	// Next sample. Intervals are aligned to multiples of the interval
+	// length, even if a sample is taken late.
+	last_cycle = cycle;
+	next_cycle = (cycle / interval + 1) * interval;
+}
+
+
+void Statistics::Flush(long long cycle)
+{
+	// Nothing to write if not active or if the last interval is empty
+	if (!active || (header_written && cycle <= last_cycle))
+		return;
+
+	// Last row
+	WriteRow(cycle);
+	f.flush();
+}
+
+
+}  // namespace esim
+
@@ -0,0 +1,125 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2012  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LIB_CPP_ESIM_STATISTICS_H
+#define LIB_CPP_ESIM_STATISTICS_H
+
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+namespace esim
+{
+
+/// Registry of cumulative simulation counters, sampled periodically into a
+/// time series. Subsystems register their counters once when they are
+/// created. Every interval of cycles, the increment of each counter since
+/// the previous sample is appended to a CSV file, whose first line contains
+/// the column names. Rows are written as they are sampled, so memory usage
+/// does not depend on the length of the simulation.
+class Statistics
+{
+	// Counter registered by a subsystem
+	struct Counter
+	{
+		// Column name
+		std::string name;
+
+		// Function returning the current cumulative value
+		std::function<long long()> getter;
+
+		// Value in the last sample
+		long long last_value = 0;
+	};
+
+	// Unique instance
+	static std::unique_ptr<Statistics> instance;
+
+	// Path of the output file
+	std::string path;
+
+	// Output file
+	std::ofstream f;
+
+	// Flag indicating whether statistics were activated
+	bool active = false;
+
+	// Sampling interval in cycles
+	long long interval = 0;
+
+	// Cycle of the next sample
+	long long next_cycle = 0;
+
+	// Cycle of the last sample written
+	long long last_cycle = 0;
+
+	// Flag indicating whether the header has been written. No more
+	// counters can be registered after that.
+	bool header_written = false;
+
+	// Registered counters
+	std::vector<Counter> counters;
+
+	// Write the header line with the column names
+	void WriteHeader();
+
+	// Write one row with the increments of all counters up to the given
+	// cycle.
+	void WriteRow(long long cycle);
+
+public:
+
+	/// Return the unique instance
+	static Statistics *getInstance();
+
+	/// Activate statistics, writing a sample into the file with the given
+	/// path every \a interval cycles.
+	void setPath(const std::string &path, long long interval);
+
+	/// Return whether statistics were activated
+	bool isActive() const { return active; }
+
+	/// Register a counter with the given column name. The getter returns
+	/// its cumulative value, and is invoked on every sample. This function
+	/// has no effect if statistics were not activated, and it must be
+	/// called before the first sample.
+	void Register(const std::string &name,
+			std::function<long long()> getter);
+
+	/// Write a sample if the interval ended in the given cycle of the
+	/// fastest frequency domain.
+	void Sample(long long cycle)
+	{
+		if (active && cycle >= next_cycle)
+			WriteRow(cycle);
+	}
+
+	/// Write the last, possibly shorter, interval at the end of the
+	/// simulation.
+	void Flush(long long cycle);
+};
+
+
+}  // namespace esim
+
+#endif
+
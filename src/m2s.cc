@@ -17,9 +17,16 @@
  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <algorithm>
+#include <cassert>
+#include <cctype>
 #include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <map>
 #include <sys/time.h>
+#include <sys/wait.h>
+#include <unistd.h>
 
 #include <arch/common/CallStack.h>
 #include <arch/common/Driver.h>
@@ -54,6 +61,7 @@
 #include <lib/cpp/Misc.h>
 #include <lib/cpp/Terminal.h>
 #include <lib/esim/Engine.h>
+#include <lib/esim/Statistics.h>
 #include <lib/esim/Trace.h>
 
 extern "C"
@@ -64,9 +72,24 @@ extern "C"
 // Configuration options
 //
 
+// Batch file with one simulation per line
+std::string m2s_batch_file;
+
+// Maximum number of simulations of a batch running at the same time
+int m2s_batch_jobs = 1;
+
+// True in the process running one simulation of a batch
+bool m2s_batch_simulation = false;
+
 // Context configuration file
 std::string m2s_context_config;
 
+// Co-simulation of timing simulators
+bool m2s_cosim = false;
+
+// Co-simulation lookahead in memory system cycles
+long long m2s_cosim_lookahead = 0;
+
 // Debug information in CUDA runtime
 std::string m2s_cuda_debug;
 
@@ -91,6 +114,12 @@ std::string m2s_opencl_debug;
 // List of OpenCL devices for runtime
 std::string m2s_opencl_devices;
 
+// Interval statistics file
+std::string m2s_stats_file;
+
+// Interval statistics sampling period in cycles
+long long m2s_stats_interval = 10000;
+
 // Trace file
 std::string m2s_trace_file;
 
@@ -264,6 +293,31 @@ void RegisterOptions()
 	// Set category for following options
 	command_line->setCategory("default", "General Multi2Sim Options");
 
+	// Batch of simulations
+	command_line->RegisterString("--batch <file>",
+			m2s_batch_file,
+			"Run a batch of independent simulations, one for each "
+			"line of the given file. Each line contains the "
+			"options, program, and arguments of one simulation, in "
+			"the same format as the Multi2Sim command line. Tokens "
+			"are separated by white space, and can be enclosed in "
+			"single or double quotes to include white space; there "
+			"are no escape characters. Empty lines and lines "
+			"starting with '#' are ignored, and option '--batch' "
+			"cannot be used in a line. Other options given together "
+			"with '--batch' are added to all simulations. Each "
+			"simulation runs in a separate process forked from "
+			"this one, as if Multi2Sim was run once per line, "
+			"except that the executable is not loaded again; "
+			"configuration files and programs are still read by "
+			"every simulation. The standard output and error of a "
+			"simulation are written to files <file>.<line>.out and "
+			"<file>.<line>.err.");
+	command_line->RegisterInt32("--batch-jobs <num> (default = 1)",
+			m2s_batch_jobs,
+			"Maximum number of simulations of a batch (option "
+			"'--batch') running at the same time.");
+
 	// Debugger for call stack
 	command_line->RegisterString("--call-debug <file>",
 			m2s_debug_callstack,
@@ -280,6 +334,28 @@ void RegisterOptions()
 			"--ctx-config-help for a description of the context "
 			"configuration file format.");
 	
+	// Co-simulation
+	command_line->RegisterBool("--cosim",
+			m2s_cosim,
+			"Run the timing simulators of the CPU and GPU "
+			"concurrently on separate host threads. They are "
+			"synchronized with each other and with the memory "
+			"system at the end of every quantum, whose length is "
+			"the lookahead given with option '--cosim-lookahead'. "
+			"Memory accesses start in a fixed order, but the CPU "
+			"and GPU emulate instructions in the order in which "
+			"host threads reach the emulator. Programs whose CPU "
+			"and GPU parts access the same memory concurrently "
+			"may observe a different interleaving on each run.");
+	command_line->RegisterInt64("--cosim-lookahead <cycles> "
+			"(default = 0)",
+			m2s_cosim_lookahead,
+			"Length of the co-simulation quanta (option '--cosim') "
+			"in memory system cycles. A value of 0 uses the minimum "
+			"latency of the memory modules that the CPU and GPU "
+			"access directly, which is the shortest time in which "
+			"one of them can observe the other through memory.");
+
 	// Debugger for event-driven simulator
 	command_line->RegisterString("--esim-debug <file>",
 			m2s_debug_esim,
@@ -299,6 +375,25 @@ void RegisterOptions()
 			"will stop once this time is exceeded. A value of 0 "
 			"(default) means no time limit.");
 	
+	// Interval statistics
+	command_line->RegisterString("--stats-file <file>",
+			m2s_stats_file,
+			"Dump a time series of simulation statistics into a CSV "
+			"file. Every interval of cycles (see option "
+			"'--stats-interval'), a line is added with the "
+			"increment over the interval of counters registered by "
+			"the CPU, GPU, memory, and network models, such as "
+			"committed instructions, cache accesses and hits, or "
+			"transferred bytes. The first line contains the names "
+			"of the columns. Only detailed simulations produce "
+			"samples.");
+	command_line->RegisterInt64("--stats-interval <cycles> "
+			"(default = 10000)",
+			m2s_stats_interval,
+			"Number of cycles of the fastest frequency domain "
+			"between samples in the statistics file given with "
+			"option '--stats-file'.");
+
 	// Trace file
 	command_line->RegisterString("--trace <file>",
 			m2s_trace_file,
@@ -404,6 +499,24 @@ void ProcessOptions()
 	if (!m2s_opencl_binary.empty())
 		environment->addVariable("M2S_OPENCL_BINARY", m2s_opencl_binary);
 
+	// Co-simulation
+	if (m2s_cosim_lookahead < 0)
+		throw misc::Error("Value for option '--cosim-lookahead' must "
+				"not be negative");
+	if (m2s_cosim_lookahead && !m2s_cosim)
+		throw misc::Error("Option '--cosim-lookahead' requires option "
+				"'--cosim'");
+
+	// Interval statistics
+	if (m2s_stats_interval < 1)
+		throw misc::Error("Value for option '--stats-interval' must "
+				"be greater than 0");
+	if (!m2s_stats_file.empty())
+	{
+		esim::Statistics *statistics = esim::Statistics::getInstance();
+		statistics->setPath(m2s_stats_file, m2s_stats_interval);
+	}
+
 	// Trace file
 	if (!m2s_trace_file.empty())
 	{
@@ -461,6 +574,7 @@ void MainLoop()
 
 	// Get singletons
 	comm::ArchPool *arch_pool = comm::ArchPool::getInstance();
+	esim::Statistics *statistics = esim::Statistics::getInstance();
 
 	// Simulation loop
 	while (!esim->hasFinished())
@@ -478,7 +592,10 @@ void MainLoop()
 		// next global simulation cycle if any architecture performed a
 		// useful timing simulation.
 		if (num_active_timing_simulators)
+		{
 			esim->ProcessEvents();
+			statistics->Sample(esim->getCycle());
+		}
 
 		// If neither functional nor timing simulation was performed for
 		// any architecture, it means that all guest contexts finished
@@ -499,6 +616,10 @@ void MainLoop()
 	// Process all remaining events
 	esim->ProcessAllEvents();
 
+	// Last interval of statistics
+	if (esim->getTime())
+		statistics->Flush(esim->getCycle());
+
 	// Restore default signal handlers
 	esim->DisableSignals();
 }
@@ -507,7 +628,7 @@ void MainLoop()
 void DumpStatisticsSummary(std::ostream &os = std::cerr)
 {
 	// No summary dumped if no simulation was run
-	if (m2s_loop_iterations < 2)
+	if (m2s_loop_iterations < 2 && !mem::System::isAccessTraceReplay())
 		return;
 	
 	// Print in blue
@@ -579,6 +700,236 @@ void DumpReports()
 }
 
 
+int MainProgram(int argc, char **argv);
+
+
+// Run one simulation of a batch in a forked process. The command line is
+// formed by the options of the batch command line, excluding the batch
+// options themselves, followed by the tokens of the batch file line. This
+// function does not return.
+void RunBatchSimulation(int argc, char **argv,
+		const std::vector<std::string> &tokens,
+		int line)
+{
+	// Redirect output
+	std::string out_file = misc::fmt("%s.%d.out",
+			m2s_batch_file.c_str(), line);
+	std::string err_file = misc::fmt("%s.%d.err",
+			m2s_batch_file.c_str(), line);
+	if (!freopen(out_file.c_str(), "w", stdout) ||
+			!freopen(err_file.c_str(), "w", stderr))
+		_exit(1);
+
+	// Build command line
+	std::vector<std::string> arguments;
+	arguments.push_back(argv[0]);
+	for (int i = 1; i < argc; i++)
+	{
+		std::string argument = argv[i];
+		if (argument == "--batch" || argument == "--batch-jobs")
+			i++;
+		else
+			arguments.push_back(argument);
+	}
+	arguments.insert(arguments.end(), tokens.begin(), tokens.end());
+	std::vector<char *> simulation_argv;
+	for (std::string &argument : arguments)
+		simulation_argv.push_back(&argument[0]);
+	simulation_argv.push_back(nullptr);
+
+	// Run simulation with a new command line
+	int status;
+	misc::CommandLine::Destroy();
+	m2s_batch_file.clear();
+	m2s_batch_simulation = true;
+	try
+	{
+		status = MainProgram(arguments.size(), simulation_argv.data());
+	}
+	catch (misc::Exception &e)
+	{
+		e.Dump();
+		status = 1;
+	}
+	exit(status);
+}
+
+
+// Wait for one simulation of a batch to finish. Return false if it failed.
+bool WaitBatchSimulation(std::map<pid_t, int> &running)
+{
+	// Wait for any child
+	int status;
+	pid_t pid = wait(&status);
+	if (pid < 0)
+		throw misc::Panic("No simulation running in batch");
+
+	// Remove from running simulations
+	auto it = running.find(pid);
+	assert(it != running.end());
+	int line = it->second;
+	running.erase(it);
+
+	// Check exit status
+	if (WIFEXITED(status) && !WEXITSTATUS(status))
+		return true;
+	std::cerr << misc::fmt("; Batch: simulation in line %d failed, "
+			"see %s.%d.err\n", line, m2s_batch_file.c_str(), line);
+	return false;
+}
+
+
+// Split the given line of the batch file into tokens separated by white
+// space. Quotes group characters, including white space, into a token, and
+// are removed.
+void TokenizeBatchLine(const std::string &line, int line_number,
+		std::vector<std::string> &tokens)
+{
+	std::string token;
+	bool in_token = false;
+	char quote = 0;
+	for (char c : line)
+	{
+		if (quote)
+		{
+			// Inside quotes
+			if (c == quote)
+				quote = 0;
+			else
+				token += c;
+		}
+		else if (c == '\'' || c == '"')
+		{
+			// Opening quote
+			quote = c;
+			in_token = true;
+		}
+		else if (isspace(c))
+		{
+			// End of token
+			if (in_token)
+				tokens.push_back(token);
+			token.clear();
+			in_token = false;
+		}
+		else
+		{
+			// Regular character
+			token += c;
+			in_token = true;
+		}
+	}
+
+	// Last token
+	if (quote)
+		throw misc::Error(misc::fmt("%s: line %d: missing closing "
+				"quote", m2s_batch_file.c_str(), line_number));
+	if (in_token)
+		tokens.push_back(token);
+}
+
+
+// Run all simulations in the batch file given with option --batch. Return
+// the exit code of Multi2Sim.
+int RunBatch(int argc, char **argv)
+{
+	// No program can be given in the batch command line
+	misc::CommandLine *command_line = misc::CommandLine::getInstance();
+	if (command_line->getArguments().size())
+		throw misc::Error("Option '--batch' is incompatible with a "
+				"program in the command line");
+	if (m2s_batch_jobs < 1)
+		throw misc::Error("Value for option '--batch-jobs' must be "
+				"greater than 0");
+
+	// Read simulations
+	std::ifstream f(m2s_batch_file);
+	if (!f)
+		throw misc::Error(misc::fmt("%s: cannot open batch file",
+				m2s_batch_file.c_str()));
+	std::vector<std::pair<int, std::vector<std::string>>> simulations;
+	std::string line;
+	for (int line_number = 1; std::getline(f, line); line_number++)
+	{
+		// Skip comments
+		size_t first = line.find_first_not_of(" \t\r");
+		if (first == std::string::npos || line[first] == '#')
+			continue;
+
+		// Tokenize
+		std::vector<std::string> tokens;
+		TokenizeBatchLine(line, line_number, tokens);
+		if (tokens.size())
+			simulations.emplace_back(line_number, tokens);
+	}
+
+	// Flush output before forking, so that it is not duplicated
+	std::cout.flush();
+	std::cerr.flush();
+	fflush(nullptr);
+
+	// Run simulations, keeping at most the given number of them running
+	std::map<pid_t, int> running;
+	int num_failed = 0;
+	for (auto &simulation : simulations)
+	{
+		// Wait for a free slot
+		while ((int) running.size() >= m2s_batch_jobs)
+			if (!WaitBatchSimulation(running))
+				num_failed++;
+
+		// Start simulation
+		pid_t pid = fork();
+		if (pid < 0)
+			throw misc::Error("Cannot fork process for batch "
+					"simulation");
+		if (!pid)
+			RunBatchSimulation(argc, argv, simulation.second,
+					simulation.first);
+		running[pid] = simulation.first;
+	}
+
+	// Wait for the rest
+	while (running.size())
+		if (!WaitBatchSimulation(running))
+			num_failed++;
+
+	// Summary
+	std::cerr << misc::fmt("; Batch: %d simulations, %d failed\n",
+			(int) simulations.size(), num_failed);
+	return num_failed ? 1 : 0;
+}
+
+
+// Run the timing simulators concurrently, with the lookahead given in option
+// --cosim-lookahead, or the minimum latency of their entry modules.
+void StartCoSimulation()
+{
+	comm::ArchPool *arch_pool = comm::ArchPool::getInstance();
+	mem::System *memory_system = mem::System::getInstance();
+	long long lookahead = m2s_cosim_lookahead;
+	for (auto it = arch_pool->getTimingBegin(),
+			end = arch_pool->getTimingEnd();
+			!m2s_cosim_lookahead && it != end; it++)
+	{
+		comm::Timing *timing = (*it)->getTiming();
+		for (int i = 0; i < timing->getNumEntryModules(); i++)
+		{
+			mem::Module *module = timing->getEntryModule(i);
+			if (!lookahead || module->getDataLatency() < lookahead)
+				lookahead = module->getDataLatency();
+		}
+	}
+
+	// Start with the lookahead in picoseconds
+	esim::FrequencyDomain *frequency_domain =
+			memory_system->getFrequencyDomain();
+	lookahead = std::max(1LL, lookahead);
+	arch_pool->StartCoSimulation(lookahead *
+			frequency_domain->getCycleTime());
+}
+
+
 int MainProgram(int argc, char **argv)
 {
 	// Print welcome message in standard error output
@@ -613,6 +964,17 @@ int MainProgram(int argc, char **argv)
 	// command-line option was not recognized.
 	misc::CommandLine *command_line = misc::CommandLine::getInstance();
 	command_line->Process(argc, argv, false);
+
+	// Batch of simulations, each one running in a forked process that
+	// processes its own command line
+	if (!m2s_batch_file.empty())
+	{
+		// A simulation of a batch would start a batch of its own
+		if (m2s_batch_simulation)
+			throw misc::Error("Option '--batch' cannot be used in "
+					"a batch file");
+		return RunBatch(argc, argv);
+	}
 	
 	// Process command line
 	ProcessOptions();
@@ -643,6 +1005,10 @@ int MainProgram(int argc, char **argv)
 	// simulation active. Check this in the architecture pool after all
 	// '--xxx-sim' command-line options have been processed.
 	comm::ArchPool *arch_pool = comm::ArchPool::getInstance();
+	if (mem::System::isAccessTraceReplay() && arch_pool->getNumTiming())
+		throw misc::Error("Option '--mem-trace-replay' is incompatible "
+				"with a detailed simulation (options "
+				"'--x86-sim detailed', '--si-sim detailed', ...)");
 	if (arch_pool->getNumTiming())
 	{
 		// We need to load the network configuration file prior to
@@ -652,9 +1018,37 @@ int MainProgram(int argc, char **argv)
 		net::System *net_system = net::System::getInstance();
 		net_system->ReadConfiguration();
 
+		// The DRAM configuration file is also loaded first, since main
+		// memory modules can refer to its memory controllers.
+		dram::System *dram_system = dram::System::getInstance();
+		dram_system->ReadConfiguration();
+
 		// Parse the memory configuration file
 		mem::System *memory_system = mem::System::getInstance();
 		memory_system->ReadConfiguration();
+
+		// Co-simulation, once entry modules are known
+		if (m2s_cosim)
+			StartCoSimulation();
+	}
+
+	// Replay a memory access trace, only if option --mem-trace-replay is
+	// used. No CPU or GPU is simulated in this case.
+	if (mem::System::isAccessTraceReplay())
+	{
+		net::System *net_system = net::System::getInstance();
+		net_system->ReadConfiguration();
+		dram::System *dram_system = dram::System::getInstance();
+		dram_system->ReadConfiguration();
+		mem::System *memory_system = mem::System::getInstance();
+		memory_system->ReadConfiguration();
+		memory_system->ReplayAccessTrace();
+
+		// Statistics summary and reports. No guest program is loaded
+		// in this mode.
+		DumpStatisticsSummary();
+		DumpReports();
+		return 0;
 	}
 
 	// Initialize network system, only if the option --net-sim is used
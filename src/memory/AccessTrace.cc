@@ -0,0 +1,185 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2012  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstring>
+
+#include "AccessTrace.h"
+#include "System.h"
+
+
+namespace mem
+{
+
+
+const char AccessTrace::signature[8] = { 'm', '2', 's', 'm', 't', 'r', 'c', 1 };
+
+
+AccessTraceWriter::AccessTraceWriter(const std::string &path) :
+		path(path)
+{
+	// Open file
+	f.open(path, std::ios::binary | std::ios::trunc);
+	if (!f)
+		throw Error(misc::fmt("%s: cannot open access trace for write",
+				path.c_str()));
+
+	// Signature
+	f.write(AccessTrace::signature, sizeof AccessTrace::signature);
+}
+
+
+void AccessTraceWriter::WriteVarInt(unsigned long long value)
+{
+	while (value >= 0x80)
+	{
+		f.put((char) (value & 0x7f) | 0x80);
+		value >>= 7;
+	}
+	f.put((char) value);
+}
+
+
+void AccessTraceWriter::Record(long long cycle,
+		Module *module,
+		Module::AccessType access_type,
+		unsigned address)
+{
+	// Introduce module the first time it is found
+	assert(access_type > 0 && access_type < 4);
+	auto it = module_indexes.find(module);
+	if (it == module_indexes.end())
+	{
+		unsigned index = module_indexes.size();
+		it = module_indexes.emplace(module, index).first;
+		const std::string &name = module->getName();
+		WriteVarInt((unsigned long long) index << 2);
+		WriteVarInt(name.length());
+		f.write(name.c_str(), name.length());
+	}
+
+	// Module index and access type
+	WriteVarInt(((unsigned long long) it->second << 2) | access_type);
+
+	// Cycles since last access. The first access is relative to cycle 0.
+	assert(cycle >= last_cycle);
+	WriteVarInt(cycle - last_cycle);
+	last_cycle = cycle;
+
+	// Address
+	char bytes[4];
+	for (int i = 0; i < 4; i++)
+		bytes[i] = (address >> (i * 8)) & 0xff;
+	f.write(bytes, 4);
+
+	// Check errors
+	if (!f)
+		throw Error(misc::fmt("%s: error writing access trace",
+				path.c_str()));
+	num_accesses++;
+}
+
+
+AccessTraceReader::AccessTraceReader(const std::string &path) :
+		path(path)
+{
+	// Open file
+	f.open(path, std::ios::binary);
+	if (!f)
+		throw Error(misc::fmt("%s: cannot open access trace",
+				path.c_str()));
+
+	// Check signature
+	char signature[sizeof AccessTrace::signature];
+	f.read(signature, sizeof signature);
+	if (!f || memcmp(signature, AccessTrace::signature, sizeof signature))
+		throw Error(misc::fmt("%s: not a valid access trace",
+				path.c_str()));
+}
+
+
+bool AccessTraceReader::ReadVarInt(unsigned long long &value)
+{
+	value = 0;
+	for (int shift = 0; shift < 64; shift += 7)
+	{
+		int c = f.get();
+		if (c == EOF)
+		{
+			if (!shift)
+				return false;
+			throw Error(misc::fmt("%s: unexpected end of access "
+					"trace", path.c_str()));
+		}
+		value |= (unsigned long long) (c & 0x7f) << shift;
+		if (!(c & 0x80))
+			return true;
+	}
+	throw Error(misc::fmt("%s: corrupt access trace", path.c_str()));
+}
+
+
+bool AccessTraceReader::Read(Record &record)
+{
+	while (true)
+	{
+		// Module index and access type
+		unsigned long long value;
+		if (!ReadVarInt(value))
+			return false;
+		unsigned index = value >> 2;
+		int access_type = value & 3;
+
+		// New module
+		if (!access_type)
+		{
+			unsigned long long length;
+			if (index != module_names.size() || !ReadVarInt(length))
+				throw Error(misc::fmt("%s: corrupt access trace",
+						path.c_str()));
+			std::string name(length, '\0');
+			f.read(&name[0], length);
+			module_names.push_back(name);
+			continue;
+		}
+
+		// Access
+		unsigned long long cycle_delta;
+		char bytes[4];
+		if (index >= module_names.size() || !ReadVarInt(cycle_delta))
+			throw Error(misc::fmt("%s: corrupt access trace",
+					path.c_str()));
+		f.read(bytes, 4);
+		if (!f)
+			throw Error(misc::fmt("%s: unexpected end of access "
+					"trace", path.c_str()));
+
+		// Populate record
+		record.module_name = module_names[index];
+		record.access_type = (Module::AccessType) access_type;
+		record.cycle_delta = cycle_delta;
+		record.address = 0;
+		for (int i = 0; i < 4; i++)
+			record.address |= (unsigned) (unsigned char) bytes[i] <<
+					(i * 8);
+		return true;
+	}
+}
+
+
+}  // namespace mem
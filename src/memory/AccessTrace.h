@@ -0,0 +1,142 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2012  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MEMORY_ACCESS_TRACE_H
+#define MEMORY_ACCESS_TRACE_H
+
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Module.h"
+
+
+namespace mem
+{
+
+/// Binary trace of the accesses performed by CPUs and GPUs on the entry
+/// modules of the memory hierarchy.
+///
+/// The file starts with an 8-byte signature, followed by a sequence of
+/// records. Each record starts with a variable-length integer (7 bits per
+/// byte, least significant group first) encoding the module index shifted
+/// left by 2, combined with the access type in the 2 least significant
+/// bits. An access type of 0 introduces a new module, and is followed by
+/// the length and characters of the module name. Any other access type is
+/// followed by the number of memory system cycles elapsed since the
+/// previous access, as a variable-length integer, and the 32-bit physical
+/// address in little-endian order.
+class AccessTrace
+{
+public:
+
+	/// Signature at the beginning of a trace file
+	static const char signature[8];
+};
+
+
+/// Writer of a memory access trace
+class AccessTraceWriter
+{
+	// Output file
+	std::ofstream f;
+
+	// Path of the output file
+	std::string path;
+
+	// Index assigned to each module found so far in the trace
+	std::unordered_map<Module *, unsigned> module_indexes;
+
+	// Cycle of the last recorded access
+	long long last_cycle = 0;
+
+	// Number of accesses recorded
+	long long num_accesses = 0;
+
+	// Write a variable-length integer
+	void WriteVarInt(unsigned long long value);
+
+public:
+
+	/// Create the trace file with the given path
+	AccessTraceWriter(const std::string &path);
+
+	/// Record an access to \a module performed in the given memory system
+	/// cycle.
+	void Record(long long cycle,
+			Module *module,
+			Module::AccessType access_type,
+			unsigned address);
+
+	/// Return the number of accesses recorded
+	long long getNumAccesses() const { return num_accesses; }
+};
+
+
+/// Reader of a memory access trace
+class AccessTraceReader
+{
+public:
+
+	/// Access read from the trace
+	struct Record
+	{
+		/// Name of the accessed module
+		std::string module_name;
+
+		/// Access type
+		Module::AccessType access_type;
+
+		/// Number of memory system cycles since the previous access
+		long long cycle_delta;
+
+		/// Physical address
+		unsigned address;
+	};
+
+private:
+
+	// Input file
+	std::ifstream f;
+
+	// Path of the input file
+	std::string path;
+
+	// Module names, indexed by their index in the trace
+	std::vector<std::string> module_names;
+
+	// Read a variable-length integer. Return false if the end of the
+	// file is found before the first byte.
+	bool ReadVarInt(unsigned long long &value);
+
+public:
+
+	/// Open the trace file with the given path
+	AccessTraceReader(const std::string &path);
+
+	/// Read the next access into \a record. Return false if the end of
+	/// the trace was reached.
+	bool Read(Record &record);
+};
+
+
+}  // namespace mem
+
+#endif
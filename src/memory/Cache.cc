@@ -134,13 +134,14 @@ void Cache::setBlock(unsigned set_id,
 		BlockState state)
 {
 	// Trace
-	System::trace << misc::fmt("mem.set_block cache=\"%s\" "
-			"set=%d way=%d tag=0x%x state=\"%s\"\n",
-			name.c_str(),
-			set_id,
-			way_id,
-			tag,
-			BlockStateMap[state]);
+	if (System::trace)
+		System::trace << misc::fmt("mem.set_block cache=\"%s\" "
+				"set=%d way=%d tag=0x%x state=\"%s\"\n",
+				name.c_str(),
+				set_id,
+				way_id,
+				tag,
+				BlockStateMap[state]);
 	
 	// Get set and block
 	Set *set = getSet(set_id);
@@ -155,6 +156,15 @@ void Cache::setBlock(unsigned set_id,
 		set->lru_list.PushFront(block->lru_node);
 	}
 
+	// Record old and new tags for incremental sanity checks
+	if (record_changes && (block->tag != tag || block->state != state))
+	{
+		if (block->state != BlockInvalid)
+			changed_tags.push_back(block->tag);
+		if (state != BlockInvalid)
+			changed_tags.push_back(tag);
+	}
+
 	// Set new values for block
 	block->tag = tag;
 	block->state = state;
@@ -21,6 +21,7 @@
 #define MEMORY_CACHE_H
 
 #include <memory>
+#include <vector>
 
 #include <lib/cpp/List.h>
 #include <lib/cpp/String.h>
@@ -158,6 +159,14 @@ private:
 	// Write policy (write-back, write-through)
 	WritePolicy write_policy;
 
+	// Whether blocks modified with setBlock() are recorded for incremental
+	// sanity checks of the coherence protocol
+	bool record_changes = false;
+
+	// Old and new tags of the valid blocks modified since the last call to
+	// ClearChangedTags()
+	std::vector<unsigned> changed_tags;
+
 	// Array of sets
 	std::unique_ptr<Set[]> sets;
 
@@ -288,6 +297,22 @@ public:
 		block->transient_tag = tag;
 	}
 
+	/// Start recording the blocks whose tag or state change in calls to
+	/// setBlock(). This is used by incremental sanity checks of the
+	/// coherence protocol.
+	void RecordChanges() { record_changes = true; }
+
+	/// Return the tags of the valid blocks that were replaced, brought
+	/// into the cache, or changed state since the last call to
+	/// ClearChangedTags(). A tag can appear multiple times.
+	const std::vector<unsigned> &getChangedTags() const
+	{
+		return changed_tags;
+	}
+
+	/// Clear the list of changed tags
+	void ClearChangedTags() { changed_tags.clear(); }
+
 
 
 	//
@@ -31,25 +31,52 @@ namespace mem
 const int Directory::NoOwner;
 
 
+const misc::StringMap Directory::TypeMap =
+{
+	{ "FullMap", TypeFullMap },
+	{ "LimitedPointer", TypeLimitedPointer },
+	{ "CoarseVector", TypeCoarseVector },
+	{ "Sparse", TypeSparse }
+};
+
+
 Directory::Directory(const std::string &name,
 		int num_sets,
 		int num_ways,
 		int num_sub_blocks,
-		int num_nodes)
+		int num_nodes,
+		Type type,
+		int num_pointers,
+		int coarseness)
 		:
 		name(name),
 		num_sets(num_sets),
 		num_ways(num_ways),
 		num_sub_blocks(num_sub_blocks),
 		num_nodes(num_nodes),
-		sharers(num_sets * num_ways * num_sub_blocks * num_nodes)
+		type(type),
+		num_pointers(num_pointers),
+		coarseness(coarseness),
+		num_bits(type == TypeFullMap ? num_nodes :
+				type == TypeCoarseVector ?
+				(num_nodes + coarseness - 1) / coarseness : 0),
+		sharers((size_t) num_sets * num_ways * num_sub_blocks *
+				std::max(num_bits, 1))
 {
+	// Sanity
+	assert(type == TypeFullMap ||
+			type == TypeSparse ||
+			(type == TypeLimitedPointer && num_pointers > 0) ||
+			(type == TypeCoarseVector && coarseness > 0));
+
 	// Initialize entries
 	entries = misc::new_unique_array<Entry>(num_sets
 			* num_ways * num_sub_blocks);
 
-	// Initialize locks
-	locks = misc::new_unique_array<Lock>(num_sets * num_ways);
+	// Initialize pointers
+	if (type == TypeLimitedPointer)
+		pointers = misc::new_unique_array<short>(num_sets * num_ways *
+				num_sub_blocks * num_pointers);
 }
 	
 
@@ -59,165 +86,308 @@ void Directory::setOwner(int set_id, int way_id, int sub_block_id, int owner)
 	assert(owner == NoOwner || misc::inRange(owner, 0, num_nodes - 1));
 	Entry *entry = getEntry(set_id, way_id, sub_block_id);
 	entry->setOwner(owner);
+	RecordChange(set_id, way_id);
 
 	// Trace
-	System::trace << misc::fmt("mem.set_owner dir=\"%s\" "
-			"x=%d y=%d z=%d owner=%d\n",
-			name.c_str(),
-			set_id,
-			way_id,
-			sub_block_id,
-			owner);
+	if (System::trace)
+		System::trace << misc::fmt("mem.set_owner dir=\"%s\" "
+				"x=%d y=%d z=%d owner=%d\n",
+				name.c_str(),
+				set_id,
+				way_id,
+				sub_block_id,
+				owner);
 
 	// Debug
-	System::debug << misc::fmt("    dir=\"%s\" set=%d, way=%d, sub_block=%d: "
-			"set owner=%d\n",
-			name.c_str(),
-			set_id,
-			way_id,
-			sub_block_id,
-			owner);
+	if (System::debug)
+		System::debug << misc::fmt("    dir=\"%s\" set=%d, way=%d, "
+				"sub_block=%d: set owner=%d\n",
+				name.c_str(),
+				set_id,
+				way_id,
+				sub_block_id,
+				owner);
 }
 	
 
 void Directory::setSharer(int set_id, int way_id, int sub_block_id, int node_id)
 {
 	// Sanity
-	assert(misc::inRange(set_id, 0, num_sets - 1));
-	assert(misc::inRange(way_id, 0, num_ways - 1));
-	assert(misc::inRange(sub_block_id, 0, num_sub_blocks - 1));
 	assert(misc::inRange(node_id, 0, num_nodes - 1));
+	int index = getEntryIndex(set_id, way_id, sub_block_id);
+	Entry *entry = &entries[index];
 
-	// Get position in bitmap
-	int bit_id = set_id * num_ways * num_sub_blocks * num_nodes +
-			way_id * num_sub_blocks * num_nodes +
-			sub_block_id * num_nodes +
-			node_id;
-	
 	// Check if already set
-	if (sharers[bit_id])
+	if (isSharer(set_id, way_id, sub_block_id, node_id))
 		return;
+	RecordChange(set_id, way_id);
 	
 	// Set sharer
-	Entry *entry = getEntry(set_id, way_id, sub_block_id);
 	assert(entry->getNumSharers() < num_nodes);
-	entry->incNumSharers();
-	sharers.Set(bit_id);
+	switch (type)
+	{
+
+	case TypeFullMap:
+
+		sharers.Set((size_t) index * num_bits + node_id);
+		entry->incNumSharers();
+		break;
+
+	case TypeLimitedPointer:
+
+		// When pointers run out, the entry overflows and all nodes
+		// become sharers.
+		if (entry->getNumSharers() < num_pointers)
+		{
+			pointers[(size_t) index * num_pointers +
+					entry->getNumSharers()] = node_id;
+			entry->incNumSharers();
+		}
+		else
+		{
+			entry->setNumSharers(num_nodes);
+		}
+		break;
+
+	case TypeCoarseVector:
+
+		// All nodes in the group become sharers
+		sharers.Set((size_t) index * num_bits + node_id / coarseness);
+		entry->setNumSharers(entry->getNumSharers() +
+				getGroupSize(node_id));
+		break;
+
+	case TypeSparse:
+	{
+		auto it = sparse_sharers.find(index);
+		if (it == sparse_sharers.end())
+			it = sparse_sharers.emplace(index,
+					misc::Bitmap(num_nodes)).first;
+		it->second.Set(node_id);
+		entry->incNumSharers();
+		break;
+	}
+
+	default:
+
+		throw misc::Panic("Invalid directory type");
+	}
 	
 	// Trace
-	System::trace << misc::fmt("mem.set_sharer dir=\"%s\" "
-			"x=%d y=%d z=%d sharer=%d\n",
-			name.c_str(),
-			set_id,
-			way_id,
-			sub_block_id,
-			node_id);
-
-	System::debug << misc::fmt("    dir=\"%s\" set=%d, way=%d, sub_block=%d: "
-			"set sharer=%d\n",
-			name.c_str(),
-			set_id,
-			way_id,
-			sub_block_id,
-			node_id);
+	if (System::trace)
+		System::trace << misc::fmt("mem.set_sharer dir=\"%s\" "
+				"x=%d y=%d z=%d sharer=%d\n",
+				name.c_str(),
+				set_id,
+				way_id,
+				sub_block_id,
+				node_id);
+
+	if (System::debug)
+		System::debug << misc::fmt("    dir=\"%s\" set=%d, way=%d, "
+				"sub_block=%d: set sharer=%d\n",
+				name.c_str(),
+				set_id,
+				way_id,
+				sub_block_id,
+				node_id);
 }
 
 
 void Directory::clearSharer(int set_id, int way_id, int sub_block_id, int node_id)
 {
 	// Sanity
-	assert(misc::inRange(set_id, 0, num_sets - 1));
-	assert(misc::inRange(way_id, 0, num_ways - 1));
-	assert(misc::inRange(sub_block_id, 0, num_sub_blocks - 1));
 	assert(misc::inRange(node_id, 0, num_nodes - 1));
+	int index = getEntryIndex(set_id, way_id, sub_block_id);
+	Entry *entry = &entries[index];
 
-	// Get position in bitmap
-	int bit_id = set_id * num_ways * num_sub_blocks * num_nodes +
-			way_id * num_sub_blocks * num_nodes +
-			sub_block_id * num_nodes +
-			node_id;
-	
 	// Check if already clear
-	if (!sharers[bit_id])
+	if (!isSharer(set_id, way_id, sub_block_id, node_id))
 		return;
+	RecordChange(set_id, way_id);
 	
 	// Clear sharer
-	Entry *entry = getEntry(set_id, way_id, sub_block_id);
 	assert(entry->getNumSharers() > 0);
-	entry->decNumSharers();
-	sharers.Set(bit_id, false);
+	switch (type)
+	{
+
+	case TypeFullMap:
+
+		sharers.Set((size_t) index * num_bits + node_id, false);
+		entry->decNumSharers();
+		break;
+
+	case TypeLimitedPointer:
+	{
+		// Overflowed entries can only be cleared as a whole
+		if (entry->getNumSharers() > num_pointers)
+			return;
+
+		// Replace pointer with the last one
+		short *entry_pointers = &pointers[(size_t) index *
+				num_pointers];
+		int last = entry->getNumSharers() - 1;
+		for (int i = 0; i < last; i++)
+			if (entry_pointers[i] == node_id)
+				entry_pointers[i] = entry_pointers[last];
+		entry->decNumSharers();
+		break;
+	}
+
+	case TypeCoarseVector:
+
+		// Other nodes in the group might still be sharers
+		if (getGroupSize(node_id) > 1)
+			return;
+		sharers.Set((size_t) index * num_bits + node_id / coarseness,
+				false);
+		entry->decNumSharers();
+		break;
+
+	case TypeSparse:
+	{
+		auto it = sparse_sharers.find(index);
+		assert(it != sparse_sharers.end());
+		it->second.Set(node_id, false);
+		entry->decNumSharers();
+		if (!entry->getNumSharers())
+			sparse_sharers.erase(it);
+		break;
+	}
+
+	default:
+
+		throw misc::Panic("Invalid directory type");
+	}
 	
 	// Trace
-	System::trace << misc::fmt("mem.clear_sharer dir=\"%s\" "
-			"x=%d y=%d z=%d sharer=%d\n",
-			name.c_str(),
-			set_id,
-			way_id,
-			sub_block_id,
-			node_id);
+	if (System::trace)
+		System::trace << misc::fmt("mem.clear_sharer dir=\"%s\" "
+				"x=%d y=%d z=%d sharer=%d\n",
+				name.c_str(),
+				set_id,
+				way_id,
+				sub_block_id,
+				node_id);
 
 	// Debug
-	System::debug << misc::fmt("    dir=\"%s\" set=%d, way=%d, sub_block=%d: "
-			"clear sharer=%d\n",
-			name.c_str(),
-			set_id,
-			way_id,
-			sub_block_id,
-			node_id);
+	if (System::debug)
+		System::debug << misc::fmt("    dir=\"%s\" set=%d, way=%d, "
+				"sub_block=%d: clear sharer=%d\n",
+				name.c_str(),
+				set_id,
+				way_id,
+				sub_block_id,
+				node_id);
 }
 
 
 void Directory::clearAllSharers(int set_id, int way_id, int sub_block_id)
 {
 	// Skip if no sharer is present
-	Entry *entry = getEntry(set_id, way_id, sub_block_id);
+	int index = getEntryIndex(set_id, way_id, sub_block_id);
+	Entry *entry = &entries[index];
 	if (entry->getNumSharers() == 0)
 		return;
-	
-	// Get position in bitmap
-	int bit_id = set_id * num_ways * num_sub_blocks * num_nodes +
-			way_id * num_sub_blocks * num_nodes +
-			sub_block_id * num_nodes;
+	RecordChange(set_id, way_id);
 	
 	// Clear all sharers
 	entry->setNumSharers(0);
-	for (int i = 0; i < num_nodes; i++)
-		sharers.Set(bit_id + i, false);
+	if (type == TypeFullMap || type == TypeCoarseVector)
+	{
+		for (int i = 0; i < num_bits; i++)
+			sharers.Set((size_t) index * num_bits + i, false);
+	}
+	else if (type == TypeSparse)
+	{
+		sparse_sharers.erase(index);
+	}
 	
 	// Trace
-	System::trace << misc::fmt("mem.clear_all_sharers dir=\"%s\" "
-			"x=%d y=%d z=%d\n",
-			name.c_str(),
-			set_id,
-			way_id,
-			sub_block_id);
+	if (System::trace)
+		System::trace << misc::fmt("mem.clear_all_sharers dir=\"%s\" "
+				"x=%d y=%d z=%d\n",
+				name.c_str(),
+				set_id,
+				way_id,
+				sub_block_id);
 
 	// Debug
-	System::debug << misc::fmt("    clear all sharer "
-			"dir=\"%s\" set=%d, way=%d, sub_block=%d\n",
-			name.c_str(),
-			set_id,
-			way_id,
-			sub_block_id);
+	if (System::debug)
+		System::debug << misc::fmt("    clear all sharer "
+				"dir=\"%s\" set=%d, way=%d, sub_block=%d\n",
+				name.c_str(),
+				set_id,
+				way_id,
+				sub_block_id);
+}
+
+
+void Directory::clearAllSharersExcept(int set_id, int way_id, int sub_block_id,
+		int node_id)
+{
+	// Precise directories remove sharers one by one
+	assert(node_id == NoOwner || misc::inRange(node_id, 0, num_nodes - 1));
+	if (isPrecise())
+	{
+		for (int i = 0; i < num_nodes; i++)
+			if (i != node_id)
+				clearSharer(set_id, way_id, sub_block_id, i);
+		return;
+	}
+
+	// Imprecise directories clear the entire entry, and add the remaining
+	// sharer again.
+	bool keep = node_id != NoOwner &&
+			isSharer(set_id, way_id, sub_block_id, node_id);
+	clearAllSharers(set_id, way_id, sub_block_id);
+	if (keep)
+		setSharer(set_id, way_id, sub_block_id, node_id);
 }
 
 
 bool Directory::isSharer(int set_id, int way_id, int sub_block_id, int node_id)
 {
 	// Sanity
-	assert(misc::inRange(set_id, 0, num_sets - 1));
-	assert(misc::inRange(way_id, 0, num_ways - 1));
-	assert(misc::inRange(sub_block_id, 0, num_sub_blocks - 1));
 	assert(misc::inRange(node_id, 0, num_nodes - 1));
+	int index = getEntryIndex(set_id, way_id, sub_block_id);
 
-	// Get position in bitmap
-	int bit_id = set_id * num_ways * num_sub_blocks * num_nodes +
-			way_id * num_sub_blocks * num_nodes +
-			sub_block_id * num_nodes +
-			node_id;
-	
 	// Return whether sharer is present
-	return sharers[bit_id];
+	switch (type)
+	{
+
+	case TypeFullMap:
+
+		return sharers[(size_t) index * num_bits + node_id];
+
+	case TypeLimitedPointer:
+	{
+		int num_sharers = entries[index].getNumSharers();
+		if (num_sharers > num_pointers)
+			return true;
+		short *entry_pointers = &pointers[(size_t) index *
+				num_pointers];
+		for (int i = 0; i < num_sharers; i++)
+			if (entry_pointers[i] == node_id)
+				return true;
+		return false;
+	}
+
+	case TypeCoarseVector:
+
+		return sharers[(size_t) index * num_bits +
+				node_id / coarseness];
+
+	case TypeSparse:
+	{
+		auto it = sparse_sharers.find(index);
+		return it != sparse_sharers.end() && it->second[node_id];
+	}
+
+	default:
+
+		throw misc::Panic("Invalid directory type");
+	}
 }
 
 
@@ -258,42 +428,46 @@ bool Directory::LockEntry(
 	assert(access_id > 0);
 	assert(misc::inRange(set_id, 0, num_sets - 1));
 	assert(misc::inRange(way_id, 0, num_ways - 1));
-	Lock *lock = &locks[set_id * num_ways + way_id];
+	auto it = locks.find(set_id * num_ways + way_id);
 
 	// If the entry is already locked, enqueue a new waiter and return
 	// failure to lock.
-	if (lock->access_id)
+	if (it != locks.end())
 	{
+		Lock *lock = &it->second;
 		lock->queue.Wait(event);
-		System::debug << misc::fmt("    "
-				"A-%lld suspended, "
-				"A-%lld has directory entry lock\n",
-				access_id,
-				lock->access_id);
+		if (System::debug)
+			System::debug << misc::fmt("    "
+					"A-%lld suspended, "
+					"A-%lld has directory entry lock\n",
+					access_id,
+					lock->access_id);
 		return false;
 	}
 
 	// Trace
-	System::trace << misc::fmt("mem.new_access_block "
-			"cache=\"%s\" "
-			"access=\"A-%lld\" "
-			"set=%d "
-			"way=%d\n",
-			name.c_str(),
-			access_id,
-			set_id,
-			way_id);
+	if (System::trace)
+		System::trace << misc::fmt("mem.new_access_block "
+				"cache=\"%s\" "
+				"access=\"A-%lld\" "
+				"set=%d "
+				"way=%d\n",
+				name.c_str(),
+				access_id,
+				set_id,
+				way_id);
 	
 	// Debug
-	System::debug << misc::fmt("    "
-			"A-%lld acquires directory lock "
-			"at set=%d, way=%d\n",
-			access_id,
-			set_id,
-			way_id);
+	if (System::debug)
+		System::debug << misc::fmt("    "
+				"A-%lld acquires directory lock "
+				"at set=%d, way=%d\n",
+				access_id,
+				set_id,
+				way_id);
 
 	// Lock entry
-	lock->access_id = access_id;
+	locks[set_id * num_ways + way_id].access_id = access_id;
 	return true;
 }
 
@@ -303,17 +477,20 @@ void Directory::UnlockEntry(int set_id, int way_id, long long access_id)
 	// Get lock
 	assert(misc::inRange(set_id, 0, num_sets - 1));
 	assert(misc::inRange(way_id, 0, num_ways - 1));
-	Lock *lock = &locks[set_id * num_ways + way_id];
+	auto it = locks.find(set_id * num_ways + way_id);
+	assert(it != locks.end());
+	Lock *lock = &it->second;
 	assert(lock->access_id > 0);
 	assert(access_id == lock->access_id);
 
 	// Debug
-	System::debug << misc::fmt("    "
-			"A-%lld releases directory lock "
-			"at set=%d, way=%d\n",
-			access_id,
-			set_id,
-			way_id);
+	if (System::debug)
+		System::debug << misc::fmt("    "
+				"A-%lld releases directory lock "
+				"at set=%d, way=%d\n",
+				access_id,
+				set_id,
+				way_id);
 
 	// Wake up all frames waiting in the queue.
 	//
@@ -329,9 +506,10 @@ void Directory::UnlockEntry(int set_id, int way_id, long long access_id)
 		while (true)
 		{
 			// Print debug info
-			System::debug << misc::fmt("      "
-					"A-%lld resumed to retry lock\n",
-					frame->getId());
+			if (System::debug)
+				System::debug << misc::fmt("      A-%lld "
+						"resumed to retry lock\n",
+						frame->getId());
 
 			// Done if no more frames
 			if (!frame->getNext())
@@ -346,18 +524,19 @@ void Directory::UnlockEntry(int set_id, int way_id, long long access_id)
 	}
 
 	// Trace
-	System::trace << misc::fmt("mem.end_access_block "
-			"cache=\"%s\" "
-			"access=\"A-%lld\" "
-			"set=%d "
-			"way=%d\n",
-			name.c_str(),
-			access_id,
-			set_id,
-			way_id);
+	if (System::trace)
+		System::trace << misc::fmt("mem.end_access_block "
+				"cache=\"%s\" "
+				"access=\"A-%lld\" "
+				"set=%d "
+				"way=%d\n",
+				name.c_str(),
+				access_id,
+				set_id,
+				way_id);
 
 	// Unlock entry
-	lock->access_id = 0;
+	locks.erase(it);
 }
 
 
@@ -366,10 +545,10 @@ long long Directory::getEntryAccessId(int set_id, int way_id) const
 	// Get lock
 	assert(misc::inRange(set_id, 0, num_sets - 1));
 	assert(misc::inRange(way_id, 0, num_ways - 1));
-	Lock *lock = &locks[set_id * num_ways + way_id];
+	auto it = locks.find(set_id * num_ways + way_id);
 
 	// Return frame locking entry
-	return lock->access_id;
+	return it == locks.end() ? 0 : it->second.access_id;
 }
 
 
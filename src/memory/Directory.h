@@ -20,10 +20,14 @@
 #ifndef MEMORY_DIRECTORY_H
 #define MEMORY_DIRECTORY_H
 
+#include <algorithm>
 #include <cassert>
+#include <unordered_map>
+#include <vector>
 
 #include <lib/cpp/Bitmap.h>
 #include <lib/cpp/Misc.h>
+#include <lib/cpp/String.h>
 #include <lib/esim/Queue.h>
 
 
@@ -41,6 +45,32 @@ public:
 	/// Value set to an owner identifier to represent no owner
 	static const int NoOwner = -1;
 
+	/// Encoding of the sharers of each directory entry
+	enum Type
+	{
+		TypeInvalid = 0,
+
+		/// One bit per node. The set of sharers is exact.
+		TypeFullMap,
+
+		/// A limited number of node identifiers per entry. When more
+		/// sharers are added than there are pointers, the entry
+		/// overflows and every node is considered a sharer until the
+		/// entry is cleared.
+		TypeLimitedPointer,
+
+		/// One bit per group of consecutive nodes. Setting a sharer
+		/// makes all nodes in its group sharers.
+		TypeCoarseVector,
+
+		/// Exact set of sharers, only allocated for entries that have
+		/// at least one sharer.
+		TypeSparse
+	};
+
+	/// String map for values of type Type
+	static const misc::StringMap TypeMap;
+
 	/// Directory entry
 	class Entry
 	{
@@ -55,7 +85,10 @@ public:
 		/// Return owner identifier
 		int getOwner() const { return owner; }
 
-		/// Return number of sharers
+		/// Return number of sharers. For directories with an imprecise
+		/// encoding, this is the number of nodes for which
+		/// Directory::isSharer() returns true, which can be larger than
+		/// the number of nodes actually holding the sub-block.
 		int getNumSharers() const { return num_sharers; }
 
 		/// Set new owner
@@ -96,14 +129,70 @@ private:
 	int num_sub_blocks;
 	int num_nodes;
 
-	// Bitmap of sharers for the entire directory
+	// Sharer encoding
+	Type type;
+
+	// Number of node identifiers per entry in limited-pointer directories
+	int num_pointers = 0;
+
+	// Number of nodes per bit in coarse-vector directories
+	int coarseness = 1;
+
+	// Number of sharer bits per entry in full-map and coarse-vector
+	// directories
+	int num_bits = 0;
+
+	// Sharer bits for full-map and coarse-vector directories
 	misc::Bitmap sharers;
 
+	// Node identifiers for limited-pointer directories. The first
+	// 'num_sharers' pointers of an entry are valid, unless the entry has
+	// more sharers than pointers, in which case it overflowed.
+	std::unique_ptr<short[]> pointers;
+
+	// Sharer bits for sparse directories, indexed by entry. Only entries
+	// with at least one sharer are present.
+	std::unordered_map<int, misc::Bitmap> sparse_sharers;
+
 	// Directory entries
 	std::unique_ptr<Entry[]> entries;
 
-	// Directory locks
-	std::unique_ptr<Lock[]> locks;
+	// Locks for the directory entries currently locked, indexed by
+	// set * num_ways + way. An entry is removed when unlocked.
+	std::unordered_map<int, Lock> locks;
+
+	// Whether modified entries are recorded for incremental sanity checks
+	// of the coherence protocol
+	bool record_changes = false;
+
+	// Entries whose owner or sharers were modified since the last call to
+	// ClearChangedEntries(), given as set * num_ways + way
+	std::vector<int> changed_entries;
+
+	// Record a modification of the owner or sharers of an entry
+	void RecordChange(int set_id, int way_id)
+	{
+		if (record_changes)
+			changed_entries.push_back(set_id * num_ways + way_id);
+	}
+
+	// Return the index of an entry
+	int getEntryIndex(int set_id, int way_id, int sub_block_id) const
+	{
+		assert(misc::inRange(set_id, 0, num_sets - 1));
+		assert(misc::inRange(way_id, 0, num_ways - 1));
+		assert(misc::inRange(sub_block_id, 0, num_sub_blocks - 1));
+		return (set_id * num_ways + way_id) * num_sub_blocks +
+				sub_block_id;
+	}
+
+	// Return the number of nodes represented by the coarse-vector bit of
+	// the given node
+	int getGroupSize(int node_id) const
+	{
+		int first = node_id / coarseness * coarseness;
+		return std::min(coarseness, num_nodes - first);
+	}
 
 public:
 
@@ -124,11 +213,24 @@ public:
 	/// \param num_nodes
 	///	Number of nodes that can be sharers of each sub-block
 	///
+	/// \param type
+	///	Encoding of the sharers of each entry
+	///
+	/// \param num_pointers
+	///	Number of node identifiers per entry, for limited-pointer
+	///	directories
+	///
+	/// \param coarseness
+	///	Number of nodes per bit, for coarse-vector directories
+	///
 	Directory(const std::string &name,
 			int num_sets,
 			int num_ways,
 			int num_sub_blocks,
-			int num_nodes);
+			int num_nodes,
+			Type type = TypeFullMap,
+			int num_pointers = 4,
+			int coarseness = 4);
 	
 	/// Return the number of sets
 	int getNumSets() { return num_sets; }
@@ -142,15 +244,23 @@ public:
 	/// Return the number of nodes that can be sharers of each sub-block
 	int getNumNodes() { return num_nodes; }
 
+	/// Return the sharer encoding
+	Type getType() const { return type; }
+
+	/// Return whether the set of sharers is always exact. Imprecise
+	/// directories may report nodes not holding a sub-block as sharers,
+	/// causing unnecessary invalidations that the coherence protocol
+	/// handles as requests for evicted blocks.
+	bool isPrecise() const
+	{
+		return type == TypeFullMap || type == TypeSparse ||
+				(type == TypeCoarseVector && coarseness == 1);
+	}
+
 	/// Return a directory entry
 	Entry *getEntry(int set_id, int way_id, int sub_block_id)
 	{
-		assert(misc::inRange(set_id, 0, num_sets - 1));
-		assert(misc::inRange(way_id, 0, num_ways - 1));
-		assert(misc::inRange(sub_block_id, 0, num_sub_blocks - 1));
-		return &entries.get()[set_id * num_ways * num_sub_blocks +
-				way_id * num_sub_blocks +
-				sub_block_id];
+		return &entries[getEntryIndex(set_id, way_id, sub_block_id)];
 	}
 
 	/// Set new owner for the directory entry
@@ -159,12 +269,22 @@ public:
 	/// Activate one sharer for a directory entry
 	void setSharer(int set_id, int way_id, int sub_block_id, int node);
 
-	/// Disable one sharer for a directory entry
+	/// Disable one sharer for a directory entry. In imprecise
+	/// directories, the sharer might not be removable without removing
+	/// other nodes that still hold the sub-block, in which case the entry
+	/// is left unchanged.
 	void clearSharer(int set_id, int way_id, int sub_block_id, int node);
 
 	/// Clear all sharers of a directory entry
 	void clearAllSharers(int set_id, int way_id, int sub_block_id);
 
+	/// Clear all sharers of a directory entry except for \a node, which
+	/// remains a sharer only if it was one before. Argument \a node can
+	/// be NoOwner to clear all sharers. This is used after invalidating
+	/// all copies of a sub-block except for the requester's.
+	void clearAllSharersExcept(int set_id, int way_id, int sub_block_id,
+			int node);
+
 	/// Return whether a sharer is present in a directory entry
 	bool isSharer(int set_id, int way_id, int sub_block_id, int node_id);
 
@@ -220,9 +340,28 @@ public:
 		return getEntryAccessId(set_id, way_id);
 	}
 
+	/// Return the number of directory entries currently locked
+	int getNumLockedEntries() const { return locks.size(); }
+
 	/// Return the access ID of the access locking the given directory
 	/// entry, or 0 if there is no access locking this entry.
 	long long getEntryAccessId(int set_id, int way_id) const;
+
+	/// Start recording the entries whose owner or sharers are modified.
+	/// This is used by incremental sanity checks of the coherence
+	/// protocol.
+	void RecordChanges() { record_changes = true; }
+
+	/// Return the entries modified since the last call to
+	/// ClearChangedEntries(), given as set * num_ways + way. An entry can
+	/// appear multiple times.
+	const std::vector<int> &getChangedEntries() const
+	{
+		return changed_entries;
+	}
+
+	/// Clear the list of changed entries
+	void ClearChangedEntries() { changed_entries.clear(); }
 };
 
 
@@ -36,10 +36,9 @@ Frame::Frame(long long id, Module *module, unsigned address) :
 		module(module),
 		address(address)
 {
-	// Initialize iterators to past-the-end iterators
+	// Initialize iterator to past-the-end iterator
 	assert(module);
 	accesses_iterator = module->getAccessListEnd();
-	write_accesses_iterator = module->getWriteAccessListEnd();
 }
 
 
@@ -107,9 +107,9 @@ public:
 	/// Module::accesses.
 	std::list<Frame *>::iterator accesses_iterator;
 	
-	/// Iterator to the current position of this frame in
-	/// Module::write_accesses
-	std::list<Frame *>::iterator write_accesses_iterator;
+	/// Sequence number assigned by the module when the access started,
+	/// ordering in-flight accesses by age.
+	long long access_sequence = 0;
 
 	/// Type of memory access
 	Module::AccessType access_type = Module::AccessInvalid;
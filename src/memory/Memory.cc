@@ -342,10 +342,14 @@ void Memory::Map(unsigned address, unsigned size, unsigned perm)
 	// Calculate page boundaries
 	unsigned tag1 = address & ~(PageSize-1);
 	unsigned tag2 = (address + size - 1) & ~(PageSize-1);
+	unsigned num_pages = (tag2 - tag1) / PageSize + 1;
 
-	// Allocate pages
-	for (unsigned tag = tag1; tag <= tag2; tag += PageSize)
+	// Allocate pages. Pages are counted instead of compared against the
+	// last tag, which would wrap around for the top page of the address
+	// space.
+	for (unsigned i = 0; i < num_pages; i++)
 	{
+		unsigned tag = tag1 + i * PageSize;
 		Page *page = getPage(tag);
 		if (!page)
 			page = newPage(tag, perm);
@@ -361,10 +365,11 @@ void Memory::Unmap(unsigned address, unsigned size)
 	assert(!(size & (PageSize - 1)));
 	unsigned tag1 = address & ~(PageSize-1);
 	unsigned tag2 = (address + size - 1) & ~(PageSize-1);
+	unsigned num_pages = (tag2 - tag1) / PageSize + 1;
 
 	// Deallocate pages
-	for (unsigned tag = tag1; tag <= tag2; tag += PageSize)
-		pages.erase(tag);
+	for (unsigned i = 0; i < num_pages; i++)
+		pages.erase(tag1 + i * PageSize);
 }
 
 
@@ -375,11 +380,12 @@ void Memory::Protect(unsigned address, unsigned size, unsigned perm)
 	assert(!(size & (PageSize - 1)));
 	unsigned tag1 = address & ~(PageSize-1);
 	unsigned tag2 = (address + size - 1) & ~(PageSize-1);
+	unsigned num_pages = (tag2 - tag1) / PageSize + 1;
 
 	// Assign new permissions
-	for (unsigned tag = tag1; tag <= tag2; tag += PageSize)
+	for (unsigned i = 0; i < num_pages; i++)
 	{
-		Page *page = getPage(tag);
+		Page *page = getPage(tag1 + i * PageSize);
 		if (!page)
 			continue;
 
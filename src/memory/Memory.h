@@ -23,6 +23,7 @@
 #include <cassert>
 #include <iostream>
 #include <memory>
+#include <pthread.h>
 #include <unordered_map>
 
 #include <lib/cpp/Error.h>
@@ -140,6 +141,10 @@ private:
 	/// Last accessed address
 	unsigned last_address = 0;
 
+	// Mutex held by host threads emulating contexts that share this
+	// memory image
+	pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+
 	/// Create a new page and add it to the page table. The value given in
 	/// \a perm is an *or*'ed bitmap of AccessType flags.
 	Page *newPage(unsigned address, unsigned perm);
@@ -168,6 +173,15 @@ public:
 	/// Return whether the safe mode is on
 	bool getSafe() const { return safe; }
 
+	/// Lock the memory image. Timing simulators emulating contexts on
+	/// several host threads hold this lock while emulating a context that
+	/// uses this memory image, so that contexts with different memory
+	/// images run concurrently.
+	void Lock() { pthread_mutex_lock(&mutex); }
+
+	/// Unlock the memory image
+	void Unlock() { pthread_mutex_unlock(&mutex); }
+
 	/// Clear content of memory
 	void Clear() { pages.clear(); }
 
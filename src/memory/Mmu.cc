@@ -34,9 +34,10 @@ namespace mem
 // Class 'Mmu::Space'
 //
 
-Mmu::Space::Space(const std::string &name, Mmu *mmu) :
+Mmu::Space::Space(const std::string &name, Mmu *mmu, int id) :
 		name(name),
-		mmu(mmu)
+		mmu(mmu),
+		id(id)
 {
 	// Debug
 	debug << misc::fmt("[MMU %s] Space %s created\n",
@@ -109,11 +110,60 @@ Mmu::Mmu(const std::string &name) :
 
 Mmu::Space *Mmu::newSpace(const std::string &name)
 {
-	spaces.emplace_back(new Space(name, this));
+	spaces.emplace_back(new Space(name, this, spaces.size()));
 	return spaces.back().get();
 }
 
 
+void Mmu::setNumRegions(int num_regions)
+{
+	// Regions must be set before allocating pages
+	assert(num_regions > 0);
+	assert(pages.empty());
+	this->num_regions = num_regions;
+
+	// Regions start at multiples of their size
+	region_tops.resize(num_regions);
+	for (int i = 0; i < num_regions; i++)
+		region_tops[i] = (1ull << 32) / num_regions * i;
+}
+
+
+unsigned Mmu::AllocatePhysicalPage(Space *space)
+{
+	// Regions can be shared by spaces translating on different host
+	// threads
+	unsigned physical_address;
+	pthread_mutex_lock(&mutex);
+
+	// Contiguous allocation
+	if (!num_regions)
+	{
+		physical_address = top_physical_address;
+		top_physical_address += PageSize;
+		pthread_mutex_unlock(&mutex);
+		return physical_address;
+	}
+
+	// Allocation in the region of the space
+	int region = space->getId() % num_regions;
+	unsigned long long region_size = (1ull << 32) / num_regions;
+	unsigned long long &top = region_tops[region];
+	if (top + PageSize > region_size * (region + 1))
+	{
+		pthread_mutex_unlock(&mutex);
+		throw misc::Error(misc::fmt("[MMU %s] Space %s: physical "
+				"memory region exhausted",
+				name.c_str(),
+				space->getName().c_str()));
+	}
+	physical_address = top;
+	top += PageSize;
+	pthread_mutex_unlock(&mutex);
+	return physical_address;
+}
+
+
 unsigned Mmu::TranslateVirtualAddress(Space *space,
 		unsigned virtual_address)
 {
@@ -124,22 +174,23 @@ unsigned Mmu::TranslateVirtualAddress(Space *space,
 	unsigned virtual_tag = virtual_address & PageMask;
 	unsigned page_offset = virtual_address & ~PageMask;
 
-	// Find page, and created if not found
+	// Find page, and created if not found. Pages of other spaces may be
+	// created concurrently.
 	Page *page = space->getPage(virtual_tag);
 	if (page == nullptr)
 	{
 		// Create new page
+		unsigned physical_address = AllocatePhysicalPage(space);
+		pthread_mutex_lock(&mutex);
 		pages.emplace_back(new Page(space, virtual_tag,
-				top_physical_address));
+				physical_address));
 		
 		// Add page to virtual and physical maps
 		page = pages.back().get();
-		physical_pages[page->getPhysicalAddress()] = page;
+		physical_pages[physical_address] = page;
+		pthread_mutex_unlock(&mutex);
 		space->addPage(page);
 
-		// Increment top of physical address space
-		top_physical_address += PageSize;
-
 		// Debug
 		if (debug)
 			debug << misc::fmt("[MMU %s] Page created. "
@@ -173,10 +224,13 @@ bool Mmu::TranslatePhysicalAddress(unsigned physical_address,
 	// Find page
 	unsigned physical_tag = physical_address & PageMask;
 	unsigned page_offset = physical_address & ~PageMask;
+	pthread_mutex_lock(&mutex);
 	auto it = physical_pages.find(physical_tag);
+	Page *page = it == physical_pages.end() ? nullptr : it->second;
+	pthread_mutex_unlock(&mutex);
 
 	// Page not found
-	if (it == physical_pages.end())
+	if (page == nullptr)
 	{
 		// Debug
 		if (debug)
@@ -191,7 +245,6 @@ bool Mmu::TranslatePhysicalAddress(unsigned physical_address,
 	}
 
 	// Return page information
-	Page *page = it->second;
 	space = page->getSpace();
 	virtual_address = page->getVirtualAddress() + page_offset;
 
@@ -212,8 +265,10 @@ bool Mmu::TranslatePhysicalAddress(unsigned physical_address,
 bool Mmu::isValidPhysicalAddress(unsigned physical_address)
 {
 	unsigned physical_tag = physical_address & PageMask;
-	auto it = physical_pages.find(physical_tag);
-	return it != physical_pages.end();
+	pthread_mutex_lock(&mutex);
+	bool valid = physical_pages.count(physical_tag);
+	pthread_mutex_unlock(&mutex);
+	return valid;
 }
 
 
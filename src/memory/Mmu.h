@@ -21,6 +21,7 @@
 #define MEMORY_MMU_H
 
 #include <memory>
+#include <pthread.h>
 #include <unordered_map>
 #include <vector>
 
@@ -109,6 +110,9 @@ public:
 		// Memory management unit that it belongs to
 		Mmu *mmu;
 
+		// Index of the space in the MMU, in order of creation
+		int id;
+
 		// Hash table of pages in this virtual space indexed by their
 		// virtual address.
 		std::unordered_map<unsigned, Page *> virtual_pages;
@@ -116,11 +120,14 @@ public:
 	public:
 
 		/// Constructor
-		Space(const std::string &name, Mmu *mmu);
+		Space(const std::string &name, Mmu *mmu, int id);
 
 		/// Return the name of the virtual memory space
 		const std::string &getName() const { return name; }
 
+		/// Return the index of the space in the MMU
+		int getId() const { return id; }
+
 		/// Return memory management unit that the virtual memory
 		/// space belongs to.
 		Mmu *getMmu() const { return mmu; }
@@ -153,6 +160,13 @@ private:
 	// allocated, this value is incremented by PageSize.
 	unsigned top_physical_address = 0;
 
+	// Number of regions that the physical address space is split into,
+	// or 0 if pages are allocated contiguously for all spaces
+	int num_regions = 0;
+
+	// Top of each region of the physical address space
+	std::vector<unsigned long long> region_tops;
+
 	// Vector containing all virtual address spaces
 	std::vector<std::unique_ptr<Space>> spaces;
 
@@ -162,6 +176,13 @@ private:
 	// Hash table of pages indexed by their physical address
 	std::unordered_map<unsigned, Page *> physical_pages;
 
+	// Mutex protecting the allocation of physical pages and the tables
+	// of all pages, shared by all spaces
+	pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+
+	// Return the physical address of a new page for the given space
+	unsigned AllocatePhysicalPage(Space *space);
+
 public:
 
 	//
@@ -198,7 +219,18 @@ public:
 	///
 	Space *newSpace(const std::string &name = "");
 
-	/// Translate virtual to physical address.
+	/// Split the physical address space into \a num_regions regions of
+	/// the same size, and allocate the pages of the space with index `i`
+	/// in region `i % num_regions`. Physical addresses then do not depend
+	/// on the order in which spaces of different regions touch new pages,
+	/// which is needed when they are translated from different host
+	/// threads. This function must be called before any page is
+	/// allocated.
+	void setNumRegions(int num_regions);
+
+	/// Translate virtual to physical address. Translations in different
+	/// spaces can run concurrently on different host threads, while
+	/// translations in the same space cannot.
 	///
 	/// \param space
 	///	Virtual address space.
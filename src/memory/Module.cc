@@ -22,6 +22,11 @@
 #include <iostream>
 #include <iomanip>
 
+#include <dram/Address.h>
+#include <dram/Controller.h>
+#include <dram/Request.h>
+#include <lib/esim/Statistics.h>
+
 #include "Frame.h"
 #include "Module.h"
 #include "System.h"
@@ -49,6 +54,22 @@ Module::Module(const std::string &name,
 	// Block size
 	assert(!(block_size & (block_size - 1)) && block_size >= 4);
 	log_block_size = misc::LogBase2(block_size);
+
+	// Interval statistics
+	esim::Statistics *statistics = esim::Statistics::getInstance();
+	std::string prefix = "mem." + name + ".";
+	statistics->Register(prefix + "Accesses",
+			[this] { return num_accesses; });
+	statistics->Register(prefix + "Hits",
+			[this] { return getNumHits(); });
+	statistics->Register(prefix + "Misses",
+			[this] { return num_accesses - getNumHits(); });
+	statistics->Register(prefix + "Reads",
+			[this] { return num_reads; });
+	statistics->Register(prefix + "Writes",
+			[this] { return num_writes; });
+	statistics->Register(prefix + "Evictions",
+			[this] { return num_evictions; });
 }
 
 
@@ -229,6 +250,14 @@ long long Module::Access(AccessType access_type,
 		throw misc::Panic("Invalid module type");
 	}
 
+	// Record access in access trace
+	AccessTraceWriter *access_trace_writer = System::getAccessTraceWriter();
+	if (access_trace_writer && type != TypeLocalMemory)
+		access_trace_writer->Record(System::getInstance()->getCycle(),
+				this,
+				access_type,
+				address);
+
 	// Schedule event
 	esim::Engine *esim_engine = esim::Engine::getInstance();
 	esim_engine->Call(event, frame, return_event);
@@ -238,61 +267,92 @@ long long Module::Access(AccessType access_type,
 }
 
 
+void Module::AccessDram(bool write, unsigned address, esim::Event *event)
+{
+	// Blocks are numbered locally to the module, as in FindBlock()
+	assert(dram_controller);
+	unsigned block = address >> log_block_size;
+	if (range_type == RangeInterleaved)
+		block /= range.interleaved.mod;
+
+	// Create request
+	auto request = std::make_shared<dram::Request>();
+	request->setType(write ? dram::RequestWrite : dram::RequestRead);
+	request->setAddress(dram_controller->getBlockAddress(block,
+			block_size));
+
+	// Suspend event chain until the request completes
+	if (event)
+		request->Wait(event);
+	dram_controller->AddRequest(request);
+}
+
+
+void Module::UpdateMSHROccupancy()
+{
+	// Accumulate occupancy since the last change
+	long long cycle = System::getInstance()->getCycle();
+	int occupancy = accesses.size() - num_coalesced_accesses;
+	assert(cycle >= mshr_occupancy_cycle);
+	mshr_occupancy_integral += occupancy * (cycle - mshr_occupancy_cycle);
+	if (mshr_size && occupancy >= mshr_size)
+		mshr_full_cycles += cycle - mshr_occupancy_cycle;
+	mshr_occupancy_cycle = cycle;
+}
+
+
 void Module::StartAccess(Frame *frame, AccessType access_type)
 {
-	// Record access type
+	// Record access type and age
+	UpdateMSHROccupancy();
 	frame->access_type = access_type;
+	frame->access_sequence = access_sequence_counter++;
 
 	// Insert in access list
 	frame->accesses_iterator = accesses.insert(accesses.end(),
 			frame);
 
-	// Insert in write access list
+	// Insert in indexes of write accesses
 	if (access_type == AccessStore)
-		frame->write_accesses_iterator = write_accesses.insert(
-				write_accesses.end(),
-				frame);
+		write_accesses.emplace_hint(write_accesses.end(),
+				frame->access_sequence, frame);
+	if (access_type != AccessLoad)
+		non_load_accesses.emplace_hint(non_load_accesses.end(),
+				frame->access_sequence, frame);
 
-	// Insert in hash table of block addresses
+	// Insert in the chain of accesses to the block
 	unsigned block_address = frame->getAddress() >> log_block_size;
-	in_flight_block_addresses.emplace(std::make_pair(block_address, frame));
+	auto &chain = in_flight_blocks[block_address];
+	chain.emplace_hint(chain.end(), frame->access_sequence, frame);
 
 	// Insert in set of access identifiers
 	in_flight_access_ids.emplace(frame->getId());
+
+	// Maximum occupancy
+	mshr_max_occupancy = std::max(mshr_max_occupancy,
+			(int) accesses.size() - num_coalesced_accesses);
 }
 
 
 void Module::FinishAccess(Frame *frame)
 {
 	// Remove from access list
+	UpdateMSHROccupancy();
 	accesses.erase(frame->accesses_iterator);
 	frame->accesses_iterator = accesses.end();
 
-	// Remove from write access list
+	// Remove from indexes of write accesses
 	assert(frame->access_type);
 	if (frame->access_type == Module::AccessStore)
-	{
-		write_accesses.erase(frame->write_accesses_iterator);
-		frame->write_accesses_iterator = write_accesses.end();
-	}
+		write_accesses.erase(frame->access_sequence);
+	if (frame->access_type != Module::AccessLoad)
+		non_load_accesses.erase(frame->access_sequence);
 
-	// Remove from hash table
+	// Remove from the chain of accesses to the block
 	unsigned block_address = frame->getAddress() >> log_block_size;
-	auto range = in_flight_block_addresses.equal_range(block_address);
-	bool found = false;
-	for (auto it = range.first; it != range.second; ++it)
-	{
-		Frame *other_frame = it->second;
-		if (frame == other_frame)
-		{
-			found = true;
-			in_flight_block_addresses.erase(it);
-			break;
-		}
-	}
-
-	// Must have been removed
-	if (!found)
+	auto it = in_flight_blocks.find(block_address);
+	if (it == in_flight_blocks.end() ||
+			!it->second.erase(frame->access_sequence))
 		throw misc::Panic("Frame not found");
 
 	// Remove from set of in-flight access identifiers
@@ -310,13 +370,16 @@ void Module::FinishAccess(Frame *frame)
 	// finished frame as a master frame. If they are, their master frame
 	// pointer is resest to null. This is to prevent a situation where the
 	// finishing frame makes a later access and adopts a master frame from
-	// a frame in the access list which points to itself.
-	for (auto it = accesses.begin(); it != accesses.end(); it++)
+	// a frame in the access list which points to itself. Only accesses to
+	// the same block can be coalesced.
+	for (auto &pair : it->second)
 	{
-		Frame *list_frame = *it;
-		if (list_frame->master_frame == frame)
-			list_frame->master_frame = nullptr;
+		Frame *chain_frame = pair.second;
+		if (chain_frame->master_frame == frame)
+			chain_frame->master_frame = nullptr;
 	}
+	if (it->second.empty())
+		in_flight_blocks.erase(it);
 
 	// Wake up dependent accesses
 	frame->queue.WakeupAll();
@@ -326,62 +389,49 @@ void Module::FinishAccess(Frame *frame)
 Frame *Module::getInFlightAddress(unsigned address,
 		Frame *older_than_frame)
 {
-	// Look for address
+	// Look for block
 	unsigned block_address = address >> log_block_size;
-	auto range = in_flight_block_addresses.equal_range(block_address);
-	for (auto it = range.first; it != range.second; ++it)
-	{
-		// Get frame
-		Frame *frame = it->second;
-
-		// This frame is not older than 'older_than_frame'
-		if (older_than_frame && frame->getId() >=
-				older_than_frame->getId())
-			continue;
+	auto it = in_flight_blocks.find(block_address);
+	if (it == in_flight_blocks.end())
+		return nullptr;
 
-		// Block address matches
-		assert(frame->getAddress() >> log_block_size ==
-				address >> log_block_size);
-		return frame;
-	}
+	// Youngest access older than 'older_than_frame'
+	auto &chain = it->second;
+	auto chain_it = older_than_frame ?
+			chain.lower_bound(older_than_frame->access_sequence) :
+			chain.end();
+	if (chain_it == chain.begin())
+		return nullptr;
+	--chain_it;
 
-	// Not found
-	return nullptr;
+	// Block address matches
+	Frame *frame = chain_it->second;
+	assert(frame->getAddress() >> log_block_size ==
+			address >> log_block_size);
+	return frame;
 }
 
 
 Frame *Module::getInFlightWrite(Frame *older_than_frame)
 {
-	// No 'older_than_frame' given, return youngest write, or nullptr if
-	// there is no in-flight write.
-	if (!older_than_frame)
-		return write_accesses.size() ?
-				write_accesses.back() :
-				nullptr;
-	
-	// Search
-	auto it = older_than_frame->accesses_iterator;
-	while (it != accesses.begin())
-	{
-		// Rewind
-		--it;
-
-		// Check if it is a write
-		Frame *frame = *it;
-		if (frame->access_type == AccessStore)
-			return frame;
-	}
-
-	// Not found
-	return nullptr;
+	// Youngest write older than 'older_than_frame', or youngest write if
+	// no 'older_than_frame' is given.
+	auto it = older_than_frame ?
+			write_accesses.lower_bound(
+			older_than_frame->access_sequence) :
+			write_accesses.end();
+	if (it == write_accesses.begin())
+		return nullptr;
+	--it;
+	return it->second;
 }
 
 
 bool Module::isInFlightAddress(unsigned address)
 {
 	unsigned block_address = address >> log_block_size;
-	auto it = in_flight_block_addresses.find(block_address);
-	return it != in_flight_block_addresses.end();
+	auto it = in_flight_blocks.find(block_address);
+	return it != in_flight_blocks.end();
 }
 
 
@@ -796,8 +846,7 @@ void Module::DumpReport(std::ostream &os) const
 	os << misc::fmt("Evictions = %lld\n", num_evictions);
 
 	// Statistics - Hits and misses
-	long long int num_hits = num_read_hits + num_write_hits 
-			+ num_nc_write_hits;
+	long long num_hits = getNumHits();
 	os << misc::fmt("Hits = %lld\n", num_hits);
 	os << misc::fmt("Misses = %lld\n", num_accesses - num_hits);
 	os << misc::fmt("HitRatio = %.4g\n", num_accesses ? 
@@ -851,9 +900,36 @@ void Module::DumpReport(std::ostream &os) const
 	if (type == TypeCache)
 		os << misc::fmt("ConflictInvalidation = %lld\n",
 				num_conflict_invalidations);
+	os << "\n";
+
+	// Statistics - MSHR occupancy, including the time since the last
+	// change in the number of in-flight accesses
+	long long cycle = System::getInstance()->getCycle();
+	int occupancy = accesses.size() - num_coalesced_accesses;
+	long long occupancy_integral = mshr_occupancy_integral +
+			occupancy * (cycle - mshr_occupancy_cycle);
+	long long full_cycles = mshr_full_cycles;
+	if (mshr_size && occupancy >= mshr_size)
+		full_cycles += cycle - mshr_occupancy_cycle;
+	os << misc::fmt("MSHR = %d\n", mshr_size);
+	os << misc::fmt("MSHROccupancy = %.4g\n", cycle ?
+			(double) occupancy_integral / cycle : 0.0);
+	os << misc::fmt("MSHRMaxOccupancy = %d\n", mshr_max_occupancy);
+	os << misc::fmt("MSHRFullCycles = %lld\n", full_cycles);
+	
+	// DRAM statistics
+	if (dram_controller)
+	{
+		os << "\n";
+		dram_controller->DumpReport(os);
+	}
 	
 	// Separating line between modules
 	os << "\n\n";
+
+	// Miss-ratio curves
+	if (stack_distance_profiler)
+		stack_distance_profiler->DumpReport(os);
 }
 
  
@@ -862,22 +938,25 @@ void Module::DumpInFlightAddresses(std::ostream &os)
 	esim::Engine *engine = esim::Engine::getInstance();
 	os << misc::fmt("[%s] In-flight blocks in cycle %lld:\n",
 			name.c_str(), engine->getCycle());
-	for (auto &pair : in_flight_block_addresses)
+	for (auto &pair : in_flight_blocks)
 	{
-		
 		unsigned block_address = pair.first;
-		Frame *frame = pair.second;
-		os << misc::fmt("\tkey (block_address) = 0x%x: "
-				"id = %lld, "
-				"address = 0x%x, "
-				"block_address = 0x%x\n",
-				block_address,
-				frame->getId(),
-				frame->getAddress(),
-				frame->getAddress() >> log_block_size);
-		frame->CheckMagic();
-		if (block_address != frame->getAddress() >> log_block_size)
-			throw misc::Panic("Invalid block address");
+		for (auto &chain_pair : pair.second)
+		{
+			Frame *frame = chain_pair.second;
+			os << misc::fmt("\tkey (block_address) = 0x%x: "
+					"id = %lld, "
+					"address = 0x%x, "
+					"block_address = 0x%x\n",
+					block_address,
+					frame->getId(),
+					frame->getAddress(),
+					frame->getAddress() >> log_block_size);
+			frame->CheckMagic();
+			if (block_address != frame->getAddress() >>
+					log_block_size)
+				throw misc::Panic("Invalid block address");
+		}
 	}
 }
 
@@ -890,17 +969,12 @@ Frame *Module::canCoalesce(AccessType access_type,
 	if (!accesses.size())
 		return nullptr;
 
-	// For efficiency, first check in the hash table of accesses
-	// whether there is an access in flight to the same block.
+	// Youngest access to the same block older than 'older_than_frame'
 	assert(access_type);
-	if (!getInFlightAddress(address, older_than_frame))
+	Frame *block_frame = getInFlightAddress(address, older_than_frame);
+	if (!block_frame)
 		return nullptr;
 
-	// Nothing if 'older_than_frame' is in the head of the in-flight
-	// access list (i.e., there is nothing older).
-	if (older_than_frame->accesses_iterator == accesses.begin())
-		return nullptr;
-	
 	// Get iterator to youngest access older than 'older_than_frame', or an
 	// iterator to the overall youngest access if 'older_than_frame' is
 	// null.
@@ -916,33 +990,25 @@ Frame *Module::canCoalesce(AccessType access_type,
 
 	case AccessLoad:
 	{
-		auto it = tail;
-		while (true)
-		{
-			// Only coalesce with groups of reads at the tail
-			Frame *frame = *it;
-			if (frame->access_type != AccessLoad)
-				return nullptr;
-
-			// Same block address, coalesce
-			if (frame->getAddress() >> log_block_size ==
-					address >> log_block_size)
-			{
-				assert(!frame->master_frame ||
-						!frame->master_frame->master_frame);
-				return frame->master_frame ?
-						frame->master_frame :
-						frame;
-			}
-			
-			// Done when head reached
-			if (it == accesses.begin())
-				break;
+		// Only coalesce with groups of reads at the tail, that is, if
+		// there is no write or non-coherent write between the access to
+		// the same block and 'older_than_frame'.
+		if (block_frame->access_type != AccessLoad)
+			return nullptr;
+		auto it = older_than_frame ?
+				non_load_accesses.lower_bound(
+				older_than_frame->access_sequence) :
+				non_load_accesses.end();
+		if (it != non_load_accesses.begin() &&
+				(--it)->first > block_frame->access_sequence)
+			return nullptr;
 
-			// Previous
-			--it;
-		}
-		break;
+		// Coalesce
+		assert(!block_frame->master_frame ||
+				!block_frame->master_frame->master_frame);
+		return block_frame->master_frame ?
+				block_frame->master_frame :
+				block_frame;
 	}
 
 	case AccessStore:
@@ -1006,13 +1072,14 @@ Frame *Module::canCoalesce(AccessType access_type,
 void Module::Coalesce(Frame *master_frame, Frame *frame)
 {
 	// Debug
-	System::debug << misc::fmt("    "
-			"A-%lld is coalesced with A-%lld "
-			"on %s for 0x%x\n",
-			frame->getId(),
-			master_frame->getId(),
-			name.c_str(),
-			frame->getAddress());
+	if (System::debug)
+		System::debug << misc::fmt("    "
+				"A-%lld is coalesced with A-%lld "
+				"on %s for 0x%x\n",
+				frame->getId(),
+				master_frame->getId(),
+				name.c_str(),
+				frame->getAddress());
 
 	// Master frame must not have a parent. We only want one level of
 	// coalesced accesses.
@@ -1023,6 +1090,7 @@ void Module::Coalesce(Frame *master_frame, Frame *frame)
 	assert(frame->access_type);
 
 	// Set slave frame as a coalesced access
+	UpdateMSHROccupancy();
 	frame->coalesced = true;
 	frame->master_frame = master_frame;
 	assert(num_coalesced_accesses <= (int) accesses.size());
@@ -1066,11 +1134,12 @@ void Module::LockPort(Frame *frame, esim::Event *event)
 
 	// Debug
 	esim::Engine *esim_engine = esim::Engine::getInstance();
-	System::debug << misc::fmt("    "
-			"A-%lld locks port %d on %s\n",
-			frame->getId(),
-			port_index,
-			name.c_str());
+	if (System::debug)
+		System::debug << misc::fmt("    "
+				"A-%lld locks port %d on %s\n",
+				frame->getId(),
+				port_index,
+				name.c_str());
 
 	// Schedule event
 	esim_engine->Next(event);
@@ -1091,10 +1160,11 @@ void Module::UnlockPort(Port *port, Frame *frame)
 	num_locked_ports--;
 
 	// Debug
-	System::debug << misc::fmt("    "
-			"A-%lld unlocks port on %s\n",
-			frame->getId(),
-			name.c_str());
+	if (System::debug)
+		System::debug << misc::fmt("    "
+				"A-%lld unlocks port on %s\n",
+				frame->getId(),
+				name.c_str());
 
 	// Check if there was any access waiting for free port
 	if (port_queue.isEmpty())
@@ -1110,10 +1180,11 @@ void Module::UnlockPort(Port *port, Frame *frame)
 	port_queue.WakeupOne();
 	
 	// Debug
-	System::debug << misc::fmt("    "
-			"A-%lld locks port on %s\n",
-			frame->getId(),
-			name.c_str());
+	if (System::debug)
+		System::debug << misc::fmt("    "
+				"A-%lld locks port on %s\n",
+				frame->getId(),
+				name.c_str());
 }
 
 
@@ -1327,6 +1398,16 @@ void Module::UpdateStats(Frame *frame)
 		{
 			throw misc::Panic("Invalid memory operation type");
 		}
+
+		// Stack distance profile. Blocks are numbered as in the set
+		// selection performed in FindBlock().
+		if (stack_distance_profiler && !frame->retry)
+		{
+			unsigned block = frame->getAddress() >> log_block_size;
+			if (range_type == RangeInterleaved)
+				block /= range.interleaved.mod;
+			stack_distance_profiler->Access(block);
+		}
 	}
 	else if (frame->request_direction == Frame::RequestDirectionDownUp)
 	{
@@ -20,7 +20,9 @@
 #ifndef MEMORY_MODULE_H
 #define MEMORY_MODULE_H
 
+#include <algorithm>
 #include <list>
+#include <map>
 #include <memory>
 #include <unordered_map>
 #include <unordered_set>
@@ -32,9 +34,11 @@
 
 #include "Cache.h"
 #include "Directory.h"
+#include "StackDistanceProfiler.h"
 
 
 // Forward declarations
+namespace dram { class Controller; }
 namespace net { class Network; }
 namespace net { class Node; }
 
@@ -190,6 +194,15 @@ private:
 	// Directory associativity
 	int directory_num_ways = 0;
 
+	// Encoding of the sharers in the directory
+	Directory::Type directory_type = Directory::TypeFullMap;
+
+	// Node identifiers per entry in a limited-pointer directory
+	int directory_num_pointers = 4;
+
+	// Nodes per bit in a coarse-vector directory
+	int directory_coarseness = 4;
+
 
 
 	//
@@ -214,24 +227,47 @@ private:
 	// In-flight accesses
 	//
 
-	// List of all in-flight accesses
+	// List of all in-flight accesses, in the order in which they started
 	std::list<Frame *> accesses;
 
-	// List of all in-flight write accesses
-	std::list<Frame *> write_accesses;
+	// Sequence number assigned to the next access started in the module.
+	// In-flight accesses are ordered by age using this number.
+	long long access_sequence_counter = 0;
+
+	// In-flight write accesses, indexed by sequence number
+	std::map<long long, Frame *> write_accesses;
+
+	// In-flight write and non-coherent write accesses, indexed by
+	// sequence number
+	std::map<long long, Frame *> non_load_accesses;
 	
 	// Number of in-flight coalesced accesses. This is a number
 	// between 0 and access_list.size() at all times.
 	int num_coalesced_accesses = 0;
 
-	// Hash table of accesses, indexed by a block address (that is, a
-	// memory address divided by the module's block size). There can be
-	// multiple in-flight accesses for the same block.
-	std::unordered_multimap<unsigned, Frame *> in_flight_block_addresses;
+	// In-flight accesses to each block, indexed by block address (that
+	// is, a memory address divided by the module's block size). The
+	// accesses to each block are indexed by sequence number. Blocks with
+	// no in-flight access are not present.
+	std::unordered_map<unsigned, std::map<long long, Frame *>>
+			in_flight_blocks;
 
 	// Set containing all in-flight access identifiers
 	std::unordered_set<long long> in_flight_access_ids;
 
+	// MSHR occupancy, measured as the number of non-coalesced in-flight
+	// accesses. The cycle of the last occupancy change is recorded to
+	// accumulate the occupancy over time.
+	long long mshr_occupancy_cycle = 0;
+	long long mshr_occupancy_integral = 0;
+	long long mshr_full_cycles = 0;
+	int mshr_max_occupancy = 0;
+
+	// Accumulate MSHR occupancy statistics up to the current cycle. This
+	// function must be invoked before the number of non-coalesced
+	// in-flight accesses changes.
+	void UpdateMSHROccupancy();
+
 
 
 
@@ -245,6 +281,13 @@ private:
 	// Associated cache
 	std::unique_ptr<Cache> cache;
 
+	// Optional stack distance profiler
+	std::unique_ptr<StackDistanceProfiler> stack_distance_profiler;
+
+	// DRAM controller modeling the timing of data accesses in a main
+	// memory module, or null if the fixed data latency is used instead
+	dram::Controller *dram_controller = nullptr;
+
 	// List of previous-level modules, closer to the processor
 	std::vector<Module *> high_modules;
 
@@ -333,6 +376,18 @@ public:
 		directory_size = directory_num_sets * directory_num_ways;
 	}
 
+	/// Set the encoding of the sharers in the directory. This does not
+	/// instantiate the directory. See Directory::Directory() for the
+	/// meaning of the arguments.
+	void setDirectoryType(Directory::Type directory_type,
+			int directory_num_pointers,
+			int directory_coarseness)
+	{
+		this->directory_type = directory_type;
+		this->directory_num_pointers = directory_num_pointers;
+		this->directory_coarseness = directory_coarseness;
+	}
+
 	/// Initialize the associated directory.
 	void InitializeDirectory(
 			int num_sets,
@@ -346,7 +401,10 @@ public:
 				num_sets,
 				num_ways,
 				num_sub_blocks,
-				num_nodes);
+				num_nodes,
+				directory_type,
+				directory_num_pointers,
+				directory_coarseness);
 	}
 
 	/// Return the directory associated with the module. If no directory
@@ -374,6 +432,10 @@ public:
 
 	/// Return whether the module can be accessed. A module can be accessed
 	/// if there are available ports and enough room in the MSHR register.
+	/// Accesses buffered by a parallel timing simulator are not accounted
+	/// for until they start, so the simulator calls this function right
+	/// before starting a buffered access that a sequential simulation
+	/// would have checked (see comm::ParallelSimulation::PendingAccess).
 	bool canAccess(int address) const;
 
 	/// Return module name
@@ -460,7 +522,48 @@ public:
 	/// created by a call to setCache(). If setCache() wasn't invoked
 	/// before, return nullptr.
 	Cache *getCache() const { return cache.get(); }
+
+	/// Attach a stack distance profiler to the module. The profiler
+	/// observes all non-retried accesses looking up the module, and
+	/// reports miss-ratio curves for caches of the module's block size
+	/// with up to \a max_num_sets sets and \a max_num_ways ways.
+	void setStackDistanceProfiler(unsigned max_num_sets,
+			unsigned max_num_ways)
+	{
+		assert(!stack_distance_profiler.get());
+		stack_distance_profiler = misc::new_unique<StackDistanceProfiler>(
+				name,
+				block_size,
+				max_num_sets,
+				max_num_ways);
+	}
+
+	/// Return the stack distance profiler associated with the module, or
+	/// nullptr if none was attached with setStackDistanceProfiler().
+	StackDistanceProfiler *getStackDistanceProfiler() const
+	{
+		return stack_distance_profiler.get();
+	}
 	
+	/// Model the timing of data accesses to the module with the given
+	/// DRAM controller instead of a fixed data latency.
+	void setDramController(dram::Controller *dram_controller)
+	{
+		this->dram_controller = dram_controller;
+	}
+
+	/// Return the DRAM controller associated with the module, or nullptr
+	/// if the module uses a fixed data latency.
+	dram::Controller *getDramController() const { return dram_controller; }
+
+	/// Send a read or write request for the block containing \a address
+	/// to the DRAM controller associated with the module. If \a event is
+	/// given, the current event chain is suspended until the request
+	/// completes, and then continues with \a event. In this case, this
+	/// function must be invoked in the body of an event handler.
+	void AccessDram(bool write, unsigned address,
+			esim::Event *event = nullptr);
+
 	/// Set the address range served by the module between \a low and
 	/// \a high physical addresses.
 	void setRangeBounds(unsigned low, unsigned high)
@@ -493,6 +596,13 @@ public:
 		return high_modules[index];
 	}
 
+	/// Return whether the given module is a high module of this module
+	bool isHighModule(Module *module) const
+	{
+		return std::find(high_modules.begin(), high_modules.end(),
+				module) != high_modules.end();
+	}
+
 	/// Add a high module (one that is closer to the processor)
 	void addHighModule(Module *high_module)
 	{
@@ -682,6 +792,10 @@ public:
 	/// flight. The access identifier is that returned by Access()
 	bool isInFlightAccess(long long id);
 
+	/// Return the number of accesses in flight in the module, started with
+	/// Access() and not finished yet.
+	int getNumInFlightAccesses() const { return accesses.size(); }
+
 	/// Dump information about all event-driven simulation frames associated
 	/// with in-flight accesses in the module.
 	void DumpInFlightAddresses(std::ostream &os = std::cout);
@@ -771,20 +885,6 @@ public:
 		return accesses.end();
 	}
 
-	/// Return an iterator to the first element of the list of in-flight
-	/// write accesses.
-	std::list<Frame *>::iterator getWriteAccessListBegin()
-	{
-		return write_accesses.begin();
-	}
-
-	/// Return a past-the-end iterator to the list of in-flight write
-	/// accesses.
-	std::list<Frame *>::iterator getWriteAccessListEnd()
-	{
-		return write_accesses.end();
-	}
-
 
 
 
@@ -801,6 +901,12 @@ public:
 	/// Increment the number of evictions
 	void incEvictions() { num_evictions++; }
 
+	/// Return the number of up-down accesses that hit in the module
+	long long getNumHits() const
+	{
+		return num_read_hits + num_write_hits + num_nc_write_hits;
+	}
+
 	/// Increment number of coalesced reads
 	void incCoalescedReads() { num_coalesced_reads++; }
 
@@ -848,6 +954,9 @@ public:
 	/// - Number of retried read probes
 	/// - Number of evictions
 	///
+	/// The access is also recorded in the stack distance profiler, if
+	/// present.
+	///
 	void UpdateStats(Frame *frame);
 
 	/// Return a random latency calculated in proportion to the standard
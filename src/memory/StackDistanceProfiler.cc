@@ -0,0 +1,273 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2012  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#include <lib/cpp/Misc.h>
+#include <lib/cpp/String.h>
+
+#include "StackDistanceProfiler.h"
+
+
+namespace mem
+{
+
+
+// Initial number of time stamps in the Fenwick tree
+static const unsigned initial_tree_size = 1 << 16;
+
+
+StackDistanceProfiler::StackDistanceProfiler(const std::string &name,
+		unsigned block_size,
+		unsigned max_num_sets,
+		unsigned max_num_ways)
+		:
+		name(name),
+		block_size(block_size),
+		max_num_sets(max_num_sets),
+		max_num_ways(max_num_ways)
+{
+	// Checks
+	assert(!(block_size & (block_size - 1)));
+	assert(max_num_sets && !(max_num_sets & (max_num_sets - 1)));
+	assert(max_num_ways && !(max_num_ways & (max_num_ways - 1)));
+	log_max_num_sets = misc::LogBase2(max_num_sets);
+
+	// Fully-associative stack. Position 0 of the Fenwick tree is unused.
+	tree.resize(initial_tree_size + 1);
+	histogram.resize(34);
+
+	// Set-associative stacks
+	set_stacks.resize(log_max_num_sets + 1);
+	for (int level = 0; level <= log_max_num_sets; level++)
+	{
+		SetStacks &stacks = set_stacks[level];
+		unsigned num_sets = 1 << level;
+		stacks.blocks.resize(num_sets * max_num_ways);
+		stacks.sizes.resize(num_sets);
+		stacks.histogram.resize(max_num_ways + 1);
+	}
+}
+
+
+void StackDistanceProfiler::TreeAdd(unsigned index, int value)
+{
+	assert(index > 0);
+	for (; index < tree.size(); index += index & -index)
+		tree[index] += value;
+}
+
+
+int StackDistanceProfiler::TreeSum(unsigned index) const
+{
+	int sum = 0;
+	for (; index > 0; index -= index & -index)
+		sum += tree[index];
+	return sum;
+}
+
+
+void StackDistanceProfiler::Compact()
+{
+	// Sort live blocks by the time stamp of their last access
+	std::vector<std::pair<unsigned, unsigned>> live;
+	live.reserve(last_access.size());
+	for (auto &pair : last_access)
+		live.emplace_back(pair.second, pair.first);
+	std::sort(live.begin(), live.end());
+
+	// Leave at least as much room for new accesses as there are live
+	// blocks, so that compaction cost is amortized.
+	unsigned size = std::max(initial_tree_size,
+			(unsigned) live.size() * 2);
+	tree.assign(size + 1, 0);
+
+	// Assign consecutive time stamps preserving the order
+	time = 1;
+	for (auto &pair : live)
+	{
+		last_access[pair.second] = time;
+		TreeAdd(time, 1);
+		time++;
+	}
+}
+
+
+void StackDistanceProfiler::AccessFullyAssociative(unsigned block)
+{
+	// Make room for a new time stamp
+	if (time >= tree.size())
+		Compact();
+
+	// Look for previous access
+	auto it = last_access.find(block);
+	if (it == last_access.end())
+	{
+		// Cold access
+		num_cold_misses++;
+		last_access.emplace(block, time);
+	}
+	else
+	{
+		// The stack distance is the number of different blocks accessed
+		// after the last access to this block.
+		unsigned last_time = it->second;
+		long long distance = last_access.size() - TreeSum(last_time);
+		TreeAdd(last_time, -1);
+		it->second = time;
+
+		// Record in histogram, in bin floor(log2(distance)) + 1
+		int bin = 0;
+		while (distance)
+		{
+			distance >>= 1;
+			bin++;
+		}
+		histogram[bin]++;
+	}
+
+	// Mark new time stamp as most recent access to the block
+	TreeAdd(time, 1);
+	time++;
+}
+
+
+void StackDistanceProfiler::AccessSetAssociative(unsigned block)
+{
+	for (int level = 0; level <= log_max_num_sets; level++)
+	{
+		// Get the stack for the set
+		SetStacks &stacks = set_stacks[level];
+		unsigned set_id = block & ((1 << level) - 1);
+		unsigned *stack = &stacks.blocks[set_id * max_num_ways];
+		unsigned &size = stacks.sizes[set_id];
+
+		// Find block in stack
+		unsigned distance;
+		for (distance = 0; distance < size; distance++)
+			if (stack[distance] == block)
+				break;
+
+		// Record distance. Blocks not found are either cold accesses or
+		// accesses at a distance larger than the maximum associativity.
+		stacks.histogram[distance < size ? distance : max_num_ways]++;
+
+		// Evict the least recently used block if the block was not
+		// found and the stack is full.
+		if (distance == size && size == max_num_ways)
+			distance--;
+		else if (distance == size)
+			size++;
+
+		// Move block to the top of the stack
+		memmove(stack + 1, stack, distance * sizeof(unsigned));
+		stack[0] = block;
+	}
+}
+
+
+void StackDistanceProfiler::Access(unsigned block)
+{
+	num_accesses++;
+	AccessFullyAssociative(block);
+	AccessSetAssociative(block);
+}
+
+
+long long StackDistanceProfiler::getNumMisses(unsigned num_blocks) const
+{
+	// A fully-associative cache of 2^k blocks misses on all accesses with a
+	// stack distance of 2^k or more, which are those recorded in bins k+1
+	// and above.
+	assert(num_blocks && !(num_blocks & (num_blocks - 1)));
+	long long num_misses = num_cold_misses;
+	for (unsigned bin = misc::LogBase2(num_blocks) + 1;
+			bin < histogram.size(); bin++)
+		num_misses += histogram[bin];
+	return num_misses;
+}
+
+
+long long StackDistanceProfiler::getNumMisses(unsigned num_sets,
+		unsigned num_ways) const
+{
+	assert(num_sets && !(num_sets & (num_sets - 1)));
+	assert(num_ways && !(num_ways & (num_ways - 1)));
+	assert(num_sets <= max_num_sets);
+	assert(num_ways <= max_num_ways);
+
+	// Misses are accesses with a per-set stack distance equal or larger
+	// than the associativity.
+	const SetStacks &stacks = set_stacks[misc::LogBase2(num_sets)];
+	long long num_misses = 0;
+	for (unsigned distance = num_ways; distance <= max_num_ways; distance++)
+		num_misses += stacks.histogram[distance];
+	return num_misses;
+}
+
+
+void StackDistanceProfiler::DumpReport(std::ostream &os) const
+{
+	// Header
+	os << misc::fmt("[ %s StackDistance ]\n\n", name.c_str());
+	os << misc::fmt("BlockSize = %u\n", block_size);
+	os << misc::fmt("Accesses = %lld\n", num_accesses);
+	os << misc::fmt("ColdMisses = %lld\n", num_cold_misses);
+	os << misc::fmt("Blocks = %u\n", (unsigned) last_access.size());
+	os << "\n";
+
+	// Fully-associative caches, up to the first capacity that holds all
+	// blocks ever accessed.
+	for (unsigned num_blocks = 1; ; num_blocks <<= 1)
+	{
+		long long num_misses = getNumMisses(num_blocks);
+		os << misc::fmt("FullyAssoc%u.Misses = %lld\n",
+				num_blocks, num_misses);
+		os << misc::fmt("FullyAssoc%u.MissRatio = %.4g\n",
+				num_blocks, num_accesses ?
+				(double) num_misses / num_accesses : 0.0);
+		if (num_blocks >= last_access.size() || num_blocks >= 1u << 31)
+			break;
+	}
+	os << "\n";
+
+	// Set-associative caches
+	for (unsigned num_sets = 1; num_sets <= max_num_sets; num_sets <<= 1)
+	{
+		for (unsigned num_ways = 1; num_ways <= max_num_ways;
+				num_ways <<= 1)
+		{
+			long long num_misses = getNumMisses(num_sets, num_ways);
+			os << misc::fmt("Sets%u.Assoc%u.Misses = %lld\n",
+					num_sets, num_ways, num_misses);
+			os << misc::fmt("Sets%u.Assoc%u.MissRatio = %.4g\n",
+					num_sets, num_ways, num_accesses ?
+					(double) num_misses / num_accesses :
+					0.0);
+		}
+	}
+
+	// Separating line between modules
+	os << "\n\n";
+}
+
+
+}  // namespace mem
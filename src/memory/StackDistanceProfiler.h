@@ -0,0 +1,179 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2012  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MEMORY_STACK_DISTANCE_PROFILER_H
+#define MEMORY_STACK_DISTANCE_PROFILER_H
+
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+namespace mem
+{
+
+/// LRU stack distance profiler. The profiler observes the stream of blocks
+/// reaching a memory module and computes, in a single pass, the number of
+/// misses that an LRU cache with the same block size would suffer for every
+/// power-of-two number of sets and associativity, as well as for
+/// fully-associative caches of every power-of-two capacity.
+///
+/// Fully-associative stack distances are computed with the Bennett-Kruskal
+/// algorithm, using a Fenwick tree indexed by access time stamps. Set
+/// associative stack distances are computed with one bounded LRU stack per
+/// set and per set count, which is exact for all associativities up to the
+/// configured maximum.
+class StackDistanceProfiler
+{
+	// Name of the profiled module, used in the report
+	std::string name;
+
+	// Block size in bytes
+	unsigned block_size;
+
+	// Largest number of sets modeled for set-associative caches
+	unsigned max_num_sets;
+
+	// Log base 2 of the largest number of sets
+	int log_max_num_sets;
+
+	// Largest associativity modeled for set-associative caches
+	unsigned max_num_ways;
+
+	// Total number of accesses observed
+	long long num_accesses = 0;
+
+	// Number of accesses to blocks never referenced before
+	long long num_cold_misses = 0;
+
+
+
+	//
+	// Fully-associative stacks
+	//
+
+	// Fenwick tree over access time stamps. Position 't' (1-based)
+	// contains a 1 if the access performed at time stamp 't' is the most
+	// recent access to its block.
+	std::vector<int> tree;
+
+	// Next time stamp to be assigned
+	unsigned time = 1;
+
+	// Time stamp of the last access to each block
+	std::unordered_map<unsigned, unsigned> last_access;
+
+	// Histogram of fully-associative stack distances. Element 0 counts
+	// distance 0, and element 'k' counts distances in [2^(k-1), 2^k).
+	std::vector<long long> histogram;
+
+	// Add 'value' to position 'index' of the Fenwick tree
+	void TreeAdd(unsigned index, int value);
+
+	// Return the sum of positions 1 to 'index' in the Fenwick tree
+	int TreeSum(unsigned index) const;
+
+	// Renumber the time stamps of all live blocks to make room in the
+	// Fenwick tree for new accesses.
+	void Compact();
+
+	// Record an access in the fully-associative stack
+	void AccessFullyAssociative(unsigned block);
+
+
+
+	//
+	// Set-associative stacks
+	//
+
+	// Bounded LRU stacks for a given number of sets
+	struct SetStacks
+	{
+		// Block numbers in LRU order for every set, with 'max_num_ways'
+		// entries per set. Most recently used block comes first.
+		std::vector<unsigned> blocks;
+
+		// Number of valid entries in each set
+		std::vector<unsigned> sizes;
+
+		// Histogram of per-set stack distances. Element 'd' counts
+		// distance 'd' for 'd' < 'max_num_ways', while the last element
+		// counts larger distances and cold accesses.
+		std::vector<long long> histogram;
+	};
+
+	// Stacks for 1, 2, 4, ..., 'max_num_sets' sets
+	std::vector<SetStacks> set_stacks;
+
+	// Record an access in the set-associative stacks
+	void AccessSetAssociative(unsigned block);
+
+public:
+
+	/// Constructor
+	///
+	/// \param name
+	///	Name of the profiled module.
+	///
+	/// \param block_size
+	///	Block size in bytes, must be a power of two.
+	///
+	/// \param max_num_sets
+	///	Largest number of sets modeled, must be a power of two.
+	///
+	/// \param max_num_ways
+	///	Largest associativity modeled, must be a power of two.
+	///
+	StackDistanceProfiler(const std::string &name,
+			unsigned block_size,
+			unsigned max_num_sets,
+			unsigned max_num_ways);
+
+	/// Record an access to the given block. Argument \a block is the
+	/// block number as seen by the module, that is, the physical address
+	/// divided by the block size and, for interleaved modules, by the
+	/// number of interleaved modules. Sets are selected with the least
+	/// significant bits of this value.
+	void Access(unsigned block);
+
+	/// Return the number of accesses observed
+	long long getNumAccesses() const { return num_accesses; }
+
+	/// Return the number of accesses to blocks never referenced before
+	long long getNumColdMisses() const { return num_cold_misses; }
+
+	/// Return the number of misses for a fully-associative LRU cache with
+	/// \a num_blocks blocks. The number of blocks must be a power of two.
+	long long getNumMisses(unsigned num_blocks) const;
+
+	/// Return the number of misses for an LRU cache with \a num_sets sets
+	/// and \a num_ways ways. Both values must be powers of two, no larger
+	/// than the maximums given in the constructor.
+	long long getNumMisses(unsigned num_sets, unsigned num_ways) const;
+
+	/// Dump the miss-ratio curves in the INI format used in the memory
+	/// system report.
+	void DumpReport(std::ostream &os = std::cout) const;
+};
+
+
+}  // namespace mem
+
+#endif
@@ -17,7 +17,9 @@
  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <algorithm>
 #include <fstream>
+#include <unordered_map>
 
 #include <lib/cpp/CommandLine.h>
 #include <lib/cpp/Misc.h>
@@ -40,6 +42,12 @@ bool System::help = false;
 int System::frequency = 1000;
 long long System::sanity_check_interval = 0;
 long long System::last_sanity_check = 0;
+bool System::sanity_check_full = false;
+std::string System::access_trace_record_file;
+std::string System::access_trace_replay_file;
+int System::access_trace_max_in_flight = 0;
+
+std::unique_ptr<AccessTraceWriter> System::access_trace_writer;
 
 esim::Trace System::trace;
 
@@ -339,7 +347,46 @@ void System::RegisterOptions()
 			"This option performs a sanity check for the underlying "
 			"coherency protocol in constant periods equal to the interval, "
 			"to examine its consistency and correctness. The simulation "
-			"fails if the correctness is not maintained.");
+			"fails if the correctness is not maintained. After the "
+			"first check, only blocks whose state or directory entries "
+			"changed since the previous check are examined.");
+
+	// Option for full sanity checks
+	command_line->RegisterBool("--mem-sanity-check-full",
+			sanity_check_full,
+			"Examine all blocks of all caches in every sanity check "
+			"enabled with option '--mem-sanity-check', instead of only "
+			"those that changed since the previous check.");
+
+	// Option to record access trace
+	command_line->RegisterString("--mem-trace-record <file>",
+			access_trace_record_file,
+			"Record all accesses performed by CPUs and GPUs on the "
+			"memory hierarchy in a binary trace file. Each access "
+			"includes the cycle, the accessed module, the access type, "
+			"and the physical address. The trace can be replayed "
+			"later with option '--mem-trace-replay'.");
+
+	// Option to replay access trace
+	command_line->RegisterString("--mem-trace-replay <file>",
+			access_trace_replay_file,
+			"Replay an access trace recorded with option "
+			"'--mem-trace-record' on the memory hierarchy given in "
+			"option '--mem-config', without simulating any CPU or "
+			"GPU. Modules are matched by name, and sections "
+			"[Entry <name>] in the memory configuration file are "
+			"ignored. This option cannot be combined with a detailed "
+			"CPU or GPU simulation. The simulation ends once the "
+			"trace has been replayed.");
+
+	// Option to limit in-flight accesses during replay
+	command_line->RegisterInt32("--mem-trace-max-in-flight <num>",
+			access_trace_max_in_flight,
+			"Maximum number of accesses in flight while replaying an "
+			"access trace. Once reached, the following accesses are "
+			"delayed until previous accesses complete. The default "
+			"value of 0 limits in-flight accesses only by the number "
+			"of ports of the accessed modules.");
 }
 
 
@@ -354,6 +401,100 @@ void System::ProcessOptions()
 
 	// Debug file
 	debug.setPath(debug_file);
+
+	// Access trace replay
+	if (!access_trace_replay_file.empty())
+	{
+		if (config_file.empty())
+			throw Error("Option --mem-trace-replay requires "
+					"option --mem-config");
+		if (!access_trace_record_file.empty())
+			throw Error("Options --mem-trace-record and "
+					"--mem-trace-replay are incompatible");
+	}
+	if (access_trace_max_in_flight < 0)
+		throw Error("Invalid value for option --mem-trace-max-in-flight");
+
+	// Access trace record
+	if (!access_trace_record_file.empty())
+		access_trace_writer = misc::new_unique<AccessTraceWriter>(
+				access_trace_record_file);
+}
+
+
+void System::ReplayAccessTrace()
+{
+	// Open trace
+	AccessTraceReader reader(access_trace_replay_file);
+
+	// Modules found in the trace, indexed by name
+	std::map<std::string, Module *> trace_modules;
+
+	// Next access to issue, and cycle where it can be issued
+	AccessTraceReader::Record record;
+	bool has_record = reader.Read(record);
+	long long issue_cycle = record.cycle_delta;
+	long long num_accesses = 0;
+
+	// Simulation loop
+	esim::Engine *esim_engine = esim::Engine::getInstance();
+	int num_in_flight_accesses = 0;
+	while (has_record || num_in_flight_accesses)
+	{
+		// Count accesses still in flight. Only the replay accesses the
+		// modules found in the trace, so their access lists contain no
+		// other accesses.
+		num_in_flight_accesses = 0;
+		for (auto &pair : trace_modules)
+			num_in_flight_accesses +=
+					pair.second->getNumInFlightAccesses();
+
+		// Issue all accesses due in this cycle
+		long long cycle = getCycle();
+		while (has_record && issue_cycle <= cycle)
+		{
+			// Get module
+			Module *&module = trace_modules[record.module_name];
+			if (!module)
+			{
+				module = getModule(record.module_name);
+				if (!module)
+					throw Error(misc::fmt("%s: module '%s' "
+							"not found in memory "
+							"configuration",
+							access_trace_replay_file.c_str(),
+							record.module_name.c_str()));
+			}
+
+			// Back-pressure
+			if (access_trace_max_in_flight &&
+					num_in_flight_accesses >=
+					access_trace_max_in_flight)
+				break;
+			if (!module->canAccess(record.address))
+				break;
+
+			// Issue access
+			module->Access(record.access_type, record.address);
+			num_in_flight_accesses++;
+			num_accesses++;
+
+			// Next access, relative to the actual issue cycle of
+			// this one
+			has_record = reader.Read(record);
+			issue_cycle = cycle + record.cycle_delta;
+		}
+
+		// Next cycle
+		if (debug)
+			debug << misc::fmt("___ cycle %lld ___\n", cycle);
+		esim_engine->ProcessEvents();
+	}
+
+	// Summary
+	debug << misc::fmt("Access trace replayed: %lld accesses in "
+			"%lld cycles\n", num_accesses, getCycle());
+	esim_engine->Finish("AccessTraceReplayed");
 }
 
 
@@ -395,6 +536,12 @@ void System::DumpReport(std::ostream &os) const
 			"Reads/writes coming from lower-level cache\n";
 	os << ";    NonBlockingReads, NonBlockingWrites, NonBlockingNCWrites -"
 			" Coming from upper-level cache\n";
+	os << ";    MSHROccupancy, MSHRMaxOccupancy - Average and maximum number "
+			"of non-coalesced in-flight accesses\n";
+	os << ";    MSHRFullCycles - Cycles with as many non-coalesced "
+			"in-flight accesses as MSHR entries\n";
+	os << ";    [ <module> StackDistance ] - Miss-ratio curves for modules "
+			"with 'StackDistanceProfile' enabled\n";
 	os << "\n\n";
 	
 	// Dump report for each module
@@ -403,286 +550,304 @@ void System::DumpReport(std::ostream &os) const
 }
 
 
+bool System::SanityCheckBlock(Module *module, int set, int way)
+{
+	// Get the associated cache and directory
+	Cache *cache = module->getCache();
+	Directory *directory = module->getDirectory();
+
+	// Get the block. If the block is not valid, there is nothing to check.
+	Cache::Block *block = cache->getBlock(set, way);
+	Cache::BlockState state = block->getState();
+	if (state == Cache::BlockInvalid)
+		return true;
+
+	// Get the block's tag
+	unsigned tag = block->getTag();
+
+	// Get the lower module for the top-down rules
+	Module *lower_module = module->getLowModuleServingAddress(tag);
+	assert(lower_module);
+
+	int lower_set;
+	int lower_way;
+	int lower_tag;
+	Cache::BlockState lower_state = Cache::BlockInvalid;
+	lower_module->FindBlock(tag,
+			lower_set,
+			lower_way,
+			lower_tag,
+			lower_state);
+
+	// Rule 1:
+	// Lower level module should have the block in an state other than
+	// Invalid.
+	if (lower_state == Cache::BlockInvalid)
+	{
+		module->Dump();
+		lower_module->Dump();
+		throw Error(misc::fmt("Sanity check failed\n"
+				"window %lld to %lld: The module %s "
+				"has a block that is not found in "
+				"module's approperiate lower module %s\n",
+				(last_sanity_check - 1) * sanity_check_interval,
+				last_sanity_check * sanity_check_interval,
+				module->getName().c_str(),
+				lower_module->getName().c_str()));
+	}
+
+	// Rule 2:
+	// If block is in E or M state the lower level should have that block
+	// as an owner
+	bool complete = true;
+	if (state != Cache::BlockExclusive && state != Cache::BlockModified)
+		return complete;
+
+	// Get lower module directory
+	Directory *lower_directory = lower_module->getDirectory();
+
+	// Get the directory entry tag
+	for (int z = 0; z < lower_directory->getNumSubBlocks(); z++)
+	{
+		// Get tag of directory entry
+		unsigned directory_entry_tag = lower_tag + z *
+				lower_module->getSubBlockSize();
+		assert(directory_entry_tag < lower_tag +
+				(unsigned) lower_module->getBlockSize());
+
+		// Find the entry
+		if (directory_entry_tag < tag ||
+				directory_entry_tag >= tag +
+				lower_module->getSubBlockSize())
+			continue;
+
+		// Sub-block is z
+		// Module should be owner of the sub-block
+		if (lower_module->getOwner(lower_set, lower_way, z) !=
+				module)
+		{
+			// The only reason that the lower level can be
+			// different from what higher level expect it to be is
+			// that this is an in-flight process. So the higher
+			// level directory should be locked
+			if (directory->isEntryLocked(set, way))
+			{
+				complete = false;
+				continue;
+			}
+
+			// Otherwise this is an error
+			module->Dump();
+			lower_module->Dump();
+			throw Error(misc::fmt("Sanity check failed\n"
+					"window %lld to %lld: The module %s:"
+					"block (set %d:  way %d) is in E/M "
+					"state but not considered an owner "
+					"by lower module %s block (set %d: "
+					" way %d: sub %d)\n",
+					(last_sanity_check - 1) *
+					sanity_check_interval,
+					last_sanity_check *
+					sanity_check_interval,
+					module->getName().c_str(),
+					set,
+					way,
+					lower_module->getName().c_str(),
+					lower_set,
+					lower_way,
+					z));
+		}
+
+		// Module should be the only sharer of the sub-block. Imprecise
+		// directories can report more.
+		if (lower_module->getNumSharers(lower_set, lower_way, z) != 1 &&
+				lower_directory->isPrecise())
+		{
+			// The only reason that the lower module might have
+			// zero sharer or have 1 sharer but not the 'module' is
+			// that this is an in-flight eviction. Lower level
+			// removes the module as sharer but the module is still
+			// not updated.
+			if (directory->isEntryLocked(set, way))
+			{
+				complete = false;
+				continue;
+			}
+
+			// Else there is an error
+			throw Error(misc::fmt("Sanity check failed\n"
+					"window %lld to %lld: The module %s"
+					"has a block that is in E/M state but "
+					"lower module %s has more than 1 "
+					"sharer\n",
+					(last_sanity_check - 1) *
+					sanity_check_interval,
+					last_sanity_check *
+					sanity_check_interval,
+					module->getName().c_str(),
+					lower_module->getName().c_str()));
+		}
+
+		// Module should be the only sharer of the sub-block
+		if (!lower_module->isSharer(lower_set, lower_way, z, module))
+		{
+			// The only reason that the module is not the sharer is
+			// that this is an in-flight process. We removed it as
+			// sharer but the module is not yet updated.
+			if (directory->isEntryLocked(set, way))
+			{
+				complete = false;
+				continue;
+			}
+
+			// Otherwise this is an error
+			throw Error(misc::fmt("Sanity check failed\n"
+					"window %lld to %lld: The module %s"
+					"has a block that is in E/M state but "
+					"is not the sharer in the lower module "
+					"%s\n",
+					(last_sanity_check - 1) *
+					sanity_check_interval,
+					last_sanity_check *
+					sanity_check_interval,
+					module->getName().c_str(),
+					lower_module->getName().c_str()));
+		}
+	}
+
+	// Done
+	return complete;
+}
+
+
+// Add the block of a module that holds an address, if any, to the blocks to
+// be checked, given as set * num_ways + way for each module.
+static void AddSanityCheckBlock(
+		std::unordered_map<Module *, std::vector<int>> &blocks,
+		Module *module,
+		unsigned address)
+{
+	int set;
+	int way;
+	int tag;
+	Cache::BlockState state;
+	if (module->getType() != Module::TypeMainMemory &&
+			module->FindBlock(address, set, way, tag, state))
+		blocks[module].push_back(set *
+				module->getCache()->getNumWays() + way);
+}
+
+
 void System::SanityCheck()
 {
 	//
 	// Top down Rules
 	//
-	// Get the blocks of each module in the highest level
+
+	// The first check, and every check with option
+	// '--mem-sanity-check-full', covers all blocks of all modules. It also
+	// starts recording changes in caches and directories.
+	if (sanity_check_full || !sanity_check_recording)
+	{
+		sanity_check_retry.clear();
+		for (auto &module : modules)
+		{
+			// Continue if module is in the last level
+			if (module->getType() == Module::TypeMainMemory)
+				continue;
+
+			// Check every block of the cache
+			Cache *cache = module->getCache();
+			for (unsigned set = 0; set < cache->getNumSets(); set++)
+				for (unsigned way = 0; way < cache->getNumWays();
+						way++)
+					if (!SanityCheckBlock(module.get(),
+							set, way))
+						sanity_check_retry.emplace_back(
+								module.get(), set *
+								cache->getNumWays() +
+								way);
+		}
+
+		// Record changes
+		if (!sanity_check_full && !sanity_check_recording)
+		{
+			for (auto &module : modules)
+			{
+				module->getCache()->RecordChanges();
+				module->getDirectory()->RecordChanges();
+			}
+			sanity_check_recording = true;
+		}
+		return;
+	}
+
+	// Later checks only cover the blocks that changed since the previous
+	// check, either in their own state or in the directory entry of their
+	// lower module, together with the blocks that could not be fully
+	// checked before.
+	std::unordered_map<Module *, std::vector<int>> blocks;
+	for (auto &retry : sanity_check_retry)
+		blocks[retry.first].push_back(retry.second);
+	sanity_check_retry.clear();
+	std::vector<unsigned> tags;
 	for (auto &module : modules)
 	{
-		// Get the associated cache
+		// Tags of the blocks that changed in the cache or the directory
 		Cache *cache = module->getCache();
-
-		// Get the associated directory
 		Directory *directory = module->getDirectory();
+		tags = cache->getChangedTags();
+		for (int index : directory->getChangedEntries())
+		{
+			Cache::Block *block = cache->getBlock(
+					index / cache->getNumWays(),
+					index % cache->getNumWays());
+			if (block->getState() != Cache::BlockInvalid)
+				tags.push_back(block->getTag());
+		}
+		cache->ClearChangedTags();
+		directory->ClearChangedEntries();
 
-		// Continue if module is in the last level
-		if (module->getType() == Module::TypeMainMemory)
-			continue;
-
-		// Get every block of the cache
-		for (unsigned set = 0; set < cache->getNumSets(); set++)
+		// The changed block itself, and all blocks of higher modules
+		// contained in it
+		for (unsigned tag : tags)
 		{
-			for (unsigned way = 0; way < cache->getNumWays(); way++)
+			AddSanityCheckBlock(blocks, module.get(), tag);
+			for (int i = 0; i < module->getNumHighModules(); i++)
 			{
-				// Get the block
-				Cache::Block *block = cache->getBlock(set,way);
-				
-				// If the block is not valid, continue
-				Cache::BlockState state = block->getState();
-				if (state == Cache::BlockInvalid)
-					continue;
-
-				// Get the block's tag
-				unsigned tag = block->getTag();
-
-				// Get the lower module for the top-down rules
-				Module *lower_module = module->
-						getLowModuleServingAddress(
-						block->getTag());
-				assert(lower_module);
-
-				int lower_set;
-				int lower_way;
-				int lower_tag;
-				Cache::BlockState lower_state = Cache::BlockInvalid;
-				lower_module->FindBlock(tag,
-						lower_set,
-						lower_way,
-						lower_tag,
-						lower_state);
-
-				// Rule 1:
-				// Lower level module should have the block
-				// in an state other than Invalid.
-				if (lower_state == Cache::BlockInvalid)
-				{
-					module->Dump();
-					lower_module->Dump();
-					throw Error(misc::fmt("Sanity check failed\n"
-					"window %lld to %lld: The module %s "
-					"has a block that is not found in "
-					"module's approperiate lower module %s\n",
-					(last_sanity_check - 1) * sanity_check_interval,
-					last_sanity_check * sanity_check_interval,
-					module->getName().c_str(),
-					lower_module->getName().c_str()));
-				}
-
-				// Rule 2:
-				// If block is in E or M state the lower level
-				// should have that block as an owner
-				if (state == Cache::BlockExclusive ||
-						state == Cache::BlockModified)
-				{
-					// Get lower module directory
-					Directory *lower_directory = lower_module->
-							getDirectory();
-
-					// Get the directory entry tag
-					for (int z = 0; z < lower_directory->
-							getNumSubBlocks();
-							z++)
-					{
-						// Get tag of directory entry
-						unsigned directory_entry_tag =
-								lower_tag + z *
-								lower_module->
-								getSubBlockSize();
-						assert(directory_entry_tag <
-								lower_tag +
-								(unsigned)
-								lower_module->
-								getBlockSize());
-
-						// Find the entry
-						if (directory_entry_tag <
-								tag ||
-								directory_entry_tag >=
-								tag + lower_module->
-								getSubBlockSize())
-							continue;
-
-						// Sub-block is z
-						// Module should be owner of the
-						// sub-block
-						if (lower_module->getOwner(lower_set,
-								lower_way,
-								z) != module.get())
-						{
-							// The only reason that
-							// the lower level can be 
-							// different from what
-							// higher level expect
-							// it to be is that
-							// this is an in-flight
-							// process. So the higher
-							// level directory should
-							// be locked
-							if (directory->isEntryLocked(
-									set, way))
-								continue;
-
-							// Otherwise this is 
-							// an error
-							module->Dump();
-							lower_module->Dump();
-							throw Error(misc::fmt(
-									"Sanity "
-									"check "
-									"failed\n"
-									"window "
-									"%lld to "
-									"%lld: "
-									"The "
-									"module %s:"
-									"block "
-									"(set %d: "
-									" way %d) "
-									"is in E/M "
-									"state "
-									"but not "
-									"considered "
-									"an owner "
-									"by lower "
-									"module %s "
-									"block "
-									"(set %d: "
-									" way %d: "
-									"sub %d)\n",
-									(last_sanity_check -
-									1) * 
-									sanity_check_interval,
-									last_sanity_check *
-									sanity_check_interval,
-									module->
-									getName().
-									c_str(),
-									set,
-									way,
-									lower_module->
-									getName().
-									c_str(),
-									lower_set,
-									lower_way,
-									z));
-						}
-
-						// Module should be the only sharer
-						// of the sub-block
-						if (lower_module->getNumSharers(
-								lower_set,
-								lower_way,
-								z) != 1)
-						{
-							// The only reason that
-							// the lower module might
-							// have zero sharer
-							// or have 1 sharer but
-							// not the 'module' 
-							// is that this is
-							// an in-flight eviction.
-							// Lower level removes
-							// the module as sharer
-							// but the module is 
-							// still not updated.
-							if (directory->isEntryLocked(
-									set, way))
-								continue;
-
-							// Else there is an error
-							throw Error(misc::fmt(
-									"Sanity "
-									"check "
-									"failed\n"
-									"window "
-									"%lld to "
-									"%lld: "
-									"The "
-									"module %s"
-									"has a "
-									"block "
-									"that is "
-									"in E/M "
-									"state "
-									"but lower "
-									"module %s "
-									"has more "
-									"than 1 "
-									"sharer\n",
-									(last_sanity_check -
-									1) * 
-									sanity_check_interval,
-									last_sanity_check *
-									sanity_check_interval,
-									module->
-									getName().
-									c_str(),
-									lower_module->
-									getName().
-									c_str()));
-						}
-	
-						// Module should be the only sharer
-						// of the sub-block
-						if (!lower_module->isSharer(
-								lower_set,
-								lower_way,
-								z, module.get()))
-						{
-							// The only reason that
-							// the module is not the
-							// sharer is that
-							// this is an in-flight
-							// process.
-							// We removed it as sharer
-							// but the module is not
-							// yet updated.
-							if (directory->isEntryLocked(
-									set, way))
-								continue;
-
-							// Otherwise this is an
-							// error
-							throw Error(misc::fmt(
-									"Sanity "
-									"check "
-									"failed\n"
-									"window "
-									"%lld to "
-									"%lld: "
-									"The "
-									"module %s"
-									"has a "
-									"block "
-									"that is "
-									"in E/M "
-									"state "
-									"but is "
-									"not the "
-									"sharer "
-									"in the "
-									"lower "
-									"module %s\n",
-									(last_sanity_check -
-									1) * 
-									sanity_check_interval,
-									last_sanity_check *
-									sanity_check_interval,
-									module->
-									getName().
-									c_str(),
-									lower_module->
-									getName().
-									c_str()));
-						}
-					}
-				}
+				Module *high_module = module->getHighModule(i);
+				for (unsigned address = tag; address < tag +
+						module->getBlockSize();
+						address += high_module->
+						getBlockSize())
+					AddSanityCheckBlock(blocks,
+							high_module,
+							address);
 			}
 		}
 	}
 
+	// Check blocks, in the order of modules
+	for (auto &module : modules)
+	{
+		// Blocks of the module
+		auto it = blocks.find(module.get());
+		if (it == blocks.end())
+			continue;
+		std::vector<int> &indexes = it->second;
+		std::sort(indexes.begin(), indexes.end());
+		indexes.erase(std::unique(indexes.begin(), indexes.end()),
+				indexes.end());
+
+		// Check them
+		int num_ways = module->getCache()->getNumWays();
+		for (int index : indexes)
+			if (!SanityCheckBlock(module.get(), index / num_ways,
+					index % num_ways))
+				sanity_check_retry.emplace_back(module.get(),
+						index);
+	}
+
 	//
 	// Down Up Rules
 	//
@@ -23,6 +23,7 @@
 #include <list>
 #include <map>
 #include <memory>
+#include <vector>
 
 #include <lib/cpp/Debug.h>
 #include <lib/esim/Event.h>
@@ -32,6 +33,7 @@
 #include <network/Network.h>
 #include <network/Node.h>
 
+#include "AccessTrace.h"
 #include "Module.h"
 
 
@@ -90,6 +92,23 @@ class System
 
 	// Last time a sanity check is performed
 	static long long last_sanity_check;
+
+	// Check all blocks in every sanity check, instead of only those that
+	// changed since the previous check
+	static bool sanity_check_full;
+
+	// Access trace file given in option '--mem-trace-record'
+	static std::string access_trace_record_file;
+
+	// Access trace file given in option '--mem-trace-replay'
+	static std::string access_trace_replay_file;
+
+	// Maximum number of in-flight accesses while replaying an access
+	// trace, or 0 for no limit other than the module ports.
+	static int access_trace_max_in_flight;
+
+	// Writer for the access trace, or null if no trace is recorded
+	static std::unique_ptr<AccessTraceWriter> access_trace_writer;
 	
 	// Error messages
 	static const char *err_config_note;
@@ -202,6 +221,14 @@ class System
 			Module *module,
 			const std::string &section);
 
+	void ConfigReadStackDistanceProfiler(misc::IniFile *ini_file,
+			Module *module,
+			const std::string &section);
+
+	void ConfigReadDirectoryType(misc::IniFile *ini_file,
+			Module *module,
+			const std::string &section);
+
 	void ConfigReadModules(misc::IniFile *ini_file);
 
 	void ConfigCheckRouteToMainMemory(
@@ -262,6 +289,15 @@ public:
 		return it == network_map.end() ? nullptr : it->second;
 	}
 
+	/// Return the frequency domain of the memory system
+	esim::FrequencyDomain *getFrequencyDomain() const
+	{
+		return frequency_domain;
+	}
+
+	/// Return the current cycle in the memory system frequency domain
+	long long getCycle() const { return frequency_domain->getCycle(); }
+
 
 
 
@@ -289,6 +325,20 @@ public:
 
 	/// Destroy the singleton if allocated.
 	static void Destroy() { instance = nullptr; }
+
+	/// Return the writer for the access trace given in option
+	/// '--mem-trace-record', or nullptr if no trace is recorded.
+	static AccessTraceWriter *getAccessTraceWriter()
+	{
+		return access_trace_writer.get();
+	}
+
+	/// Return whether an access trace is replayed with option
+	/// '--mem-trace-replay'
+	static bool isAccessTraceReplay()
+	{
+		return !access_trace_replay_file.empty();
+	}
 	
 
 
@@ -380,6 +430,21 @@ public:
 	static esim::Event *event_local_find_and_lock_action;
 	static esim::Event *event_local_find_and_lock_finish;
 
+	// True once caches and directories record their changes for
+	// incremental sanity checks
+	bool sanity_check_recording = false;
+
+	// Blocks that could not be fully checked in the last sanity check
+	// because of in-flight accesses, given as a module and an index
+	// set * num_ways + way. They are checked again in the next one.
+	std::vector<std::pair<Module *, int>> sanity_check_retry;
+
+	// Check the coherence rules for a block of a module. The function
+	// throws an exception if a rule is broken, and returns false if some
+	// rule could not be checked because the directory entry of the block
+	// is locked.
+	bool SanityCheckBlock(Module *module, int set, int way);
+
 	// Sanity check of the event driven simulation
 	void SanityCheck();
 
@@ -413,6 +478,20 @@ public:
 	/// Dump function for report
 	void DumpReport(std::ostream &os = std::cout) const;
 
+
+
+
+	//
+	// Access trace
+	//
+
+	/// Feed the accesses of the trace given in option '--mem-trace-replay'
+	/// into their modules, and run the simulation until all of them
+	/// complete. Each access is issued the recorded number of cycles
+	/// after the previous one was issued, or later if the module cannot
+	/// accept it or the limit of in-flight accesses is reached.
+	void ReplayAccessTrace();
+
 };
 
 }  // namespace mem
@@ -17,8 +17,12 @@
  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <climits>
+
 #include <arch/common/Arch.h>
 #include <arch/common/Timing.h>
+#include <dram/Controller.h>
+#include <dram/System.h>
 #include <lib/esim/Engine.h>
 #include <network/EndNode.h>
 #include <network/Node.h>
@@ -126,6 +130,13 @@ const std::string System::help_message =
 	"  DirectoryLatency = <cycles>\n"
 	"      Access latency for directory. This variable is only allowed for a\n"
 	"      main memory module.\n"
+	"  DramController = <name>\n"
+	"      Memory controller defined in a [MemoryController <name>] section of the\n"
+	"      DRAM configuration file (option '--dram-config'). When given, reads\n"
+	"      and write-backs of blocks in the main memory module become requests to\n"
+	"      the controller, and the value of 'Latency' is not used. Consecutive\n"
+	"      blocks are interleaved across the controller's channels. This\n"
+	"      variable is only allowed for a main memory module.\n"
 	"  AddressRange = { BOUNDS <low> <high> | ADDR DIV <div> MOD <mod> EQ <eq> }\n"
 	"      Physical address range served by the module. If not specified, the\n"
 	"      entire address space is served by the module. There are two possible\n"
@@ -141,6 +152,33 @@ const std::string System::help_message =
 	"      When a module serves only a subset of the address space, the user must\n"
 	"      make sure that the rest of the modules at the same level serve the\n"
 	"      remaining address space.\n"
+	"  StackDistanceProfile = {On|Off}  (Default = Off)\n"
+	"      Attach an LRU stack distance profiler to the module. The profiler\n"
+	"      observes all accesses looking up the module and reports, in the\n"
+	"      memory report, the number of misses and miss ratio of LRU caches with\n"
+	"      the module's block size for every power-of-two number of sets and\n"
+	"      associativity, and for fully-associative caches of every power-of-two\n"
+	"      capacity. This allows for the exploration of cache geometries with a\n"
+	"      single simulation.\n"
+	"  StackDistanceMaxSets = <num_sets>  (Default = 4096)\n"
+	"      Largest number of sets for which miss ratios are reported.\n"
+	"  StackDistanceMaxAssoc = <num_ways>  (Default = 32)\n"
+	"      Largest associativity for which miss ratios are reported in\n"
+	"      set-associative configurations.\n"
+	"  DirectoryType = {FullMap|LimitedPointer|CoarseVector|Sparse}\n"
+	"      (Default = FullMap)\n"
+	"      Encoding of the sharers of each directory entry, used to reduce the\n"
+	"      size of directories with many upper-level modules. 'FullMap' stores\n"
+	"      one bit per upper-level module. 'LimitedPointer' stores up to\n"
+	"      'DirectoryPointers' module identifiers, and considers all modules as\n"
+	"      sharers once they are exceeded. 'CoarseVector' stores one bit per\n"
+	"      group of 'DirectoryCoarseness' modules. 'Sparse' stores an exact set\n"
+	"      of sharers only for blocks present in upper-level modules. Imprecise\n"
+	"      encodings cause additional invalidation messages.\n"
+	"  DirectoryPointers = <num>  (Default = 4)\n"
+	"      Number of sharers per directory entry with 'LimitedPointer'.\n"
+	"  DirectoryCoarseness = <num>  (Default = 4)\n"
+	"      Number of upper-level modules per bit with 'CoarseVector'.\n"
 	"\n"
 	"Section [CacheGeometry <geo>] defines a geometry for a cache. Caches using\n"
 	"this geometry are instantiated [Module <name>] sections.\n"
@@ -183,6 +221,12 @@ const std::string System::help_message =
 	"      Size of output buffers for end nodes and switch. \n"
 	"  DefaultBandwidth = <bandwidth>\n"
 	"      Bandwidth for links and switch crossbar in number of bytes per cycle.\n"
+	"  Model = {Detailed|Analytical}  (Default = Detailed)\n"
+	"      Timing model of the network. The analytical model delivers every\n"
+	"      message with a single event, after a latency estimated from its route\n"
+	"      and the utilization of the links, instead of simulating each hop. It\n"
+	"      speeds up memory-intensive simulations at the cost of ignoring buffer\n"
+	"      occupancy and arbitration (see option '--net-help' for details).\n"
 	"\n"
 	"Section [Entry <name>] creates an entry into the memory system. An entry is\n"
 	"a connection between a CPU core/thread or a GPU compute unit with a module\n"
@@ -314,6 +358,20 @@ void System::ConfigReadNetworks(misc::IniFile *ini_file)
 		ini_file->Enforce(section, "DefaultInputBufferSize");
 		ini_file->Enforce(section, "DefaultOutputBufferSize");
 		ini_file->Enforce(section, "DefaultBandwidth");
+
+		// Timing model
+		std::string model_str = ini_file->ReadString(section, "Model",
+				"Detailed");
+		net::Network::Model model = (net::Network::Model)
+				net::Network::ModelMap.MapString(model_str);
+		if (!model)
+			throw Error(misc::fmt("%s: Network %s: %s: Invalid "
+					"value for 'Model'.\n%s",
+					ini_file->getPath().c_str(),
+					network->getName().c_str(),
+					model_str.c_str(),
+					err_config_note));
+		network->setModel(model);
 		ini_file->Check(section);
 	}
 }
@@ -696,6 +754,27 @@ Module *System::ConfigReadMainMemory(misc::IniFile *ini_file,
 			directory_num_ways,
 			directory_latency);
 
+	// DRAM controller
+	std::string dram_controller_name = ini_file->ReadString(section,
+			"DramController");
+	if (!dram_controller_name.empty())
+	{
+		dram::System *dram_system = dram::System::getInstance();
+		dram::Controller *dram_controller = dram_system->getController(
+				dram_controller_name);
+		if (!dram_controller)
+			throw Error(misc::fmt("%s: %s: invalid DRAM controller "
+					"'%s'. Memory controllers are defined "
+					"in sections [MemoryController <name>] "
+					"of the DRAM configuration file passed "
+					"with option '--dram-config'.\n%s",
+					ini_file->getPath().c_str(),
+					module_name.c_str(),
+					dram_controller_name.c_str(),
+					err_config_note));
+		module->setDramController(dram_controller);
+	}
+
 	// High network
 	std::string network_name = ini_file->ReadString(section, "HighNetwork");
 	std::string network_node_name = ini_file->ReadString(section, "HighNetworkNode");
@@ -858,6 +937,77 @@ void System::ConfigReadModuleAddressRange(misc::IniFile *ini_file,
 }
 
 
+void System::ConfigReadStackDistanceProfiler(misc::IniFile *ini_file,
+		Module *module,
+		const std::string &section)
+{
+	// Read variables
+	bool enabled = ini_file->ReadBool(section, "StackDistanceProfile",
+			false);
+	int max_num_sets = ini_file->ReadInt(section, "StackDistanceMaxSets",
+			4096);
+	int max_num_ways = ini_file->ReadInt(section, "StackDistanceMaxAssoc",
+			32);
+	if (!enabled)
+		return;
+
+	// Check values
+	if (max_num_sets < 1 || (max_num_sets & (max_num_sets - 1)))
+		throw Error(misc::fmt("%s: %s: value for 'StackDistanceMaxSets' "
+				"must be a power of two.\n%s",
+				ini_file->getPath().c_str(),
+				module->getName().c_str(),
+				err_config_note));
+	if (max_num_ways < 1 || (max_num_ways & (max_num_ways - 1)))
+		throw Error(misc::fmt("%s: %s: value for 'StackDistanceMaxAssoc' "
+				"must be a power of two.\n%s",
+				ini_file->getPath().c_str(),
+				module->getName().c_str(),
+				err_config_note));
+
+	// Attach profiler
+	module->setStackDistanceProfiler(max_num_sets, max_num_ways);
+}
+
+
+void System::ConfigReadDirectoryType(misc::IniFile *ini_file,
+		Module *module,
+		const std::string &section)
+{
+	// Read variables
+	std::string type_str = ini_file->ReadString(section, "DirectoryType",
+			"FullMap");
+	int num_pointers = ini_file->ReadInt(section, "DirectoryPointers", 4);
+	int coarseness = ini_file->ReadInt(section, "DirectoryCoarseness", 4);
+
+	// Check values
+	Directory::Type type = (Directory::Type)
+			Directory::TypeMap.MapString(type_str);
+	if (!type)
+		throw Error(misc::fmt("%s: %s: %s: invalid value for "
+				"'DirectoryType'.\n%s",
+				ini_file->getPath().c_str(),
+				module->getName().c_str(),
+				type_str.c_str(),
+				err_config_note));
+	if (num_pointers < 1 || num_pointers > SHRT_MAX)
+		throw Error(misc::fmt("%s: %s: invalid value for variable "
+				"'DirectoryPointers'.\n%s",
+				ini_file->getPath().c_str(),
+				module->getName().c_str(),
+				err_config_note));
+	if (coarseness < 1)
+		throw Error(misc::fmt("%s: %s: invalid value for variable "
+				"'DirectoryCoarseness'.\n%s",
+				ini_file->getPath().c_str(),
+				module->getName().c_str(),
+				err_config_note));
+
+	// Save directory type
+	module->setDirectoryType(type, num_pointers, coarseness);
+}
+
+
 void System::ConfigReadModules(misc::IniFile *ini_file)
 {
 	// Create modules
@@ -894,6 +1044,12 @@ void System::ConfigReadModules(misc::IniFile *ini_file)
 		// Read module address range
 		ConfigReadModuleAddressRange(ini_file, module, section);
 
+		// Read stack distance profiler
+		ConfigReadStackDistanceProfiler(ini_file, module, section);
+
+		// Read directory type
+		ConfigReadDirectoryType(ini_file, module, section);
+
 		// Debug
 		debug << "\t" << module_name << '\n';
 	}
@@ -1032,6 +1188,27 @@ void System::ConfigReadEntries(misc::IniFile *ini_file)
 	// Get architecture pool
 	comm::ArchPool *arch_pool = comm::ArchPool::getInstance();
 
+	// When replaying an access trace, entries are given by the modules
+	// accessed in the trace. Allow the variables used in entry sections
+	// without processing them.
+	if (isAccessTraceReplay())
+	{
+		for (auto it = ini_file->sections_begin(),
+				e = ini_file->sections_end();
+				it != e;
+				++it)
+		{
+			std::string section = *it;
+			if (strncasecmp(section.c_str(), "Entry ", 6))
+				continue;
+			for (const char *var : { "Arch", "Core", "Thread",
+					"ComputeUnit", "Module", "DataModule",
+					"ConstantDataModule", "InstModule" })
+				ini_file->Allow(section, var);
+		}
+		return;
+	}
+
 	// Read all [Entry <name>] sections
 	debug << "Processing entries to the memory system:\n\n";
 	for (auto it = ini_file->sections_begin(),
@@ -1356,6 +1533,13 @@ void System::ConfigCalculateModuleLevels()
 		}
 	}
 
+	// When replaying an access trace, there are no entries from CPUs or
+	// GPUs. All modules without high modules are considered L1.
+	if (isAccessTraceReplay())
+		for (auto &module : modules)
+			if (!module->getNumHighModules())
+				ConfigSetModuleLevel(module.get(), 1);
+
 	// Debug
 	debug << "Calculating module levels:\n";
 	for (auto &module : modules)
@@ -140,19 +140,21 @@ void System::EventLoadHandler(esim::Event *event, esim::Frame *esim_frame)
 	// Event "load"
 	if (event == event_load)
 	{
-		debug << misc::fmt("%lld A-%lld 0x%x %s load\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->getAddress(),
-				module->getName().c_str());
-		trace << misc::fmt("mem.new_access "
-				"name=\"A-%lld\" "
-				"type=\"load\" "
-				"state=\"%s:load\" "
-				"addr=0x%x\n",
-				frame->getId(),
-				module->getName().c_str(),
-				frame->getAddress());
+		if (debug)
+			debug << misc::fmt("%lld A-%lld 0x%x %s load\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->getAddress(),
+					module->getName().c_str());
+		if (trace)
+			trace << misc::fmt("mem.new_access "
+					"name=\"A-%lld\" "
+					"type=\"load\" "
+					"state=\"%s:load\" "
+					"addr=0x%x\n",
+					frame->getId(),
+					module->getName().c_str(),
+					frame->getAddress());
 
 		// Record access
 		module->StartAccess(frame, Module::AccessLoad);
@@ -178,24 +180,28 @@ void System::EventLoadHandler(esim::Event *event, esim::Frame *esim_frame)
 	// Event "load_lock"
 	if (event == event_load_lock)
 	{
-		debug << misc::fmt("  %lld A-%lld 0x%x %s load lock\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->getAddress(),
-				module->getName().c_str());
-		trace << misc::fmt("mem.access "
-				"name=\"A-%lld\" "
-				"state=\"%s:load_lock\"\n",
-				frame->getId(),
-				module->getName().c_str());
+		if (debug)
+			debug << misc::fmt("  %lld A-%lld 0x%x %s load lock\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->getAddress(),
+					module->getName().c_str());
+		if (trace)
+			trace << misc::fmt("mem.access "
+					"name=\"A-%lld\" "
+					"state=\"%s:load_lock\"\n",
+					frame->getId(),
+					module->getName().c_str());
 
 		// If there is any older write, wait for it
 		Frame *older_frame = module->getInFlightWrite(frame);
 		if (older_frame)
 		{
-			debug << misc::fmt("    A-%lld wait for store A-%lld\n",
-					frame->getId(),
-					older_frame->getId());
+			if (debug)
+				debug << misc::fmt("    A-%lld wait for store "
+						"A-%lld\n",
+						frame->getId(),
+						older_frame->getId());
 			older_frame->queue.Wait(event_load_lock);
 			return;
 		}
@@ -207,9 +213,11 @@ void System::EventLoadHandler(esim::Event *event, esim::Frame *esim_frame)
 				frame);
 		if (older_frame)
 		{
-			debug << misc::fmt("    A-%lld wait for access A-%lld\n",
-					frame->getId(),
-					older_frame->getId());
+			if (debug)
+				debug << misc::fmt("    A-%lld wait for "
+						"access A-%lld\n",
+						frame->getId(),
+						older_frame->getId());
 			older_frame->queue.Wait(event_load_lock);
 			return;
 		}
@@ -234,15 +242,18 @@ void System::EventLoadHandler(esim::Event *event, esim::Frame *esim_frame)
 	if (event == event_load_action)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s load_action\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->getAddress(),
-				module->getName().c_str());
-		trace << misc::fmt("mem.access name=\"A-%lld\" "
-				"state=\"%s:load_action\"\n",
-				frame->getId(),
-				module->getName().c_str());
+		if (debug)
+			debug << misc::fmt("  %lld A-%lld 0x%x %s "
+					"load_action\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->getAddress(),
+					module->getName().c_str());
+		if (trace)
+			trace << misc::fmt("mem.access name=\"A-%lld\" "
+					"state=\"%s:load_action\"\n",
+					frame->getId(),
+					module->getName().c_str());
 
 		// Error locking
 		if (frame->error)
@@ -251,9 +262,10 @@ void System::EventLoadHandler(esim::Event *event, esim::Frame *esim_frame)
 			int retry_latency = module->getRetryLatency();
 
 			// Debug
-			debug << misc::fmt("    lock error, retrying in "
-					"%d cycles\n",
-					retry_latency);
+			if (debug)
+				debug << misc::fmt("    lock error, retrying "
+						"in %d cycles\n",
+						retry_latency);
 
 			// Reschedule 'load-lock'
 			frame->retry = true;
@@ -289,16 +301,18 @@ void System::EventLoadHandler(esim::Event *event, esim::Frame *esim_frame)
 	if (event == event_load_miss)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s load_miss\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->getAddress(),
-				module->getName().c_str());
-		trace << misc::fmt("mem.access "
-				"name=\"A-%lld\" "
-				"state=\"%s:load_miss\"\n",
-				frame->getId(),
-				module->getName().c_str());
+		if (debug)
+			debug << misc::fmt("  %lld A-%lld 0x%x %s load_miss\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->getAddress(),
+					module->getName().c_str());
+		if (trace)
+			trace << misc::fmt("mem.access "
+					"name=\"A-%lld\" "
+					"state=\"%s:load_miss\"\n",
+					frame->getId(),
+					module->getName().c_str());
 
 		// Error on read request. Unlock block and retry load.
 		if (frame->error)
@@ -312,8 +326,10 @@ void System::EventLoadHandler(esim::Event *event, esim::Frame *esim_frame)
 			int retry_latency = module->getRetryLatency();
 
 			// Debug
-			debug << misc::fmt("    lock error, retrying "
-					"in %d cycles\n", retry_latency);
+			if (debug)
+				debug << misc::fmt("    lock error, retrying "
+						"in %d cycles\n",
+						retry_latency);
 
 			// Continue with 'load-lock' after retry latency
 			frame->retry = true;
@@ -338,17 +354,19 @@ void System::EventLoadHandler(esim::Event *event, esim::Frame *esim_frame)
 	if (event == event_load_unlock)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s "
-				"load unlock\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->getAddress(),
-				module->getName().c_str());
-		trace << misc::fmt("mem.access "
-				"name=\"A-%lld\" "
-				"state=\"%s:load_unlock\"\n",
-				frame->getId(),
-				module->getName().c_str());
+		if (debug)
+			debug << misc::fmt("  %lld A-%lld 0x%x %s "
+					"load unlock\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->getAddress(),
+					module->getName().c_str());
+		if (trace)
+			trace << misc::fmt("mem.access "
+					"name=\"A-%lld\" "
+					"state=\"%s:load_unlock\"\n",
+					frame->getId(),
+					module->getName().c_str());
 
 		// Unlock directory entry
 		directory->UnlockEntry(frame->set,
@@ -369,19 +387,22 @@ void System::EventLoadHandler(esim::Event *event, esim::Frame *esim_frame)
 	if (event == event_load_finish)
 	{
 		// Debug and trace
-		debug << misc::fmt("%lld A-%lld 0x%x %s load_finish\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->getAddress(),
-				module->getName().c_str());
-		trace << misc::fmt("mem.access "
-				"name=\"A-%lld\" "
-				"state=\"%s:load_finish\"\n",
-				frame->getId(),
-				module->getName().c_str());
-		trace << misc::fmt("mem.end_access "
-				"name=\"A-%lld\"\n",
-				frame->getId());
+		if (debug)
+			debug << misc::fmt("%lld A-%lld 0x%x %s load_finish\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->getAddress(),
+					module->getName().c_str());
+		if (trace)
+			trace << misc::fmt("mem.access "
+					"name=\"A-%lld\" "
+					"state=\"%s:load_finish\"\n",
+					frame->getId(),
+					module->getName().c_str());
+		if (trace)
+			trace << misc::fmt("mem.end_access "
+					"name=\"A-%lld\"\n",
+					frame->getId());
 
 		// Increment witness variable
 		if (frame->witness)
@@ -425,18 +446,20 @@ void System::EventStoreHandler(esim::Event *event,
 	if (event == event_store)
 	{
 		// Debug and trace
-		debug << misc::fmt("%lld A-%lld 0x%x %s store\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->getAddress(),
-				module->getName().c_str());
-		trace << misc::fmt("mem.new_access "
-				"name=\"A-%lld\" "
-				"type=\"store\" "
-				"state=\"%s:store\" addr=0x%x\n",
-				frame->getId(),
-				module->getName().c_str(),
-				frame->getAddress());
+		if (debug)
+			debug << misc::fmt("%lld A-%lld 0x%x %s store\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->getAddress(),
+					module->getName().c_str());
+		if (trace)
+			trace << misc::fmt("mem.new_access "
+					"name=\"A-%lld\" "
+					"type=\"store\" "
+					"state=\"%s:store\" addr=0x%x\n",
+					frame->getId(),
+					module->getName().c_str(),
+					frame->getAddress());
 
 		// Record access
 		module->StartAccess(frame, Module::AccessStore);
@@ -470,16 +493,18 @@ void System::EventStoreHandler(esim::Event *event,
 	if (event == event_store_lock)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s store_lock\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->getAddress(),
-				module->getName().c_str());
-		trace << misc::fmt("mem.access "
-				"name=\"A-%lld\" "
-				"state=\"%s:store_lock\"\n",
-				frame->getId(),
-				module->getName().c_str());
+		if (debug)
+			debug << misc::fmt("  %lld A-%lld 0x%x %s store_lock\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->getAddress(),
+					module->getName().c_str());
+		if (trace)
+			trace << misc::fmt("mem.access "
+					"name=\"A-%lld\" "
+					"state=\"%s:store_lock\"\n",
+					frame->getId(),
+					module->getName().c_str());
 
 		// If there is any older access, wait for it
 		auto it = frame->accesses_iterator;
@@ -491,9 +516,11 @@ void System::EventStoreHandler(esim::Event *event,
 			Frame *older_frame = *it;
 
 			// Debug
-			debug << misc::fmt("    A-%lld wait for access A-%lld\n",
-					frame->getId(),
-					older_frame->getId());
+			if (debug)
+				debug << misc::fmt("    A-%lld wait for "
+						"access A-%lld\n",
+						frame->getId(),
+						older_frame->getId());
 
 			// Enqueue
 			older_frame->queue.Wait(event_store_lock);
@@ -520,16 +547,19 @@ void System::EventStoreHandler(esim::Event *event,
 	if (event == event_store_action)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s store_action\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->getAddress(),
-				module->getName().c_str());
-		trace << misc::fmt("mem.access "
-				"name=\"A-%lld\" "
-				"state=\"%s:store_action\"\n",
-				frame->getId(),
-				module->getName().c_str());
+		if (debug)
+			debug << misc::fmt("  %lld A-%lld 0x%x %s "
+					"store_action\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->getAddress(),
+					module->getName().c_str());
+		if (trace)
+			trace << misc::fmt("mem.access "
+					"name=\"A-%lld\" "
+					"state=\"%s:store_action\"\n",
+					frame->getId(),
+					module->getName().c_str());
 
 		// Error locking
 		if (frame->error)
@@ -538,9 +568,10 @@ void System::EventStoreHandler(esim::Event *event,
 			int retry_latency = module->getRetryLatency();
 
 			// Debug
-			debug << misc::fmt("    lock error, retrying in "
-					"%d cycles\n",
-					retry_latency);
+			if (debug)
+				debug << misc::fmt("    lock error, retrying "
+						"in %d cycles\n",
+						retry_latency);
 
 			// Reschedule 'store-lock' after lantecy
 			frame->retry = true;
@@ -590,16 +621,19 @@ void System::EventStoreHandler(esim::Event *event,
 	if (event == event_store_unlock)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s store_unlock\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->getAddress(),
-				module->getName().c_str());
-		trace << misc::fmt("mem.access "
-				"name=\"A-%lld\" "
-				"state=\"%s:store_unlock\"\n",
-				frame->getId(),
-				module->getName().c_str());
+		if (debug)
+			debug << misc::fmt("  %lld A-%lld 0x%x %s "
+					"store_unlock\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->getAddress(),
+					module->getName().c_str());
+		if (trace)
+			trace << misc::fmt("mem.access "
+					"name=\"A-%lld\" "
+					"state=\"%s:store_unlock\"\n",
+					frame->getId(),
+					module->getName().c_str());
 
 		// Error in write request, unlock block and retry store.
 		if (frame->error)
@@ -608,8 +642,10 @@ void System::EventStoreHandler(esim::Event *event,
 			int retry_latency = module->getRetryLatency();
 
 			// Debug
-			debug << misc::fmt("    lock error, retrying in "
-					"%d cycles\n", retry_latency);
+			if (debug)
+				debug << misc::fmt("    lock error, retrying "
+						"in %d cycles\n",
+						retry_latency);
 
 			// Unlock directory entry
 			directory->UnlockEntry(frame->set,
@@ -642,19 +678,22 @@ void System::EventStoreHandler(esim::Event *event,
 	if (event == event_store_finish)
 	{
 		// Debug and trace
-		debug << misc::fmt("%lld A-%lld 0x%x %s store_finish\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->getAddress(),
-				module->getName().c_str());
-		trace << misc::fmt("mem.access "
-				"name=\"A-%lld\" "
-				"state=\"%s:store_finish\"\n",
-				frame->getId(),
-				module->getName().c_str());
-		trace << misc::fmt("mem.end_access "
-				"name=\"A-%lld\"\n",
-				frame->getId());
+		if (debug)
+			debug << misc::fmt("%lld A-%lld 0x%x %s store_finish\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->getAddress(),
+					module->getName().c_str());
+		if (trace)
+			trace << misc::fmt("mem.access "
+					"name=\"A-%lld\" "
+					"state=\"%s:store_finish\"\n",
+					frame->getId(),
+					module->getName().c_str());
+		if (trace)
+			trace << misc::fmt("mem.end_access "
+					"name=\"A-%lld\"\n",
+					frame->getId());
 
 		// Finish access
 		module->FinishAccess(frame);
@@ -696,19 +735,21 @@ void System::EventNCStoreHandler(esim::Event *event,
 	if (event == event_nc_store)
 	{
 		// Debug and trace
-		debug << misc::fmt("%lld A-%lld 0x%x %s nc_store\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->getAddress(),
-				module->getName().c_str());
-		trace << misc::fmt("mem.new_access "
-				"name=\"A-%lld\" "
-				"type=\"nc_store\" "
-				"state=\"%s:nc store\" "
-				"addr=0x%x\n",
-				frame->getId(),
-				module->getName().c_str(),
-				frame->getAddress());
+		if (debug)
+			debug << misc::fmt("%lld A-%lld 0x%x %s nc_store\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->getAddress(),
+					module->getName().c_str());
+		if (trace)
+			trace << misc::fmt("mem.new_access "
+					"name=\"A-%lld\" "
+					"type=\"nc_store\" "
+					"state=\"%s:nc store\" "
+					"addr=0x%x\n",
+					frame->getId(),
+					module->getName().c_str(),
+					frame->getAddress());
 
 		// Record access
 		module->StartAccess(frame, Module::AccessNCStore);
@@ -735,25 +776,30 @@ void System::EventNCStoreHandler(esim::Event *event,
 	if (event == event_nc_store_lock)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s nc_store_lock\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->getAddress(),
-				module->getName().c_str());
-		trace << misc::fmt("mem.access "
-				"name=\"A-%lld\" "
-				"state=\"%s:nc_store_lock\"\n",
-				frame->getId(),
-				module->getName().c_str());
+		if (debug)
+			debug << misc::fmt("  %lld A-%lld 0x%x %s "
+					"nc_store_lock\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->getAddress(),
+					module->getName().c_str());
+		if (trace)
+			trace << misc::fmt("mem.access "
+					"name=\"A-%lld\" "
+					"state=\"%s:nc_store_lock\"\n",
+					frame->getId(),
+					module->getName().c_str());
 
 		// If there is any older write, wait for it
 		Frame *older_frame = module->getInFlightWrite(frame);
 		if (older_frame)
 		{
 			// Debug
-			debug << misc::fmt("    A-%lld wait for store A-%lld\n",
-					frame->getId(),
-					older_frame->getId());
+			if (debug)
+				debug << misc::fmt("    A-%lld wait for store "
+						"A-%lld\n",
+						frame->getId(),
+						older_frame->getId());
 
 			// Wait for access
 			older_frame->queue.Wait(event_nc_store_lock);
@@ -767,9 +813,11 @@ void System::EventNCStoreHandler(esim::Event *event,
 		if (older_frame)
 		{
 			// Debug
-			debug << misc::fmt("    A-%lld wait for access A-%lld\n",
-					frame->getId(),
-					older_frame->getId());
+			if (debug)
+				debug << misc::fmt("    A-%lld wait for "
+						"access A-%lld\n",
+						frame->getId(),
+						older_frame->getId());
 
 			// Wait for it
 			older_frame->queue.Wait(event_nc_store_lock);
@@ -795,16 +843,19 @@ void System::EventNCStoreHandler(esim::Event *event,
 	if (event == event_nc_store_writeback)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s nc_store_writeback\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->getAddress(),
-				module->getName().c_str());
-		trace << misc::fmt("mem.access "
-				"name=\"A-%lld\" "
-				"state=\"%s:nc_store_writeback\"\n",
-				frame->getId(),
-				module->getName().c_str());
+		if (debug)
+			debug << misc::fmt("  %lld A-%lld 0x%x %s "
+					"nc_store_writeback\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->getAddress(),
+					module->getName().c_str());
+		if (trace)
+			trace << misc::fmt("mem.access "
+					"name=\"A-%lld\" "
+					"state=\"%s:nc_store_writeback\"\n",
+					frame->getId(),
+					module->getName().c_str());
 
 		// Error locking
 		if (frame->error)
@@ -813,8 +864,10 @@ void System::EventNCStoreHandler(esim::Event *event,
 			int retry_latency = module->getRetryLatency();
 
 			// Debug
-			debug << misc::fmt("    lock error, retrying in "
-					"%d cycles\n", retry_latency);
+			if (debug)
+				debug << misc::fmt("    lock error, retrying "
+						"in %d cycles\n",
+						retry_latency);
 
 			// Retry access after latency
 			frame->retry = true;
@@ -852,16 +905,19 @@ void System::EventNCStoreHandler(esim::Event *event,
 	if (event == event_nc_store_action)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s nc_store_action\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->getAddress(),
-				module->getName().c_str());
-		trace << misc::fmt("mem.access "
-				"name=\"A-%lld\" "
-				"state=\"%s:nc_store_action\"\n",
-				frame->getId(),
-				module->getName().c_str());
+		if (debug)
+			debug << misc::fmt("  %lld A-%lld 0x%x %s "
+					"nc_store_action\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->getAddress(),
+					module->getName().c_str());
+		if (trace)
+			trace << misc::fmt("mem.access "
+					"name=\"A-%lld\" "
+					"state=\"%s:nc_store_action\"\n",
+					frame->getId(),
+					module->getName().c_str());
 
 		// Error locking
 		if (frame->error)
@@ -870,8 +926,10 @@ void System::EventNCStoreHandler(esim::Event *event,
 			int retry_latency = module->getRetryLatency();
 
 			// Debug
-			debug << misc::fmt("    lock error, retrying in "
-					"%d cycles\n", retry_latency);
+			if (debug)
+				debug << misc::fmt("    lock error, retrying "
+						"in %d cycles\n",
+						retry_latency);
 
 			// Retry after latency
 			frame->retry = true;
@@ -953,16 +1011,19 @@ void System::EventNCStoreHandler(esim::Event *event,
 	if (event == event_nc_store_miss)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s nc_store_miss\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->getAddress(),
-				module->getName().c_str());
-		trace << misc::fmt("mem.access "
-				"name=\"A-%lld\" "
-				"state=\"%s:nc_store_miss\"\n",
-				frame->getId(),
-				module->getName().c_str());
+		if (debug)
+			debug << misc::fmt("  %lld A-%lld 0x%x %s "
+					"nc_store_miss\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->getAddress(),
+					module->getName().c_str());
+		if (trace)
+			trace << misc::fmt("mem.access "
+					"name=\"A-%lld\" "
+					"state=\"%s:nc_store_miss\"\n",
+					frame->getId(),
+					module->getName().c_str());
 
 		// Error on read request. Unlock block and retry nc store.
 		if (frame->error)
@@ -976,8 +1037,10 @@ void System::EventNCStoreHandler(esim::Event *event,
 					frame->getId());
 
 			// Debug
-			debug << misc::fmt("    lock error, retrying in "
-					"%d cycles\n", retry_latency);
+			if (debug)
+				debug << misc::fmt("    lock error, retrying "
+						"in %d cycles\n",
+						retry_latency);
 
 
 			// Continue with 'nc-store-lock' after latency
@@ -995,16 +1058,19 @@ void System::EventNCStoreHandler(esim::Event *event,
 	if (event == event_nc_store_unlock)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s nc_store_unlock\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->getAddress(),
-				module->getName().c_str());
-		trace << misc::fmt("mem.access "
-				"name=\"A-%lld\" "
-				"state=\"%s:nc_store_unlock\"\n",
-				frame->getId(),
-				module->getName().c_str());
+		if (debug)
+			debug << misc::fmt("  %lld A-%lld 0x%x %s "
+					"nc_store_unlock\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->getAddress(),
+					module->getName().c_str());
+		if (trace)
+			trace << misc::fmt("mem.access "
+					"name=\"A-%lld\" "
+					"state=\"%s:nc_store_unlock\"\n",
+					frame->getId(),
+					module->getName().c_str());
 
 		// Set block state to E/S depending on return var 'shared'.
 		// Also set the tag of the block.
@@ -1029,18 +1095,22 @@ void System::EventNCStoreHandler(esim::Event *event,
 	if (event == event_nc_store_finish)
 	{
 		// Debug and trace
-		debug << misc::fmt("%lld A-%lld 0x%x %s nc_store_finish\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->getAddress(),
-				module->getName().c_str());
-		trace << misc::fmt("mem.access "
-				"name=\"A-%lld\" "
-				"state=\"%s:nc_store_finish\"\n",
-				frame->getId(),
-				module->getName().c_str());
-		trace << misc::fmt("mem.end_access name=\"A-%lld\"\n",
-				frame->getId());
+		if (debug)
+			debug << misc::fmt("%lld A-%lld 0x%x %s "
+					"nc_store_finish\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->getAddress(),
+					module->getName().c_str());
+		if (trace)
+			trace << misc::fmt("mem.access "
+					"name=\"A-%lld\" "
+					"state=\"%s:nc_store_finish\"\n",
+					frame->getId(),
+					module->getName().c_str());
+		if (trace)
+			trace << misc::fmt("mem.end_access name=\"A-%lld\"\n",
+					frame->getId());
 
 		// Increment witness variable
 		if (frame->witness)
@@ -1073,18 +1143,20 @@ void System::EventFindAndLockHandler(esim::Event *event,
 	// Event "find_and_lock"
 	if (event == event_find_and_lock)
 	{
-		debug << misc::fmt("  %lld A-%lld 0x%x %s "
-				"find_and_lock (blocking=%d)\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->getAddress(),
-				module->getName().c_str(),
-				frame->blocking);
-		trace << misc::fmt("mem.access "
-				"name=\"A-%lld\" "
-				"state=\"%s:find_and_lock\"\n",
-				frame->getId(),
-				module->getName().c_str());
+		if (debug)
+			debug << misc::fmt("  %lld A-%lld 0x%x %s "
+					"find_and_lock (blocking=%d)\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->getAddress(),
+					module->getName().c_str(),
+					frame->blocking);
+		if (trace)
+			trace << misc::fmt("mem.access "
+					"name=\"A-%lld\" "
+					"state=\"%s:find_and_lock\"\n",
+					frame->getId(),
+					module->getName().c_str());
 
 		// Default return values
 		parent_frame->error = false;
@@ -1105,16 +1177,19 @@ void System::EventFindAndLockHandler(esim::Event *event,
 		assert(port);
 
 		// Debug
-		debug << misc::fmt("  %lld A-%lld 0x%x %s find_and_lock_port\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->getAddress(),
-				module->getName().c_str());
-		trace << misc::fmt("mem.access "
-				"name=\"A-%lld\" "
-				"state=\"%s:find_and_lock_port\"\n",
-				frame->getId(),
-				module->getName().c_str());
+		if (debug)
+			debug << misc::fmt("  %lld A-%lld 0x%x %s "
+					"find_and_lock_port\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->getAddress(),
+					module->getName().c_str());
+		if (trace)
+			trace << misc::fmt("mem.access "
+					"name=\"A-%lld\" "
+					"state=\"%s:find_and_lock_port\"\n",
+					frame->getId(),
+					module->getName().c_str());
 
 		// Statistics
 		module->incAccesses();
@@ -1134,15 +1209,16 @@ void System::EventFindAndLockHandler(esim::Event *event,
 				frame->state);
 		if (frame->hit)
 		{
-			debug << misc::fmt("    A-%lld 0x%x %s "
-					"hit: set=%d, way=%d, "
-					"state=%s\n",
-					frame->getId(),
-					frame->tag,
-					module->getName().c_str(),
-					frame->set,
-					frame->way,
-					Cache::BlockStateMap[frame->state]);
+			if (debug)
+				debug << misc::fmt("    A-%lld 0x%x %s hit: "
+						"set=%d, way=%d, state=%s\n",
+						frame->getId(),
+						frame->tag,
+						module->getName().c_str(),
+						frame->set,
+						frame->way,
+						Cache::BlockStateMap[
+								frame->state]);
 		}
 
 		// If a store access hits in the cache, we can be sure
@@ -1163,9 +1239,10 @@ void System::EventFindAndLockHandler(esim::Event *event,
 			// for it.
 			if (frame->request_direction == Frame::RequestDirectionDownUp)
 			{
-				debug << misc::fmt("        A-%lld "
-						"block not found",
-						frame->getId());
+				if (debug)
+					debug << misc::fmt("        A-%lld "
+							"block not found",
+							frame->getId());
 				parent_frame->block_not_found = true;
 				module->UnlockPort(port, frame);
 				parent_frame->port_locked = false;
@@ -1185,17 +1262,18 @@ void System::EventFindAndLockHandler(esim::Event *event,
 				!frame->blocking)
 		{
 			// Debug
-			debug << misc::fmt("    A-%lld 0x%x %s block locked at "
-					"set=%d, "
-					"way=%d "
-					"by A-%lld - aborting\n",
-					frame->getId(),
-					frame->tag,
-					module->getName().c_str(),
-					frame->set,
-					frame->way,
-					directory->getEntryAccessId(frame->set,
-							frame->way));
+			if (debug)
+				debug << misc::fmt("    A-%lld 0x%x %s block "
+						"locked at set=%d, way=%d by "
+						"A-%lld - aborting\n",
+						frame->getId(),
+						frame->tag,
+						module->getName().c_str(),
+						frame->set,
+						frame->way,
+						directory->getEntryAccessId(
+								frame->set,
+								frame->way));
 
 			// Return error code to parent frame
 			parent_frame->error = true;
@@ -1222,17 +1300,18 @@ void System::EventFindAndLockHandler(esim::Event *event,
 				frame->getId()))
 		{
 			// Debug
-			debug << misc::fmt("    A-%lld 0x%x %s block locked at "
-					"set=%d, "
-					"way=%d by "
-					"A-%lld - waiting\n",
-					frame->getId(), 
-					frame->tag,
-					module->getName().c_str(),
-					frame->set,
-					frame->way,
-					directory->getEntryAccessId(frame->set,
-							frame->way));
+			if (debug)
+				debug << misc::fmt("    A-%lld 0x%x %s block "
+						"locked at set=%d, way=%d by "
+						"A-%lld - waiting\n",
+						frame->getId(),
+						frame->tag,
+						module->getName().c_str(),
+						frame->set,
+						frame->way,
+						directory->getEntryAccessId(
+								frame->set,
+								frame->way));
 
 			// Unlock port
 			module->UnlockPort(port, frame);
@@ -1260,16 +1339,17 @@ void System::EventFindAndLockHandler(esim::Event *event,
 					frame->set, frame->way));
 			
 			// Debug
-			debug << misc::fmt("    A-%lld 0x%x %s miss -> lru: "
-					"set=%d, "
-					"way=%d, "
-					"state=%s\n",
-					frame->getId(),
-					frame->tag,
-					module->getName().c_str(),
-					frame->set,
-					frame->way,
-					Cache::BlockStateMap[frame->state]);
+			if (debug)
+				debug << misc::fmt("    A-%lld 0x%x %s miss "
+						"-> lru: set=%d, way=%d, "
+						"state=%s\n",
+						frame->getId(),
+						frame->tag,
+						module->getName().c_str(),
+						frame->set,
+						frame->way,
+						Cache::BlockStateMap[
+								frame->state]);
 		}
 
 		// Statistics
@@ -1298,16 +1378,19 @@ void System::EventFindAndLockHandler(esim::Event *event,
 		assert(port);
 
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s find_and_lock_action\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->tag,
-				module->getName().c_str());
-		trace << misc::fmt("mem.access "
-				"name=\"A-%lld\" "
-				"state=\"%s:find_and_lock_action\"\n",
-				frame->getId(),
-				module->getName().c_str());
+		if (debug)
+			debug << misc::fmt("  %lld A-%lld 0x%x %s "
+					"find_and_lock_action\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->tag,
+					module->getName().c_str());
+		if (trace)
+			trace << misc::fmt("mem.access "
+					"name=\"A-%lld\" "
+					"state=\"%s:find_and_lock_action\"\n",
+					frame->getId(),
+					module->getName().c_str());
 
 		// Release port
 		module->UnlockPort(port, frame);
@@ -1346,17 +1429,19 @@ void System::EventFindAndLockHandler(esim::Event *event,
 		Directory *directory = module->getDirectory();
 
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s "
-				"find_and_lock_finish (err=%d)\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->tag,
-				module->getName().c_str(),
-				frame->error);
-		trace << misc::fmt("mem.access name=\"A-%lld\" "
-				"state=\"%s:find_and_lock_finish\"\n",
-				frame->getId(),
-				module->getName().c_str());
+		if (debug)
+			debug << misc::fmt("  %lld A-%lld 0x%x %s "
+					"find_and_lock_finish (err=%d)\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->tag,
+					module->getName().c_str(),
+					frame->error);
+		if (trace)
+			trace << misc::fmt("mem.access name=\"A-%lld\" "
+					"state=\"%s:find_and_lock_finish\"\n",
+					frame->getId(),
+					module->getName().c_str());
 
 		// If evict produced error, return this error
 		if (frame->error)
@@ -1449,19 +1534,21 @@ void System::EventEvictHandler(esim::Event *event,
 				frame->set, frame->way));
 
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s evict "
-				"(set=%d, way=%d, state=%s)\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->tag,
-				module->getName().c_str(),
-				frame->set,
-				frame->way,
-				Cache::BlockStateMap[frame->state]);
-		trace << misc::fmt("mem.access name=\"A-%lld\" "
-				"state=\"%s:evict\"\n",
-				frame->getId(),
-				module->getName().c_str());
+		if (debug)
+			debug << misc::fmt("  %lld A-%lld 0x%x %s evict "
+					"(set=%d, way=%d, state=%s)\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->tag,
+					module->getName().c_str(),
+					frame->set,
+					frame->way,
+					Cache::BlockStateMap[frame->state]);
+		if (trace)
+			trace << misc::fmt("mem.access name=\"A-%lld\" "
+					"state=\"%s:evict\"\n",
+					frame->getId(),
+					module->getName().c_str());
 
 		// Save some data
 		frame->src_set = frame->set;
@@ -1488,16 +1575,19 @@ void System::EventEvictHandler(esim::Event *event,
 	if (event == event_evict_invalid)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s evict_invalid\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->tag,
-				module->getName().c_str());
-		trace << misc::fmt("mem.access "
-				"name=\"A-%lld\" "
-				"state=\"%s:evict_invalid\"\n",
-				frame->getId(),
-				module->getName().c_str());
+		if (debug)
+			debug << misc::fmt("  %lld A-%lld 0x%x %s "
+					"evict_invalid\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->tag,
+					module->getName().c_str());
+		if (trace)
+			trace << misc::fmt("mem.access "
+					"name=\"A-%lld\" "
+					"state=\"%s:evict_invalid\"\n",
+					frame->getId(),
+					module->getName().c_str());
 
 		// Update the cache state since it may have changed after its 
 		// higher-level modules were invalidated.
@@ -1527,16 +1617,19 @@ void System::EventEvictHandler(esim::Event *event,
 	if (event == event_evict_action)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s evict_action\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->tag,
-				module->getName().c_str());
-		trace << misc::fmt("mem.access "
-				"name=\"A-%lld\" "
-				"state=\"%s:evict_action\"\n",
-				frame->getId(),
-				module->getName().c_str());
+		if (debug)
+			debug << misc::fmt("  %lld A-%lld 0x%x %s "
+					"evict_action\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->tag,
+					module->getName().c_str());
+		if (trace)
+			trace << misc::fmt("mem.access "
+					"name=\"A-%lld\" "
+					"state=\"%s:evict_action\"\n",
+					frame->getId(),
+					module->getName().c_str());
 
 		// Get low node
 		Module *low_module = frame->target_module;
@@ -1578,7 +1671,7 @@ void System::EventEvictHandler(esim::Event *event,
 				message_size,
 				event_evict_receive,
 				event);
-		if (frame->message)
+		if (frame->message && net::System::trace)
 			net::System::trace << misc::fmt("net.msg_access "
 					"net=\"%s\" "
 					"name=\"M-%lld\" "
@@ -1593,16 +1686,19 @@ void System::EventEvictHandler(esim::Event *event,
 	if (event == event_evict_receive)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s evict_receive\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->tag,
-				target_module->getName().c_str());
-		trace << misc::fmt("mem.access "
-				"name=\"A-%lld\" "
-				"state=\"%s:evict_receive\"\n",
-				frame->getId(),
-				target_module->getName().c_str());
+		if (debug)
+			debug << misc::fmt("  %lld A-%lld 0x%x %s "
+					"evict_receive\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->tag,
+					target_module->getName().c_str());
+		if (trace)
+			trace << misc::fmt("mem.access "
+					"name=\"A-%lld\" "
+					"state=\"%s:evict_receive\"\n",
+					frame->getId(),
+					target_module->getName().c_str());
 
 		// Receive message
 		net::Network *network = target_module->getHighNetwork();
@@ -1633,16 +1729,19 @@ void System::EventEvictHandler(esim::Event *event,
 	if (event == event_evict_process)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s evict_process\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->tag,
-				target_module->getName().c_str());
-		trace << misc::fmt("mem.access "
-				"name=\"A-%lld\" "
-				"state=\"%s:evict_process\"\n",
-				frame->getId(),
-				target_module->getName().c_str());
+		if (debug)
+			debug << misc::fmt("  %lld A-%lld 0x%x %s "
+					"evict_process\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->tag,
+					target_module->getName().c_str());
+		if (trace)
+			trace << misc::fmt("mem.access "
+					"name=\"A-%lld\" "
+					"state=\"%s:evict_process\"\n",
+					frame->getId(),
+					target_module->getName().c_str());
 
 		// Error locking block
 		if (frame->error)
@@ -1718,6 +1817,12 @@ void System::EventEvictHandler(esim::Event *event,
 		// Stats
 		target_module->incDataAccesses();
 
+		// Write back received data in DRAM. The write is posted, so
+		// the eviction does not wait for it to complete.
+		if (target_module->getDramController() &&
+				frame->reply == Frame::ReplyAckData)
+			target_module->AccessDram(true, frame->tag);
+
 		// Continue with 'evict-reply', after data latency
 		esim_engine->Next(event_evict_reply,
 				target_module->getDataLatency());
@@ -1728,17 +1833,20 @@ void System::EventEvictHandler(esim::Event *event,
 	if (event == event_evict_process_noncoherent)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s "
-				"evict_process_noncoherent\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->tag,
-				target_module->getName().c_str());
-		trace << misc::fmt("mem.access "
-				"name=\"A-%lld\" "
-				"state=\"%s:evict_process_noncoherent\"\n",
-				frame->getId(),
-				target_module->getName().c_str());
+		if (debug)
+			debug << misc::fmt("  %lld A-%lld 0x%x %s "
+					"evict_process_noncoherent\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->tag,
+					target_module->getName().c_str());
+		if (trace)
+			trace << misc::fmt("mem.access "
+					"name=\"A-%lld\" "
+					"state=\"%s:"
+					"evict_process_noncoherent\"\n",
+					frame->getId(),
+					target_module->getName().c_str());
 
 		// Error locking block
 		if (frame->error)
@@ -1825,6 +1933,11 @@ void System::EventEvictHandler(esim::Event *event,
 
 		// Stats
 		target_module->incDataAccesses();
+
+		// Write back received data in DRAM, posted
+		if (target_module->getDramController() &&
+				frame->reply == Frame::ReplyAckData)
+			target_module->AccessDram(true, frame->tag);
 		
 		// Continue with 'evict-reply' after latency
 		esim_engine->Next(event_evict_reply,
@@ -1836,17 +1949,19 @@ void System::EventEvictHandler(esim::Event *event,
 	if (event == event_evict_reply)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s "
-				"evict_reply\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->tag,
-				target_module->getName().c_str());
-		trace << misc::fmt("mem.access "
-				"name=\"A-%lld\" "
-				"state=\"%s:evict_reply\"\n",
-				frame->getId(),
-				target_module->getName().c_str());
+		if (debug)
+			debug << misc::fmt("  %lld A-%lld 0x%x %s "
+					"evict_reply\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->tag,
+					target_module->getName().c_str());
+		if (trace)
+			trace << misc::fmt("mem.access "
+					"name=\"A-%lld\" "
+					"state=\"%s:evict_reply\"\n",
+					frame->getId(),
+					target_module->getName().c_str());
 
 		// Send message
 		net::Network *network = target_module->getHighNetwork();
@@ -1857,7 +1972,7 @@ void System::EventEvictHandler(esim::Event *event,
 				8,
 				event_evict_reply_receive,
 				event);
-		if (frame->message)
+		if (frame->message && net::System::trace)
 			net::System::trace << misc::fmt("net.msg_access "
 					"net=\"%s\" "
 					"name=\"M-%lld\" "
@@ -1872,17 +1987,19 @@ void System::EventEvictHandler(esim::Event *event,
 	if (event == event_evict_reply_receive)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s "
-				"evict_reply_receive\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->tag,
-				module->getName().c_str());
-		trace << misc::fmt("mem.access "
-				"name=\"A-%lld\" "
-				"state=\"%s:evict_reply_receive\"\n",
-				frame->getId(),
-				module->getName().c_str());
+		if (debug)
+			debug << misc::fmt("  %lld A-%lld 0x%x %s "
+					"evict_reply_receive\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->tag,
+					module->getName().c_str());
+		if (trace)
+			trace << misc::fmt("mem.access "
+					"name=\"A-%lld\" "
+					"state=\"%s:evict_reply_receive\"\n",
+					frame->getId(),
+					module->getName().c_str());
 
 		// Receive message
 		net::Network *network = module->getLowNetwork();
@@ -1908,16 +2025,19 @@ void System::EventEvictHandler(esim::Event *event,
 	if (event == event_evict_finish)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s evict_finish\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->tag,
-				module->getName().c_str());
-		trace << misc::fmt("mem.access "
-				"name=\"A-%lld\" "
-				"state=\"%s:evict_finish\"\n",
-				frame->getId(),
-				module->getName().c_str());
+		if (debug)
+			debug << misc::fmt("  %lld A-%lld 0x%x %s "
+					"evict_finish\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->tag,
+					module->getName().c_str());
+		if (trace)
+			trace << misc::fmt("mem.access "
+					"name=\"A-%lld\" "
+					"state=\"%s:evict_finish\"\n",
+					frame->getId(),
+					module->getName().c_str());
 
 		// Return
 		esim_engine->Return();
@@ -1945,16 +2065,19 @@ void System::EventWriteRequestHandler(esim::Event *event,
 	if (event == event_write_request)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s write_request\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->getAddress(),
-				module->getName().c_str());
-		trace << misc::fmt("mem.access "
-				"name=\"A-%lld\" "
-				"state=\"%s:write_request\"\n",
-				frame->getId(),
-				module->getName().c_str());
+		if (debug)
+			debug << misc::fmt("  %lld A-%lld 0x%x %s "
+					"write_request\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->getAddress(),
+					module->getName().c_str());
+		if (trace)
+			trace << misc::fmt("mem.access "
+					"name=\"A-%lld\" "
+					"state=\"%s:write_request\"\n",
+					frame->getId(),
+					module->getName().c_str());
 
 		// Default return values
 		parent_frame->error = false;
@@ -1989,7 +2112,7 @@ void System::EventWriteRequestHandler(esim::Event *event,
 				8,
 				event_write_request_receive,
 				event);
-		if (frame->message)
+		if (frame->message && net::System::trace)
 			net::System::trace << misc::fmt("net.msg_access "
 					"net=\"%s\" "
 					"name=\"M-%lld\" "
@@ -2004,17 +2127,19 @@ void System::EventWriteRequestHandler(esim::Event *event,
 	if (event == event_write_request_receive)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s "
-				"write_request_receive\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->getAddress(),
-				target_module->getName().c_str());
-		trace << misc::fmt("mem.access "
-				"name=\"A-%lld\" "
-				"state=\"%s:write_request_receive\"\n",
-				frame->getId(),
-				target_module->getName().c_str());
+		if (debug)
+			debug << misc::fmt("  %lld A-%lld 0x%x %s "
+					"write_request_receive\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->getAddress(),
+					target_module->getName().c_str());
+		if (trace)
+			trace << misc::fmt("mem.access "
+					"name=\"A-%lld\" "
+					"state=\"%s:write_request_receive\"\n",
+					frame->getId(),
+					target_module->getName().c_str());
 
 		// Receive message
 		net::Network *network;
@@ -2051,16 +2176,19 @@ void System::EventWriteRequestHandler(esim::Event *event,
 	if (event == event_write_request_action)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s write_request_action\n", 
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->tag,
-				target_module->getName().c_str());
-		trace << misc::fmt("mem.access "
-				"name=\"A-%lld\" "
-				"state=\"%s:write_request_action\"\n",
-				frame->getId(),
-				target_module->getName().c_str());
+		if (debug)
+			debug << misc::fmt("  %lld A-%lld 0x%x %s "
+					"write_request_action\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->tag,
+					target_module->getName().c_str());
+		if (trace)
+			trace << misc::fmt("mem.access "
+					"name=\"A-%lld\" "
+					"state=\"%s:write_request_action\"\n",
+					frame->getId(),
+					target_module->getName().c_str());
 
 		// Check lock error. If write request is down-up, there should
 		// have been no error.
@@ -2122,17 +2250,20 @@ void System::EventWriteRequestHandler(esim::Event *event,
 	if (event == event_write_request_exclusive)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s "
-				"write_request_exclusive\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->tag,
-				target_module->getName().c_str());
-		trace << misc::fmt("mem.access "
-				"name=\"A-%lld\" "
-				"state=\"%s:write_request_exclusive\"\n",
-				frame->getId(),
-				target_module->getName().c_str());
+		if (debug)
+			debug << misc::fmt("  %lld A-%lld 0x%x %s "
+					"write_request_exclusive\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->tag,
+					target_module->getName().c_str());
+		if (trace)
+			trace << misc::fmt("mem.access "
+					"name=\"A-%lld\" "
+					"state=\"%s:"
+					"write_request_exclusive\"\n",
+					frame->getId(),
+					target_module->getName().c_str());
 
 		// Continue with 'write-request-updown' or
 		// 'write-request-downup', depending on direction.
@@ -2147,16 +2278,19 @@ void System::EventWriteRequestHandler(esim::Event *event,
 	if (event == event_write_request_updown)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s write_request_updown\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->tag,
-				target_module->getName().c_str());
-		trace << misc::fmt("mem.access "
-				"name=\"A-%lld\" "
-				"state=\"%s:write_request_updown\"\n",
-				frame->getId(),
-				target_module->getName().c_str());
+		if (debug)
+			debug << misc::fmt("  %lld A-%lld 0x%x %s "
+					"write_request_updown\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->tag,
+					target_module->getName().c_str());
+		if (trace)
+			trace << misc::fmt("mem.access "
+					"name=\"A-%lld\" "
+					"state=\"%s:write_request_updown\"\n",
+					frame->getId(),
+					target_module->getName().c_str());
 
 		// Check state
 		switch (frame->state)
@@ -2212,17 +2346,20 @@ void System::EventWriteRequestHandler(esim::Event *event,
 	if (event == event_write_request_updown_finish)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s "
-				"write_request_updown_finish\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->tag,
-				target_module->getName().c_str());
-		trace << misc::fmt("mem.access "
-				"name=\"A-%lld\" "
-				"state=\"%s:write_request_updown_finish\"\n",
-				frame->getId(),
-				target_module->getName().c_str());
+		if (debug)
+			debug << misc::fmt("  %lld A-%lld 0x%x %s "
+					"write_request_updown_finish\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->tag,
+					target_module->getName().c_str());
+		if (trace)
+			trace << misc::fmt("mem.access "
+					"name=\"A-%lld\" "
+					"state=\"%s:"
+					"write_request_updown_finish\"\n",
+					frame->getId(),
+					target_module->getName().c_str());
 
 		// Ensure that a reply was received
 		assert(frame->reply);
@@ -2275,7 +2412,8 @@ void System::EventWriteRequestHandler(esim::Event *event,
 					frame->way,
 					z,
 					index);
-			assert(entry->getNumSharers() == 1);
+			assert(entry->getNumSharers() == 1 ||
+					!target_directory->isPrecise());
 		}
 
 		// Set state to E
@@ -2303,6 +2441,16 @@ void System::EventWriteRequestHandler(esim::Event *event,
 		// Stats
 		target_module->incDataAccesses();
 
+		// Read data from DRAM if it must be sent up, and continue with
+		// 'write-request-reply' when the read completes
+		if (target_module->getDramController() &&
+				frame->reply_size > 8)
+		{
+			target_module->AccessDram(false, frame->tag,
+					event_write_request_reply);
+			return;
+		}
+
 		// Continue with 'write-request-reply' after data latency
 		esim_engine->Next(event_write_request_reply,
 				target_module->getDataLatency());
@@ -2313,16 +2461,19 @@ void System::EventWriteRequestHandler(esim::Event *event,
 	if (event == event_write_request_downup)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s write_request_downup\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->tag,
-				target_module->getName().c_str());
-		trace << misc::fmt("mem.access "
-				"name=\"A-%lld\" "
-				"state=\"%s:write_request_downup\"\n",
-				frame->getId(),
-				target_module->getName().c_str());
+		if (debug)
+			debug << misc::fmt("  %lld A-%lld 0x%x %s "
+					"write_request_downup\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->tag,
+					target_module->getName().c_str());
+		if (trace)
+			trace << misc::fmt("mem.access "
+					"name=\"A-%lld\" "
+					"state=\"%s:write_request_downup\"\n",
+					frame->getId(),
+					target_module->getName().c_str());
 
 		// Sanity
 		assert(frame->state != Cache::BlockInvalid);
@@ -2365,17 +2516,20 @@ void System::EventWriteRequestHandler(esim::Event *event,
 	if (event == event_write_request_downup_finish)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s "
-				"write_request_downup_finish\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->tag,
-				target_module->getName().c_str());
-		trace << misc::fmt("mem.access "
-				"name=\"A-%lld\" "
-				"state=\"%s:write_request_downup_finish\"\n",
-				frame->getId(),
-				target_module->getName().c_str());
+		if (debug)
+			debug << misc::fmt("  %lld A-%lld 0x%x %s "
+					"write_request_downup_finish\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->tag,
+					target_module->getName().c_str());
+		if (trace)
+			trace << misc::fmt("mem.access "
+					"name=\"A-%lld\" "
+					"state=\"%s:"
+					"write_request_downup_finish\"\n",
+					frame->getId(),
+					target_module->getName().c_str());
 
 		// Set state to I
 		target_cache->setBlock(frame->set, frame->way, 0,
@@ -2420,18 +2574,20 @@ void System::EventWriteRequestHandler(esim::Event *event,
 	if (event == event_write_request_reply)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s "
-				"write_request_reply (size=%d)\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->tag,
-				target_module->getName().c_str(),
-				frame->reply_size);
-		trace << misc::fmt("mem.access "
-				"name=\"A-%lld\" "
-				"state=\"%s:write_request_reply\"\n",
-				frame->getId(),
-				target_module->getName().c_str());
+		if (debug)
+			debug << misc::fmt("  %lld A-%lld 0x%x %s "
+					"write_request_reply (size=%d)\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->tag,
+					target_module->getName().c_str(),
+					frame->reply_size);
+		if (trace)
+			trace << misc::fmt("mem.access "
+					"name=\"A-%lld\" "
+					"state=\"%s:write_request_reply\"\n",
+					frame->getId(),
+					target_module->getName().c_str());
 
 		// Sanity
 		assert(frame->reply_size);
@@ -2461,7 +2617,7 @@ void System::EventWriteRequestHandler(esim::Event *event,
 				frame->reply_size,
 				event_write_request_finish,
 				event);
-		if (frame->message)
+		if (frame->message && net::System::trace)
 			net::System::trace << misc::fmt("net.msg_access "
 					"net=\"%s\" "
 					"name=\"M-%lld\" "
@@ -2476,17 +2632,19 @@ void System::EventWriteRequestHandler(esim::Event *event,
 	if (event == event_write_request_finish)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s "
-				"write_request_finish\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->tag,
-				module->getName().c_str());
-		trace << misc::fmt("mem.access "
-				"name=\"A-%lld\" "
-				"state=\"%s:write_request_finish\"\n",
-				frame->getId(),
-				module->getName().c_str());
+		if (debug)
+			debug << misc::fmt("  %lld A-%lld 0x%x %s "
+					"write_request_finish\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->tag,
+					module->getName().c_str());
+		if (trace)
+			trace << misc::fmt("mem.access "
+					"name=\"A-%lld\" "
+					"state=\"%s:write_request_finish\"\n",
+					frame->getId(),
+					module->getName().c_str());
 
 		// Receive message
 		net::Network *network;
@@ -2537,16 +2695,19 @@ void System::EventReadRequestHandler(esim::Event *event,
 	if (event == event_read_request)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s read_request\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->getAddress(),
-				module->getName().c_str());
-		trace << misc::fmt("mem.access "
-				"name=\"A-%lld\" "
-				"state=\"%s:read_request\"\n",
-				frame->getId(),
-				module->getName().c_str());
+		if (debug)
+			debug << misc::fmt("  %lld A-%lld 0x%x %s "
+					"read_request\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->getAddress(),
+					module->getName().c_str());
+		if (trace)
+			trace << misc::fmt("mem.access "
+					"name=\"A-%lld\" "
+					"state=\"%s:read_request\"\n",
+					frame->getId(),
+					module->getName().c_str());
 
 		// Default return values
 		parent_frame->shared = false;
@@ -2586,7 +2747,7 @@ void System::EventReadRequestHandler(esim::Event *event,
 				8,
 				event_read_request_receive,
 				event);
-		if (frame->message)
+		if (frame->message && net::System::trace)
 			net::System::trace << misc::fmt("net.msg_access "
 					"net=\"%s\" "
 					"name=\"M-%lld\" "
@@ -2601,16 +2762,19 @@ void System::EventReadRequestHandler(esim::Event *event,
 	if (event == event_read_request_receive)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s read_request_receive\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->getAddress(),
-				target_module->getName().c_str());
-		trace << misc::fmt("mem.access "
-				"name=\"A-%lld\" "
-				"state=\"%s:read_request_receive\"\n",
-				frame->getId(),
-				target_module->getName().c_str());
+		if (debug)
+			debug << misc::fmt("  %lld A-%lld 0x%x %s "
+					"read_request_receive\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->getAddress(),
+					target_module->getName().c_str());
+		if (trace)
+			trace << misc::fmt("mem.access "
+					"name=\"A-%lld\" "
+					"state=\"%s:read_request_receive\"\n",
+					frame->getId(),
+					target_module->getName().c_str());
 
 		// Receive message
 		if (frame->request_direction == Frame::RequestDirectionUpDown)
@@ -2651,16 +2815,19 @@ void System::EventReadRequestHandler(esim::Event *event,
 	if (event == event_read_request_action)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s read_request_action\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->tag,
-				target_module->getName().c_str());
-		trace << misc::fmt("mem.access "
-				"name=\"A-%lld\" "
-				"state=\"%s:read_request_action\"\n",
-				frame->getId(),
-				target_module->getName().c_str());
+		if (debug)
+			debug << misc::fmt("  %lld A-%lld 0x%x %s "
+					"read_request_action\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->tag,
+					target_module->getName().c_str());
+		if (trace)
+			trace << misc::fmt("mem.access "
+					"name=\"A-%lld\" "
+					"state=\"%s:read_request_action\"\n",
+					frame->getId(),
+					target_module->getName().c_str());
 
 		// Check block locking error. If read request is down-up, 
 		// there should not have been any error while locking.
@@ -2705,16 +2872,19 @@ void System::EventReadRequestHandler(esim::Event *event,
 	if (event == event_read_request_updown)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s read_request_updown\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->tag,
-				target_module->getName().c_str());
-		trace << misc::fmt("mem.access "
-				"name=\"A-%lld\" "
-				"state=\"%s:read_request_updown\"\n",
-				frame->getId(),
-				target_module->getName().c_str());
+		if (debug)
+			debug << misc::fmt("  %lld A-%lld 0x%x %s "
+					"read_request_updown\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->tag,
+					target_module->getName().c_str());
+		if (trace)
+			trace << misc::fmt("mem.access "
+					"name=\"A-%lld\" "
+					"state=\"%s:read_request_updown\"\n",
+					frame->getId(),
+					target_module->getName().c_str());
 
 		// One pending request initially
 		frame->pending = 1;
@@ -2807,17 +2977,20 @@ void System::EventReadRequestHandler(esim::Event *event,
 	if (event == event_read_request_updown_miss)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s "
-				"read_request_updown_miss\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->tag,
-				target_module->getName().c_str());
-		trace << misc::fmt("mem.access "
-				"name=\"A-%lld\" "
-				"state=\"%s:read_request_updown_miss\"\n",
-				frame->getId(),
-				target_module->getName().c_str());
+		if (debug)
+			debug << misc::fmt("  %lld A-%lld 0x%x %s "
+					"read_request_updown_miss\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->tag,
+					target_module->getName().c_str());
+		if (trace)
+			trace << misc::fmt("mem.access "
+					"name=\"A-%lld\" "
+					"state=\"%s:"
+					"read_request_updown_miss\"\n",
+					frame->getId(),
+					target_module->getName().c_str());
 
 		// Check error
 		if (frame->error)
@@ -2865,17 +3038,20 @@ void System::EventReadRequestHandler(esim::Event *event,
 			return;
 
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s "
-				"read_request_updown_finish\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->tag,
-				target_module->getName().c_str());
-		trace << misc::fmt("mem.access "
-				"name=\"A-%lld\" "
-				"state=\"%s:read_request_updown_finish\"\n",
-				frame->getId(),
-				target_module->getName().c_str());
+		if (debug)
+			debug << misc::fmt("  %lld A-%lld 0x%x %s "
+					"read_request_updown_finish\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->tag,
+					target_module->getName().c_str());
+		if (trace)
+			trace << misc::fmt("mem.access "
+					"name=\"A-%lld\" "
+					"state=\"%s:"
+					"read_request_updown_finish\"\n",
+					frame->getId(),
+					target_module->getName().c_str());
 
 		// If blocks were sent directly to the peer, the reply size
 		// would have been decreased.  Based on the final size, we can
@@ -2977,6 +3153,16 @@ void System::EventReadRequestHandler(esim::Event *event,
 		// Stats
 		target_module->incDataAccesses();
 
+		// Read data from DRAM if it must be sent up, and continue with
+		// 'read-request-reply' when the read completes
+		if (target_module->getDramController() &&
+				frame->reply_size > 8)
+		{
+			target_module->AccessDram(false, frame->tag,
+					event_read_request_reply);
+			return;
+		}
+
 		// Continue with 'read-request-reply' after latency
 		esim_engine->Next(event_read_request_reply,
 				target_module->getDataLatency());
@@ -2987,16 +3173,19 @@ void System::EventReadRequestHandler(esim::Event *event,
 	if (event == event_read_request_downup)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s read_request_downup\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->tag,
-				target_module->getName().c_str());
-		trace << misc::fmt("mem.access "
-				"name=\"A-%lld\" "
-				"state=\"%s:read_request_downup\"\n",
-				frame->getId(),
-				target_module->getName().c_str());
+		if (debug)
+			debug << misc::fmt("  %lld A-%lld 0x%x %s "
+					"read_request_downup\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->tag,
+					target_module->getName().c_str());
+		if (trace)
+			trace << misc::fmt("mem.access "
+					"name=\"A-%lld\" "
+					"state=\"%s:read_request_downup\"\n",
+					frame->getId(),
+					target_module->getName().c_str());
 
 		// Check: state must not be invalid or shared. By default, only
 		// one pending request. Response depends on state.
@@ -3061,17 +3250,20 @@ void System::EventReadRequestHandler(esim::Event *event,
 			return;
 		
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s "
-				"read_request_downup_finish\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->tag,
-				target_module->getName().c_str());
-		trace << misc::fmt("mem.access "
-				"name=\"A-%lld\" "
-				"state=\"%s:read_request_downup_finish\"\n",
-				frame->getId(),
-				target_module->getName().c_str());
+		if (debug)
+			debug << misc::fmt("  %lld A-%lld 0x%x %s "
+					"read_request_downup_finish\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->tag,
+					target_module->getName().c_str());
+		if (trace)
+			trace << misc::fmt("mem.access "
+					"name=\"A-%lld\" "
+					"state=\"%s:"
+					"read_request_downup_finish\"\n",
+					frame->getId(),
+					target_module->getName().c_str());
 
 		// Check reply type
 		switch (frame->reply)
@@ -3183,18 +3375,20 @@ void System::EventReadRequestHandler(esim::Event *event,
 	if (event == event_read_request_reply)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s "
-				"read_request_reply (size=%d)\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->tag,
-				target_module->getName().c_str(),
-				frame->reply_size);
-		trace << misc::fmt("mem.access "
-				"name=\"A-%lld\" "
-				"state=\"%s:read_request_reply\"\n",
-				frame->getId(),
-				target_module->getName().c_str());
+		if (debug)
+			debug << misc::fmt("  %lld A-%lld 0x%x %s "
+					"read_request_reply (size=%d)\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->tag,
+					target_module->getName().c_str(),
+					frame->reply_size);
+		if (trace)
+			trace << misc::fmt("mem.access "
+					"name=\"A-%lld\" "
+					"state=\"%s:read_request_reply\"\n",
+					frame->getId(),
+					target_module->getName().c_str());
 
 		// Checks
 		assert(frame->reply_size);
@@ -3228,7 +3422,7 @@ void System::EventReadRequestHandler(esim::Event *event,
 				frame->reply_size,
 				event_read_request_finish,
 				event);
-		if (frame->message)
+		if (frame->message && net::System::trace)
 			net::System::trace << misc::fmt("net.msg_access "
 					"net=\"%s\" "
 					"name=\"M-%lld\" "
@@ -3243,17 +3437,19 @@ void System::EventReadRequestHandler(esim::Event *event,
 	if (event == event_read_request_finish)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s "
-				"read_request_finish\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->tag,
-				module->getName().c_str());
-		trace << misc::fmt("mem.access "
-				"name=\"A-%lld\" "
-				"state=\"%s:read_request_finish\"\n",
-				frame->getId(),
-				module->getName().c_str());
+		if (debug)
+			debug << misc::fmt("  %lld A-%lld 0x%x %s "
+					"read_request_finish\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->tag,
+					module->getName().c_str());
+		if (trace)
+			trace << misc::fmt("mem.access "
+					"name=\"A-%lld\" "
+					"state=\"%s:read_request_finish\"\n",
+					frame->getId(),
+					module->getName().c_str());
 
 		// Receive message
 		net::Network *network;
@@ -3299,23 +3495,33 @@ void System::EventInvalidateHandler(esim::Event *event,
 		frame->tag = tag;
 
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s invalidate "
-				"(set=%d, way=%d, state=%s)\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->tag,
-				module->getName().c_str(),
-				frame->set,
-				frame->way,
-				Cache::BlockStateMap[frame->state]);
-		trace << misc::fmt("mem.access name=\"A-%lld\" "
-				"state=\"%s:invalidate\"\n",
-				frame->getId(),
-				module->getName().c_str());
+		if (debug)
+			debug << misc::fmt("  %lld A-%lld 0x%x %s invalidate "
+					"(set=%d, way=%d, state=%s)\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->tag,
+					module->getName().c_str(),
+					frame->set,
+					frame->way,
+					Cache::BlockStateMap[frame->state]);
+		if (trace)
+			trace << misc::fmt("mem.access name=\"A-%lld\" "
+					"state=\"%s:invalidate\"\n",
+					frame->getId(),
+					module->getName().c_str());
 
 		// At least one pending reply
 		frame->pending = 1;
 		
+		// Node of 'except_module' in the high network, if it is an
+		// upper-level module. For down-up requests, 'except_module' is
+		// the lower-level module that sent the request.
+		int except_node = Directory::NoOwner;
+		if (frame->except_module &&
+				module->isHighModule(frame->except_module))
+			except_node = module->getSharerIndex(frame->except_module);
+
 		// Send write request to all upper level sharers except
 		// 'except_module'.
 		for (int z = 0; z < directory->getNumSubBlocks(); z++)
@@ -3352,11 +3558,13 @@ void System::EventInvalidateHandler(esim::Event *event,
 				if (sharer == frame->except_module)
 					continue;
 
-				// Clear sharer and owner
-				directory->clearSharer(frame->set,
-						frame->way,
-						z,
-						i);
+				// Imprecise directories can report nodes other
+				// than upper-level modules as sharers
+				if (!directory->isPrecise() &&
+						(!sharer || !module->isHighModule(sharer)))
+					continue;
+
+				// Clear owner
 				if (directory_entry->getOwner() == i)
 					directory->setOwner(frame->set,
 							frame->way,
@@ -3384,6 +3592,12 @@ void System::EventInvalidateHandler(esim::Event *event,
 						new_frame,
 						event_invalidate_finish);
 			}
+
+			// Clear all sharers except 'except_module'
+			directory->clearAllSharersExcept(frame->set,
+					frame->way,
+					z,
+					except_node);
 		}
 
 		// Continue with 'invalidate-finish' event
@@ -3395,16 +3609,19 @@ void System::EventInvalidateHandler(esim::Event *event,
 	if (event == event_invalidate_finish)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s invalidate_finish\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->tag,
-				module->getName().c_str());
-		trace << misc::fmt("mem.access "
-				"name=\"A-%lld\" "
-				"state=\"%s:invalidate_finish\"\n",
-				frame->getId(),
-				module->getName().c_str());
+		if (debug)
+			debug << misc::fmt("  %lld A-%lld 0x%x %s "
+					"invalidate_finish\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->tag,
+					module->getName().c_str());
+		if (trace)
+			trace << misc::fmt("mem.access "
+					"name=\"A-%lld\" "
+					"state=\"%s:invalidate_finish\"\n",
+					frame->getId(),
+					module->getName().c_str());
 
 		// TODO The following line updates the block state.  We must
 		// be sure that the directory entry is always locked if we
@@ -3470,12 +3687,13 @@ void System::EventMessageHandler(esim::Event *event,
 	if (event == event_message)
 	{
 		// Memory debug
-		debug << misc::fmt("  %lld A-%lld 0x%x %s "
-				"message\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->tag,
-				module->getName().c_str());
+		if (debug)
+			debug << misc::fmt("  %lld A-%lld 0x%x %s "
+					"message\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->tag,
+					module->getName().c_str());
 
 		// Set reply
 		frame->reply_size = 8;
@@ -3501,7 +3719,7 @@ void System::EventMessageHandler(esim::Event *event,
 				event);
 
 		// Trace
-		if (frame->message)
+		if (frame->message && net::System::trace)
 			net::System::trace << misc::fmt("net.msg_access "
 					"net=\"%s\" "
 					"name=\"M-%lld\" "
@@ -3517,12 +3735,13 @@ void System::EventMessageHandler(esim::Event *event,
 	if (event == event_message_receive)
 	{
 		// Memory debug
-		debug << misc::fmt("  %lld A-%lld 0x%x %s "
-				"message_receive\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->tag,
-				module->getName().c_str());
+		if (debug)
+			debug << misc::fmt("  %lld A-%lld 0x%x %s "
+					"message_receive\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->tag,
+					module->getName().c_str());
 
 		// Receive message
 		net::Network *network = target_module->getHighNetwork();
@@ -3550,17 +3769,19 @@ void System::EventMessageHandler(esim::Event *event,
 	if (event == event_message_action)
 	{
 		// Memory debug
-		debug << misc::fmt("  %lld A-%lld 0x%x %s "
-				"message_action\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->tag,
-				module->getName().c_str());
+		if (debug)
+			debug << misc::fmt("  %lld A-%lld 0x%x %s "
+					"message_action\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->tag,
+					module->getName().c_str());
 		// Checks
 		assert(frame->message);
 
 		// Check block locking error
-		debug << misc::fmt("frame error = %u\n", frame->error);
+		if (debug)
+			debug << misc::fmt("frame error = %u\n", frame->error);
 		if (frame->error)
 		{
 			parent_frame->error = true;
@@ -3611,13 +3832,14 @@ void System::EventMessageHandler(esim::Event *event,
 	if (event == event_message_reply)
 	{
 		// Memory debug
-		debug << misc::fmt("  %lld A-%lld 0x%x %s "
-				"message_reply (size=%d)\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->tag,
-				module->getName().c_str(),
-				frame->reply_size);
+		if (debug)
+			debug << misc::fmt("  %lld A-%lld 0x%x %s "
+					"message_reply (size=%d)\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->tag,
+					module->getName().c_str(),
+					frame->reply_size);
 
 		// Get source and destination node
 		net::Network *network = module->getLowNetwork();
@@ -3633,7 +3855,7 @@ void System::EventMessageHandler(esim::Event *event,
 				event);
 
 		// Trace
-		if (frame->message)
+		if (frame->message && net::System::trace)
 			net::System::trace << misc::fmt("net.msg_access "
 					"net=\"%s\" "
 					"name=\"M-%lld\" "
@@ -3648,12 +3870,13 @@ void System::EventMessageHandler(esim::Event *event,
 	if (event == event_message_finish)
 	{
 		// Memory debug
-		debug << misc::fmt("  %lld A-%lld 0x%x %s "
-				"message_finish\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->tag,
-				module->getName().c_str());
+		if (debug)
+			debug << misc::fmt("  %lld A-%lld 0x%x %s "
+					"message_finish\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->tag,
+					module->getName().c_str());
 
 		// Receive message
 		net::Network *network = module->getLowNetwork();
@@ -3682,22 +3905,24 @@ void System::EventFlushHandler(esim::Event *event,
 	if (event == event_flush)
 	{
 		// Memory debug
-		debug << misc::fmt("  %lld A-%lld 0x%x %s "
-				"flush\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->getAddress(),
-				module->getName().c_str());
+		if (debug)
+			debug << misc::fmt("  %lld A-%lld 0x%x %s "
+					"flush\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->getAddress(),
+					module->getName().c_str());
 
 		// Trace
-		trace << misc::fmt("mem.new_access "
-				"name=\"A-%lld\" "
-				"type=\"flush\" "
-				"state=\"%s:flush\" "
-				"addr=0x%x\n",
-				frame->getId(),
-				module->getName().c_str(),
-				frame->getAddress());
+		if (trace)
+			trace << misc::fmt("mem.new_access "
+					"name=\"A-%lld\" "
+					"type=\"flush\" "
+					"state=\"%s:flush\" "
+					"addr=0x%x\n",
+					frame->getId(),
+					module->getName().c_str(),
+					frame->getAddress());
 
 		// Set pending replies to 1
 		frame->pending = 1;
@@ -3722,8 +3947,9 @@ void System::EventFlushHandler(esim::Event *event,
 			return;
 
 		// Trace
-		trace << misc::fmt("mem.end_access name=\"A-%lld\"\n",
-				frame->getId());
+		if (trace)
+			trace << misc::fmt("mem.end_access name=\"A-%lld\"\n",
+					frame->getId());
 
 		// Increment the witness pointer if one was provided
 		if (frame->witness)
@@ -3750,19 +3976,21 @@ void System::EventLocalLoadHandler(esim::Event *event,
 	if (event == event_local_load)
 	{
 		// Memory debug
-		debug << misc::fmt("%lld A-%lld 0x%x %s local_load\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->getAddress(),
-				module->getName().c_str());
+		if (debug)
+			debug << misc::fmt("%lld A-%lld 0x%x %s local_load\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->getAddress(),
+					module->getName().c_str());
 		// Trace
-		trace << misc::fmt("mem.new_access "
-				"name=\"A-%lld\" "
-				"type=\"store\" "
-				"state=\"%s:store\" addr=0x%x\n",
-				frame->getId(),
-				module->getName().c_str(),
-				frame->getAddress());
+		if (trace)
+			trace << misc::fmt("mem.new_access "
+					"name=\"A-%lld\" "
+					"type=\"store\" "
+					"state=\"%s:store\" addr=0x%x\n",
+					frame->getId(),
+					module->getName().c_str(),
+					frame->getAddress());
 
 		// Record access
 		module->StartAccess(frame, Module::AccessLoad);
@@ -3791,24 +4019,29 @@ void System::EventLocalLoadHandler(esim::Event *event,
 	// Event "local_load_lock"
 	if (event == event_local_load_lock)
 	{
-		debug << misc::fmt("  %lld A-%lld 0x%x %s local_load_lock\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->getAddress(),
-				module->getName().c_str());
-		trace << misc::fmt("mem.access "
-				"name=\"A-%lld\" "
-				"state=\"%s:load_lock\"\n",
-				frame->getId(),
-				module->getName().c_str());
+		if (debug)
+			debug << misc::fmt("  %lld A-%lld 0x%x %s "
+					"local_load_lock\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->getAddress(),
+					module->getName().c_str());
+		if (trace)
+			trace << misc::fmt("mem.access "
+					"name=\"A-%lld\" "
+					"state=\"%s:load_lock\"\n",
+					frame->getId(),
+					module->getName().c_str());
 
 		// If there is any older write, wait for it
 		Frame *older_frame = module->getInFlightWrite(frame);
 		if (older_frame)
 		{
-			debug << misc::fmt("    A-%lld wait for write A-%lld\n",
-					frame->getId(),
-					older_frame->getId());
+			if (debug)
+				debug << misc::fmt("    A-%lld wait for write "
+						"A-%lld\n",
+						frame->getId(),
+						older_frame->getId());
 			older_frame->queue.Wait(event_local_load_lock);
 			return;
 		}
@@ -3820,9 +4053,11 @@ void System::EventLocalLoadHandler(esim::Event *event,
 				frame);
 		if (older_frame)
 		{
-			debug << misc::fmt("    A-%lld wait for access A-%lld\n",
-					frame->getId(),
-					older_frame->getId());
+			if (debug)
+				debug << misc::fmt("    A-%lld wait for "
+						"access A-%lld\n",
+						frame->getId(),
+						older_frame->getId());
 			older_frame->queue.Wait(event_local_load_lock);
 			return;
 		}
@@ -3846,23 +4081,27 @@ void System::EventLocalLoadHandler(esim::Event *event,
 	if (event == event_local_load_finish)
 	{
 		// Memory debug
-		debug << misc::fmt("%lld A-%lld 0x%x %s local_load_finish\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->getAddress(),
-				module->getName().c_str());
+		if (debug)
+			debug << misc::fmt("%lld A-%lld 0x%x %s "
+					"local_load_finish\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->getAddress(),
+					module->getName().c_str());
 
 		// Trace
-		trace << misc::fmt("mem.access "
-				"name=\"A-%lld\" "
-				"state=\"%s:load_finish\"\n",
-				frame->getId(),
-				module->getName().c_str());
+		if (trace)
+			trace << misc::fmt("mem.access "
+					"name=\"A-%lld\" "
+					"state=\"%s:load_finish\"\n",
+					frame->getId(),
+					module->getName().c_str());
 
 		// Trace
-		trace << misc::fmt("mem.end_access "
-				"name=\"A-%lld\"\n",
-				frame->getId());
+		if (trace)
+			trace << misc::fmt("mem.end_access "
+					"name=\"A-%lld\"\n",
+					frame->getId());
 
 		// Increment witness variable
 		if (frame->witness)
@@ -3893,20 +4132,22 @@ void System::EventLocalStoreHandler(esim::Event *event,
 	if (event == event_local_store)
 	{
 		// Memory debug
-		debug << misc::fmt("%lld A-%lld 0x%x %s local_store\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->getAddress(),
-				module->getName().c_str());
+		if (debug)
+			debug << misc::fmt("%lld A-%lld 0x%x %s local_store\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->getAddress(),
+					module->getName().c_str());
 
 		// Trace
-		trace << misc::fmt("mem.new_access "
-				"name=\"A-%lld\" "
-				"type=\"store\" "
-				"state=\"%s:store\" addr=0x%x\n",
-				frame->getId(),
-				module->getName().c_str(),
-				frame->getAddress());
+		if (trace)
+			trace << misc::fmt("mem.new_access "
+					"name=\"A-%lld\" "
+					"type=\"store\" "
+					"state=\"%s:store\" addr=0x%x\n",
+					frame->getId(),
+					module->getName().c_str(),
+					frame->getAddress());
 
 		// Record access
 		module->StartAccess(frame, Module::AccessStore);
@@ -3940,18 +4181,21 @@ void System::EventLocalStoreHandler(esim::Event *event,
 	if (event == event_local_store_lock)
 	{
 		// Debug
-		debug << misc::fmt("  %lld A-%lld 0x%x %s local_store_lock\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->getAddress(),
-				module->getName().c_str());
+		if (debug)
+			debug << misc::fmt("  %lld A-%lld 0x%x %s "
+					"local_store_lock\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->getAddress(),
+					module->getName().c_str());
 
 		// Trace
-		trace << misc::fmt("mem.access "
-				"name=\"A-%lld\" "
-				"state=\"%s:store_lock\"\n",
-				frame->getId(),
-				module->getName().c_str());
+		if (trace)
+			trace << misc::fmt("mem.access "
+					"name=\"A-%lld\" "
+					"state=\"%s:store_lock\"\n",
+					frame->getId(),
+					module->getName().c_str());
 
 		// If there is any older access, wait for it
 		auto it = frame->accesses_iterator;
@@ -3963,9 +4207,11 @@ void System::EventLocalStoreHandler(esim::Event *event,
 			Frame *older_frame = *it;
 
 			// Debug
-			debug << misc::fmt("    A-%lld wait for access A-%lld\n",
-					frame->getId(),
-					older_frame->getId());
+			if (debug)
+				debug << misc::fmt("    A-%lld wait for "
+						"access A-%lld\n",
+						frame->getId(),
+						older_frame->getId());
 
 			// Enqueue
 			older_frame->queue.Wait(event_local_store_lock);
@@ -3996,23 +4242,27 @@ void System::EventLocalStoreHandler(esim::Event *event,
 	if (event == event_local_store_finish)
 	{
 		// Debug
-		debug << misc::fmt("%lld A-%lld 0x%x %s local_store_finish\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->getAddress(),
-				module->getName().c_str());
+		if (debug)
+			debug << misc::fmt("%lld A-%lld 0x%x %s "
+					"local_store_finish\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->getAddress(),
+					module->getName().c_str());
 
 		// Trace
-		trace << misc::fmt("mem.access "
-				"name=\"A-%lld\" "
-				"state=\"%s:store_finish\"\n",
-				frame->getId(),
-				module->getName().c_str());
+		if (trace)
+			trace << misc::fmt("mem.access "
+					"name=\"A-%lld\" "
+					"state=\"%s:store_finish\"\n",
+					frame->getId(),
+					module->getName().c_str());
 
 		// Trace
-		trace << misc::fmt("mem.end_access "
-				"name=\"A-%lld\"\n",
-				frame->getId());
+		if (trace)
+			trace << misc::fmt("mem.end_access "
+					"name=\"A-%lld\"\n",
+					frame->getId());
 
 		// Finish access
 		module->FinishAccess(frame);
@@ -4039,18 +4289,20 @@ void System::EventLocalFindAndLockHandler(esim::Event *event,
 	// Event "local_find_and_lock"
 	if (event == event_local_find_and_lock)
 	{
-		debug << misc::fmt("  %lld A-%lld 0x%x %s "
-				"local_find_and_lock (blocking=%d)\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->getAddress(),
-				module->getName().c_str(),
-				frame->blocking);
-		trace << misc::fmt("mem.access "
-				"name=\"A-%lld\" "
-				"state=\"%s:find_and_lock\"\n",
-				frame->getId(),
-				module->getName().c_str());
+		if (debug)
+			debug << misc::fmt("  %lld A-%lld 0x%x %s "
+					"local_find_and_lock (blocking=%d)\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->getAddress(),
+					module->getName().c_str(),
+					frame->blocking);
+		if (trace)
+			trace << misc::fmt("mem.access "
+					"name=\"A-%lld\" "
+					"state=\"%s:find_and_lock\"\n",
+					frame->getId(),
+					module->getName().c_str());
 
 		// Default return values
 		parent_frame->error = false;
@@ -4072,18 +4324,21 @@ void System::EventLocalFindAndLockHandler(esim::Event *event,
 		assert(port);
 
 		// Memory debug
-		debug << misc::fmt("  %lld A-%lld 0x%x %s local_find_and_lock_port\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->getAddress(),
-				module->getName().c_str());
+		if (debug)
+			debug << misc::fmt("  %lld A-%lld 0x%x %s "
+					"local_find_and_lock_port\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->getAddress(),
+					module->getName().c_str());
 
 		// Trace
-		trace << misc::fmt("mem.access "
-				"name=\"A-%lld\" "
-				"state=\"%s:find_and_lock_port\"\n",
-				frame->getId(),
-				module->getName().c_str());
+		if (trace)
+			trace << misc::fmt("mem.access "
+					"name=\"A-%lld\" "
+					"state=\"%s:find_and_lock_port\"\n",
+					frame->getId(),
+					module->getName().c_str());
 
 		// Set parent frame flag expressing that port has already been
 		// locked. This flag is checked by new writes to find out if
@@ -4128,19 +4383,21 @@ void System::EventLocalFindAndLockHandler(esim::Event *event,
 		assert(port);
 
 		// Memory debug
-		debug << misc::fmt("  %lld A-%lld 0x%x %s "
-				"local_find_and_lock_action\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->getAddress(),
-				module->getName().c_str());
+		if (debug)
+			debug << misc::fmt("  %lld A-%lld 0x%x %s "
+					"local_find_and_lock_action\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->getAddress(),
+					module->getName().c_str());
 
 		// Trace
-		trace << misc::fmt("mem.access "
-				"name=\"A-%lld\" "
-				"state=\"%s:find_and_lock_action\"\n",
-				frame->getId(),
-				module->getName().c_str());
+		if (trace)
+			trace << misc::fmt("mem.access "
+					"name=\"A-%lld\" "
+					"state=\"%s:find_and_lock_action\"\n",
+					frame->getId(),
+					module->getName().c_str());
 
 		// Release port
 		module->UnlockPort(port, frame);
@@ -4155,19 +4412,21 @@ void System::EventLocalFindAndLockHandler(esim::Event *event,
 	if (event == event_local_find_and_lock_finish)
 	{
 		// Memory debug
-		debug << misc::fmt("  %lld A-%lld 0x%x %s "
-				"local_find_and_lock_finish\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->getAddress(),
-				module->getName().c_str());
+		if (debug)
+			debug << misc::fmt("  %lld A-%lld 0x%x %s "
+					"local_find_and_lock_finish\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->getAddress(),
+					module->getName().c_str());
 
 		// Trace
-		trace << misc::fmt("mem.access "
-				"name=\"A-%lld\" "
-				"state=\"%s:find_and_lock_finish\"\n",
-				frame->getId(),
-				module->getName().c_str());
+		if (trace)
+			trace << misc::fmt("mem.access "
+					"name=\"A-%lld\" "
+					"state=\"%s:find_and_lock_finish\"\n",
+					frame->getId(),
+					module->getName().c_str());
 		
 		// Return esim engine
 		esim_engine->Return();
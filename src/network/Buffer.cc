@@ -55,13 +55,14 @@ void Buffer::InsertPacket(Packet *packet)
 
 	// Debug
 	Message *message = packet->getMessage();
-	System::debug << misc::fmt("net: %s - M-%lld:%d - "
-			"insert_buf: %s:%s\n",
-			message->getNetwork()->getName().c_str(),
-			message->getId(),
-			packet->getId(),
-			node->getName().c_str(),
-			name.c_str());
+	if (System::debug)
+		System::debug << misc::fmt("net: %s - M-%lld:%d - "
+				"insert_buf: %s:%s\n",
+				message->getNetwork()->getName().c_str(),
+				message->getId(),
+				packet->getId(),
+				node->getName().c_str(),
+				name.c_str());
 }
 
 
@@ -126,13 +127,14 @@ void Buffer::ExtractPacket()
 
 	// Debug
 	Message *message = packet->getMessage();
-	System::debug << misc::fmt("net: %s - M-%lld:%d - "
-			"extract_buf: %s:%s\n",
-			message->getNetwork()->getName().c_str(),
-			message->getId(),
-			packet->getId(),
-			node->getName().c_str(),
-			name.c_str());
+	if (System::debug)
+		System::debug << misc::fmt("net: %s - M-%lld:%d - "
+				"extract_buf: %s:%s\n",
+				message->getNetwork()->getName().c_str(),
+				message->getId(),
+				packet->getId(),
+				node->getName().c_str(),
+				name.c_str());
 }
 
 
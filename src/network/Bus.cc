@@ -114,12 +114,13 @@ void Bus::TransferPacket(Packet *packet)
 	if (source_buffer->getBufferHead() != packet)
 	{
 		// Update debug information
-		System::debug << misc::fmt("net: %s - M-%lld:%d - "
-				"stl_not_buf_head: %s:%s\n",
-				network->getName().c_str(),
-				message->getId(), packet->getId(),
-				node->getName().c_str(), 
-				source_buffer->getName().c_str());
+		if (System::debug)
+			System::debug << misc::fmt("net: %s - M-%lld:%d - "
+					"stl_not_buf_head: %s:%s\n",
+					network->getName().c_str(),
+					message->getId(), packet->getId(),
+					node->getName().c_str(), 
+					source_buffer->getName().c_str());
 
 		// Schedule the event for next time buffer head has changed
 		source_buffer->Wait(current_event);
@@ -159,12 +160,13 @@ void Bus::TransferPacket(Packet *packet)
 	// Check if the destination buffer is not busy
 	if (destination_buffer->write_busy >= cycle)
 	{
-		System::debug << misc::fmt("net: %s - M-%lld:%d - "
-				"stl_busy_dest_buf: %s:%s\n", 
-				network->getName().c_str(),
-				message->getId(), packet->getId(),
-				destination_buffer->getNode()->getName().c_str(),
-				destination_buffer->getName().c_str());
+		if (System::debug)
+			System::debug << misc::fmt("net: %s - M-%lld:%d - "
+					"stl_busy_dest_buf: %s:%s\n", 
+					network->getName().c_str(),
+					message->getId(), packet->getId(),
+					destination_buffer->getNode()->getName().c_str(),
+					destination_buffer->getName().c_str());
 		esim_engine->Next(current_event,
 				destination_buffer->write_busy - cycle + 1);
 		return;
@@ -179,13 +181,14 @@ void Bus::TransferPacket(Packet *packet)
 	if (destination_buffer->getCount() + packet_size >
 			destination_buffer->getSize())
 	{
-		System::debug << misc::fmt("net: %s - M-%lld:%d - "
-				"stl_full_bus_dest_buf: %s - %s:%s\n", 
-				network->getName().c_str(),
-				message->getId(), packet->getId(),
-				name.c_str(),
-				destination_buffer->getNode()->getName().c_str(),
-				destination_buffer->getName().c_str());
+		if (System::debug)
+			System::debug << misc::fmt("net: %s - M-%lld:%d - "
+					"stl_full_bus_dest_buf: %s - %s:%s\n", 
+					network->getName().c_str(),
+					message->getId(), packet->getId(),
+					name.c_str(),
+					destination_buffer->getNode()->getName().c_str(),
+					destination_buffer->getName().c_str());
 		destination_buffer->Wait(current_event);
 		return;
 	}
@@ -194,11 +197,12 @@ void Bus::TransferPacket(Packet *packet)
 	Lane *lane = Arbitration(source_buffer);
 	if (!lane)
 	{
-		System::debug << misc::fmt("net: %s - M-%lld:%d - "
-				"stl_bus_arb: %s\n", 
-				network->getName().c_str(),
-				message->getId(), packet->getId(),
-				this->name.c_str());
+		if (System::debug)
+			System::debug << misc::fmt("net: %s - M-%lld:%d - "
+					"stl_bus_arb: %s\n", 
+					network->getName().c_str(),
+					message->getId(), packet->getId(),
+					this->name.c_str());
 		esim_engine->Next(current_event, 1);
 		return;
 	}
@@ -217,20 +221,23 @@ void Bus::TransferPacket(Packet *packet)
 	packet->setBusy(cycle + latency - 1);
 
 	// Buffer's trace information
-    	System::trace << misc::fmt("net.packet_extract net=\"%s\" node=\"%s\" "
-			"buffer=\"%s\" name=\"P-%lld:%d\" occpncy=%d\n",
-    			network->getName().c_str(),
-			source_buffer->getNode()->getName().c_str(),
-			source_buffer->getName().c_str(),
-			message->getId(), packet->getId(),
-			source_buffer->getOccupancyInBytes());
-	System::trace << misc::fmt("net.packet_insert net=\"%s\" node=\"%s\" "
-			"buffer=\"%s\" name=\"P-%lld:%d\" occpncy=%d\n",
-			network->getName().c_str(),
-			destination_buffer->getNode()->getName().c_str(),
-			destination_buffer->getName().c_str(),
-			message->getId(), packet->getId(),
-			destination_buffer->getOccupancyInBytes());
+	if (System::trace)
+	{
+		System::trace << misc::fmt("net.packet_extract net=\"%s\" node=\"%s\" "
+				"buffer=\"%s\" name=\"P-%lld:%d\" occpncy=%d\n",
+				network->getName().c_str(),
+				source_buffer->getNode()->getName().c_str(),
+				source_buffer->getName().c_str(),
+				message->getId(), packet->getId(),
+				source_buffer->getOccupancyInBytes());
+		System::trace << misc::fmt("net.packet_insert net=\"%s\" node=\"%s\" "
+				"buffer=\"%s\" name=\"P-%lld:%d\" occpncy=%d\n",
+				network->getName().c_str(),
+				destination_buffer->getNode()->getName().c_str(),
+				destination_buffer->getName().c_str(),
+				message->getId(), packet->getId(),
+				destination_buffer->getOccupancyInBytes());
+	}
 
 	// Update the statistics
 	lane->incBusyCycles(latency);
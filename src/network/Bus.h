@@ -133,6 +133,17 @@ public:
 	/// Transfer the packet from an output buffer
 	void TransferPacket(Packet *packet);
 
+	/// Return the number of cycles it takes to transfer a packet of the
+	/// given size over one lane of the bus. All lanes have the same
+	/// bandwidth.
+	int getTransferLatency(int size) const
+	{
+		return (size - 1) / lanes[0]->getBandwidth() + 1;
+	}
+
+	/// Each lane transfers one packet at a time
+	int getNumChannels() const { return lanes.size(); }
+
 
 
 
@@ -17,6 +17,8 @@
  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <algorithm>
+
 #include "Connection.h"
 #include "Network.h"
 #include "Buffer.h"
@@ -24,6 +26,15 @@
 namespace net
 {
 
+// Length in cycles of the windows over which the utilization of connections
+// is measured in the analytical model
+static const long long analytical_window = 1000;
+
+// Utilization at which the analytical queuing delay is capped. An M/D/1
+// queue grows without bound as its utilization approaches 1, while the
+// detailed model throttles the senders through full buffers instead.
+static const double analytical_max_utilization = 0.95;
+
 Connection::Connection(const std::string &name, Network *network) :
 		network(network),
 		name(name)
@@ -42,5 +53,28 @@ void Connection::addDestinationBuffer(Buffer* buffer)
 	this->destination_buffers.emplace_back(buffer);
 }
 
+
+int Connection::AnalyticalTransfer(int size, int num_packets)
+{
+	// Measure the utilization of the last window if it ended
+	long long cycle = System::getInstance()->getCycle();
+	if (cycle >= window_start + analytical_window)
+	{
+		long long capacity = (cycle - window_start) * getNumChannels();
+		utilization = std::min((double) window_busy_cycles / capacity,
+				analytical_max_utilization);
+		window_start = cycle;
+		window_busy_cycles = 0;
+	}
+
+	// Mean wait of an M/D/1 queue with service time S and utilization U
+	// is U * S / (2 * (1 - U))
+	int latency = getTransferLatency(size);
+	double wait = utilization * latency / (2 * (1 - utilization));
+
+	// Reserve the connection for all packets
+	window_busy_cycles += (long long) latency * num_packets;
+	return (int) (wait + 0.5);
 }
 
+}
@@ -47,6 +47,22 @@ protected:
 	// List of the destination buffers connected to the bus
 	std::vector<Buffer *> destination_buffers;
 
+
+
+
+	//
+	// Analytical model
+	//
+
+	// First cycle of the current utilization window
+	long long window_start = 0;
+
+	// Cycles the connection was reserved for during the current window
+	long long window_busy_cycles = 0;
+
+	// Utilization measured in the last complete window, between 0 and 1
+	double utilization = 0.0;
+
 public:
 
 	/// Constructor
@@ -84,6 +100,22 @@ public:
 
 	/// Transfer the packet 
 	virtual void TransferPacket(Packet *packet) = 0;
+
+	/// Return the number of cycles the connection is busy transferring
+	/// a packet of the given size.
+	virtual int getTransferLatency(int size) const = 0;
+
+	/// Return the number of packets that the connection can transfer in
+	/// the same cycle.
+	virtual int getNumChannels() const { return 1; }
+
+	/// Estimate the number of cycles that a packet of the given size
+	/// waits for the connection in the analytical network model, and
+	/// account for the transfer of \a num_packets of these packets in
+	/// future estimates. The wait is the mean queuing delay of an M/D/1
+	/// queue, whose utilization is measured over the previous window of
+	/// cycles.
+	int AnalyticalTransfer(int size, int num_packets);
 };
 }
 
@@ -28,6 +28,10 @@ namespace net
 // An end node is where the packet is generated and consumed
 class EndNode : public Node
 {
+	// Cycle when the last message to this node is delivered in the
+	// analytical network model
+	long long analytical_receive_cycle = 0;
+
 public:
 
 	/// Constructor
@@ -41,6 +45,20 @@ public:
 	/// Dump node information
 	void Dump(std::ostream &os) const;
 
+	/// Return the cycle when the last message to this node is delivered
+	/// in the analytical network model
+	long long getAnalyticalReceiveCycle() const
+	{
+		return analytical_receive_cycle;
+	}
+
+	/// Set the cycle when the last message to this node is delivered in
+	/// the analytical network model
+	void setAnalyticalReceiveCycle(long long cycle)
+	{
+		analytical_receive_cycle = cycle;
+	}
+
 };
 
 }  // namespace net
@@ -102,6 +102,40 @@ void Link::Dump(std::ostream &os) const
 }
 
 
+// Parallel simulation is not supported yet. A conservative simulation
+// would partition the network into regions bounded by links, each with its
+// own event queue and host thread, using link latencies as lookahead. This
+// function provides no lookahead, however. In the cycle of the transfer it
+// reads and updates the state of the destination buffer, owned by the
+// region on the other side of the link: its occupancy, its write port, and
+// its wait queue, where a sender blocks until space is freed. A packet also
+// enters the destination buffer in that same cycle.
+//
+// The planned design removes this back-pressure through shared state with
+// credit-based flow control:
+//
+// - The source side of each virtual channel keeps a credit count,
+//   initialized to the size of the destination buffer. A transfer checks
+//   and consumes credits instead of reading the destination buffer, and
+//   waits on the credit count instead of on the buffer's wait queue. The
+//   write port is only used by this link, so it moves to the source side.
+//
+// - A transferred packet reaches the destination buffer a link latency
+//   later, as a timestamped message for the destination region.
+//
+// - When a packet leaves the destination buffer, its size returns to the
+//   source as credits, also delayed by the link latency.
+//
+// With a latency of at least one cycle in both directions, regions can run
+// windows of that many cycles between barriers, exchanging packets and
+// credits at the end of each window in the order of their cycle and link.
+// The results then do not depend on the number of host threads. Buses are
+// shared media and would stay inside one region.
+//
+// The credit delay changes timing with respect to the current model. It
+// would be introduced first as a serial flow-control option, and parallel
+// runs validated bit for bit against it. Messages, statistics, and the
+// events of the global engine would also need to be kept per region.
 void Link::TransferPacket(Packet *packet)
 {
 	// Get current cycle
@@ -126,12 +160,13 @@ void Link::TransferPacket(Packet *packet)
 	if (source_buffer->getBufferHead() != packet)
 	{
 		// Update debug information
-		System::debug << misc::fmt("net: %s - M-%lld:%d - "
-				"stl_not_buf_head: %s:%s\n",
-				network->getName().c_str(),
-				message->getId(), packet->getId(),
-				node->getName().c_str(), 
-				source_buffer->getName().c_str());
+		if (System::debug)
+			System::debug << misc::fmt("net: %s - M-%lld:%d - "
+					"stl_not_buf_head: %s:%s\n",
+					network->getName().c_str(),
+					message->getId(), packet->getId(),
+					node->getName().c_str(), 
+					source_buffer->getName().c_str());
 
 		// Wait for the head to change
 		source_buffer->Wait(current_event);
@@ -142,23 +177,25 @@ void Link::TransferPacket(Packet *packet)
 	if (busy >= cycle)
 	{
 		// Update debug information
-		System::debug << misc::fmt("net: %s - M-%lld:%d - "
-				"stl at %s:%s busy_link: %s\n",
-				network->getName().c_str(),
-				message->getId(), packet->getId(),
-				node->getName().c_str(), 
-				source_buffer->getName().c_str(),
-				getName().c_str());
+		if (System::debug)
+			System::debug << misc::fmt("net: %s - M-%lld:%d - "
+					"stl at %s:%s busy_link: %s\n",
+					network->getName().c_str(),
+					message->getId(), packet->getId(),
+					node->getName().c_str(), 
+					source_buffer->getName().c_str(),
+					getName().c_str());
 
 		// Trace information
-		System::trace << misc::fmt("net.packet "
-				"net=\"%s\" name=\"P-%lld:%d\" "
-				"state=\"%s:%s:link_busy\" "
-				"stg=\"LB\"\n",
-				network->getName().c_str(), message->getId(),
-				packet->getId(),
-				node->getName().c_str(),
-				source_buffer->getName().c_str());
+		if (System::trace)
+			System::trace << misc::fmt("net.packet "
+					"net=\"%s\" name=\"P-%lld:%d\" "
+					"state=\"%s:%s:link_busy\" "
+					"stg=\"LB\"\n",
+					network->getName().c_str(), message->getId(),
+					packet->getId(),
+					node->getName().c_str(),
+					source_buffer->getName().c_str());
 
 		esim_engine->Next(current_event, busy - cycle + 1);
 		return;
@@ -170,24 +207,26 @@ void Link::TransferPacket(Packet *packet)
 	if (next_buffer != source_buffer)
 	{
 		// Update debug information
-		System::debug << misc::fmt("net: %s - M-%lld:%d - "
-				"stl at %s:%s vc_arb: %s\n",
-				network->getName().c_str(),
-				message->getId(), packet->getId(),
-				node->getName().c_str(), 
-				source_buffer->getName().c_str(),
-				name.c_str());
+		if (System::debug)
+			System::debug << misc::fmt("net: %s - M-%lld:%d - "
+					"stl at %s:%s vc_arb: %s\n",
+					network->getName().c_str(),
+					message->getId(), packet->getId(),
+					node->getName().c_str(), 
+					source_buffer->getName().c_str(),
+					name.c_str());
 
 		// Trace information
-		System::trace << misc::fmt("net.packet "
-				"net=\"%s\" "
-				"name=\"P-%lld:%d\" "
-				"state=\"%s:%s:VC_arbitration_fail\" "
-				"stg=\"VCA\"\n",
-				network->getName().c_str(), message->getId(),
-				packet->getId(),
-				node->getName().c_str(),
-				source_buffer->getName().c_str());
+		if (System::trace)
+			System::trace << misc::fmt("net.packet "
+					"net=\"%s\" "
+					"name=\"P-%lld:%d\" "
+					"state=\"%s:%s:VC_arbitration_fail\" "
+					"stg=\"VCA\"\n",
+					network->getName().c_str(), message->getId(),
+					packet->getId(),
+					node->getName().c_str(),
+					source_buffer->getName().c_str());
 
 		// Next cycle to check again
 		esim_engine->Next(current_event, 1);
@@ -204,23 +243,25 @@ void Link::TransferPacket(Packet *packet)
 	if (write_busy >= cycle)
 	{
 		// Update debug information
-		System::debug << misc::fmt("net: %s - M-%lld:%d - "
-				"stl_busy_dst_buf: %s:%s\n",
-				network->getName().c_str(),
-				message->getId(), packet->getId(),
-				destination_buffer->getNode()->getName().c_str(),
-				destination_buffer->getName().c_str());
+		if (System::debug)
+			System::debug << misc::fmt("net: %s - M-%lld:%d - "
+					"stl_busy_dst_buf: %s:%s\n",
+					network->getName().c_str(),
+					message->getId(), packet->getId(),
+					destination_buffer->getNode()->getName().c_str(),
+					destination_buffer->getName().c_str());
 
 		// Trace information
-		System::trace << misc::fmt("net.packet "
-				"net=\"%s\" "
-				"name=\"P-%lld:%d\" "
-				"state=\"%s:%s:Dest_buffer_busy\" "
-				"stg=\"DBB\"\n",
-				network->getName().c_str(), message->getId(),
-				packet->getId(),
-				node->getName().c_str(),
-				source_buffer->getName().c_str());
+		if (System::trace)
+			System::trace << misc::fmt("net.packet "
+					"net=\"%s\" "
+					"name=\"P-%lld:%d\" "
+					"state=\"%s:%s:Dest_buffer_busy\" "
+					"stg=\"DBB\"\n",
+					network->getName().c_str(), message->getId(),
+					packet->getId(),
+					node->getName().c_str(),
+					source_buffer->getName().c_str());
 
 		esim_engine->Next(current_event, write_busy - cycle + 1);
 		return;
@@ -232,23 +273,25 @@ void Link::TransferPacket(Packet *packet)
 			destination_buffer->getSize())
 	{
 		// Update debug information
-		System::debug << misc::fmt("net: %s - M-%lld:%d - "
-				"stl_full_dst_buf: %s:%s\n",
-				network->getName().c_str(),
-				message->getId(), packet->getId(),
-				destination_buffer->getNode()->getName().c_str(),
-				destination_buffer->getName().c_str());
+		if (System::debug)
+			System::debug << misc::fmt("net: %s - M-%lld:%d - "
+					"stl_full_dst_buf: %s:%s\n",
+					network->getName().c_str(),
+					message->getId(), packet->getId(),
+					destination_buffer->getNode()->getName().c_str(),
+					destination_buffer->getName().c_str());
 
 		// Trace information
-		System::trace << misc::fmt("net.packet "
-                		"net=\"%s\" "
-		                "name=\"P-%lld:%d\" "
-		                "state=\"%s:%s:Dest_buffer_full\" "
-		                "stg=\"DBF\"\n",
-		                network->getName().c_str(), message->getId(),
-		                packet->getId(),
-		                node->getName().c_str(),
-		                source_buffer->getName().c_str());
+		if (System::trace)
+			System::trace << misc::fmt("net.packet "
+	                		"net=\"%s\" "
+			                "name=\"P-%lld:%d\" "
+			                "state=\"%s:%s:Dest_buffer_full\" "
+			                "stg=\"DBF\"\n",
+			                network->getName().c_str(), message->getId(),
+			                packet->getId(),
+			                node->getName().c_str(),
+			                source_buffer->getName().c_str());
 
 		// Wait for a change in the buffer
 		destination_buffer->Wait(current_event);
@@ -269,20 +312,23 @@ void Link::TransferPacket(Packet *packet)
 	packet->setBusy(cycle + latency - 1);
 
 	// Buffer's trace information
-	System::trace << misc::fmt("net.packet_extract net=\"%s\" node=\"%s\" "
-			"buffer=\"%s\" name=\"P-%lld:%d\" occpncy=%d\n",
-			network->getName().c_str(),
-			source_buffer->getNode()->getName().c_str(),
-			source_buffer->getName().c_str(),
-			message->getId(), packet->getId(),
-			source_buffer->getOccupancyInBytes());
-	System::trace << misc::fmt("net.packet_insert net=\"%s\" node=\"%s\" "
-			"buffer=\"%s\" name=\"P-%lld:%d\" occpncy=%d\n",
-			network->getName().c_str(),
-			destination_buffer->getNode()->getName().c_str(),
-			destination_buffer->getName().c_str(),
-			message->getId(), packet->getId(),
-			destination_buffer->getOccupancyInBytes());
+	if (System::trace)
+	{
+		System::trace << misc::fmt("net.packet_extract net=\"%s\" node=\"%s\" "
+				"buffer=\"%s\" name=\"P-%lld:%d\" occpncy=%d\n",
+				network->getName().c_str(),
+				source_buffer->getNode()->getName().c_str(),
+				source_buffer->getName().c_str(),
+				message->getId(), packet->getId(),
+				source_buffer->getOccupancyInBytes());
+		System::trace << misc::fmt("net.packet_insert net=\"%s\" node=\"%s\" "
+				"buffer=\"%s\" name=\"P-%lld:%d\" occpncy=%d\n",
+				network->getName().c_str(),
+				destination_buffer->getNode()->getName().c_str(),
+				destination_buffer->getName().c_str(),
+				message->getId(), packet->getId(),
+				destination_buffer->getOccupancyInBytes());
+	}
 
 	// Statistics
 	busy_cycles += latency;
@@ -293,11 +339,12 @@ void Link::TransferPacket(Packet *packet)
 	destination_node->incReceivedBytes(packet_size);
 	destination_node->incReceivedPackets();
 
-	System::trace << misc::fmt("net.link_transfer net=\"%s\" link=\"%s\" "
-			"transB=%lld last_size=%d busy=%lld\n",
-			network->getName().c_str(), getName().c_str(),
-			transferred_bytes,
-			packet->getSize(), busy);
+	if (System::trace)
+		System::trace << misc::fmt("net.link_transfer net=\"%s\" link=\"%s\" "
+				"transB=%lld last_size=%d busy=%lld\n",
+				network->getName().c_str(), getName().c_str(),
+				transferred_bytes,
+				packet->getSize(), busy);
 
 	// Schedule input buffer event	
 	esim_engine->Next(System::event_input_buffer, latency);
@@ -132,6 +132,13 @@ public:
 	/// Transfer the packet from an output buffer 
 	void TransferPacket(Packet *packet);
 
+	/// Return the number of cycles it takes to transfer a packet of the
+	/// given size over the link.
+	int getTransferLatency(int size) const
+	{
+		return (size - 1) / bandwidth + 1;
+	}
+
 	/// This function returns the buffer that is scheduled to transmit
 	/// a packet on the link on the current cycle. The arbitration
 	/// is in round-robin fashion.
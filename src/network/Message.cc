@@ -85,11 +85,12 @@ bool Message::Assemble(Packet *packet)
 	received_packets.push_back(packet);
 
 	// Update the trace with the position of the packet, the depacketizer
-	net::System::trace << misc::fmt("net.packet net=\"%s\" "
-			"name=\"P-%lld:%d\" state=\"%s:depacketizer\" stg=\"DC\"\n",
-			network->getName().c_str(), id,
-			packet->getId(),
-			packet->getNode()->getName().c_str());
+	if (net::System::trace)
+		net::System::trace << misc::fmt("net.packet net=\"%s\" "
+				"name=\"P-%lld:%d\" state=\"%s:depacketizer\" stg=\"DC\"\n",
+				network->getName().c_str(), id,
+				packet->getId(),
+				packet->getNode()->getName().c_str());
 
 	// Check if all the packets of the message received
 	if (received_packets.size() == packets.size())
@@ -17,11 +17,13 @@
  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <algorithm>
 #include <cstring>
 #include <csignal>
 #include <fstream>
 
 #include <lib/esim/Engine.h>
+#include <lib/esim/Statistics.h>
 
 #include "Buffer.h"
 #include "Bus.h"
@@ -41,10 +43,25 @@ static const char *err_cycle_detected =
 	"for the network. Routing cycles can cause deadlocks in simulations,"
 	"that can in turn make the simulation stall with no output.";
 
+const misc::StringMap Network::ModelMap =
+{
+	{ "Detailed", ModelDetailed },
+	{ "Analytical", ModelAnalytical }
+};
+
 Network::Network(const std::string &name) :
 				name(name),
 				routing_table(this)
 {
+	// Interval statistics
+	esim::Statistics *statistics = esim::Statistics::getInstance();
+	std::string prefix = "net." + name + ".";
+	statistics->Register(prefix + "Transfers",
+			[this] { return transfers; });
+	statistics->Register(prefix + "TransferredBytes",
+			[this] { return accumulated_bytes; });
+	statistics->Register(prefix + "AccumulatedLatency",
+			[this] { return accumulated_latency; });
 }
 
 
@@ -88,6 +105,25 @@ void Network::ParseConfiguration(misc::IniFile *config,
 				name.c_str()));
 	}
 
+	// Timing model
+	std::string model_str = config->ReadString(section, "Model",
+			"Detailed");
+	model = (Model) ModelMap.MapString(model_str);
+	if (!model)
+		throw Error(misc::fmt("%s: Network %s: %s: Invalid value "
+				"for 'Model'.\n%s",
+				config->getPath().c_str(),
+				name.c_str(),
+				model_str.c_str(),
+				System::err_config_note));
+	if (model == ModelAnalytical && fix_latency)
+		throw Error(misc::fmt("%s: Network %s: An analytical "
+				"model cannot be used together with a fix "
+				"latency or an ideal network.\n%s",
+				config->getPath().c_str(),
+				name.c_str(),
+				System::err_config_note));
+
 	// Print a warning in case constant network is used
 	if (fix_latency > 0)
 	{
@@ -860,6 +896,10 @@ bool Network::CanSend(EndNode *source_node,
 	if (!output_buffer)
 		return false;
 
+	// Buffers are not modeled in the analytical model
+	if (model == ModelAnalytical)
+		return true;
+
 	// Get current cycle
 	System *system = System::getInstance();
 	long long cycle = system->getCycle();
@@ -909,30 +949,41 @@ Message *Network::Send(EndNode *source_node,
 	Message *message = newMessage(source_node, destination_node, size);
 
 	// Updating trace with new message creation
-	net::System::trace << misc::fmt("net.new_msg net=\"%s\" "
-			"name=\"M-%lld\" size=%d state=\"%s:create\"\n",
-			name.c_str(), message->getId(),
-			message->getSize(), source_node->getName().c_str());
+	if (net::System::trace)
+		net::System::trace << misc::fmt("net.new_msg net=\"%s\" "
+				"name=\"M-%lld\" size=%d state=\"%s:create\"\n",
+				name.c_str(), message->getId(),
+				message->getSize(), source_node->getName().c_str());
 
-	// Packetize message
-	if (packet_size == 0)
+	// Packetize message. The analytical model delivers the entire
+	// message at once.
+	if (packet_size == 0 || model == ModelAnalytical)
 		message->Packetize(size);
 	else 
 		message->Packetize(packet_size);
 
 	// Updating the trace with the message's packetization information
-	net::System::trace << misc::fmt("net.msg net=\"%s\" name=\"M-%lld\" "
-			"state=\"%s:packetize\"\n",
-			name.c_str(), message->getId(),
-			source_node->getName().c_str());
+	if (net::System::trace)
+		net::System::trace << misc::fmt("net.msg net=\"%s\" name=\"M-%lld\" "
+				"state=\"%s:packetize\"\n",
+				name.c_str(), message->getId(),
+				source_node->getName().c_str());
 
 	// Debug information
-	System::debug << misc::fmt("net: %s - send M-%lld "
-			"'%s'-->'%s'\n",
-			name.c_str(),
-			message->getId(),
-			source_node->getName().c_str(),
-			destination_node->getName().c_str());
+	if (System::debug)
+		System::debug << misc::fmt("net: %s - send M-%lld "
+				"'%s'-->'%s'\n",
+				name.c_str(),
+				message->getId(),
+				source_node->getName().c_str(),
+				destination_node->getName().c_str());
+
+	// Analytical model
+	if (model == ModelAnalytical)
+	{
+		SendAnalytical(message, receive_event);
+		return message;
+	}
 
 	// Send the message out
 	for (int i = 0; i < message->getNumPackets(); i++)
@@ -940,17 +991,19 @@ Message *Network::Send(EndNode *source_node,
 		Packet *packet = message->getPacket(i);
 
 		// Update the trace with the new packet and its state
-		net::System::trace << misc::fmt("net.new_packet net=\"%s\" "
-				"name=\"P-%lld:%d\" size=%d state=\"%s:packetizer\"\n",
-				name.c_str(), message->getId(),
-				packet->getId(), packet->getSize(),
-				source_node->getName().c_str());
+		if (net::System::trace)
+			net::System::trace << misc::fmt("net.new_packet net=\"%s\" "
+					"name=\"P-%lld:%d\" size=%d state=\"%s:packetizer\"\n",
+					name.c_str(), message->getId(),
+					packet->getId(), packet->getSize(),
+					source_node->getName().c_str());
 
 		// Update the trace with the new packet association
-		net::System::trace << misc::fmt("net.packet_msg net=\"%s\" "
-				"name=\"P-%lld:%d\" message=\"M-%lld\"\n",
-				name.c_str(), message->getId(),
-				packet->getId(), message->getId());
+		if (net::System::trace)
+			net::System::trace << misc::fmt("net.packet_msg net=\"%s\" "
+					"name=\"P-%lld:%d\" message=\"M-%lld\"\n",
+					name.c_str(), message->getId(),
+					packet->getId(), message->getId());
 		
 		// Create event frame
 		auto frame = misc::new_shared<Frame>(packet);
@@ -1027,49 +1080,157 @@ void Network::Receive(EndNode *node, Message *message)
 		Packet *packet = message->getPacket(i);
 		Buffer *buffer = packet->getBuffer();
 
-		// In the case the network is fixed, there are no
-		// buffer insertion and extraction. Otherwise, extract
+		// In the case the network is fixed or analytical, there
+		// are no buffer insertion and extraction. Otherwise, extract
 		// from buffer and report in trace
-		if (!hasConstantLatency())
+		if (!hasConstantLatency() && model != ModelAnalytical)
 		{
 			// Remove the packet from buffer
 			buffer->RemovePacket(packet);
 
 			// Updating the trace with extraction of the packet
 			// from the buffer
-			System::trace << misc::fmt("net.packet_extract "
-					"net=\"%s\" node=\"%s\" buffer=\"%s\" "
-					"name=\"P-%lld:%d\" occpncy=%d\n",
-					name.c_str(),
-					buffer->getNode()->getName().c_str(),
-					buffer->getName().c_str(),
-					message->getId(), packet->getId(),
-					buffer->getOccupancyInBytes());
+			if (System::trace)
+				System::trace << misc::fmt("net.packet_extract "
+						"net=\"%s\" node=\"%s\" buffer=\"%s\" "
+						"name=\"P-%lld:%d\" occpncy=%d\n",
+						name.c_str(),
+						buffer->getNode()->getName().c_str(),
+						buffer->getName().c_str(),
+						message->getId(), packet->getId(),
+						buffer->getOccupancyInBytes());
 		}
 
 		// Updating the trace with end of packet
 		// transmission information
-		System::trace << misc::fmt("net.end_packet net=\"%s\" "
-				"name=\"P-%lld:%d\"\n",
-				name.c_str(), message->getId(),
-				packet->getId());
+		if (System::trace)
+			System::trace << misc::fmt("net.end_packet net=\"%s\" "
+					"name=\"P-%lld:%d\"\n",
+					name.c_str(), message->getId(),
+					packet->getId());
 	}
 
 	// Dump debug information
-	System::debug << misc::fmt("net: %s - M-%lld rcv'd at %s\n",
-			name.c_str(),
-			message->getId(),
-			node->getName().c_str());
+	if (System::debug)
+		System::debug << misc::fmt("net: %s - M-%lld rcv'd at %s\n",
+				name.c_str(),
+				message->getId(),
+				node->getName().c_str());
 
 	// Updating the trace with the end of the message
-	System::trace << misc::fmt("net.end_msg net=\"%s\" name=\"M-%lld\"\n",
-			name.c_str(), message->getId());
+	if (System::trace)
+		System::trace << misc::fmt("net.end_msg net=\"%s\" name=\"M-%lld\"\n",
+				name.c_str(), message->getId());
 
 	// Destroy the message
 	message_table.erase(message->getId());
 }
 
 
+int Network::AnalyticalLatency(Node *source_node,
+		EndNode *destination_node,
+		int size)
+{
+	// Packets that the message is split into
+	int bytes = packet_size ? packet_size : size;
+	int num_packets = (size - 1) / bytes + 1;
+
+	// Insertion in the output buffer of the source node
+	int latency = 1;
+
+	// Follow the route of the first packet. The rest of the packets are
+	// pipelined behind it, separated by the slowest hop.
+	int slowest_hop = 0;
+	int last_transfer_latency = 0;
+	int num_hops = 0;
+	Node *node = source_node;
+	while (node != destination_node)
+	{
+		// Next hop. Routes longer than the number of nodes contain a
+		// cycle.
+		RoutingTable::Entry *entry = routing_table.Lookup(node,
+				destination_node);
+		Buffer *buffer = entry->getBuffer();
+		if (!buffer || ++num_hops > (int) nodes.size())
+			throw misc::Panic(misc::fmt("%s: no route from "
+					"%s to %s.",
+					name.c_str(),
+					source_node->getName().c_str(),
+					destination_node->getName().c_str()));
+
+		// Transfer over the connection, including the queuing delay
+		Connection *connection = buffer->getConnection();
+		int transfer_latency = connection->getTransferLatency(bytes);
+		latency += transfer_latency +
+				connection->AnalyticalTransfer(bytes,
+				num_packets);
+		slowest_hop = std::max(slowest_hop, transfer_latency);
+		last_transfer_latency = transfer_latency;
+
+		// Crossbar of an intermediate switch
+		node = entry->getNextNode();
+		Switch *switch_node = dynamic_cast<Switch *>(node);
+		if (switch_node)
+		{
+			int forward_latency = (bytes - 1) /
+					switch_node->getBandwidth() + 1;
+			latency += forward_latency;
+			slowest_hop = std::max(slowest_hop, forward_latency);
+		}
+	}
+
+	// Remaining packets
+	latency += (num_packets - 1) * slowest_hop;
+
+	// Messages to the same node arrive one after another through its last
+	// link, as in the detailed model. The memory system relies on this,
+	// since messages delivered to a node in the same cycle could resume
+	// the same event chain twice.
+	long long cycle = System::getInstance()->getCycle();
+	long long receive_cycle = std::max(cycle + latency,
+			destination_node->getAnalyticalReceiveCycle() +
+			(long long) num_packets * last_transfer_latency);
+	destination_node->setAnalyticalReceiveCycle(receive_cycle);
+	return receive_cycle - cycle;
+}
+
+
+void Network::SendAnalytical(Message *message, esim::Event *receive_event)
+{
+	// Estimate latency
+	Node *source_node = message->getSourceNode();
+	EndNode *destination_node = misc::cast<EndNode *>(
+			message->getDestinationNode());
+	int latency = AnalyticalLatency(source_node, destination_node,
+			message->getSize());
+
+	// Debug information
+	if (System::debug)
+		System::debug << misc::fmt("net: %s - M-%lld - "
+				"analytical_lat=%d\n",
+				name.c_str(),
+				message->getId(),
+				latency);
+
+	// The message travels as a single packet, placed in the destination
+	// node right away, as in a network with a fix latency
+	Packet *packet = message->getPacket(0);
+	source_node->incSentBytes(packet->getSize());
+	source_node->incSentPackets();
+	destination_node->incReceivedBytes(packet->getSize());
+	destination_node->incReceivedPackets();
+	packet->setNode(destination_node);
+
+	// Schedule the reception. The packet is received automatically if
+	// the user didn't pass any receive event.
+	auto frame = misc::new_shared<Frame>(packet);
+	frame->automatic_receive = !receive_event;
+	esim::Engine *esim_engine = esim::Engine::getInstance();
+	esim_engine->Call(System::event_receive, frame, receive_event,
+			latency);
+}
+
+
 EndNode *Network::addEndNode(int input_buffer_size,
 		int output_buffer_size,
 		const std::string &name,
@@ -44,6 +44,20 @@ class Graph;
 
 class Network
 {
+public:
+
+	/// Timing models of a network
+	enum Model
+	{
+		ModelInvalid = 0,
+		ModelDetailed,
+		ModelAnalytical
+	};
+
+	/// String map for values of type Model
+	static const misc::StringMap ModelMap;
+
+private:
 
 	// Network name
 	std::string name;
@@ -113,6 +127,10 @@ class Network
 	// of 1.
 	int fix_latency = 0;
 
+	// Timing model. In the analytical model, messages are delivered with
+	// a single event after a latency estimated from their route.
+	Model model = ModelDetailed;
+
 
 	
 	//
@@ -137,6 +155,23 @@ class Network
 
 	std::unique_ptr<Graph> graph;
 
+
+
+
+	//
+	// Analytical model
+	//
+
+	// Return the latency of a message of the given size between two end
+	// nodes in the analytical model, and reserve the connections on its
+	// route and the destination node for it.
+	int AnalyticalLatency(Node *source_node,
+			EndNode *destination_node,
+			int size);
+
+	// Deliver a message in the analytical model
+	void SendAnalytical(Message *message, esim::Event *receive_event);
+
 public:
 
 	/// Constructors
@@ -182,6 +217,12 @@ public:
 	/// Get the fix delay of the network
 	int getFixLatency() const {return fix_latency; }
 
+	/// Set the timing model of the network
+	void setModel(Model model) { this->model = model; }
+
+	/// Return the timing model of the network
+	Model getModel() const { return model; }
+
 	/// Create a message to be transfered in the network. The network 
 	/// keeps the ownership of the message. Message is destoried when it 
 	/// is received by the \a destination node.
@@ -21,6 +21,7 @@
 #include <fstream>
 #include <iostream>
 #include <iomanip>
+#include <set>
 
 #include <lib/cpp/Error.h>
 
@@ -92,26 +93,36 @@ void RoutingTable::Initialize()
 
 void RoutingTable::FloydWarshall()
 {
+	// Costs are copied into a flat array, which is traversed much faster
+	// than the entries. Entries are only updated when a shorter path is
+	// found.
+	std::vector<int> costs(entries.size());
+	for (unsigned i = 0; i < entries.size(); i++)
+		costs[i] = entries[i]->cost;
+
 	// The entry->next_node values do not necessarily point
 	// to the immediate next hop after this.
 	for (int k = 0; k < dimension; k++)
 	{
+		Node *node_k = network->getNode(k);
+		int *costs_k = &costs[k * dimension];
 		for (int i = 0; i < dimension; i++)
 		{
+			// Infinite costs never improve a path, since no cost in
+			// the table is higher than the dimension
+			int *costs_i = &costs[i * dimension];
+			int cost_i_k = costs_i[k];
+			if (cost_i_k >= dimension)
+				continue;
+
 			for (int j = 0; j < dimension; j++)
 			{
-				Node *node_i = network->getNode(i);
-				Node *node_j = network->getNode(j);
-				Node *node_k = network->getNode(k);
-
-				Entry *entry_i_k = Lookup(node_i,node_k);
-				Entry *entry_k_j = Lookup(node_k,node_j);
-				Entry *entry_i_j = Lookup(node_i,node_j);
-
-				int temp_cost = entry_i_k->cost +
-						entry_k_j->cost;
-				if (entry_i_j->cost > temp_cost)
+				int temp_cost = cost_i_k + costs_k[j];
+				if (costs_i[j] > temp_cost)
 				{
+					Entry *entry_i_j = entries[i * dimension
+							+ j].get();
+					costs_i[j] = temp_cost;
 					entry_i_j->cost = temp_cost;
 					entry_i_j->setNextNode(node_k);
 				}
@@ -188,6 +199,10 @@ bool RoutingTable::hasCycle()
 	// the graph
 	std::unordered_map<Buffer *, misc::Vertex *> buffer_to_vertex;
 
+	// Edges added to the graph, indexed by their source and destination
+	// vertices
+	std::set<std::pair<misc::Vertex *, misc::Vertex *>> edges;
+
 	// For every output buffer that plays a role in routing table
 	for (int node_id = 0; node_id < dimension; node_id++)
 	{
@@ -307,8 +322,8 @@ bool RoutingTable::hasCycle()
 							buffer_to_vertex.end());
 
 					// First see if the edge exists
-					if (!graph->findEdge(source_vertex_it->second,
-						destination_vertex_it->second))
+					if (edges.emplace(source_vertex_it->second,
+						destination_vertex_it->second).second)
 					{
 						// Add an edge to the graph based 
 						// on the source and the destination 
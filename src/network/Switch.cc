@@ -81,13 +81,14 @@ void Switch::Forward(Packet *packet)
 	if (input_buffer->read_busy >= cycle)
 	{
 		// Update debug information
-		System::debug << misc::fmt("net: %s - M-%lld:%d - "
-				"stl_busy_sw_src_buf: %s:%s\n",
-				network->getName().c_str(),
-				message->getId(),
-				packet->getId(),
-				node->getName().c_str(),
-				input_buffer->getName().c_str());
+		if (System::debug)
+			System::debug << misc::fmt("net: %s - M-%lld:%d - "
+					"stl_busy_sw_src_buf: %s:%s\n",
+					network->getName().c_str(),
+					message->getId(),
+					packet->getId(),
+					node->getName().c_str(),
+					input_buffer->getName().c_str());
 
 		// Coming back to this event when buffer is not busy
 		esim_engine->Next(current_event, 
@@ -112,26 +113,28 @@ void Switch::Forward(Packet *packet)
 	if (output_buffer->write_busy >= cycle)
 	{
 		// Update debug information
-		System::debug << misc::fmt("net: %s - M-%lld:%d - "
-				"stl_busy_sw_dst_buf: %s:%s\n",
-				network->getName().c_str(),
-				message->getId(),
-				packet->getId(),
-				output_buffer->getNode()->
-				getName().c_str(),
-				output_buffer->getName().c_str());
+		if (System::debug)
+			System::debug << misc::fmt("net: %s - M-%lld:%d - "
+					"stl_busy_sw_dst_buf: %s:%s\n",
+					network->getName().c_str(),
+					message->getId(),
+					packet->getId(),
+					output_buffer->getNode()->
+					getName().c_str(),
+					output_buffer->getName().c_str());
 
 		// Update trace information
-		System::trace << misc::fmt("net.packet "
-				"net=\"%s\" "
-				"name=\"P-%lld:%d\" "
-				"state=\"%s:%s:Dest_buffer_busy\" "
-				"stg=\"DBB\"\n",
-				network->getName().c_str(),
-				message->getId(),
-				packet->getId(),
-				node->getName().c_str(),
-				input_buffer->getName().c_str());
+		if (System::trace)
+			System::trace << misc::fmt("net.packet "
+					"net=\"%s\" "
+					"name=\"P-%lld:%d\" "
+					"state=\"%s:%s:Dest_buffer_busy\" "
+					"stg=\"DBB\"\n",
+					network->getName().c_str(),
+					message->getId(),
+					packet->getId(),
+					node->getName().c_str(),
+					input_buffer->getName().c_str());
 
 
 		esim_engine->Next(current_event, 
@@ -151,26 +154,28 @@ void Switch::Forward(Packet *packet)
 			output_buffer->getSize())
 	{
 		// Update debug information
-		System::debug << misc::fmt("net: %s - M-%lld:%d - "
-				"stl_full_sw_dst_buf: %s:%s\n",
-				network->getName().c_str(),
-				message->getId(),
-				packet->getId(),
-				output_buffer->getNode()->
-				getName().c_str(),
-				output_buffer->getName().c_str());
+		if (System::debug)
+			System::debug << misc::fmt("net: %s - M-%lld:%d - "
+					"stl_full_sw_dst_buf: %s:%s\n",
+					network->getName().c_str(),
+					message->getId(),
+					packet->getId(),
+					output_buffer->getNode()->
+					getName().c_str(),
+					output_buffer->getName().c_str());
 
 		// Update trace information
-		System::trace << misc::fmt("net.packet "
-				"net=\"%s\" "
-				"name=\"P-%lld:%d\" "
-				"state=\"%s:%s:Dest_buffer_full\" "
-				"stg=\"DBF\"\n",
-				network->getName().c_str(),
-				message->getId(),
-				packet->getId(),
-				node->getName().c_str(),
-				input_buffer->getName().c_str());
+		if (System::trace)
+			System::trace << misc::fmt("net.packet "
+					"net=\"%s\" "
+					"name=\"P-%lld:%d\" "
+					"state=\"%s:%s:Dest_buffer_full\" "
+					"stg=\"DBF\"\n",
+					network->getName().c_str(),
+					message->getId(),
+					packet->getId(),
+					node->getName().c_str(),
+					input_buffer->getName().c_str());
 
 		// Come back when buffer is not busy
 		output_buffer->Wait(current_event);
@@ -181,12 +186,13 @@ void Switch::Forward(Packet *packet)
 	if (Schedule(output_buffer) != input_buffer)
 	{
 		// Update debug information
-		System::debug << misc::fmt("net: %s - M-%lld:%d - "
-				"stl_sw_arb: %s\n",
-				network->getName().c_str(),
-				message->getId(),
-				packet->getId(),
-				name.c_str());
+		if (System::debug)
+			System::debug << misc::fmt("net: %s - M-%lld:%d - "
+					"stl_sw_arb: %s\n",
+					network->getName().c_str(),
+					message->getId(),
+					packet->getId(),
+					name.c_str());
 
 		esim_engine->Next(current_event, 1);
 		return;
@@ -204,23 +210,25 @@ void Switch::Forward(Packet *packet)
 	packet->setBusy(cycle + latency - 1);
 
 	// Buffer's trace information
-	System::trace << misc::fmt("net.packet_extract "
-			"net=\"%s\" node=\"%s\" buffer=\"%s\" "
-			"name=\"P-%lld:%d\" occpncy=%d\n",
-			network->getName().c_str(),
-			input_buffer->getNode()->getName().c_str(),
-			input_buffer->getName().c_str(),
-			message->getId(), packet->getId(),
-			input_buffer->getOccupancyInBytes());
-
-	System::trace << misc::fmt("net.packet_insert net=\"%s\" "
-			"node=\"%s\" buffer=\"%s\" "
-			"name=\"P-%lld:%d\" occpncy=%d\n",
-			network->getName().c_str(),
-			output_buffer->getNode()->getName().c_str(),
-			output_buffer->getName().c_str(),
-			message->getId(), packet->getId(),
-			output_buffer->getOccupancyInBytes());
+	if (System::trace)
+		System::trace << misc::fmt("net.packet_extract "
+				"net=\"%s\" node=\"%s\" buffer=\"%s\" "
+				"name=\"P-%lld:%d\" occpncy=%d\n",
+				network->getName().c_str(),
+				input_buffer->getNode()->getName().c_str(),
+				input_buffer->getName().c_str(),
+				message->getId(), packet->getId(),
+				input_buffer->getOccupancyInBytes());
+
+	if (System::trace)
+		System::trace << misc::fmt("net.packet_insert net=\"%s\" "
+				"node=\"%s\" buffer=\"%s\" "
+				"name=\"P-%lld:%d\" occpncy=%d\n",
+				network->getName().c_str(),
+				output_buffer->getNode()->getName().c_str(),
+				output_buffer->getName().c_str(),
+				message->getId(), packet->getId(),
+				output_buffer->getOccupancyInBytes());
 
 	// Schedule next event
 	esim_engine->Next(System::event_output_buffer, latency);
@@ -53,6 +53,9 @@ public:
 	/// Dump node information
 	void Dump(std::ostream &os) const;
 
+	/// Return the bandwidth of the switch crossbar in bytes per cycle
+	int getBandwidth() const { return bandwidth; }
+
 	/// Forward the packet to next hop
 	/// 
 	/// This function would at first assert the packet is in an input 
@@ -299,7 +299,8 @@ void System::UniformTrafficSimulation(Network *network)
 		}
 
 		// Next cycle
-		debug << misc::fmt("___ cycle %lld ___\n", cycle);	
+		if (debug)
+			debug << misc::fmt("___ cycle %lld ___\n", cycle);	
 		esim_engine->ProcessEvents();
 	}
 }
@@ -70,6 +70,22 @@ const std::string System::help_message =
 		"      packetizing, with the fix_latency, regardless of\n"
 		"      the network topology. The ideal option still requires a\n"
 		"      network to connect the end-nodes to each other\n"
+		"  Model = {Detailed|Analytical} (Default = Detailed)\n"
+		"      Timing model of the network. The detailed model simulates\n"
+		"      every packet hop through buffers, links, buses, and\n"
+		"      switches. The analytical model delivers each message with\n"
+		"      a single event, after a latency computed from the route in\n"
+		"      the routing table: the transfer time of every link and\n"
+		"      switch on the route, plus the mean queuing delay of an\n"
+		"      M/D/1 queue at every link, based on its utilization over\n"
+		"      the last 1000 cycles. Packets are pipelined behind the\n"
+		"      first one. Networks with many hops are simulated several\n"
+		"      times faster. Latencies match the detailed model in an idle\n"
+		"      network, but buffer occupancy, arbitration, and\n"
+		"      back-pressure are not modeled, so latencies deviate under\n"
+		"      load, and saturation is not reproduced. Link and buffer\n"
+		"      statistics are not collected. This option cannot be\n"
+		"      combined with 'Ideal' or 'FixLatency'.\n"
 		"\n"
 		"Sections '[ Network.<network>.Node.<node> ]' are used to \n"
 		"define nodes in network '<network>'.\n"
@@ -55,12 +55,13 @@ void System::EventTypeSendHandler(esim::Event *event,
 	if (network->hasConstantLatency())
 	{
 		// Debug Information
-		debug << misc::fmt("net: %s - M-%lld:%d - "
-				"fix_lat=%d\n",
-				network->getName().c_str(),
-				message->getId(),
-				packet->getId(),
-				network->getFixLatency());
+		if (debug)
+			debug << misc::fmt("net: %s - M-%lld:%d - "
+					"fix_lat=%d\n",
+					network->getName().c_str(),
+					message->getId(),
+					packet->getId(),
+					network->getFixLatency());
 
 		// Update the network related statistics
 		source_node->incSentBytes(packet->getSize());
@@ -107,14 +108,15 @@ void System::EventTypeSendHandler(esim::Event *event,
 	packet->setBusy(cycle);
 
 	// Update trace with buffer information
-	System::trace << misc::fmt("net.packet_insert "
-			"net=\"%s\" node=\"%s\" buffer=\"%s\" "
-			"name=\"P-%lld:%d\" occpncy=%d\n",
-			network->getName().c_str(),
-			output_buffer->getNode()->getName().c_str(),
-			output_buffer->getName().c_str(),
-			message->getId(), packet->getId(),
-			output_buffer->getOccupancyInBytes());
+	if (System::trace)
+		System::trace << misc::fmt("net.packet_insert "
+				"net=\"%s\" node=\"%s\" buffer=\"%s\" "
+				"name=\"P-%lld:%d\" occpncy=%d\n",
+				network->getName().c_str(),
+				output_buffer->getNode()->getName().c_str(),
+				output_buffer->getName().c_str(),
+				message->getId(), packet->getId(),
+				output_buffer->getOccupancyInBytes());
 
 	// Schedule next event
 	esim_engine->Next(event_output_buffer, 1);
@@ -164,13 +166,14 @@ void System::EventTypeInputBufferHandler(esim::Event *event,
 	if (buffer->getBufferHead() != packet)
 	{
 		// Debug info
-		debug << misc::fmt("net: %s - M-%lld:%d -"
-				"stl_not_buf_head: %s:%s\n",
-				network->getName().c_str(),
-				message->getId(),
-				packet->getId(),
-				node->getName().c_str(),
-				buffer->getName().c_str());
+		if (debug)
+			debug << misc::fmt("net: %s - M-%lld:%d -"
+					"stl_not_buf_head: %s:%s\n",
+					network->getName().c_str(),
+					message->getId(),
+					packet->getId(),
+					node->getName().c_str(),
+					buffer->getName().c_str());
 
 		// Schedule event for later
 		buffer->Wait(event);
@@ -214,12 +217,13 @@ void System::EventTypeReceiveHandler(esim::Event *event,
 			// Produce the depacketize in the trace, if message
 			// was packetized
 			if (message->getNumPackets() > 1)
-				System::trace << misc::fmt("net.msg net=\"%s\" "
-						"name=\"M-%lld\" "
-						"state=\"%s:depacketize\"\n",
-						network->getName().c_str(),
-						message->getId(),
-						node->getName().c_str());
+				if (System::trace)
+					System::trace << misc::fmt("net.msg net=\"%s\" "
+							"name=\"M-%lld\" "
+							"state=\"%s:depacketize\"\n",
+							network->getName().c_str(),
+							message->getId(),
+							node->getName().c_str());
 
 			// Receive the message just when there is
 			// no return event
@@ -0,0 +1,99 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2012  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include <lib/cpp/Error.h>
+#include <lib/cpp/Misc.h>
+#include <memory/AccessTrace.h>
+
+
+//
+// Generator of a synthetic memory access trace, replayed with option
+// '--mem-trace-replay' to measure the access rate of a memory hierarchy.
+// Every cycle, each of the given entry modules issues one access. Accesses
+// alternate between a sequential stream and pseudo-random addresses within
+// a region larger than the caches in the sample configurations. The trace
+// is deterministic for the same arguments.
+//
+
+// Size of the accessed region
+static const unsigned region_size = 16 << 20;
+
+
+int main(int argc, char **argv)
+{
+	// Syntax
+	if (argc < 4)
+	{
+		std::cerr << "syntax: " << argv[0] << " <trace> <accesses> "
+				"<module> [<module> ...]\n";
+		return 1;
+	}
+
+	try
+	{
+		// Entry modules, only used for their names
+		std::vector<std::unique_ptr<mem::Module>> modules;
+		for (int i = 3; i < argc; i++)
+			modules.emplace_back(misc::new_unique<mem::Module>(
+					argv[i], mem::Module::TypeCache,
+					1, 64, 1));
+
+		// Record accesses
+		long long num_accesses = atoll(argv[2]);
+		mem::AccessTraceWriter writer(argv[1]);
+		unsigned seed = 1;
+		for (long long i = 0; i < num_accesses; i++)
+		{
+			// Module and cycle
+			int index = i % modules.size();
+			long long cycle = i / modules.size();
+
+			// Address
+			unsigned address;
+			if (cycle % 2)
+			{
+				seed = seed * 1103515245 + 12345;
+				address = seed % region_size;
+			}
+			else
+			{
+				address = (index * region_size / modules.size() +
+						cycle * 32) % region_size;
+			}
+			address &= ~3;
+
+			// One store every 4 accesses
+			mem::Module::AccessType access_type = cycle % 4 ?
+					mem::Module::AccessLoad :
+					mem::Module::AccessStore;
+			writer.Record(cycle, modules[index].get(),
+					access_type, address);
+		}
+	}
+	catch (misc::Exception &e)
+	{
+		e.Dump();
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,112 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2012  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <iostream>
+
+#include <lib/cpp/Error.h>
+#include <lib/cpp/Misc.h>
+#include <lib/cpp/String.h>
+#include <lib/cpp/Timer.h>
+#include <lib/esim/Engine.h>
+#include <lib/esim/Event.h>
+#include <lib/esim/Frame.h>
+
+
+//
+// Throughput of the event-driven simulation engine. A fixed number of event
+// chains run concurrently, each one rescheduling itself after a pseudo-random
+// number of cycles until the total number of events is reached.
+//
+
+// Number of concurrent event chains
+static const int num_chains = 64;
+
+// Total number of events executed
+static const long long num_events = 2000000;
+
+// Events left to execute
+static long long num_events_left = num_events;
+
+// Event type rescheduled by all chains
+static esim::Event *event_bench;
+
+
+class BenchFrame : public esim::Frame
+{
+public:
+
+	// Seed of the pseudo-random generator of the chain
+	unsigned seed;
+};
+
+
+static void BenchHandler(esim::Event *event, esim::Frame *frame)
+{
+	// End of the chain
+	if (!num_events_left)
+		return;
+	num_events_left--;
+
+	// Next event of the chain in 1 to 8 cycles
+	BenchFrame *bench_frame = misc::cast<BenchFrame *>(frame);
+	bench_frame->seed = bench_frame->seed * 1103515245 + 12345;
+	esim::Engine *esim_engine = esim::Engine::getInstance();
+	esim_engine->Next(event_bench, 1 + (bench_frame->seed >> 16) % 8);
+}
+
+
+int main(int argc, char **argv)
+{
+	try
+	{
+		// Register frequency domain and event
+		esim::Engine *esim_engine = esim::Engine::getInstance();
+		esim::FrequencyDomain *domain = esim_engine->
+				RegisterFrequencyDomain("Bench", 1000);
+		event_bench = esim_engine->RegisterEvent("bench",
+				BenchHandler, domain);
+
+		// Start chains
+		misc::Timer timer("Bench");
+		timer.Start();
+		for (int i = 0; i < num_chains; i++)
+		{
+			auto frame = misc::new_shared<BenchFrame>();
+			frame->seed = i;
+			esim_engine->Call(event_bench, frame);
+		}
+
+		// Run until all events executed
+		while (num_events_left)
+			esim_engine->ProcessEvents();
+		esim_engine->ProcessAllEvents();
+		timer.Stop();
+
+		// Result
+		double seconds = timer.getValue() / 1.0e6;
+		std::cout << misc::fmt("engine,%.0f,events/s\n",
+				num_events / seconds);
+	}
+	catch (misc::Exception &e)
+	{
+		e.Dump();
+		return 1;
+	}
+	return 0;
+}
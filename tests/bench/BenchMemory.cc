@@ -0,0 +1,103 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2012  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <iostream>
+
+#include <lib/cpp/Error.h>
+#include <lib/cpp/String.h>
+#include <lib/cpp/Timer.h>
+#include <memory/Memory.h>
+
+
+//
+// Access rate of the functional memory image, with 4-byte reads and writes
+// to consecutive or to pseudo-random addresses of a mapped region, as
+// selected in the command line.
+//
+
+// Base address and size of the mapped region
+static const unsigned region_base = 0x10000000;
+static const unsigned region_size = 16 << 20;
+
+// Number of accesses
+static const long long num_accesses = 20000000;
+
+
+// Run the accesses and print the access rate
+static void Run(mem::Memory &memory, const std::string &name, bool random)
+{
+	misc::Timer timer(name);
+	timer.Start();
+	unsigned seed = 1;
+	unsigned offset = 0;
+	unsigned value = 0;
+	for (long long i = 0; i < num_accesses; i++)
+	{
+		// Next address
+		if (random)
+		{
+			seed = seed * 1103515245 + 12345;
+			offset = seed;
+		}
+		else
+		{
+			offset += 4;
+		}
+		unsigned address = region_base + (offset & (region_size - 4));
+
+		// One write every 4 accesses
+		if (i % 4)
+			memory.Read(address, 4, (char *) &value);
+		else
+			memory.Write(address, 4, (char *) &value);
+		value++;
+	}
+	timer.Stop();
+
+	// Result
+	double seconds = timer.getValue() / 1.0e6;
+	std::cout << misc::fmt("%s,%.0f,accesses/s\n", name.c_str(),
+			num_accesses / seconds);
+}
+
+
+int main(int argc, char **argv)
+{
+	// Syntax
+	std::string pattern = argc == 2 ? argv[1] : "";
+	if (pattern != "sequential" && pattern != "random")
+	{
+		std::cerr << "syntax: " << argv[0] << " sequential|random\n";
+		return 1;
+	}
+
+	try
+	{
+		mem::Memory memory;
+		memory.Map(region_base, region_size, mem::Memory::AccessRead |
+				mem::Memory::AccessWrite);
+		Run(memory, "memory_" + pattern, pattern == "random");
+	}
+	catch (misc::Exception &e)
+	{
+		e.Dump();
+		return 1;
+	}
+	return 0;
+}
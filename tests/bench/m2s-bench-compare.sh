@@ -0,0 +1,54 @@
+#!/bin/sh
+#
+# Compare two sets of Multi2Sim benchmark results
+#
+# Syntax: m2s-bench-compare.sh <baseline.csv> <current.csv> [<threshold>]
+#
+# Both files are outputs of 'm2s-bench.sh'. For every benchmark present in
+# both files, the throughput change is printed in percent. Benchmarks whose
+# throughput dropped by more than <threshold> percent (default 5) are
+# flagged as regressions, and the script exits with status 1 if any was
+# found. Benchmarks present in only one of the files are reported but do not
+# count as regressions.
+#
+
+if [ $# != 2 ] && [ $# != 3 ]
+then
+	echo "syntax: $0 <baseline.csv> <current.csv> [<threshold>]" >&2
+	exit 1
+fi
+
+awk -F, -v threshold="${3:-5}" '
+	# Baseline
+	NR == FNR {
+		baseline[$1] = $2
+		order[++num_baseline] = $1
+		next
+	}
+
+	# Current results
+	{
+		if (!($1 in baseline)) {
+			printf "%-24s %14s %14s %9s  new\n", $1, "-", $2, "-"
+			next
+		}
+		current[$1] = $2
+		change = ($2 - baseline[$1]) * 100 / baseline[$1]
+		status = change < -threshold ? "REGRESSION" : "ok"
+		if (status != "ok")
+			num_regressions++
+		printf "%-24s %14s %14s %+8.1f%%  %s\n",
+			$1, baseline[$1], $2, change, status
+	}
+
+	END {
+		for (i = 1; i <= num_baseline; i++)
+			if (!(order[i] in current))
+				printf "%-24s %14s %14s %9s  missing\n",
+					order[i], baseline[order[i]], "-", "-"
+		if (num_regressions) {
+			printf "%d benchmark(s) slower by more than %s%%\n",
+				num_regressions, threshold
+			exit 1
+		}
+	}' "$1" "$2"
@@ -0,0 +1,161 @@
+#!/bin/sh
+#
+# Multi2Sim performance benchmarks
+#
+# Syntax: m2s-bench.sh <top_builddir> <top_srcdir>
+#
+# Runs deterministic workloads on the hot parts of the simulator and prints
+# one line per benchmark in CSV format:
+#
+#	<benchmark>,<throughput>,<unit>
+#
+# Higher throughput is better for all benchmarks. Each benchmark runs
+# BENCH_REPEAT times (default 3), and the best result is reported to reduce
+# the noise of the host. Benchmarks that cannot run on the host, such as the
+# x86 ones when 32-bit libraries are not installed, are skipped with a
+# warning in the standard error output.
+#
+# Variables:
+#	BENCH_REPEAT		Number of runs of each benchmark
+#	BENCH_X86_PROGRAM	x86 program for the x86 benchmarks, instead of
+#				samples/x86/example-2/test-sort
+#
+
+if [ $# != 2 ]
+then
+	echo "syntax: $0 <top_builddir> <top_srcdir>" >&2
+	exit 1
+fi
+builddir=$(cd "$1" && pwd)
+srcdir=$(cd "$2" && pwd)
+m2s=$builddir/bin/m2s
+repeat=${BENCH_REPEAT:-3}
+x86_program=${BENCH_X86_PROGRAM:-$srcdir/samples/x86/example-2/test-sort}
+
+# Temporary directory for simulator outputs
+workdir=$(mktemp -d "${TMPDIR:-/tmp}/m2s-bench.XXXXXX") || exit 1
+trap 'rm -rf "$workdir"' EXIT
+cd "$workdir" || exit 1
+
+
+# Current time in nanoseconds
+now()
+{
+	date +%s%N
+}
+
+# Print the rate of <count> events in the time elapsed since <start>
+rate()
+{
+	awk -v count="$1" -v start="$2" -v end="$(now)" \
+		'BEGIN { printf "%.0f\n", count / ((end - start) / 1e9) }'
+}
+
+# Print a field of the first section with the given name in the simulation
+# summary of an m2s run.
+summary()
+{
+	awk -v section="[ $2 ]" -v field="$3" '
+		$0 == section { found = 1 }
+		found && $1 == field { print $3; exit }' "$1"
+}
+
+
+#
+# Benchmarks. Each function prints the throughput of one run, or nothing if
+# the benchmark could not run.
+#
+
+# Event-driven simulation engine
+bench_engine()
+{
+	"$builddir/tests/bench_engine" | cut -d, -f2
+}
+
+# Functional memory image
+bench_memory_sequential()
+{
+	"$builddir/tests/bench_memory" sequential | cut -d, -f2
+}
+
+bench_memory_random()
+{
+	"$builddir/tests/bench_memory" random | cut -d, -f2
+}
+
+# Memory hierarchy of samples/memory/example-1, replaying a synthetic trace
+# issued by the L1 caches of its three cores
+bench_memory_system()
+{
+	num_accesses=30000
+	[ -f mem-trace ] || "$builddir/tests/bench_access_trace" mem-trace \
+		$num_accesses mod-l1-0 mod-l1-1 mod-l1-2 || return
+	start=$(now)
+	"$m2s" --mem-config "$srcdir/samples/memory/example-1/mem-config" \
+		--mem-trace-replay mem-trace > /dev/null 2>&1 || return
+	rate $num_accesses "$start"
+}
+
+# x86 functional simulation
+bench_x86_functional()
+{
+	"$m2s" "$x86_program" > /dev/null 2> x86-functional.err || return
+	summary x86-functional.err x86 InstructionsPerSecond
+}
+
+# x86 detailed simulation
+bench_x86_detailed()
+{
+	"$m2s" --x86-sim detailed \
+		--x86-config "$srcdir/samples/x86/example-2/x86-config.ini" \
+		--x86-max-inst 500000 \
+		"$x86_program" > /dev/null 2> x86-detailed.err || return
+	summary x86-detailed.err x86 InstructionsPerSecond
+}
+
+# Stand-alone simulation of the 4x4 mesh of samples/network/example-4
+bench_network()
+{
+	start=$(now)
+	"$m2s" --net-sim net0 \
+		--net-config "$srcdir/samples/network/example-4/net-mesh" \
+		--net-injection-rate 0.1 \
+		--net-max-cycles 20000 \
+		--net-report net-report > /dev/null 2>&1 || return
+	transfers=$(awk '$1 == "Transfers" { print $3; exit }' \
+		net0_net-report)
+	[ -n "$transfers" ] && rate "$transfers" "$start"
+}
+
+
+# Run a benchmark BENCH_REPEAT times and print its best result
+run()
+{
+	name=$1
+	unit=$2
+	best=
+	i=0
+	while [ $i -lt "$repeat" ]
+	do
+		value=$(bench_$name)
+		if [ -z "$value" ]
+		then
+			echo "warning: benchmark '$name' could not run" >&2
+			return
+		fi
+		if [ -z "$best" ] || [ "$value" -gt "$best" ]
+		then
+			best=$value
+		fi
+		i=$((i + 1))
+	done
+	echo "$name,$best,$unit"
+}
+
+run engine events/s
+run memory_sequential accesses/s
+run memory_random accesses/s
+run memory_system accesses/s
+run x86_functional instructions/s
+run x86_detailed instructions/s
+run network packets/s
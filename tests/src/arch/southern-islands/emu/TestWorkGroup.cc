@@ -0,0 +1,169 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2015  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <gtest/gtest.h>
+
+#include <arch/southern-islands/emulator/Emulator.h>
+#include <arch/southern-islands/emulator/LocalMemory.h>
+#include <arch/southern-islands/emulator/NDRange.h>
+#include <arch/southern-islands/emulator/Wavefront.h>
+#include <arch/southern-islands/emulator/WorkGroup.h>
+#include <arch/southern-islands/emulator/WorkItem.h>
+#include <lib/cpp/Misc.h>
+
+
+namespace SI
+{
+
+// Work-groups released by the ND-Range are recycled by the next work-group
+// scheduled, which must start with the same state as a new one.
+TEST(TestWorkGroup, recycle)
+{
+	// ND-Range with 2 work-groups of 96 work-items, using 8 vector
+	// registers per work-item
+	auto ndrange = misc::new_unique<NDRange>();
+	unsigned global_size[1] = { 192 };
+	unsigned local_size[1] = { 96 };
+	ndrange->SetupSize(global_size, local_size, 1);
+	ndrange->setNumVgprUsed(8);
+
+	// First work-group
+	WorkGroup *work_group = ndrange->ScheduleWorkGroup(0);
+	Wavefront *wavefront = work_group->getWavefront(1);
+	WorkItem *work_item = wavefront->getWorkItem(0);
+	EXPECT_EQ(8, wavefront->getNumVregs());
+	EXPECT_EQ(64u, work_item->ReadVReg(0));
+	EXPECT_EQ(0xffffffffu, wavefront->getSregUint(
+			Instruction::RegisterExec));
+	work_item->WriteVReg(7, 1234);
+	wavefront->setFinished(true);
+	ndrange->RemoveWorkGroup(work_group);
+	EXPECT_EQ(0, ndrange->getNumWorkGroups());
+
+	// Second work-group reuses the same objects
+	WorkGroup *work_group_2 = ndrange->ScheduleWorkGroup(1);
+	EXPECT_EQ(work_group, work_group_2);
+	EXPECT_EQ(1, work_group->getId());
+	EXPECT_EQ(1, work_group->getId3D(0));
+	EXPECT_EQ(1, ndrange->getNumWorkGroups());
+	EXPECT_EQ(wavefront, work_group->getWavefront(1));
+	EXPECT_EQ(3, wavefront->getId());
+	EXPECT_FALSE(wavefront->getFinished());
+	EXPECT_EQ(32u, wavefront->getWorkItemCount());
+	EXPECT_EQ(160u, work_item->getId());
+	EXPECT_EQ(64u, work_item->ReadVReg(0));
+	EXPECT_EQ(0u, work_item->ReadVReg(7));
+
+	// Only the first 32 work-items of the last wavefront are active
+	EXPECT_EQ(0xffffffffu, wavefront->getSregUint(
+			Instruction::RegisterExec));
+	EXPECT_EQ(0u, wavefront->getSregUint(
+			Instruction::RegisterExec + 1));
+}
+
+// Vector registers beyond those allocated by the kernel are rejected, also
+// in builds without assertions
+TEST(TestWorkGroup, vreg_bounds)
+{
+	// ND-Range with one wavefront using 4 vector registers per work-item
+	auto ndrange = misc::new_unique<NDRange>();
+	unsigned global_size[1] = { 64 };
+	unsigned local_size[1] = { 64 };
+	ndrange->SetupSize(global_size, local_size, 1);
+	ndrange->setNumVgprUsed(4);
+	WorkGroup *work_group = ndrange->ScheduleWorkGroup(0);
+	WorkItem *work_item = work_group->getWavefront(0)->getWorkItem(63);
+
+	// Last allocated register
+	work_item->WriteVReg(3, 5678);
+	EXPECT_EQ(5678u, work_item->ReadVReg(3));
+
+	// Registers out of range
+	EXPECT_THROW(work_item->WriteVReg(4, 0), Emulator::Error);
+	EXPECT_THROW(work_item->ReadVReg(4), Emulator::Error);
+	EXPECT_THROW(work_item->ReadVReg(-1), Emulator::Error);
+}
+
+// Local memory accesses are checked against its size
+TEST(TestWorkGroup, local_memory)
+{
+	LocalMemory local_memory;
+	local_memory.Reset(16);
+
+	// Accesses within bounds
+	unsigned value = 0x12345678;
+	local_memory.Write(12, 4, (char *) &value);
+	value = 0;
+	local_memory.Read(12, 4, (char *) &value);
+	EXPECT_EQ(0x12345678u, value);
+
+	// Accesses out of bounds
+	EXPECT_THROW(local_memory.Write(13, 4, (char *) &value),
+			Emulator::Error);
+	EXPECT_THROW(local_memory.Read(0xfffffffc, 8, (char *) &value),
+			Emulator::Error);
+
+	// Reset clears the contents
+	local_memory.Reset(16);
+	local_memory.Read(12, 4, (char *) &value);
+	EXPECT_EQ(0u, value);
+}
+
+// DS instructions accept a Dword ending exactly at the top of local memory,
+// and reject one starting there, as the local memory itself does.
+TEST(TestWorkGroup, ds_bounds)
+{
+	// ND-Range with 16 bytes of local memory
+	auto ndrange = misc::new_unique<NDRange>();
+	unsigned global_size[1] = { 64 };
+	unsigned local_size[1] = { 64 };
+	ndrange->SetupSize(global_size, local_size, 1);
+	ndrange->setNumVgprUsed(2);
+	ndrange->setLocalMemTop(16);
+	WorkGroup *work_group = ndrange->ScheduleWorkGroup(0);
+	WorkItem *work_item = work_group->getWavefront(0)->getWorkItem(0);
+	work_item->WriteSReg(Instruction::RegisterM0, 0xffffffff);
+
+	// ds_write_b32 v0, v1
+	Instruction::BytesDS inst_bytes = { };
+	inst_bytes.op = 13;
+	inst_bytes.enc = 0x36;
+	inst_bytes.addr = 0;
+	inst_bytes.data0 = 1;
+	Instruction inst;
+	inst.Decode((char *) &inst_bytes, 0);
+	work_item->WriteVReg(1, 0x12345678);
+
+	// Last Dword
+	work_item->WriteVReg(0, 12);
+	work_item->Execute(inst.getOpcode(), &inst);
+	unsigned value = 0;
+	work_group->getLocalMemory()->Read(12, 4, (char *) &value);
+	EXPECT_EQ(0x12345678u, value);
+
+	// Top of local memory
+	work_item->WriteVReg(0, 16);
+	EXPECT_THROW(work_item->Execute(inst.getOpcode(), &inst),
+			Emulator::Error);
+	work_item->WriteVReg(0, 13);
+	EXPECT_THROW(work_item->Execute(inst.getOpcode(), &inst),
+			Emulator::Error);
+}
+
+}  // namespace SI
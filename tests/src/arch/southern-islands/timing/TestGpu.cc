@@ -0,0 +1,190 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2015  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <arch/southern-islands/emulator/NDRange.h>
+#include <arch/southern-islands/emulator/WorkGroup.h>
+#include <arch/southern-islands/timing/ComputeUnit.h>
+#include <arch/southern-islands/timing/Gpu.h>
+#include <arch/southern-islands/timing/Timing.h>
+#include <lib/cpp/IniFile.h>
+#include <lib/cpp/Misc.h>
+#include <lib/esim/Engine.h>
+
+namespace SI
+{
+
+static void Cleanup()
+{
+	esim::Engine::Destroy();
+	Timing::Destroy();
+	comm::ArchPool::Destroy();
+}
+
+
+// Create the timing simulator for a GPU with one compute unit, with the
+// given number of scalar registers
+static Gpu *CreateGpu(int num_scalar_registers)
+{
+	std::string config = misc::fmt(
+			"[ Device ]\n"
+			"NumComputeUnits = 1\n"
+			"[ ComputeUnit ]\n"
+			"NumScalarRegisters = %d\n",
+			num_scalar_registers);
+	misc::IniFile ini_file;
+	ini_file.LoadFromString(config);
+	Timing::ParseConfiguration(&ini_file);
+	return Timing::getInstance()->getGpu();
+}
+
+
+// Create an NDRange with the given work-group size in work-items, number of
+// work-groups, vector registers per work-item, scalar registers per
+// wavefront, and local memory per work-group
+static std::unique_ptr<NDRange> CreateNDRange(unsigned local_size,
+		unsigned num_work_groups, int num_vgprs, int num_sgprs,
+		int local_memory_size)
+{
+	auto ndrange = misc::new_unique<NDRange>();
+	unsigned global_size = local_size * num_work_groups;
+	ndrange->SetupSize(&global_size, &local_size, 1);
+	ndrange->setNumVgprUsed(num_vgprs);
+	ndrange->setNumSgprUsed(num_sgprs);
+	ndrange->setLocalMemTop(local_memory_size);
+	return ndrange;
+}
+
+
+// Map a work-group of the NDRange to the compute unit chosen by the GPU, as
+// the work-group dispatcher does. Return null if no compute unit has room
+// for it.
+static WorkGroup *Dispatch(Gpu *gpu, NDRange *ndrange, int work_group_id)
+{
+	ComputeUnit *compute_unit = gpu->getAvailableComputeUnit(ndrange);
+	if (!compute_unit)
+		return nullptr;
+	WorkGroup *work_group = ndrange->ScheduleWorkGroup(work_group_id);
+	gpu->RemoveFromAvailableComputeUnits(compute_unit);
+	compute_unit->MapWorkGroup(work_group);
+	return work_group;
+}
+
+
+// Work-groups of two NDRanges share a compute unit. Each wavefront pool
+// accounts for the wavefronts, vector registers and local memory of the
+// work-groups mapped to it, and the compute unit for their scalar registers.
+TEST(TestGpu, multiple_ndranges)
+{
+	Cleanup();
+	Gpu *gpu = CreateGpu(2048);
+	ComputeUnit *compute_unit = gpu->getComputeUnit(0);
+	ASSERT_EQ(4, ComputeUnit::num_wavefront_pools);
+
+	// NDRange with 2 wavefronts per work-group, whose local memory only
+	// allows one work-group per wavefront pool
+	auto ndrange_0 = CreateNDRange(128, 8, 4, 16, 40000);
+	gpu->StartNDRange(ndrange_0.get());
+	WavefrontPool::WorkGroupResources resources_0 =
+			gpu->getWorkGroupResources(ndrange_0.get());
+	EXPECT_EQ(2, resources_0.num_wavefronts);
+	EXPECT_EQ(512, resources_0.num_vector_registers);
+	EXPECT_EQ(32, resources_0.num_scalar_registers);
+	EXPECT_EQ(40000, resources_0.local_memory_size);
+
+	// One work-group in each wavefront pool
+	std::vector<WorkGroup *> work_groups_0;
+	for (int i = 0; i < 4; i++)
+	{
+		WorkGroup *work_group = Dispatch(gpu, ndrange_0.get(), i);
+		ASSERT_NE(nullptr, work_group);
+		WavefrontPool *wavefront_pool =
+				compute_unit->getWavefrontPool(i);
+		EXPECT_EQ(wavefront_pool, work_group->wavefront_pool);
+		EXPECT_EQ(1, wavefront_pool->getNumWorkGroups());
+		EXPECT_EQ(2, wavefront_pool->getNumWavefronts());
+		EXPECT_EQ(512, wavefront_pool->getNumVectorRegisters());
+		EXPECT_EQ(40000, wavefront_pool->getLocalMemorySize());
+		work_groups_0.push_back(work_group);
+	}
+	EXPECT_EQ(128, compute_unit->getNumScalarRegisters());
+
+	// Local memory is exhausted for the first NDRange
+	EXPECT_EQ(nullptr, gpu->getAvailableComputeUnit(ndrange_0.get()));
+
+	// A work-group of a second NDRange without local memory still fits,
+	// in the first wavefront pool with the lowest free entry
+	auto ndrange_1 = CreateNDRange(64, 4, 2, 8, 0);
+	gpu->StartNDRange(ndrange_1.get());
+	WorkGroup *work_group_1 = Dispatch(gpu, ndrange_1.get(), 0);
+	ASSERT_NE(nullptr, work_group_1);
+	WavefrontPool *wavefront_pool_0 = compute_unit->getWavefrontPool(0);
+	EXPECT_EQ(wavefront_pool_0, work_group_1->wavefront_pool);
+	EXPECT_EQ(2, wavefront_pool_0->getNumWorkGroups());
+	EXPECT_EQ(3, wavefront_pool_0->getNumWavefronts());
+	EXPECT_EQ(640, wavefront_pool_0->getNumVectorRegisters());
+	EXPECT_EQ(40000, wavefront_pool_0->getLocalMemorySize());
+	EXPECT_EQ(136, compute_unit->getNumScalarRegisters());
+
+	// Unmapping a work-group of the first NDRange releases its resources
+	// for the next one
+	WavefrontPool *wavefront_pool_1 = compute_unit->getWavefrontPool(1);
+	compute_unit->UnmapWorkGroup(work_groups_0[1]);
+	EXPECT_EQ(0, wavefront_pool_1->getNumWorkGroups());
+	EXPECT_EQ(0, wavefront_pool_1->getNumWavefronts());
+	EXPECT_EQ(0, wavefront_pool_1->getNumVectorRegisters());
+	EXPECT_EQ(0, wavefront_pool_1->getLocalMemorySize());
+	EXPECT_EQ(104, compute_unit->getNumScalarRegisters());
+	WorkGroup *work_group = Dispatch(gpu, ndrange_0.get(), 4);
+	ASSERT_NE(nullptr, work_group);
+	EXPECT_EQ(wavefront_pool_1, work_group->wavefront_pool);
+	EXPECT_EQ(136, compute_unit->getNumScalarRegisters());
+}
+
+
+// Scalar registers are shared by all wavefront pools of a compute unit, and
+// limit the work-groups mapped to it even if wavefront pools have room.
+TEST(TestGpu, scalar_registers)
+{
+	Cleanup();
+	Gpu *gpu = CreateGpu(64);
+	ComputeUnit *compute_unit = gpu->getComputeUnit(0);
+
+	// Two work-groups with one wavefront using 24 scalar registers fit
+	auto ndrange = CreateNDRange(64, 4, 1, 24, 0);
+	gpu->StartNDRange(ndrange.get());
+	EXPECT_NE(nullptr, Dispatch(gpu, ndrange.get(), 0));
+	EXPECT_NE(nullptr, Dispatch(gpu, ndrange.get(), 1));
+	EXPECT_EQ(48, compute_unit->getNumScalarRegisters());
+	EXPECT_TRUE(compute_unit->getWavefrontPool(2)->hasFreeEntries());
+	EXPECT_EQ(nullptr, gpu->getAvailableComputeUnit(ndrange.get()));
+
+	// A work-group needing more scalar registers than the compute unit
+	// has cannot run
+	auto ndrange_large = CreateNDRange(128, 1, 1, 40, 0);
+	EXPECT_THROW(gpu->StartNDRange(ndrange_large.get()), Timing::Error);
+
+	// Restore default
+	Cleanup();
+	CreateGpu(2048);
+}
+
+}  // namespace SI
@@ -0,0 +1,341 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2015  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <gtest/gtest.h>
+
+#include <arch/common/Arch.h>
+#include <arch/x86/emulator/Context.h>
+#include <arch/x86/emulator/Emulator.h>
+#include <arch/x86/timing/Timing.h>
+#include <memory/Memory.h>
+
+
+namespace x86
+{
+
+// Address of the page holding the string instruction under test
+static const unsigned code_address = 0x1000;
+
+// Address of the first data page
+static const unsigned data_address = 0x10000;
+
+// Number of data pages mapped after 'data_address'
+static const unsigned num_data_pages = 4;
+
+
+// Create a context whose only instruction is the string instruction given in
+// 'code', with the data pages mapped with read and write permissions.
+static Context *CreateContext(const std::string &code)
+{
+	Emulator *emulator = Emulator::getInstance();
+	Context *context = emulator->newContext();
+	context->Initialize();
+
+	// Map code and data
+	mem::Memory *memory = context->getMemory();
+	memory->Map(code_address, mem::Memory::PageSize,
+			mem::Memory::AccessRead | mem::Memory::AccessExec |
+			mem::Memory::AccessInit);
+	memory->Map(data_address, num_data_pages * mem::Memory::PageSize,
+			mem::Memory::AccessRead | mem::Memory::AccessWrite);
+	memory->Init(code_address, code.size(), code.data());
+
+	// Start at the string instruction
+	context->getRegs().setEip(code_address);
+	return context;
+}
+
+
+// Emulate the string instruction until all its repetitions are done,
+// allowing as many repetitions per call to Context::Execute() as a functional
+// simulation quantum would. Return the number of x86 instructions counted by
+// the emulator, and the number of calls in 'num_calls'.
+static long long RunStringInst(Context *context, int &num_calls)
+{
+	Emulator *emulator = Emulator::getInstance();
+	long long num_instructions = emulator->getNumInstructions();
+	num_calls = 0;
+	do
+	{
+		context->Execute(100000);
+		num_calls++;
+	} while (context->getRegs().getEip() == code_address &&
+			num_calls < 100000);
+	return emulator->getNumInstructions() - num_instructions;
+}
+
+
+// Reset the singletons between tests
+static void Cleanup()
+{
+	Timing::Destroy();
+	Emulator::Destroy();
+	comm::ArchPool::Destroy();
+}
+
+
+// Fill 'size' bytes at 'address' with a pattern that depends on the address
+static void WritePattern(mem::Memory *memory, unsigned address, unsigned size)
+{
+	std::string data(size, 0);
+	for (unsigned i = 0; i < size; i++)
+		data[i] = (address + i) * 7 + 1;
+	memory->Write(address, size, data.data());
+}
+
+
+// Read 'size' bytes at 'address' into a string
+static std::string Read(mem::Memory *memory, unsigned address, unsigned size)
+{
+	std::string data(size, 0);
+	memory->Read(address, size, &data[0]);
+	return data;
+}
+
+
+TEST(TestContextIsaStr, rep_movsb_page_crossing)
+{
+	// rep movsb, with source and destination crossing page boundaries at
+	// different offsets
+	Context *context = CreateContext("\xf3\xa4");
+	mem::Memory *memory = context->getMemory();
+	Regs &regs = context->getRegs();
+	unsigned src = data_address + 0xf00;
+	unsigned dst = data_address + 0x2f80;
+	unsigned size = 0x1000;
+	WritePattern(memory, src, size);
+	std::string expected = Read(memory, src, size);
+	regs.setEsi(src);
+	regs.setEdi(dst);
+	regs.setEcx(size);
+
+	// Each repetition counts as one instruction, plus the final one
+	// finding ECX = 0, as if repetitions were emulated one by one. All of
+	// them are emulated in two calls.
+	int num_calls;
+	EXPECT_EQ(size + 1, RunStringInst(context, num_calls));
+	EXPECT_EQ(2, num_calls);
+	EXPECT_TRUE(expected == Read(memory, dst, size));
+	EXPECT_EQ(src + size, regs.getEsi());
+	EXPECT_EQ(dst + size, regs.getEdi());
+	EXPECT_EQ(0u, regs.getEcx());
+	Cleanup();
+}
+
+
+TEST(TestContextIsaStr, rep_movsd_backward)
+{
+	// rep movsd with the direction flag set, copying 10 double words
+	// backwards across a page boundary
+	Context *context = CreateContext("\xf3\xa5");
+	mem::Memory *memory = context->getMemory();
+	Regs &regs = context->getRegs();
+	unsigned src = data_address + 0x1008;
+	unsigned dst = data_address + 0x3000;
+	WritePattern(memory, src - 36, 40);
+	std::string expected = Read(memory, src - 36, 40);
+	regs.setFlag(Instruction::FlagDF);
+	regs.setEsi(src);
+	regs.setEdi(dst);
+	regs.setEcx(10);
+
+	int num_calls;
+	EXPECT_EQ(11, RunStringInst(context, num_calls));
+	EXPECT_EQ(2, num_calls);
+	EXPECT_TRUE(expected == Read(memory, dst - 36, 40));
+	EXPECT_EQ(src - 40, regs.getEsi());
+	EXPECT_EQ(dst - 40, regs.getEdi());
+	EXPECT_EQ(0u, regs.getEcx());
+	Cleanup();
+}
+
+
+TEST(TestContextIsaStr, rep_movsb_overlap)
+{
+	// rep movsb with the destination one byte after the source replicates
+	// the first byte, as if repetitions were emulated one by one.
+	Context *context = CreateContext("\xf3\xa4");
+	mem::Memory *memory = context->getMemory();
+	Regs &regs = context->getRegs();
+	unsigned src = data_address + 0xff8;
+	WritePattern(memory, src, 0x40);
+	std::string first = Read(memory, src, 1);
+	regs.setEsi(src);
+	regs.setEdi(src + 1);
+	regs.setEcx(0x3f);
+
+	int num_calls;
+	EXPECT_EQ(0x40, RunStringInst(context, num_calls));
+	EXPECT_TRUE(std::string(0x40, first[0]) == Read(memory, src, 0x40));
+	EXPECT_EQ(src + 0x3f, regs.getEsi());
+	EXPECT_EQ(src + 0x40, regs.getEdi());
+	EXPECT_EQ(0u, regs.getEcx());
+	Cleanup();
+}
+
+
+TEST(TestContextIsaStr, rep_stosb_no_count)
+{
+	// rep stosb with ECX = 0 does not write memory
+	Context *context = CreateContext("\xf3\xaa");
+	mem::Memory *memory = context->getMemory();
+	Regs &regs = context->getRegs();
+	WritePattern(memory, data_address, 16);
+	std::string expected = Read(memory, data_address, 16);
+	regs.setEax(0xaa);
+	regs.setEdi(data_address);
+	regs.setEcx(0);
+
+	int num_calls;
+	EXPECT_EQ(1, RunStringInst(context, num_calls));
+	EXPECT_TRUE(expected == Read(memory, data_address, 16));
+	EXPECT_EQ(data_address, regs.getEdi());
+	EXPECT_EQ(code_address + 2, regs.getEip());
+	Cleanup();
+}
+
+
+TEST(TestContextIsaStr, rep_stosb_address_wrap)
+{
+	// rep stosb wrapping around the top of the address space
+	Context *context = CreateContext("\xf3\xaa");
+	mem::Memory *memory = context->getMemory();
+	Regs &regs = context->getRegs();
+	memory->Map(0xfffff000, mem::Memory::PageSize,
+			mem::Memory::AccessRead | mem::Memory::AccessWrite);
+	memory->Map(0, mem::Memory::PageSize,
+			mem::Memory::AccessRead | mem::Memory::AccessWrite);
+	regs.setEax(0x5a);
+	regs.setEdi(0xfffffff8);
+	regs.setEcx(16);
+
+	int num_calls;
+	EXPECT_EQ(17, RunStringInst(context, num_calls));
+	EXPECT_EQ(2, num_calls);
+	EXPECT_EQ(std::string(8, 0x5a), Read(memory, 0xfffffff8, 8));
+	EXPECT_EQ(std::string(8, 0x5a), Read(memory, 0, 8));
+	EXPECT_EQ(std::string(1, 0), Read(memory, 8, 1));
+	EXPECT_EQ(8u, regs.getEdi());
+	EXPECT_EQ(0u, regs.getEcx());
+	Cleanup();
+}
+
+
+TEST(TestContextIsaStr, repz_cmpsb_mismatch)
+{
+	// repz cmpsb stopping at a mismatch found after the source crosses a
+	// page boundary
+	Context *context = CreateContext("\xf3\xa6");
+	mem::Memory *memory = context->getMemory();
+	Regs &regs = context->getRegs();
+	unsigned src = data_address + 0xff0;
+	unsigned dst = data_address + 0x2ff8;
+	std::string data(64, 'a');
+	memory->Write(src, 64, data.data());
+	data[40] = 'b';
+	memory->Write(dst, 64, data.data());
+	regs.setEsi(src);
+	regs.setEdi(dst);
+	regs.setEcx(64);
+
+	int num_calls;
+	EXPECT_EQ(41, RunStringInst(context, num_calls));
+	EXPECT_GE(3, num_calls);
+	EXPECT_EQ(src + 41, regs.getEsi());
+	EXPECT_EQ(dst + 41, regs.getEdi());
+	EXPECT_EQ(23u, regs.getEcx());
+	EXPECT_FALSE(regs.getFlag(Instruction::FlagZF));
+	Cleanup();
+}
+
+
+TEST(TestContextIsaStr, repnz_scasb)
+{
+	// repnz scasb looking for a byte located on the page after the first
+	// one scanned
+	Context *context = CreateContext("\xf2\xae");
+	mem::Memory *memory = context->getMemory();
+	Regs &regs = context->getRegs();
+	unsigned dst = data_address + 0xf80;
+	std::string data(300, 'a');
+	data[200] = 'z';
+	memory->Write(dst, 300, data.data());
+	regs.setEax('z');
+	regs.setEdi(dst);
+	regs.setEcx(300);
+
+	int num_calls;
+	EXPECT_EQ(201, RunStringInst(context, num_calls));
+	EXPECT_GE(3, num_calls);
+	EXPECT_EQ(dst + 201, regs.getEdi());
+	EXPECT_EQ(99u, regs.getEcx());
+	EXPECT_TRUE(regs.getFlag(Instruction::FlagZF));
+	Cleanup();
+}
+
+
+TEST(TestContextIsaStr, rep_movsb_fault)
+{
+	// rep movsb reading past the last data page faults on the first byte
+	// of the unmapped page, with registers pointing to that byte.
+	Context *context = CreateContext("\xf3\xa4");
+	Regs &regs = context->getRegs();
+	unsigned src = data_address + num_data_pages * mem::Memory::PageSize
+			- 0x10;
+	unsigned dst = data_address;
+	regs.setEsi(src);
+	regs.setEdi(dst);
+	regs.setEcx(0x20);
+
+	EXPECT_THROW(context->Execute(100000), mem::Memory::Error);
+	EXPECT_EQ(src + 0x10, regs.getEsi());
+	EXPECT_EQ(dst + 0x10, regs.getEdi());
+	EXPECT_EQ(0x10u, regs.getEcx());
+	Cleanup();
+}
+
+
+TEST(TestContextIsaStr, rep_movsb_max_instructions)
+{
+	// rep movsb emulating no more repetitions than allowed, and resuming
+	// in the next call
+	Context *context = CreateContext("\xf3\xa4");
+	mem::Memory *memory = context->getMemory();
+	Regs &regs = context->getRegs();
+	unsigned src = data_address;
+	unsigned dst = data_address + 0x2000;
+	WritePattern(memory, src, 0x1000);
+	std::string expected = Read(memory, src, 0x1000);
+	regs.setEsi(src);
+	regs.setEdi(dst);
+	regs.setEcx(0x1000);
+
+	EXPECT_EQ(100, context->Execute(100));
+	EXPECT_EQ(code_address, regs.getEip());
+	EXPECT_EQ(src + 100, regs.getEsi());
+	EXPECT_EQ(0x1000u - 100, regs.getEcx());
+
+	int num_calls;
+	EXPECT_EQ(0x1000 - 100 + 1, RunStringInst(context, num_calls));
+	EXPECT_TRUE(expected == Read(memory, dst, 0x1000));
+	EXPECT_EQ(0u, regs.getEcx());
+	Cleanup();
+}
+
+}
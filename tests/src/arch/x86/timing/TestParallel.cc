@@ -0,0 +1,268 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2015  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "gtest/gtest.h"
+
+#include <arch/common/Arch.h>
+#include <arch/x86/emulator/Context.h>
+#include <arch/x86/emulator/Emulator.h>
+#include <arch/x86/timing/Cpu.h>
+#include <arch/x86/timing/Timing.h>
+#include <lib/cpp/IniFile.h>
+#include <lib/cpp/Misc.h>
+#include <lib/esim/Engine.h>
+#include <memory/Memory.h>
+#include <memory/System.h>
+#include <network/System.h>
+
+
+namespace x86
+{
+
+// Number of cores, each running one program
+static const int num_cores = 4;
+
+// Address of the code of each program
+static const unsigned code_address = 0x1000;
+
+// Address of the data of each program
+static const unsigned data_address = 0x10000;
+
+// Size of the data of each program
+static const unsigned data_size = 4 * mem::Memory::PageSize;
+
+// Cycles after which the simulation is considered deadlocked
+static const long long max_cycles = 200000;
+
+// Memory hierarchy with private L1 caches with a single port and a small
+// MSHR, so that cores often find their caches busy
+static const std::string mem_config =
+		"[ CacheGeometry geo-l1 ]\n"
+		"Sets = 16\n"
+		"Assoc = 2\n"
+		"BlockSize = 64\n"
+		"Latency = 2\n"
+		"Ports = 1\n"
+		"MSHR = 2\n"
+		"[ Module mod-l1-0 ]\n"
+		"Type = Cache\n"
+		"Geometry = geo-l1\n"
+		"LowNetwork = net-l1-mm\n"
+		"LowModules = mod-mm\n"
+		"[ Module mod-l1-1 ]\n"
+		"Type = Cache\n"
+		"Geometry = geo-l1\n"
+		"LowNetwork = net-l1-mm\n"
+		"LowModules = mod-mm\n"
+		"[ Module mod-l1-2 ]\n"
+		"Type = Cache\n"
+		"Geometry = geo-l1\n"
+		"LowNetwork = net-l1-mm\n"
+		"LowModules = mod-mm\n"
+		"[ Module mod-l1-3 ]\n"
+		"Type = Cache\n"
+		"Geometry = geo-l1\n"
+		"LowNetwork = net-l1-mm\n"
+		"LowModules = mod-mm\n"
+		"[ Module mod-mm ]\n"
+		"Type = MainMemory\n"
+		"BlockSize = 64\n"
+		"Latency = 20\n"
+		"HighNetwork = net-l1-mm\n"
+		"[ Network net-l1-mm ]\n"
+		"DefaultInputBufferSize = 256\n"
+		"DefaultOutputBufferSize = 256\n"
+		"DefaultBandwidth = 64\n"
+		"[ Entry core-0 ]\n"
+		"Arch = x86\n"
+		"Core = 0\n"
+		"Thread = 0\n"
+		"DataModule = mod-l1-0\n"
+		"InstModule = mod-l1-0\n"
+		"[ Entry core-1 ]\n"
+		"Arch = x86\n"
+		"Core = 1\n"
+		"Thread = 0\n"
+		"DataModule = mod-l1-1\n"
+		"InstModule = mod-l1-1\n"
+		"[ Entry core-2 ]\n"
+		"Arch = x86\n"
+		"Core = 2\n"
+		"Thread = 0\n"
+		"DataModule = mod-l1-2\n"
+		"InstModule = mod-l1-2\n"
+		"[ Entry core-3 ]\n"
+		"Arch = x86\n"
+		"Core = 3\n"
+		"Thread = 0\n"
+		"DataModule = mod-l1-3\n"
+		"InstModule = mod-l1-3\n";
+
+
+// Outcome of a simulation
+struct Outcome
+{
+	// Cycle where the last program finished
+	long long cycles = 0;
+
+	// Instructions committed by all cores
+	long long num_committed_instructions = 0;
+
+	// Data of each program when it finished
+	std::string data[num_cores];
+};
+
+
+// Reset the singletons between simulations
+static void Cleanup()
+{
+	esim::Engine::Destroy();
+	net::System::Destroy();
+	mem::System::Destroy();
+	Timing::Destroy();
+	Emulator::Destroy();
+	comm::ArchPool::Destroy();
+}
+
+
+// Create a context running a program that walks its data with a stride of
+// one cache block for the given number of iterations. Each iteration loads
+// the value stored by the previous one, adds the iteration count, and stores
+// the sum in the next block.
+static Context *CreateContext(unsigned num_iterations)
+{
+	std::string code =
+			"\xb9" + std::string((const char *) &num_iterations, 4) +
+			std::string("\xbe\x00\x00\x01\x00", 5) +
+			std::string("\x8b\x06\x01\xc8\x89\x46\x40\x83\xc6\x40"
+					"\x49\x75\xf3", 13) +
+			std::string("\xb8\x01\x00\x00\x00\xbb\x00\x00\x00\x00"
+					"\xcd\x80", 12);
+
+	// Map code and data
+	Emulator *emulator = Emulator::getInstance();
+	Context *context = emulator->newContext();
+	context->Initialize();
+	mem::Memory *memory = context->getMemory();
+	memory->Map(code_address, mem::Memory::PageSize,
+			mem::Memory::AccessRead | mem::Memory::AccessExec |
+			mem::Memory::AccessInit);
+	memory->Map(data_address, data_size,
+			mem::Memory::AccessRead | mem::Memory::AccessWrite);
+	memory->Init(code_address, code.size(), code.data());
+
+	// Start running
+	context->setUinstActive(true);
+	context->setState(Context::StateRunning);
+	context->getRegs().setEip(code_address);
+	return context;
+}
+
+
+// Simulate one program per core with the given number of host threads
+static Outcome Simulate(int num_threads)
+{
+	// CPU configuration
+	Cleanup();
+	misc::IniFile config_ini;
+	config_ini.LoadFromString(misc::fmt(
+			"[ General ]\n"
+			"Cores = %d\n"
+			"ParallelThreads = %d\n"
+			"ParallelQuantum = 10\n"
+			"[ TraceCache ]\n"
+			"Present = f\n",
+			num_cores, num_threads));
+	Timing::ParseConfiguration(&config_ini);
+	Emulator::getInstance();
+	Timing *timing = Timing::getInstance();
+
+	// Memory configuration
+	misc::IniFile mem_config_ini;
+	mem_config_ini.LoadFromString(mem_config);
+	mem::System::getInstance()->ReadConfiguration(&mem_config_ini);
+
+	// Programs of different lengths
+	int pids[num_cores];
+	for (int i = 0; i < num_cores; i++)
+		pids[i] = CreateContext(100 + 30 * i)->getId();
+
+	// Simulate until all programs finish. Finished contexts are freed by
+	// the scheduler in a later cycle, so their data is saved first.
+	Outcome outcome;
+	Emulator *emulator = Emulator::getInstance();
+	esim::Engine *esim_engine = esim::Engine::getInstance();
+	while (timing->Run() && timing->getCycle() < max_cycles)
+	{
+		esim_engine->ProcessEvents();
+		for (int i = 0; i < num_cores; i++)
+		{
+			Context *context = emulator->getContext(pids[i]);
+			if (context && context->getState(Context::StateFinished)
+					&& outcome.data[i].empty())
+			{
+				outcome.data[i].resize(data_size);
+				context->getMemory()->Read(data_address, data_size,
+						&outcome.data[i][0]);
+			}
+		}
+	}
+	outcome.cycles = timing->getCycle();
+	outcome.num_committed_instructions = timing->getCpu()->
+			getNumCommittedInstructions();
+	Cleanup();
+	return outcome;
+}
+
+
+TEST(TestX86TimingParallel, multiprogrammed)
+{
+	Outcome sequential = Simulate(1);
+	Outcome parallel_2 = Simulate(2);
+	Outcome parallel_4 = Simulate(4);
+
+	// All programs finished with the expected result
+	ASSERT_LT(sequential.cycles, max_cycles);
+	for (int i = 0; i < num_cores; i++)
+	{
+		unsigned num_iterations = 100 + 30 * i;
+		ASSERT_EQ(data_size, sequential.data[i].size());
+		unsigned result = *(unsigned *) &sequential.data[i][
+				num_iterations * 64];
+		EXPECT_EQ(num_iterations * (num_iterations + 1) / 2, result);
+	}
+
+	// Functional results match the sequential simulation. Timing differs,
+	// since buffered memory accesses complete up to a quantum later.
+	EXPECT_EQ(sequential.num_committed_instructions,
+			parallel_2.num_committed_instructions);
+	EXPECT_EQ(sequential.num_committed_instructions,
+			parallel_4.num_committed_instructions);
+	for (int i = 0; i < num_cores; i++)
+	{
+		EXPECT_TRUE(sequential.data[i] == parallel_2.data[i]);
+		EXPECT_TRUE(sequential.data[i] == parallel_4.data[i]);
+	}
+
+	// Timing does not depend on the number of host threads
+	EXPECT_LT(parallel_2.cycles, max_cycles);
+	EXPECT_EQ(parallel_2.cycles, parallel_4.cycles);
+}
+
+}
@@ -822,6 +822,61 @@ TEST(TestRegisterFile, write_uop_0)
 }
 
 
+// Tests WriteUop() with a uop that depends on two different producers. The
+// consumer must stay pending until both producers write their results, and
+// become ready exactly when the last one does.
+TEST(TestRegisterFile, write_uop_1)
+{
+	// Cleanup singleton instances
+	ObjectPool::Destroy();
+
+	// Get object pool instance
+	ObjectPool *object_pool = ObjectPool::getInstance();
+
+	// Create uinsts
+	auto uinst_0 = misc::new_shared<Uinst>(Uinst::OpcodeAdd);
+	auto uinst_1 = misc::new_shared<Uinst>(Uinst::OpcodeAdd);
+	auto uinst_2 = misc::new_shared<Uinst>(Uinst::OpcodeAdd);
+
+	// Set uinst dependencies
+	uinst_0->setODep(0, 1);
+	uinst_1->setODep(0, 23);
+	uinst_2->setIDep(0, 1);
+	uinst_2->setIDep(1, 23);
+
+	// Create uops
+	auto uop_0 = misc::new_unique<Uop>(object_pool->getThread(),
+			object_pool->getContext(),
+			uinst_0);
+	auto uop_1 = misc::new_unique<Uop>(object_pool->getThread(),
+			object_pool->getContext(),
+			uinst_1);
+	auto uop_2 = misc::new_unique<Uop>(object_pool->getThread(),
+			object_pool->getContext(),
+			uinst_2);
+
+	// Get register file
+	auto register_file = object_pool->getThread()->getRegisterFile();
+
+	// Rename producers first, then the consumer
+	register_file->Rename(uop_0.get());
+	register_file->Rename(uop_1.get());
+	register_file->Rename(uop_2.get());
+	EXPECT_EQ(2, uop_2->num_pending_inputs);
+	EXPECT_FALSE(register_file->isUopReady(uop_2.get()));
+
+	// Write first producer
+	register_file->WriteUop(uop_1.get());
+	EXPECT_EQ(1, uop_2->num_pending_inputs);
+	EXPECT_FALSE(register_file->isUopReady(uop_2.get()));
+
+	// Write second producer
+	register_file->WriteUop(uop_0.get());
+	EXPECT_EQ(0, uop_2->num_pending_inputs);
+	EXPECT_TRUE(uop_2->ready);
+	EXPECT_TRUE(register_file->isUopReady(uop_2.get()));
+}
+
 
 
 //
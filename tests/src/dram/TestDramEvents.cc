@@ -26,6 +26,8 @@
 #include <dram/Channel.h>
 #include <dram/Controller.h>
 #include <dram/Rank.h>
+#include <dram/Request.h>
+#include <dram/Scheduler.h>
 #include <dram/System.h>
 #include <gtest/gtest.h>
 #include <lib/cpp/IniFile.h>
@@ -806,4 +808,45 @@ TEST(TestSystemEvents, section_test_address_out_of_bounds)
 	EXPECT_REGEX_MATCH(misc::fmt("Invalid Address").c_str(),
 			message.c_str());
 }
+
+TEST(TestSystemEvents, section_test_fr_fcfs_row_hit_first)
+{
+	// cleanup singleton instance
+	Cleanup();
+
+	// Set up INI file
+	misc::IniFile ini_file;
+	ini_file.LoadFromString(zero_time_config);
+
+	// Set up dram instance
+	System *dram_system = System::getInstance();
+	dram_system->ParseConfiguration(&ini_file);
+
+	// Get relevant channel and banks
+	Channel *channel = dram_system->getController(0)->getChannel(0);
+	Bank *bank_0 = channel->getRank(0)->getBank(0);
+	Bank *bank_1 = channel->getRank(0)->getBank(1);
+
+	// Open a row in bank 1, leaving its read at the front of the queue
+	auto request_1 = std::make_shared<Request>();
+	request_1->setEncodedAddress(1 << 20);
+	request_1->setType(RequestRead);
+	bank_1->ProcessRequest(request_1);
+	bank_1->RunFrontCommand();
+
+	// Bank 0 needs an activate before its read
+	auto request_0 = std::make_shared<Request>();
+	request_0->setEncodedAddress(0);
+	request_0->setType(RequestRead);
+	bank_0->ProcessRequest(request_0);
+
+	// Both front commands are equally old and can run in the same
+	// cycle. FR-FCFS prefers the read to the open row, while oldest
+	// first keeps the first bank.
+	FrFcfs fr_fcfs(channel);
+	OldestFirst oldest_first(channel);
+	EXPECT_EQ(bank_1, fr_fcfs.FindNext());
+	EXPECT_EQ(bank_0, oldest_first.FindNext());
+}
+
 }
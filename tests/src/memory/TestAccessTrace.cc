@@ -0,0 +1,77 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2012  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <unistd.h>
+
+#include <memory/AccessTrace.h>
+
+namespace mem
+{
+
+TEST(TestAccessTrace, write_read)
+{
+	// Temporary file for the trace
+	char path_template[] = "/tmp/m2s-access-trace-XXXXXX";
+	int fd = mkstemp(path_template);
+	ASSERT_NE(-1, fd);
+	close(fd);
+	std::string path = path_template;
+
+	Module mod_a("mod-a", Module::TypeCache, 2, 64, 1);
+	Module mod_b("mod-b", Module::TypeCache, 2, 64, 1);
+
+	// Record accesses, including large cycle gaps and addresses
+	{
+		AccessTraceWriter writer(path);
+		writer.Record(3, &mod_a, Module::AccessLoad, 0x1000);
+		writer.Record(3, &mod_b, Module::AccessStore, 0xfffffff0);
+		writer.Record(100003, &mod_a, Module::AccessNCStore, 0x40);
+		EXPECT_EQ(3, writer.getNumAccesses());
+	}
+
+	// Read them back
+	AccessTraceReader reader(path);
+	AccessTraceReader::Record record;
+
+	ASSERT_TRUE(reader.Read(record));
+	EXPECT_EQ("mod-a", record.module_name);
+	EXPECT_EQ(Module::AccessLoad, record.access_type);
+	EXPECT_EQ(3, record.cycle_delta);
+	EXPECT_EQ(0x1000u, record.address);
+
+	ASSERT_TRUE(reader.Read(record));
+	EXPECT_EQ("mod-b", record.module_name);
+	EXPECT_EQ(Module::AccessStore, record.access_type);
+	EXPECT_EQ(0, record.cycle_delta);
+	EXPECT_EQ(0xfffffff0u, record.address);
+
+	ASSERT_TRUE(reader.Read(record));
+	EXPECT_EQ("mod-a", record.module_name);
+	EXPECT_EQ(Module::AccessNCStore, record.access_type);
+	EXPECT_EQ(100000, record.cycle_delta);
+	EXPECT_EQ(0x40u, record.address);
+
+	EXPECT_FALSE(reader.Read(record));
+	remove(path.c_str());
+}
+
+}
@@ -0,0 +1,131 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2012  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "gtest/gtest.h"
+
+#include <memory/Directory.h>
+
+namespace mem
+{
+
+TEST(TestDirectory, full_map)
+{
+	Directory directory("dir", 4, 2, 2, 16, Directory::TypeFullMap);
+	EXPECT_TRUE(directory.isPrecise());
+
+	directory.setSharer(1, 1, 0, 3);
+	directory.setSharer(1, 1, 0, 12);
+	directory.setSharer(1, 1, 0, 12);
+	EXPECT_EQ(2, directory.getEntry(1, 1, 0)->getNumSharers());
+	EXPECT_TRUE(directory.isSharer(1, 1, 0, 12));
+	EXPECT_FALSE(directory.isSharer(1, 1, 1, 12));
+
+	directory.clearAllSharersExcept(1, 1, 0, 12);
+	EXPECT_EQ(1, directory.getEntry(1, 1, 0)->getNumSharers());
+	EXPECT_FALSE(directory.isSharer(1, 1, 0, 3));
+	EXPECT_TRUE(directory.isSharer(1, 1, 0, 12));
+}
+
+TEST(TestDirectory, limited_pointer)
+{
+	Directory directory("dir", 4, 2, 1, 16,
+			Directory::TypeLimitedPointer, 2);
+	EXPECT_FALSE(directory.isPrecise());
+
+	// Precise while pointers are available
+	directory.setSharer(0, 0, 0, 5);
+	directory.setSharer(0, 0, 0, 9);
+	EXPECT_EQ(2, directory.getEntry(0, 0, 0)->getNumSharers());
+	EXPECT_FALSE(directory.isSharer(0, 0, 0, 1));
+	directory.clearSharer(0, 0, 0, 5);
+	EXPECT_FALSE(directory.isSharer(0, 0, 0, 5));
+	EXPECT_TRUE(directory.isSharer(0, 0, 0, 9));
+
+	// Overflow makes all nodes sharers
+	directory.setSharer(0, 0, 0, 1);
+	directory.setSharer(0, 0, 0, 2);
+	EXPECT_EQ(16, directory.getEntry(0, 0, 0)->getNumSharers());
+	EXPECT_TRUE(directory.isSharer(0, 0, 0, 15));
+	directory.clearSharer(0, 0, 0, 1);
+	EXPECT_TRUE(directory.isSharer(0, 0, 0, 1));
+
+	// Invalidation restores a precise entry
+	directory.clearAllSharersExcept(0, 0, 0, 2);
+	EXPECT_EQ(1, directory.getEntry(0, 0, 0)->getNumSharers());
+	EXPECT_TRUE(directory.isSharer(0, 0, 0, 2));
+	EXPECT_FALSE(directory.isSharer(0, 0, 0, 9));
+}
+
+TEST(TestDirectory, coarse_vector)
+{
+	Directory directory("dir", 4, 2, 1, 10,
+			Directory::TypeCoarseVector, 4, 4);
+	EXPECT_FALSE(directory.isPrecise());
+
+	// Sharers are tracked per group of 4 nodes, the last group having 2
+	directory.setSharer(2, 1, 0, 5);
+	EXPECT_TRUE(directory.isSharer(2, 1, 0, 4));
+	EXPECT_TRUE(directory.isSharer(2, 1, 0, 7));
+	EXPECT_FALSE(directory.isSharer(2, 1, 0, 8));
+	directory.setSharer(2, 1, 0, 9);
+	EXPECT_EQ(6, directory.getEntry(2, 1, 0)->getNumSharers());
+
+	// Single sharers cannot be removed
+	directory.clearSharer(2, 1, 0, 5);
+	EXPECT_TRUE(directory.isSharer(2, 1, 0, 5));
+
+	directory.clearAllSharersExcept(2, 1, 0, Directory::NoOwner);
+	EXPECT_EQ(0, directory.getEntry(2, 1, 0)->getNumSharers());
+	EXPECT_FALSE(directory.isBlockSharedOrOwned(2, 1));
+}
+
+TEST(TestDirectory, sparse)
+{
+	Directory directory("dir", 1024, 16, 1, 64, Directory::TypeSparse);
+	EXPECT_TRUE(directory.isPrecise());
+
+	directory.setSharer(1023, 15, 0, 63);
+	directory.setSharer(1023, 15, 0, 0);
+	EXPECT_EQ(2, directory.getEntry(1023, 15, 0)->getNumSharers());
+	EXPECT_TRUE(directory.isSharer(1023, 15, 0, 63));
+	EXPECT_FALSE(directory.isSharer(1023, 15, 0, 1));
+	EXPECT_FALSE(directory.isSharer(0, 0, 0, 63));
+
+	directory.clearSharer(1023, 15, 0, 63);
+	directory.clearSharer(1023, 15, 0, 0);
+	EXPECT_EQ(0, directory.getEntry(1023, 15, 0)->getNumSharers());
+	EXPECT_FALSE(directory.isSharer(1023, 15, 0, 0));
+}
+
+TEST(TestDirectory, locks)
+{
+	Directory directory("dir", 4, 2, 1, 4);
+
+	EXPECT_TRUE(directory.LockEntry(3, 1, nullptr, 10));
+	EXPECT_TRUE(directory.LockEntry(0, 0, nullptr, 11));
+	EXPECT_EQ(2, directory.getNumLockedEntries());
+	EXPECT_EQ(10, directory.getEntryAccessId(3, 1));
+	EXPECT_FALSE(directory.isEntryLocked(3, 0));
+
+	directory.UnlockEntry(3, 1, 10);
+	EXPECT_FALSE(directory.isEntryLocked(3, 1));
+	EXPECT_EQ(1, directory.getNumLockedEntries());
+}
+
+}
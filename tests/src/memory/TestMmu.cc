@@ -0,0 +1,64 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2012  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "gtest/gtest.h"
+
+#include <memory/Mmu.h>
+
+namespace mem
+{
+
+// Pages are allocated contiguously in the order in which they are touched
+TEST(TestMmu, contiguous_allocation)
+{
+	Mmu mmu("test");
+	Mmu::Space *space_0 = mmu.newSpace("space-0");
+	Mmu::Space *space_1 = mmu.newSpace("space-1");
+
+	EXPECT_EQ(0x0u, mmu.TranslateVirtualAddress(space_1, 0x8000));
+	EXPECT_EQ(0x1010u, mmu.TranslateVirtualAddress(space_0, 0x8010));
+	EXPECT_EQ(0x2004u, mmu.TranslateVirtualAddress(space_1, 0x4004));
+	EXPECT_EQ(0x10u, mmu.TranslateVirtualAddress(space_1, 0x8010));
+}
+
+// With regions, the physical address of a page does not depend on accesses
+// performed by spaces in other regions.
+TEST(TestMmu, region_allocation)
+{
+	Mmu mmu("test");
+	Mmu::Space *space_0 = mmu.newSpace("space-0");
+	Mmu::Space *space_1 = mmu.newSpace("space-1");
+	Mmu::Space *space_2 = mmu.newSpace("space-2");
+	mmu.setNumRegions(2);
+
+	EXPECT_EQ(0x80000000u, mmu.TranslateVirtualAddress(space_1, 0x8000));
+	EXPECT_EQ(0x10u, mmu.TranslateVirtualAddress(space_0, 0x8010));
+	EXPECT_EQ(0x80001004u, mmu.TranslateVirtualAddress(space_1, 0x4004));
+	EXPECT_EQ(0x1000u, mmu.TranslateVirtualAddress(space_2, 0x0));
+
+	// Reverse translation
+	Mmu::Space *space;
+	unsigned virtual_address;
+	ASSERT_TRUE(mmu.TranslatePhysicalAddress(0x80001004, space,
+			virtual_address));
+	EXPECT_EQ(space_1, space);
+	EXPECT_EQ(0x4004u, virtual_address);
+}
+
+}
@@ -19,8 +19,12 @@
 
 #include "gtest/gtest.h"
 
+#include <sstream>
+
 #include <arch/x86/timing/Timing.h>
 #include <arch/common/Arch.h>
+#include <dram/Controller.h>
+#include <dram/System.h>
 #include <lib/cpp/IniFile.h>
 #include <lib/cpp/Error.h>
 #include <lib/esim/Engine.h>
@@ -85,6 +89,51 @@ const std::string mem_config_1 =
                 "DefaultBandwidth = 256"; 
 
 
+// Same as mem_config_1, with DRAM controller 'ctrl-0' modeling the timing of
+// main memory, and no MSHR limit
+const std::string mem_config_2 =
+		"[CacheGeometry geo-l1]\n"
+		"Sets = 128\n"
+		"Assoc = 2\n"
+		"BlockSize = 256\n"
+		"Latency = 5\n"
+		"DirectoryLatency = 5\n"
+		"Policy = LRU\n"
+		"Ports = 2\n"
+		"\n"
+		"[Module mod-l1-0]\n"
+		"Type = Cache\n"
+		"Geometry = geo-l1\n"
+		"LowNetwork = l1-mm\n"
+		"LowModules = mod-mm\n"
+		"\n"
+		"[Module mod-mm]\n"
+		"Type = MainMemory\n"
+		"BlockSize = 256\n"
+		"Latency = 200\n"
+		"HighNetwork = l1-mm\n"
+		"DramController = ctrl-0\n"
+		"\n"
+		"[Entry core-0]\n"
+		"Arch = x86\n"
+		"Core = 0\n"
+		"Thread = 0\n"
+		"DataModule = mod-l1-0\n"
+		"InstModule = mod-l1-0\n"
+		"\n"
+		"[Network l1-mm]\n"
+		"DefaultInputBufferSize = 1024\n"
+		"DefaultOutputBufferSize = 1024\n"
+		"DefaultBandwidth = 256";
+
+// DRAM controller in the same frequency domain as the memory system
+const std::string dram_config_0 =
+		"[General]\n"
+		"Frequency = 1000\n"
+		"\n"
+		"[MemoryController ctrl-0]\n";
+
+
 const std::string x86_config_0 =
 		"[ General ]\n"
 		"Cores = 1\n"
@@ -98,6 +147,8 @@ static void Cleanup()
 
 	System::Destroy();
 
+	dram::System::Destroy();
+
 	x86::Timing::Destroy();
 
 	comm::ArchPool::Destroy();
@@ -419,5 +470,137 @@ TEST(TestModule, can_access_2)
 }
 
 
-} // Namespace mem
+// Loads to the same block are coalesced only if there is no in-flight store
+// between them. The first two loads coalesce, while the last one does not
+// because of the store issued before it. Coalesced accesses are not counted
+// in the MSHR occupancy.
+TEST(TestModule, coalesce_0)
+{
+	try
+	{
+		// Cleanup singleton instances
+		Cleanup();
+
+		// Load configuration file
+		misc::IniFile ini_file_mem;
+		misc::IniFile ini_file_x86;
+		ini_file_mem.LoadFromString(mem_config_1);
+		ini_file_x86.LoadFromString(x86_config_0);
+
+		// Set up x86 timing simulator
+		x86::Timing::ParseConfiguration(&ini_file_x86);
+		x86::Timing::getInstance();
+
+		// Set up memory system
+		System *memory_system = System::getInstance();
+		memory_system->ReadConfiguration(&ini_file_mem);
+
+		// Get Modules
+		Module *module_l1_0 = memory_system->getModule("mod-l1-0");
+		ASSERT_NE(module_l1_0, nullptr);
+
+		// Set up accesses
+		module_l1_0->Access(Module::AccessLoad, 0x400);
+		module_l1_0->Access(Module::AccessLoad, 0x404);
+		module_l1_0->Access(Module::AccessStore, 0x800);
+		module_l1_0->Access(Module::AccessLoad, 0x408);
 
+		// Run simulation until all accesses complete
+		esim::Engine *esim_engine = esim::Engine::getInstance();
+		for (int i = 0; i < 2000; i++)
+			esim_engine->ProcessEvents();
+		EXPECT_FALSE(module_l1_0->isInFlightAddress(0x400));
+		EXPECT_FALSE(module_l1_0->isInFlightAddress(0x800));
+
+		// Check report
+		std::ostringstream os;
+		module_l1_0->DumpReport(os);
+		std::string report = os.str();
+		EXPECT_NE(std::string::npos, report.find("CoalescedReads = 1\n"));
+		EXPECT_NE(std::string::npos, report.find("MSHR = 2\n"));
+		EXPECT_NE(std::string::npos, report.find("MSHRMaxOccupancy = 3\n"));
+		EXPECT_EQ(std::string::npos, report.find("MSHRFullCycles = 0\n"));
+	}
+	catch (misc::Exception &e)
+	{
+		e.Dump();
+		FAIL();
+	}
+}
+
+
+// Sends a read miss in an L1 cache to a main memory module backed by a DRAM
+// controller, and checks that the access completes once the DRAM read
+// completes. The latency of the access is that of the same access with a
+// fixed main memory latency, replacing that latency by the one of the DRAM
+// read.
+TEST(TestModule, dram_controller_read)
+{
+	try
+	{
+		// Latency of a read miss with fixed main memory latency
+		Cleanup();
+		misc::IniFile ini_file_mem_fixed;
+		misc::IniFile ini_file_x86;
+		ini_file_mem_fixed.LoadFromString(mem_config_1);
+		ini_file_x86.LoadFromString(x86_config_0);
+		x86::Timing::ParseConfiguration(&ini_file_x86);
+		x86::Timing::getInstance();
+		System *memory_system = System::getInstance();
+		memory_system->ReadConfiguration(&ini_file_mem_fixed);
+		Module *module_l1_0 = memory_system->getModule("mod-l1-0");
+		ASSERT_NE(module_l1_0, nullptr);
+		long long id = module_l1_0->Access(Module::AccessLoad, 0x400);
+		esim::Engine *esim_engine = esim::Engine::getInstance();
+		int fixed_latency = 0;
+		while (module_l1_0->isInFlightAccess(id) || !fixed_latency)
+		{
+			esim_engine->ProcessEvents();
+			fixed_latency++;
+			ASSERT_LT(fixed_latency, 10000);
+		}
+
+		// Same access with a DRAM controller
+		Cleanup();
+		misc::IniFile ini_file_mem;
+		misc::IniFile ini_file_dram;
+		ini_file_mem.LoadFromString(mem_config_2);
+		ini_file_dram.LoadFromString(dram_config_0);
+		x86::Timing::ParseConfiguration(&ini_file_x86);
+		x86::Timing::getInstance();
+		dram::System *dram_system = dram::System::getInstance();
+		dram_system->ParseConfiguration(&ini_file_dram);
+		memory_system = System::getInstance();
+		memory_system->ReadConfiguration(&ini_file_mem);
+		module_l1_0 = memory_system->getModule("mod-l1-0");
+		Module *module_mm = memory_system->getModule("mod-mm");
+		ASSERT_NE(module_l1_0, nullptr);
+		ASSERT_NE(module_mm, nullptr);
+		dram::Controller *controller = module_mm->getDramController();
+		ASSERT_NE(controller, nullptr);
+		EXPECT_EQ("ctrl-0", controller->getName());
+		id = module_l1_0->Access(Module::AccessLoad, 0x400);
+		esim_engine = esim::Engine::getInstance();
+		int latency = 0;
+		while (module_l1_0->isInFlightAccess(id) || !latency)
+		{
+			esim_engine->ProcessEvents();
+			latency++;
+			ASSERT_LT(latency, 10000);
+		}
+
+		// One DRAM read, taking the place of the fixed latency
+		EXPECT_EQ(1, controller->getNumReads());
+		EXPECT_EQ(0, controller->getNumWrites());
+		long long dram_latency = controller->getTotalLatency();
+		EXPECT_GT(dram_latency, 0);
+		EXPECT_EQ(fixed_latency - 200 + dram_latency, latency);
+	}
+	catch (misc::Exception &e)
+	{
+		e.Dump();
+		FAIL();
+	}
+}
+
+} // Namespace mem
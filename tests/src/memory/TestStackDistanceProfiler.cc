@@ -0,0 +1,86 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2012  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "gtest/gtest.h"
+
+#include <memory/StackDistanceProfiler.h>
+
+namespace mem
+{
+
+// A cyclic access pattern over 4 blocks only suffers cold misses in a
+// fully-associative LRU cache of 4 blocks, but misses on every access in
+// smaller caches.
+TEST(TestStackDistanceProfiler, fully_associative_cyclic)
+{
+	StackDistanceProfiler profiler("mod", 64, 1, 8);
+	for (int i = 0; i < 10; i++)
+		for (unsigned block = 0; block < 4; block++)
+			profiler.Access(block);
+
+	EXPECT_EQ(40, profiler.getNumAccesses());
+	EXPECT_EQ(4, profiler.getNumColdMisses());
+	EXPECT_EQ(40, profiler.getNumMisses(1));
+	EXPECT_EQ(40, profiler.getNumMisses(2));
+	EXPECT_EQ(4, profiler.getNumMisses(4));
+	EXPECT_EQ(4, profiler.getNumMisses(8));
+
+	// The one-set bounded stacks must agree with the fully-associative
+	// stack for all modeled associativities.
+	EXPECT_EQ(40, profiler.getNumMisses(1, 2));
+	EXPECT_EQ(4, profiler.getNumMisses(1, 4));
+	EXPECT_EQ(4, profiler.getNumMisses(1, 8));
+}
+
+// Blocks 0 and 2 map to the same set in a 2-set cache, but to different sets
+// in a 4-set cache.
+TEST(TestStackDistanceProfiler, set_associative_conflicts)
+{
+	StackDistanceProfiler profiler("mod", 64, 4, 2);
+	for (int i = 0; i < 8; i++)
+	{
+		profiler.Access(0);
+		profiler.Access(2);
+	}
+
+	EXPECT_EQ(16, profiler.getNumAccesses());
+	EXPECT_EQ(16, profiler.getNumMisses(1, 1));
+	EXPECT_EQ(16, profiler.getNumMisses(2, 1));
+	EXPECT_EQ(2, profiler.getNumMisses(4, 1));
+	EXPECT_EQ(2, profiler.getNumMisses(1, 2));
+	EXPECT_EQ(2, profiler.getNumMisses(2, 2));
+}
+
+// Exercise the compaction of time stamps in the fully-associative stack by
+// running more accesses than the initial size of the Fenwick tree.
+TEST(TestStackDistanceProfiler, compaction)
+{
+	StackDistanceProfiler profiler("mod", 64, 1, 1);
+	const unsigned num_blocks = 1000;
+	for (int i = 0; i < 200; i++)
+		for (unsigned block = 0; block < num_blocks; block++)
+			profiler.Access(block);
+
+	EXPECT_EQ(200 * num_blocks, profiler.getNumAccesses());
+	EXPECT_EQ(num_blocks, profiler.getNumColdMisses());
+	EXPECT_EQ(200 * num_blocks, profiler.getNumMisses(512));
+	EXPECT_EQ(num_blocks, profiler.getNumMisses(1024));
+}
+
+}  // namespace mem
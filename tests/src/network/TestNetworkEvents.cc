@@ -19,6 +19,7 @@
 
 #include "gtest/gtest.h"
 
+#include <sstream>
 #include <string>
 #include <regex>
 #include <exception>
@@ -1884,4 +1885,97 @@ TEST(TestSystemConfiguration, event_config_13_ideal_fix_latency)
 	}
 }
 
+TEST(TestSystemConfiguration, event_config_14_analytical_model)
+{
+	// Same route in the detailed and analytical models: a 4-byte message
+	// split into 2-byte packets, over three links and two switches.
+	std::string config =
+			"DefaultInputBufferSize = 4\n"
+			"DefaultOutputBufferSize = 4\n"
+			"DefaultBandwidth = 1\n"
+			"DefaultPacketSize = 2\n"
+			"[Network.net0.Node.N0]\n"
+			"Type = EndNode\n"
+			"[Network.net0.Node.N1]\n"
+			"Type = EndNode\n"
+			"[Network.net0.Node.S0]\n"
+			"Type = Switch\n"
+			"BandWidth = 2\n"
+			"[Network.net0.Node.S1]\n"
+			"Type = Switch\n"
+			"BandWidth = 2\n"
+			"[Network.net0.Link.N0-S0]\n"
+			"Type = Unidirectional\n"
+			"Source = N0\n"
+			"Dest = S0\n"
+			"[Network.net0.Link.S0-S1]\n"
+			"Type = Unidirectional\n"
+			"Source = S0\n"
+			"Dest = S1\n"
+			"[Network.net0.Link.S1-N1]\n"
+			"Type = Unidirectional\n"
+			"Source = S1\n"
+			"Dest = N1\n";
+
+	// Latency of an isolated message in each model
+	std::string reports[2];
+	const char *models[2] = { "Detailed", "Analytical" };
+	for (int i = 0; i < 2; i++)
+	{
+		// Cleanup previous instance
+		Cleanup();
+
+		// Set up INI file
+		misc::IniFile ini_file;
+		ini_file.LoadFromString(std::string("[ Network.net0 ]\n"
+				"Model = ") + models[i] + "\n" + config);
+
+		// Set up network instance
+		System *system = System::getInstance();
+		EXPECT_TRUE(system != nullptr);
+
+		// Test body
+		try
+		{
+			// Parse the configuration file
+			system->ParseConfiguration(&ini_file);
+
+			// Getting the network
+			Network *network = system->getNetworkByName("net0");
+
+			// Getting the source and destination nodes
+			EndNode *N0 = dynamic_cast<EndNode *>(
+					network->getNodeByName("N0"));
+			EndNode *N1 = dynamic_cast<EndNode *>(
+					network->getNodeByName("N1"));
+
+			// Send a message, received automatically
+			EXPECT_TRUE(network->TrySend(N0, N1, 4) != nullptr);
+
+			// Simulation loop
+			esim::Engine *esim_engine = esim::Engine::getInstance();
+			for (int cycle = 0; cycle < 20; cycle++)
+				esim_engine->ProcessEvents();
+
+			// Save the report
+			std::ostringstream report;
+			network->DumpReport(report);
+			reports[i] = report.str();
+		}
+		catch (misc::Error &e)
+		{
+			e.Dump();
+			FAIL();
+		}
+	}
+
+	// Both models deliver the message with the same latency
+	EXPECT_REGEX_MATCH("(.|\n)*Transfers = 1\nAverageMessageSize = "
+			"4.00\nTransferredBytes = 4\nAverageLatency = 11.0000"
+			"(.|\n)*", reports[0].c_str());
+	EXPECT_REGEX_MATCH("(.|\n)*Transfers = 1\nAverageMessageSize = "
+			"4.00\nTransferredBytes = 4\nAverageLatency = 11.0000"
+			"(.|\n)*", reports[1].c_str());
+}
+
 }